@@ -44,7 +44,9 @@ AsyncTaskBase::AsyncTaskBase(int aPriority,
 	mpGroup(apGroup),
 	mNextRunTime(arInitialTime),
 	M_INITIAL_TIME(arInitialTime),
-	mFlags(0)
+	mFlags(0),
+	mDispatchSeq(0),
+	mDispatchTime(arInitialTime)
 {
 
 }
@@ -116,6 +118,17 @@ void AsyncTaskBase::OnComplete(bool aSuccess)
 	mpGroup->OnCompletion();
 }
 
+void AsyncTaskBase::OnPreempted()
+{
+	if(!mIsRunning) {
+		throw InvalidStateException(LOCATION, "Not Running");
+	}
+	mIsRunning = false;
+
+	// the next run time is left alone, so the task is still due
+	mpGroup->OnCompletion();
+}
+
 void AsyncTaskBase::Reset()
 {
 	mIsComplete = mIsExpired = mIsRunning = false;
@@ -143,8 +156,12 @@ bool AsyncTaskBase::LessThan(const AsyncTaskBase* l, const AsyncTaskBase* r)
 	if(!r->IsEnabled() && l->IsEnabled()) return false;
 
 	if(l->IsExpired()) {
-		if(r->IsExpired()) { //if they're both expired, resolve using priority
-			return l->Priority() < r->Priority();
+		if(r->IsExpired()) {
+			// if they're both expired, resolve using priority, then the earliest
+			// due time, then whichever was dispatched least recently (round-robin)
+			if(l->Priority() != r->Priority()) return l->Priority() < r->Priority();
+			if(l->NextRunTime() != r->NextRunTime()) return l->NextRunTime() > r->NextRunTime();
+			return l->mDispatchSeq > r->mDispatchSeq;
 		} else {
 			return false; // left expired but right is not
 		}
@@ -48,6 +48,7 @@ public:
 
 	// Implements ITaskCompletion
 	void OnComplete(bool aSuccess);
+	void OnPreempted();
 
 	// Modify this task's depth to make it dependent on the argument
 	void AddDependency(const AsyncTaskBase* apTask);
@@ -145,6 +146,9 @@ protected:
 	boost::posix_time::ptime mNextRunTime;	// next execution time for the task
 	const boost::posix_time::ptime M_INITIAL_TIME;
 	int mFlags;
+	size_t mDispatchSeq;					// group sequence number of the last
+	// dispatch, 0 if never dispatched
+	boost::posix_time::ptime mDispatchTime;	// time of the last dispatch
 };
 
 }
@@ -35,12 +35,34 @@ using namespace boost::posix_time;
 namespace apl
 {
 
+TaskGroupStatistics::TaskGroupStatistics() :
+	NumDispatched(0),
+	NumScheduled(0),
+	Elapsed(0),
+	Busy(0),
+	TotalLatency(0),
+	MaxLatency(0)
+{}
+
+double TaskGroupStatistics::GetUtilization() const
+{
+	return (Elapsed > 0) ? static_cast<double>(Busy) / Elapsed : 0.0;
+}
+
+double TaskGroupStatistics::GetMeanLatency() const
+{
+	return (NumScheduled > 0) ? static_cast<double>(TotalLatency) / NumScheduled : 0.0;
+}
+
 AsyncTaskGroup::AsyncTaskGroup(ITimerSource* apTimerSrc, ITimeSource* apTimeSrc) :
 	mIsRunning(false),
 	mShutdown(false),
 	mpTimerSrc(apTimerSrc),
 	mpTimeSrc(apTimeSrc),
-	mpTimer(NULL)
+	mpTimer(NULL),
+	mDispatchSeq(0),
+	mDispatchTime(min_date_time),
+	mStatisticsStart(apTimeSrc->GetUTC())
 {
 
 }
@@ -159,6 +181,7 @@ void AsyncTaskGroup::CheckState()
 
 		if(pTask->NextRunTime() <= now) {
 			mIsRunning = true;
+			this->RecordDispatch(pTask, now);
 			pTask->Dispatch();
 		} else {
 			this->RestartTimer(pTask->NextRunTime());
@@ -170,6 +193,7 @@ void AsyncTaskGroup::OnCompletion()
 {
 	if(!mIsRunning) throw InvalidStateException(LOCATION, "Not running");
 	mIsRunning = false;
+	mStatistics.Busy += (GetUTC() - mDispatchTime).total_milliseconds();
 	this->CheckState();
 }
 
@@ -178,6 +202,39 @@ boost::posix_time::ptime AsyncTaskGroup::GetUTC() const
 	return mpTimeSrc->GetUTC();
 }
 
+TaskGroupStatistics AsyncTaskGroup::GetStatistics() const
+{
+	ptime now = GetUTC();
+	TaskGroupStatistics stats = mStatistics;
+	stats.Elapsed = (now - mStatisticsStart).total_milliseconds();
+	if(mIsRunning) stats.Busy += (now - mDispatchTime).total_milliseconds();
+	return stats;
+}
+
+void AsyncTaskGroup::ResetStatistics()
+{
+	mStatistics = TaskGroupStatistics();
+	mStatisticsStart = GetUTC();
+	if(mIsRunning) mDispatchTime = mStatisticsStart;
+}
+
+void AsyncTaskGroup::RecordDispatch(AsyncTaskBase* apTask, const boost::posix_time::ptime& arTime)
+{
+	apTask->mDispatchSeq = ++mDispatchSeq;
+	apTask->mDispatchTime = arTime;
+	mDispatchTime = arTime;
+
+	++mStatistics.NumDispatched;
+
+	// tasks that have never run or run continuously have no due time to be late for
+	if(apTask->NextRunTime() != min_date_time) {
+		millis_t latency = (arTime - apTask->NextRunTime()).total_milliseconds();
+		++mStatistics.NumScheduled;
+		mStatistics.TotalLatency += latency;
+		if(latency > mStatistics.MaxLatency) mStatistics.MaxLatency = latency;
+	}
+}
+
 void AsyncTaskGroup::Update(const boost::posix_time::ptime& arTime)
 {
 	BOOST_FOREACH(AsyncTaskBase * p, mTaskVec) {
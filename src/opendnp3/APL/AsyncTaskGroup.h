@@ -40,8 +40,36 @@ class ITimerSource;
 class ITimeSource;
 class ITimer;
 
+/**
+ Running statistics for a task group. When the group belongs to a channel,
+ every task shares one line, so these describe how well the line is used.
+*/
+struct TaskGroupStatistics {
+
+	TaskGroupStatistics();
+
+	/// @return fraction of the elapsed time during which a task was running
+	double GetUtilization() const;
+
+	/// @return mean delay between a task becoming due and being dispatched
+	double GetMeanLatency() const;
+
+	size_t NumDispatched;	// tasks dispatched since the statistics were reset
+	size_t NumScheduled;	// dispatched tasks that had a due time, i.e. count towards latency
+	millis_t Elapsed;		// time since the statistics were reset
+	millis_t Busy;			// time spent with a task running
+	millis_t TotalLatency;	// sum of the latencies of the scheduled tasks
+	millis_t MaxLatency;	// worst latency of a scheduled task
+};
+
 /**
  A collection of related tasks with optional dependencies
+
+ Only one task in a group runs at a time. Expired tasks are dispatched in order
+ of priority, then earliest due time, then least recently dispatched, so tasks
+ of equal priority (e.g. the scans of many masters on one multi-drop channel)
+ are served deadline first and round-robin rather than in the order they were
+ added.
 */
 class AsyncTaskGroup : private Uncopyable
 {
@@ -75,6 +103,9 @@ public:
 
 	boost::posix_time::ptime GetUTC() const;
 
+	TaskGroupStatistics GetStatistics() const;
+	void ResetStatistics();
+
 private:
 
 	void OnCompletion();
@@ -82,6 +113,7 @@ private:
 	void OnTimerExpiration();
 	void Update(const boost::posix_time::ptime& arTime);
 	AsyncTaskBase* GetNext(const boost::posix_time::ptime& arTime);
+	void RecordDispatch(AsyncTaskBase* apTask, const boost::posix_time::ptime& arTime);
 
 	bool mIsRunning;
 	bool mShutdown;
@@ -89,6 +121,11 @@ private:
 	ITimeSource* mpTimeSrc;
 	ITimer* mpTimer;
 
+	size_t mDispatchSeq;						// incremented for every dispatch, used for round-robin
+	boost::posix_time::ptime mDispatchTime;		// when the running task was dispatched
+	boost::posix_time::ptime mStatisticsStart;
+	TaskGroupStatistics mStatistics;
+
 	AsyncTaskGroup(ITimerSource*, ITimeSource*);
 
 	typedef std::vector< AsyncTaskBase* > TaskVec;
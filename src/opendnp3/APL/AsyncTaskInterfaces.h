@@ -30,6 +30,9 @@ public:
 
 	virtual void OnComplete(bool aSuccess) = 0;
 
+	// Stop the running task without completing it, so it runs again as soon as nothing more important is due
+	virtual void OnPreempted() = 0;
+
 	// Enable the task and notify the task group which might execute another task
 	virtual void Enable() = 0;
 
@@ -33,12 +33,22 @@ AsyncTaskPeriodic::AsyncTaskPeriodic(millis_t aPeriod, millis_t aRetryDelay, int
 
 }
 
+void AsyncTaskPeriodic::SetPeriod(millis_t aPeriod)
+{
+	mPeriod = aPeriod;
+	if(mIsComplete) mNextRunTime = mDispatchTime + milliseconds(mPeriod);
+}
+
 void AsyncTaskPeriodic::_OnComplete(bool aSuccess)
 {
 	ptime now = mpGroup->GetUTC();
 	if(aSuccess) {
 		mIsComplete = true;
-		mNextRunTime = now + milliseconds(mPeriod);
+		// measure the period from the start of the task so that the rate holds
+		// regardless of how long the task occupied the group, unless the task
+		// overran a whole period (or the clock jumped) and would run back-to-back
+		mNextRunTime = mDispatchTime + milliseconds(mPeriod);
+		if(mNextRunTime <= now) mNextRunTime = now + milliseconds(mPeriod);
 	} else {
 		mNextRunTime = now + milliseconds(mRetryDelay);
 	}
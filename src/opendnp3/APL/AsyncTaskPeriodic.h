@@ -46,6 +46,17 @@ public:
 
 	virtual ~AsyncTaskPeriodic() {}
 
+	millis_t GetPeriod() const {
+		return mPeriod;
+	}
+
+	/**
+		Changes the period. If the task has completed a run, its next run is
+		rescheduled a new period after that run was dispatched, which may be
+		immediately. The group must be checked afterwards for that to apply.
+	*/
+	void SetPeriod(millis_t aPeriod);
+
 private:
 
 	// Implements ITaskCompletion
@@ -0,0 +1,137 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ATOMIC_OPS_H_
+#define __ATOMIC_OPS_H_
+
+#include "Configure.h"
+
+#include <boost/cstdint.hpp>
+
+#ifdef APL_PLATFORM_WIN
+#include <intrin.h>
+#endif
+
+namespace apl
+{
+
+/**
+	Relaxed (unordered) atomic operations on 64-bit integers. They are
+	only suitable for statistics, where no other memory depends on the value.
+*/
+typedef volatile boost::int64_t atomic_int64_t;
+
+inline void AtomicAddRelaxed(atomic_int64_t* apValue, boost::int64_t aDelta)
+{
+#if defined(APL_PLATFORM_WIN)
+	_InterlockedExchangeAdd64(apValue, aDelta);
+#elif defined(__ATOMIC_RELAXED)
+	__atomic_fetch_add(apValue, aDelta, __ATOMIC_RELAXED);
+#else
+	__sync_fetch_and_add(apValue, aDelta);
+#endif
+}
+
+inline boost::int64_t AtomicLoadRelaxed(const atomic_int64_t* apValue)
+{
+#if defined(APL_PLATFORM_WIN)
+	return _InterlockedCompareExchange64(const_cast<atomic_int64_t*>(apValue), 0, 0);
+#elif defined(__ATOMIC_RELAXED)
+	return __atomic_load_n(apValue, __ATOMIC_RELAXED);
+#else
+	return __sync_fetch_and_add(const_cast<atomic_int64_t*>(apValue), 0);
+#endif
+}
+
+inline void AtomicStoreRelaxed(atomic_int64_t* apValue, boost::int64_t aValue)
+{
+#if defined(APL_PLATFORM_WIN)
+	_InterlockedExchange64(apValue, aValue);
+#elif defined(__ATOMIC_RELAXED)
+	__atomic_store_n(apValue, aValue, __ATOMIC_RELAXED);
+#else
+	__sync_lock_test_and_set(apValue, aValue);
+#endif
+}
+
+/**
+	Acquire/release operations for publishing plain memory to other threads,
+	or to other processes through shared memory.
+*/
+inline boost::int64_t AtomicLoadAcquire(const atomic_int64_t* apValue)
+{
+#if defined(APL_PLATFORM_WIN)
+	return _InterlockedCompareExchange64(const_cast<atomic_int64_t*>(apValue), 0, 0);
+#elif defined(__ATOMIC_ACQUIRE)
+	return __atomic_load_n(apValue, __ATOMIC_ACQUIRE);
+#else
+	return __sync_fetch_and_add(const_cast<atomic_int64_t*>(apValue), 0);
+#endif
+}
+
+inline void AtomicStoreRelease(atomic_int64_t* apValue, boost::int64_t aValue)
+{
+#if defined(APL_PLATFORM_WIN)
+	_InterlockedExchange64(apValue, aValue);
+#elif defined(__ATOMIC_RELEASE)
+	__atomic_store_n(apValue, aValue, __ATOMIC_RELEASE);
+#else
+	__sync_synchronize();
+	*apValue = aValue;
+#endif
+}
+
+/// Orders earlier loads before any later load or store
+inline void AtomicFenceAcquire()
+{
+#if defined(APL_PLATFORM_WIN)
+	_ReadWriteBarrier();
+#elif defined(__ATOMIC_ACQUIRE)
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+#else
+	__sync_synchronize();
+#endif
+}
+
+/// Orders earlier loads and stores before any later store
+inline void AtomicFenceRelease()
+{
+#if defined(APL_PLATFORM_WIN)
+	_ReadWriteBarrier();
+#elif defined(__ATOMIC_RELEASE)
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+	__sync_synchronize();
+#endif
+}
+
+/// Orders earlier stores before later loads, which acquire and release don't
+inline void AtomicFenceFull()
+{
+#if defined(APL_PLATFORM_WIN)
+	_mm_mfence();
+#elif defined(__ATOMIC_SEQ_CST)
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+	__sync_synchronize();
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "BufferPool.h"
+
+namespace apl
+{
+
+BufferPool::BufferPool() :
+	mNumBorrowed(0),
+	mNumBytesAllocated(0)
+{
+
+}
+
+void BufferPool::Acquire(CopyableBuffer& arBuffer, size_t aSize)
+{
+	if(arBuffer.Size() > 0) return;
+
+	FreeList& list = mFree[aSize];
+	if(list.empty()) {
+		CopyableBuffer fresh(aSize);
+		arBuffer.Swap(fresh);
+		mNumBytesAllocated += aSize;
+	} else {
+		arBuffer.Swap(list.back());
+		list.pop_back();
+	}
+
+	++mNumBorrowed;
+}
+
+void BufferPool::Release(CopyableBuffer& arBuffer)
+{
+	if(arBuffer.Size() == 0) return;
+
+	FreeList& list = mFree[arBuffer.Size()];
+	list.push_back(CopyableBuffer());
+	list.back().Swap(arBuffer);
+
+	--mNumBorrowed;
+}
+
+size_t BufferPool::NumFree() const
+{
+	size_t num = 0;
+	for(FreeMap::const_iterator i = mFree.begin(); i != mFree.end(); ++i) num += i->second.size();
+	return num;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,79 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __BUFFER_POOL_H_
+#define __BUFFER_POOL_H_
+
+#include "CopyableBuffer.h"
+
+#include <deque>
+#include <map>
+
+namespace apl
+{
+
+/**
+	Free lists of CopyableBuffer storage keyed by size. Layers that only
+	need a buffer while a transaction is in flight borrow it with Acquire()
+	and hand it back with Release(), so that thousands of idle stacks
+	don't each hold their own fragment sized buffers.
+
+	The pool isn't thread safe. It's owned by an io_service thread and must
+	only be used from that thread, or while the thread is paused.
+*/
+class BufferPool
+{
+public:
+
+	BufferPool();
+
+	/**
+		Gives arBuffer storage of aSize bytes, reusing a released buffer if
+		there is one. Does nothing if arBuffer already holds storage.
+	*/
+	void Acquire(CopyableBuffer& arBuffer, size_t aSize);
+
+	/// Takes the storage back from arBuffer, leaving it empty. Does nothing if arBuffer is empty.
+	void Release(CopyableBuffer& arBuffer);
+
+	/// @return number of buffers waiting in the free lists
+	size_t NumFree() const;
+
+	/// @return number of buffers currently acquired and not released
+	size_t NumBorrowed() const {
+		return mNumBorrowed;
+	}
+
+	/// @return total bytes allocated by the pool, whether free or borrowed
+	size_t NumBytesAllocated() const {
+		return mNumBytesAllocated;
+	}
+
+private:
+
+	typedef std::deque<CopyableBuffer> FreeList;
+	typedef std::map<size_t, FreeList> FreeMap;
+
+	FreeMap mFree;
+	size_t mNumBorrowed;
+	size_t mNumBytesAllocated;
+};
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "CaptureFile.h"
+
+#include "Exception.h"
+#include "LatencyTrace.h"
+#include "PackingUnpacking.h"
+
+#include <cstring>
+
+namespace apl
+{
+
+const char CaptureFile::MAGIC[8] = { 'D', 'N', 'P', '3', 'C', 'A', 'P', '1' };
+
+CaptureWriter::CaptureWriter(const std::string& arPath) :
+	mPath(arPath),
+	mFile(arPath.c_str(), std::ios::out | std::ios::trunc | std::ios::binary),
+	mStart(LatencyTrace::Now()),
+	mNumRecords(0)
+{
+	if(!mFile) throw Exception(LOCATION, "Unable to create capture file: " + arPath);
+	mFile.write(CaptureFile::MAGIC, sizeof(CaptureFile::MAGIC));
+}
+
+CaptureWriter::~CaptureWriter()
+{
+	mFile.close();
+}
+
+void CaptureWriter::Record(CaptureDirection aDirection, const boost::uint8_t* apData, size_t aLength)
+{
+	boost::int64_t time = LatencyTrace::Now() - mStart;
+
+	do {
+		size_t num = aLength;
+		if(num > CaptureFile::MAX_RECORD_DATA) num = CaptureFile::MAX_RECORD_DATA;
+
+		boost::uint8_t header[CaptureFile::HEADER_SIZE];
+		header[0] = static_cast<boost::uint8_t>(aDirection);
+		UInt48LE::Write(header + 1, time);
+		UInt16LE::Write(header + 1 + UInt48LE::Size, static_cast<boost::uint16_t>(num));
+
+		mFile.write(reinterpret_cast<const char*>(header), CaptureFile::HEADER_SIZE);
+		mFile.write(reinterpret_cast<const char*>(apData), num);
+		++mNumRecords;
+
+		apData += num;
+		aLength -= num;
+	} while(aLength > 0);
+}
+
+void CaptureWriter::Flush()
+{
+	mFile.flush();
+}
+
+CaptureReader::CaptureReader(const std::string& arPath) :
+	mPath(arPath),
+	mFile(arPath.c_str(), std::ios::in | std::ios::binary)
+{
+	if(!mFile) throw Exception(LOCATION, "Unable to open capture file: " + arPath);
+
+	char magic[sizeof(CaptureFile::MAGIC)];
+	mFile.read(magic, sizeof(magic));
+	if(mFile.gcount() != sizeof(magic) || memcmp(magic, CaptureFile::MAGIC, sizeof(magic)) != 0) {
+		throw Exception(LOCATION, "Not a capture file: " + arPath);
+	}
+}
+
+bool CaptureReader::Next(CaptureRecord& arRecord)
+{
+	boost::uint8_t header[CaptureFile::HEADER_SIZE];
+	mFile.read(reinterpret_cast<char*>(header), CaptureFile::HEADER_SIZE);
+	if(mFile.gcount() == 0) return false;
+	if(static_cast<size_t>(mFile.gcount()) != CaptureFile::HEADER_SIZE) throw Exception(LOCATION, "Truncated record header in: " + mPath);
+
+	if(header[0] != CD_READ && header[0] != CD_WRITE) throw Exception(LOCATION, "Bad record direction in: " + mPath);
+
+	arRecord.direction = static_cast<CaptureDirection>(header[0]);
+	arRecord.time = UInt48LE::Read(header + 1);
+	size_t length = UInt16LE::Read(header + 1 + UInt48LE::Size);
+
+	arRecord.data = CopyableBuffer(length);
+	mFile.read(reinterpret_cast<char*>(static_cast<boost::uint8_t*>(arRecord.data)), length);
+	if(static_cast<size_t>(mFile.gcount()) != length) throw Exception(LOCATION, "Truncated record data in: " + mPath);
+
+	return true;
+}
+
+}
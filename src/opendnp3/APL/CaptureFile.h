@@ -0,0 +1,115 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __CAPTURE_FILE_H_
+#define __CAPTURE_FILE_H_
+
+#include "Types.h"
+#include "CopyableBuffer.h"
+#include "Uncopyable.h"
+
+#include <fstream>
+#include <string>
+
+namespace apl
+{
+
+/// Direction of the bytes in a capture record, relative to the capturing physical layer
+enum CaptureDirection {
+	CD_READ = 'R',
+	CD_WRITE = 'W'
+};
+
+struct CaptureRecord {
+	CaptureRecord() : direction(CD_READ), time(0)
+	{}
+
+	CaptureDirection direction;
+	boost::int64_t time;		// microseconds since the capture started
+	CopyableBuffer data;
+};
+
+/**
+	The capture format is the 8 byte magic "DNP3CAP1" followed by records of
+
+	direction (1 byte) | time in us since the start (UInt48LE) | length (UInt16LE) | data
+
+	Reads or writes larger than 65535 bytes are split into several records
+	with the same timestamp.
+*/
+class CaptureFile
+{
+public:
+	static const char MAGIC[8];
+	static const size_t HEADER_SIZE = 9;
+	static const size_t MAX_RECORD_DATA = 65535;
+};
+
+/**
+	Appends the byte streams of a physical layer to a capture file. Not
+	thread safe, a physical layer only records from its io_service callbacks.
+*/
+class CaptureWriter : private Uncopyable
+{
+public:
+
+	/// @throw Exception if the file can't be created
+	CaptureWriter(const std::string& arPath);
+	~CaptureWriter();
+
+	void Record(CaptureDirection aDirection, const boost::uint8_t* apData, size_t aLength);
+
+	size_t NumRecords() const {
+		return mNumRecords;
+	}
+
+	/// Flushes buffered records to the file
+	void Flush();
+
+private:
+	std::string mPath;
+	std::ofstream mFile;
+	boost::int64_t mStart;
+	size_t mNumRecords;
+};
+
+/**
+	Reads back the records of a capture file in order
+*/
+class CaptureReader : private Uncopyable
+{
+public:
+
+	/// @throw Exception if the file can't be opened or isn't a capture
+	CaptureReader(const std::string& arPath);
+
+	/**
+		@param arRecord Receives the next record
+		@return false at the end of the capture
+		@throw Exception if the capture is truncated
+	*/
+	bool Next(CaptureRecord& arRecord);
+
+private:
+	std::string mPath;
+	std::ifstream mFile;
+};
+
+}
+
+#endif
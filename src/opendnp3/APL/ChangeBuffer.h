@@ -23,9 +23,9 @@
 #include "DataInterfaces.h"
 #include "TimingTools.h"
 #include "INotifier.h"
+#include "LatencyTrace.h"
 #include "SubjectBase.h"
-
-#include <queue>
+#include "RingQueue.h"
 
 namespace apl
 {
@@ -36,15 +36,15 @@ template <class LockType>
 class ChangeBuffer : public IDataObserver, public SubjectBase<NullLock>
 {
 
-	typedef std::deque< Change<Binary> > BinaryQueue;
-	typedef std::deque< Change<Analog> > AnalogQueue;
-	typedef std::deque< Change<Counter> > CounterQueue;
-	typedef std::deque< Change<ControlStatus> > ControlStatusQueue;
-	typedef std::deque< Change<SetpointStatus> > SetpointStatusQueue;
+	typedef RingQueue< Change<Binary> > BinaryQueue;
+	typedef RingQueue< Change<Analog> > AnalogQueue;
+	typedef RingQueue< Change<Counter> > CounterQueue;
+	typedef RingQueue< Change<ControlStatus> > ControlStatusQueue;
+	typedef RingQueue< Change<SetpointStatus> > SetpointStatusQueue;
 
 public:
 
-	ChangeBuffer() : mMidFlush(false) {}
+	ChangeBuffer() : mMidFlush(false), mTraceStart(0) {}
 
 	void _Start() {
 		mLock.Lock();
@@ -57,24 +57,27 @@ public:
 		}
 
 		bool notify = this->HasChanges();
+		if(notify && mTraceStart == 0 && LatencyTrace::IsEnabled() && LatencyTrace::Sample()) {
+			mTraceStart = LatencyTrace::Now();
+		}
 		mLock.Unlock();
 		if(notify) this->NotifyAll();
 	}
 
 	void _Update(const Binary& arPoint, size_t aIndex) {
-		mBinaryQueue.push_back(Change<Binary>(arPoint, aIndex));
+		this->Push(mBinaryQueue, arPoint, aIndex);
 	}
 	void _Update(const Analog& arPoint, size_t aIndex) {
-		mAnalogQueue.push_back(Change<Analog>(arPoint, aIndex));
+		this->Push(mAnalogQueue, arPoint, aIndex);
 	}
 	void _Update(const Counter& arPoint, size_t aIndex) {
-		mCounterQueue.push_back(Change<Counter>(arPoint, aIndex));
+		this->Push(mCounterQueue, arPoint, aIndex);
 	}
 	void _Update(const ControlStatus& arPoint, size_t aIndex) {
-		mControlStatusQueue.push_back(Change<ControlStatus>(arPoint, aIndex));
+		this->Push(mControlStatusQueue, arPoint, aIndex);
 	}
 	void _Update(const SetpointStatus& arPoint, size_t aIndex) {
-		mSetpointStatusQueue.push_back(Change<SetpointStatus>(arPoint, aIndex));
+		this->Push(mSetpointStatusQueue, arPoint, aIndex);
 	}
 
 
@@ -85,28 +88,50 @@ public:
 		_Clear();
 	}
 
+	/**
+		@return LatencyTrace::Now() of the oldest change waiting to be
+		flushed if it was sampled for tracing, otherwise 0. Call before
+		FlushUpdates(), which forgets the time.
+	*/
+	boost::int64_t GetTraceStart() {
+		mLock.Lock();
+		boost::int64_t ret = mTraceStart;
+		mLock.Unlock();
+		return ret;
+	}
+
 private:
 
 	void _Clear() {
-		mBinaryQueue.clear();
-		mAnalogQueue.clear();
-		mCounterQueue.clear();
-		mControlStatusQueue.clear();
-		mSetpointStatusQueue.clear();
+		mTraceStart = 0;
+		mBinaryQueue.Clear();
+		mAnalogQueue.Clear();
+		mCounterQueue.Clear();
+		mControlStatusQueue.Clear();
+		mSetpointStatusQueue.Clear();
 	}
 
 	bool HasChanges() {
-		return mBinaryQueue.size() > 0 ||
-		       mAnalogQueue.size() > 0 ||
-		       mCounterQueue.size() > 0 ||
-		       mControlStatusQueue.size() > 0 ||
-		       mSetpointStatusQueue.size() > 0;
+		return mBinaryQueue.Size() > 0 ||
+		       mAnalogQueue.Size() > 0 ||
+		       mCounterQueue.Size() > 0 ||
+		       mControlStatusQueue.Size() > 0 ||
+		       mSetpointStatusQueue.Size() > 0;
+	}
+
+	// fills the queue's recycled tail slot rather than copying in a temporary Change<T>
+	template<class T>
+	static void Push(RingQueue< Change<T> >& arQueue, const T& arPoint, size_t aIndex) {
+		Change<T>& change = arQueue.Push();
+		change.mValue = arPoint;
+		change.mIndex = aIndex;
 	}
 
 	template<class T>
 	size_t FlushUpdates(const T& arContainer, IDataObserver* apObserver);
 
 	bool mMidFlush;
+	boost::int64_t mTraceStart;
 	BinaryQueue mBinaryQueue;
 	AnalogQueue mAnalogQueue;
 	CounterQueue mCounterQueue;
@@ -143,10 +168,9 @@ template <class LockType>
 template <class T>
 size_t ChangeBuffer<LockType>::FlushUpdates(const T& arContainer, IDataObserver* apObserver)
 {
-	size_t count = 0;
-	for(typename T::const_iterator i = arContainer.begin(); i != arContainer.end(); ++i) {
-		apObserver->Update(i->mValue, i->mIndex);
-		++count;
+	size_t count = arContainer.Size();
+	for(size_t i = 0; i < count; ++i) {
+		apObserver->Update(arContainer[i].mValue, arContainer[i].mIndex);
 	}
 	return count;
 }
@@ -26,30 +26,35 @@ namespace apl
 apl::CommandTypes CommandQueue::Next()
 {
 	CriticalSection cs(&mLock);
-	if(mTypeQueue.size() > 0) {
-		return mTypeQueue.front().mType;
+	if(mTypeQueue.Size() > 0) {
+		return mTypeQueue.Front().mType;
 	} else return CT_NONE;
 }
 
 template < typename T >
-void CommandQueue::Read(T& arType, CommandData& arData, std::queue<T>& arQueue)
+void CommandQueue::Read(T& arType, CommandData& arData, RingQueue<T>& arQueue)
 {
 	apl::CriticalSection cs(&mLock);
-	assert(mTypeQueue.front().mType == arType.GetType());
-	assert(arQueue.size() > 0);
-	arType = arQueue.front();
-	arData = mTypeQueue.front();
-	arQueue.pop();
-	mTypeQueue.pop();
+	assert(mTypeQueue.Front().mType == arType.GetType());
+	assert(arQueue.Size() > 0);
+	arType = arQueue.Front();
+	arData = mTypeQueue.Front();
+	arQueue.Pop();
+	mTypeQueue.Pop();
 }
 
 template <typename T>
-void CommandQueue::AcceptCommand(const T& arType, size_t aIndex, std::queue<T>& arQueue, int aSequence, IResponseAcceptor* apRspAcceptor)
+void CommandQueue::AcceptCommand(const T& arType, size_t aIndex, RingQueue<T>& arQueue, int aSequence, IResponseAcceptor* apRspAcceptor)
 {
 	{
 		apl::CriticalSection cs(&mLock);
-		arQueue.push(arType);
-		mTypeQueue.push(CommandData(arType.GetType(), aIndex, aSequence, apRspAcceptor));
+		arQueue.Push(arType);
+		CommandData& data = mTypeQueue.Push();
+		data.mType = arType.GetType();
+		data.mIndex = aIndex;
+		data.mSequence = aSequence;
+		data.mpRspAcceptor = apRspAcceptor;
+		data.mQueued = mpTimeSrc->GetUTC();
 	}
 	if(mpNotifier != NULL) mpNotifier->Notify();
 }
@@ -108,7 +113,7 @@ void CommandQueue::SetNotifier(INotifier* apNotifier)
 size_t CommandQueue::Size()
 {
 	CriticalSection cs(&mLock);
-	return mTypeQueue.size();
+	return mTypeQueue.Size();
 }
 
 void CommandQueue::Read(apl::BinaryOutput& arType, CommandData& arData)
@@ -23,7 +23,8 @@
 #include "INotifier.h"
 #include "CommandInterfaces.h"
 #include "Lock.h"
-#include <queue>
+#include "RingQueue.h"
+#include "TimeSource.h"
 
 namespace apl
 {
@@ -37,12 +38,13 @@ struct CommandData {
 	size_t mIndex;
 	int mSequence;
 	IResponseAcceptor* mpRspAcceptor;
+	boost::posix_time::ptime mQueued;	// when the command was accepted
 };
 
 class CommandQueue : public ICommandAcceptor, public ICommandSource
 {
 public:
-	CommandQueue() : mpNotifier(NULL) {}
+	CommandQueue(ITimeSource* apTimeSrc = TimeSource::Inst()) : mpNotifier(NULL), mpTimeSrc(apTimeSrc) {}
 
 	//Implement the ICommandAcceptor interface
 	void AcceptCommand(const apl::BinaryOutput& arType, size_t aIndex, int aSequence, IResponseAcceptor* apRspAcceptor);
@@ -70,17 +72,18 @@ public:
 protected:
 	apl::SigLock mLock;
 	apl::INotifier* mpNotifier;
+	ITimeSource* mpTimeSrc;
 
-	std::queue< apl::BinaryOutput > mBinaryQueue;
-	std::queue< apl::Setpoint > mSetpointQueue;
+	RingQueue< apl::BinaryOutput > mBinaryQueue;
+	RingQueue< apl::Setpoint > mSetpointQueue;
 
-	std::queue< CommandData > mTypeQueue;
+	RingQueue< CommandData > mTypeQueue;
 
 	template <typename T>
-	void Read(T& arType, CommandData& arData, std::queue<T>& arQueue);
+	void Read(T& arType, CommandData& arData, RingQueue<T>& arQueue);
 
 	template <typename T>
-	void AcceptCommand(const T& arType, size_t aIndex, std::queue<T>& arQueue, int aSequence, IResponseAcceptor* apRspAcceptor);
+	void AcceptCommand(const T& arType, size_t aIndex, RingQueue<T>& arQueue, int aSequence, IResponseAcceptor* apRspAcceptor);
 };
 
 }
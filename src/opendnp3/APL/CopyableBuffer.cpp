@@ -19,6 +19,7 @@
 #include "CopyableBuffer.h"
 
 #include <memory.h>
+#include <algorithm>
 
 #include "ToHex.h"
 
@@ -64,6 +65,12 @@ void CopyableBuffer::Zero()
 	memset(mpBuff, 0, mSize);
 }
 
+void CopyableBuffer::Swap(CopyableBuffer& arOther)
+{
+	std::swap(mpBuff, arOther.mpBuff);
+	std::swap(mSize, arOther.mSize);
+}
+
 CopyableBuffer& CopyableBuffer::operator=(const CopyableBuffer& arRHS)
 {
 	//check for assignment to self
@@ -71,7 +78,7 @@ CopyableBuffer& CopyableBuffer::operator=(const CopyableBuffer& arRHS)
 
 	if(arRHS.Size() != mSize) {
 		mSize = arRHS.Size();
-		delete mpBuff;
+		delete [] mpBuff;
 		mpBuff = new boost::uint8_t[mSize];
 	}
 
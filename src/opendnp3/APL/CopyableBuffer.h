@@ -69,6 +69,9 @@ public:
 	}
 	void Zero();
 
+	/// Exchanges storage with another buffer without copying
+	void Swap(CopyableBuffer& arOther);
+
 protected:
 	boost::uint8_t* mpBuff;
 
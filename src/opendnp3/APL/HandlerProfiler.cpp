@@ -0,0 +1,172 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "HandlerProfiler.h"
+
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+#ifdef APL_PLATFORM_WIN
+#include <windows.h>
+#define APL_THREAD_LOCAL __declspec(thread)
+#else
+#include <time.h>
+#define APL_THREAD_LOCAL __thread
+#endif
+
+namespace apl
+{
+
+namespace
+{
+
+struct ProfileContext {
+	const HandlerProfile* pProfile;	// NULL outside any scope
+	boost::int64_t start;			// when the owner was last charged up to, 0 if it isn't being timed
+};
+
+APL_THREAD_LOCAL ProfileContext tContext;
+
+bool MoreTime(const HandlerUsage& arLeft, const HandlerUsage& arRight)
+{
+	return arLeft.nanos > arRight.nanos;
+}
+
+}
+
+HandlerProfile::HandlerProfile(Logger* apLogger) :
+	mpTime(apLogger->GetCounter("handler_time_ns", "Nanoseconds the io_service thread spent running handlers for this owner")),
+	mpCalls(apLogger->GetCounter("handler_calls", "Number of handlers run for this owner while profiling was on"))
+{}
+
+atomic_int64_t HandlerProfiler::msEnabled = 0;
+
+void HandlerProfiler::SetEnabled(bool aEnabled)
+{
+	AtomicStoreRelaxed(&msEnabled, aEnabled ? 1 : 0);
+}
+
+HandlerProfile HandlerProfiler::Current()
+{
+	return (tContext.pProfile == NULL) ? HandlerProfile() : *tContext.pProfile;
+}
+
+FunctionVoidZero HandlerProfiler::Bind(const FunctionVoidZero& arHandler)
+{
+	if(tContext.pProfile == NULL) return arHandler;
+	return boost::bind(&HandlerProfiler::Run, *tContext.pProfile, arHandler);
+}
+
+void HandlerProfiler::Run(const HandlerProfile& arProfile, const FunctionVoidZero& arHandler)
+{
+	ProfileScope scope(arProfile);
+	arHandler();
+}
+
+boost::int64_t HandlerProfiler::Now()
+{
+#ifdef APL_PLATFORM_WIN
+	LARGE_INTEGER count, freq;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&freq);
+	return (count.QuadPart / freq.QuadPart) * 1000000000 + ((count.QuadPart % freq.QuadPart) * 1000000000) / freq.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<boost::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void HandlerProfiler::GetTop(const MetricsRegistry& arRegistry, size_t aCount, std::vector<HandlerUsage>& arUsage)
+{
+	std::vector<MetricSample> samples;
+	arRegistry.Snapshot(samples);
+
+	std::map<std::string, HandlerUsage> owners;
+	for(std::vector<MetricSample>::iterator s = samples.begin(); s != samples.end(); ++s) {
+		if(s->name == "handler_time_ns") owners[s->source].nanos = s->value;
+		else if(s->name == "handler_calls") owners[s->source].calls = s->value;
+	}
+
+	std::vector<HandlerUsage> usage;
+	for(std::map<std::string, HandlerUsage>::iterator i = owners.begin(); i != owners.end(); ++i) {
+		if(i->second.calls == 0) continue;
+		i->second.owner = i->first;
+		usage.push_back(i->second);
+	}
+
+	std::stable_sort(usage.begin(), usage.end(), MoreTime);
+	if(usage.size() > aCount) usage.resize(aCount);
+	arUsage.insert(arUsage.end(), usage.begin(), usage.end());
+}
+
+void HandlerProfiler::WriteReport(const MetricsRegistry& arRegistry, size_t aCount, std::ostream& arStream)
+{
+	std::vector<HandlerUsage> all;
+	GetTop(arRegistry, static_cast<size_t>(-1), all);
+
+	boost::int64_t total = 0;
+	for(size_t i = 0; i < all.size(); ++i) total += all[i].nanos;
+
+	arStream << std::left << std::setw(20) << "owner" << std::right;
+	arStream << std::setw(12) << "time ms" << std::setw(8) << "share" << std::setw(12) << "calls" << std::setw(10) << "us/call" << "\r\n";
+
+	for(size_t i = 0; i < all.size() && i < aCount; ++i) {
+		const HandlerUsage& u = all[i];
+		arStream << std::left << std::setw(20) << u.owner << std::right;
+		arStream << std::setw(12) << u.nanos / 1000000;
+		arStream << std::setw(7) << (total > 0 ? (100 * u.nanos) / total : 0) << "%";
+		arStream << std::setw(12) << u.calls << std::setw(10) << u.nanos / (1000 * u.calls) << "\r\n";
+	}
+}
+
+ProfileScope::ProfileScope(const HandlerProfile& arProfile) :
+	mProfile(arProfile),
+	mpPrevious(tContext.pProfile),
+	mPreviousStart(tContext.start)
+{
+	if(!mProfile.HasOwner()) return;
+
+	boost::int64_t now = HandlerProfiler::IsEnabled() ? HandlerProfiler::Now() : 0;
+	if(now != 0) {
+		if(mPreviousStart != 0) mpPrevious->mpTime->Increment(now - mPreviousStart);
+		mProfile.mpCalls->Increment();
+	}
+	tContext.pProfile = &mProfile;
+	tContext.start = now;
+}
+
+ProfileScope::~ProfileScope()
+{
+	if(!mProfile.HasOwner()) return;
+
+	boost::int64_t now = (tContext.start != 0 || mPreviousStart != 0) ? HandlerProfiler::Now() : 0;
+	if(tContext.start != 0) mProfile.mpTime->Increment(now - tContext.start);
+	tContext.pProfile = mpPrevious;
+	tContext.start = (mPreviousStart != 0) ? now : 0;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
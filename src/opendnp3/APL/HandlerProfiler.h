@@ -0,0 +1,152 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __HANDLER_PROFILER_H_
+#define __HANDLER_PROFILER_H_
+
+#include "AtomicOps.h"
+#include "Function.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace apl
+{
+
+class Logger;
+class MetricCounter;
+class MetricsRegistry;
+
+/**
+	The handler_time_ns and handler_calls counters of one owner, a stack or
+	a channel, registered under the logger's var name. Copyable, so handlers
+	carry the owner by value and never point at something that can go away.
+	A default constructed profile has no owner.
+*/
+class HandlerProfile
+{
+	friend class HandlerProfiler;
+	friend class ProfileScope;
+
+public:
+	HandlerProfile() : mpTime(NULL), mpCalls(NULL)
+	{}
+
+	HandlerProfile(Logger* apLogger);
+
+	bool HasOwner() const {
+		return mpTime != NULL;
+	}
+
+private:
+	MetricCounter* mpTime;
+	MetricCounter* mpCalls;
+};
+
+/**
+	Time and invocation count of one owner's handlers
+*/
+struct HandlerUsage {
+
+	HandlerUsage() : nanos(0), calls(0)
+	{}
+
+	std::string owner;
+	boost::int64_t nanos;
+	boost::int64_t calls;
+};
+
+/**
+	Charges the handlers run on the io_service thread to the stack or channel
+	they run for.
+
+	Ownership is thread local and follows the work: a handler that runs under
+	a ProfileScope owns everything it posts or starts a timer for, so only the
+	entry points need tagging - the channel's physical layer callbacks, frames
+	routed to a stack, and whatever a stack sets up while it is constructed.
+	Nested scopes are exclusive, the outer owner isn't charged for the time
+	spent in the inner one.
+
+	Time comes from the monotonic clock around each handler. Handlers don't
+	block, so that's the CPU time the thread spent on the owner (less any
+	preemption) for a fraction of the cost of reading the thread CPU clock.
+
+	Profiling is off by default. When off, a scope is two thread local
+	stores and handlers aren't wrapped; when on, each handler costs two clock
+	reads, two relaxed atomic adds and the wrapper.
+*/
+class HandlerProfiler
+{
+public:
+
+	static void SetEnabled(bool aEnabled);
+
+	static bool IsEnabled() {
+		return AtomicLoadRelaxed(&msEnabled) != 0;
+	}
+
+	/// @return the owner of the handler running on this thread, which has no owner outside any scope
+	static HandlerProfile Current();
+
+	/// @return arHandler bound to this thread's current owner, or arHandler itself if there is none
+	static FunctionVoidZero Bind(const FunctionVoidZero& arHandler);
+
+	/// Same as Bind(), but only while profiling is on so that nothing is wrapped when it's off
+	static FunctionVoidZero BindIfEnabled(const FunctionVoidZero& arHandler) {
+		return IsEnabled() ? Bind(arHandler) : arHandler;
+	}
+
+	/// Monotonic time in nanoseconds, only meaningful as a difference
+	static boost::int64_t Now();
+
+	/// Fills arUsage with the aCount owners that have used the most time, most first
+	static void GetTop(const MetricsRegistry& arRegistry, size_t aCount, std::vector<HandlerUsage>& arUsage);
+
+	/// Writes GetTop() as a table with each owner's share of the total time
+	static void WriteReport(const MetricsRegistry& arRegistry, size_t aCount, std::ostream& arStream);
+
+private:
+
+	static void Run(const HandlerProfile& arProfile, const FunctionVoidZero& arHandler);
+
+	static atomic_int64_t msEnabled;
+};
+
+/**
+	Charges the code that runs during its lifetime to a profile, then hands
+	the thread back to the previous owner
+*/
+class ProfileScope
+{
+public:
+	ProfileScope(const HandlerProfile& arProfile);
+	~ProfileScope();
+
+private:
+	ProfileScope(const ProfileScope&);
+	ProfileScope& operator=(const ProfileScope&);
+
+	HandlerProfile mProfile;
+	const HandlerProfile* mpPrevious;
+	boost::int64_t mPreviousStart;
+};
+
+}
+
+#endif
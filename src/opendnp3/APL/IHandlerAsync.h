@@ -34,6 +34,14 @@ public:
 	// For consistency sake, use NVII pattern in case we want pre/post conditions in the future
 	void OnOpenFailure();
 
+	/**
+		Bytes still needed to finish the frame being parsed, framed serial
+		reads wait for this many. 0 if the handler doesn't parse frames.
+	*/
+	virtual size_t NumBytesToFrameEnd() const {
+		return 0;
+	}
+
 private:
 
 	// called when the layer didn't make a connection and has given up trying, safe to delete.
@@ -0,0 +1,551 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "IoUringService.h"
+
+#ifdef APL_HAS_IO_URING
+
+#include <boost/bind.hpp>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include "Exception.h"
+#include "Logger.h"
+
+using namespace boost;
+using namespace boost::asio;
+
+namespace apl
+{
+
+namespace
+{
+
+const boost::uint16_t BUFFER_GROUP = 0;
+
+int SysSetup(unsigned aEntries, io_uring_params* apParams)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, aEntries, apParams));
+}
+
+int SysEnter(int aFd, unsigned aToSubmit)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, aFd, aToSubmit, 0, 0, NULL, 0));
+}
+
+int SysRegister(int aFd, unsigned aOpcode, const void* apArg, unsigned aNumArgs)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register, aFd, aOpcode, apArg, aNumArgs));
+}
+
+void* Map(int aFd, size_t aSize, off_t aOffset)
+{
+	void* p = mmap(NULL, aSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aFd, aOffset);
+	return (p == MAP_FAILED) ? NULL : p;
+}
+
+void* MapAnonymous(size_t aSize)
+{
+	void* p = mmap(NULL, aSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return (p == MAP_FAILED) ? NULL : p;
+}
+
+std::string Describe(const std::string& arWhat, int aErrno)
+{
+	return arWhat + ": " + strerror(aErrno);
+}
+
+boost::uint64_t UserData(int aHandle, int aOp)
+{
+	return (static_cast<boost::uint64_t>(aHandle) << 8) | aOp;
+}
+
+}
+
+IoUringService::Slot::Slot() :
+	fd(-1),
+	pHandler(NULL),
+	numOps(0),
+	receiving(false),
+	sending(false),
+	sendSize(0),
+	sendOffset(0)
+{}
+
+IoUringService::IoUringService(Logger* apLogger, boost::asio::io_service* apService, size_t aMaxSockets) :
+	Loggable(apLogger),
+	mpService(apService),
+	mRingFd(-1),
+	mEventFd(-1),
+	mpSqRing(NULL),
+	mSqRingSize(0),
+	mpSqes(NULL),
+	mSqesSize(0),
+	mpSqHead(NULL),
+	mpSqTail(NULL),
+	mpSqArray(NULL),
+	mSqMask(0),
+	mSqEntries(0),
+	mSqLocalTail(0),
+	mNumQueued(0),
+	mFlushPosted(false),
+	mpCqHead(NULL),
+	mpCqTail(NULL),
+	mpCqes(NULL),
+	mCqMask(0),
+	mpBufRing(NULL),
+	mBufRingSize(0),
+	mpRecvBuffers(NULL),
+	mBufTail(0),
+	mpSendBuffers(NULL),
+	mSendBuffersSize(0),
+	mFixedSends(false),
+	mSlots(aMaxSockets),
+	mEvents(*apService),
+	mEventCount(0),
+	mNumSubmitCalls(0),
+	mNumSubmitted(0),
+	mNumCompletions(0)
+{
+	if(aMaxSockets == 0) throw ArgumentException(LOCATION, "aMaxSockets must be > 0");
+
+	for(size_t i = aMaxSockets; i > 0; --i) mFreeSlots.push_back(static_cast<int>(i - 1));
+
+	try {
+		this->CreateRing(aMaxSockets);
+		this->RegisterBuffers();
+	} catch(...) {
+		this->Teardown();
+		throw;
+	}
+
+	mEvents.assign(mEventFd);
+	this->StartWait();
+}
+
+IoUringService::~IoUringService()
+{
+	boost::system::error_code ec;
+	mEvents.close(ec);	// closes mEventFd
+	mEventFd = -1;
+	this->Teardown();	// the kernel cancels whatever is still outstanding
+}
+
+bool IoUringService::IsSupported()
+{
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	int fd = SysSetup(2, &params);
+	if(fd < 0) return false;
+
+	bool supported = false;
+	size_t size = sizeof(io_uring_buf);
+	void* pRing = MapAnonymous(size);
+	if(pRing != NULL) {
+		io_uring_buf_reg reg;
+		memset(&reg, 0, sizeof(reg));
+		reg.ring_addr = reinterpret_cast<boost::uint64_t>(pRing);
+		reg.ring_entries = 1;
+		reg.bgid = BUFFER_GROUP;
+		supported = SysRegister(fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+		munmap(pRing, size);
+	}
+
+	close(fd);
+	return supported;
+}
+
+void IoUringService::Stop()
+{
+	boost::system::error_code ec;
+	mEvents.cancel(ec);
+}
+
+void IoUringService::CreateRing(size_t aMaxSockets)
+{
+	// one receive per socket is queued when they're attached, plus sends and cancels
+	unsigned entries = 1;
+	while(entries < aMaxSockets && entries < 4096) entries <<= 1;
+
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = 4 * entries;
+
+	mRingFd = SysSetup(entries, &params);
+	if(mRingFd < 0) throw Exception(LOCATION, Describe("io_uring_setup", errno));
+	if((params.features & IORING_FEAT_SINGLE_MMAP) == 0) throw Exception(LOCATION, "io_uring is too old, the rings need separate mappings");
+
+	size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	mSqRingSize = (sqSize > cqSize) ? sqSize : cqSize;
+
+	mpSqRing = Map(mRingFd, mSqRingSize, IORING_OFF_SQ_RING);
+	if(mpSqRing == NULL) throw Exception(LOCATION, Describe("mmap of sq ring", errno));
+
+	mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	mpSqes = static_cast<io_uring_sqe*>(Map(mRingFd, mSqesSize, IORING_OFF_SQES));
+	if(mpSqes == NULL) throw Exception(LOCATION, Describe("mmap of sqes", errno));
+
+	boost::uint8_t* pRing = static_cast<boost::uint8_t*>(mpSqRing);
+	mpSqHead = reinterpret_cast<unsigned*>(pRing + params.sq_off.head);
+	mpSqTail = reinterpret_cast<unsigned*>(pRing + params.sq_off.tail);
+	mpSqArray = reinterpret_cast<unsigned*>(pRing + params.sq_off.array);
+	mSqMask = *reinterpret_cast<unsigned*>(pRing + params.sq_off.ring_mask);
+	mSqEntries = params.sq_entries;
+	mSqLocalTail = *mpSqTail;
+
+	mpCqHead = reinterpret_cast<unsigned*>(pRing + params.cq_off.head);
+	mpCqTail = reinterpret_cast<unsigned*>(pRing + params.cq_off.tail);
+	mpCqes = reinterpret_cast<io_uring_cqe*>(pRing + params.cq_off.cqes);
+	mCqMask = *reinterpret_cast<unsigned*>(pRing + params.cq_off.ring_mask);
+
+	mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(mEventFd < 0) throw Exception(LOCATION, Describe("eventfd", errno));
+	if(SysRegister(mRingFd, IORING_REGISTER_EVENTFD, &mEventFd, 1) < 0) throw Exception(LOCATION, Describe("register eventfd", errno));
+}
+
+void IoUringService::RegisterBuffers()
+{
+	mBufRingSize = NUM_RECV_BUFFERS * sizeof(io_uring_buf);
+	mpBufRing = static_cast<io_uring_buf_ring*>(MapAnonymous(mBufRingSize));
+	mpRecvBuffers = static_cast<boost::uint8_t*>(MapAnonymous(NUM_RECV_BUFFERS * RECV_BUFFER_SIZE));
+	if(mpBufRing == NULL || mpRecvBuffers == NULL) throw Exception(LOCATION, Describe("mmap of receive buffers", errno));
+
+	io_uring_buf_reg reg;
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = reinterpret_cast<boost::uint64_t>(mpBufRing);
+	reg.ring_entries = NUM_RECV_BUFFERS;
+	reg.bgid = BUFFER_GROUP;
+	if(SysRegister(mRingFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) throw Exception(LOCATION, Describe("register provided buffers", errno));
+
+	for(size_t i = 0; i < NUM_RECV_BUFFERS; ++i) this->RecycleBuffer(static_cast<boost::uint16_t>(i));
+
+	mSendBuffersSize = mSlots.size() * SEND_SLOT_SIZE;
+	mpSendBuffers = static_cast<boost::uint8_t*>(MapAnonymous(mSendBuffersSize));
+	if(mpSendBuffers == NULL) throw Exception(LOCATION, Describe("mmap of send buffers", errno));
+
+	iovec iov;
+	iov.iov_base = mpSendBuffers;
+	iov.iov_len = mSendBuffersSize;
+	mFixedSends = SysRegister(mRingFd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+	if(!mFixedSends) LOG_BLOCK(LEV_WARNING, Describe("Sending without registered buffers", errno));
+}
+
+void IoUringService::Teardown()
+{
+	if(mpSendBuffers != NULL) munmap(mpSendBuffers, mSendBuffersSize);
+	if(mpRecvBuffers != NULL) munmap(mpRecvBuffers, NUM_RECV_BUFFERS * RECV_BUFFER_SIZE);
+	if(mpBufRing != NULL) munmap(mpBufRing, mBufRingSize);
+	if(mpSqes != NULL) munmap(mpSqes, mSqesSize);
+	if(mpSqRing != NULL) munmap(mpSqRing, mSqRingSize);
+	if(mEventFd >= 0) close(mEventFd);
+	if(mRingFd >= 0) close(mRingFd);
+
+	mpSendBuffers = mpRecvBuffers = NULL;
+	mpBufRing = NULL;
+	mpSqes = NULL;
+	mpSqRing = NULL;
+	mEventFd = mRingFd = -1;
+}
+
+int IoUringService::Attach(int aFd, IHandler* apHandler)
+{
+	if(mFreeSlots.empty()) throw Exception(LOCATION, "All io_uring socket slots are in use");
+
+	int handle = mFreeSlots.back();
+	mFreeSlots.pop_back();
+
+	Slot& s = mSlots[handle];
+	s.fd = aFd;
+	s.pHandler = apHandler;
+	this->QueueReceive(handle);
+	return handle;
+}
+
+void IoUringService::Detach(int aHandle)
+{
+	// requests for the socket still in the queue must reach the kernel before the caller closes it
+	this->Submit();
+
+	Slot& s = mSlots[aHandle];
+	s.pHandler = NULL;
+	if(s.receiving) this->QueueCancel(aHandle, OP_RECV);
+	if(s.sending) this->QueueCancel(aHandle, OP_SEND);
+	this->ReleaseIfDone(aHandle);
+}
+
+void IoUringService::Send(int aHandle, const boost::uint8_t* apData, size_t aNumBytes)
+{
+	Slot& s = mSlots[aHandle];
+	assert(!s.sending);
+
+	if(aNumBytes <= SEND_SLOT_SIZE) {
+		memcpy(this->SendSlot(aHandle), apData, aNumBytes);
+	} else {
+		s.overflow.assign(apData, apData + aNumBytes);
+	}
+
+	s.sending = true;
+	s.sendSize = aNumBytes;
+	s.sendOffset = 0;
+	this->QueueSend(aHandle);
+}
+
+io_uring_sqe* IoUringService::GetSqe()
+{
+	if(mSqLocalTail - __atomic_load_n(mpSqHead, __ATOMIC_ACQUIRE) >= mSqEntries) {
+		this->Submit();
+		if(mSqLocalTail - __atomic_load_n(mpSqHead, __ATOMIC_ACQUIRE) >= mSqEntries) throw Exception(LOCATION, "io_uring submission queue is full");
+	}
+
+	io_uring_sqe* pSqe = &mpSqes[mSqLocalTail & mSqMask];
+	mpSqArray[mSqLocalTail & mSqMask] = mSqLocalTail & mSqMask;
+	++mSqLocalTail;
+	++mNumQueued;
+
+	memset(pSqe, 0, sizeof(io_uring_sqe));
+
+	// everything queued while this handler runs goes to the kernel in one call
+	if(!mFlushPosted) {
+		mFlushPosted = true;
+		mpService->post(boost::bind(&IoUringService::OnFlush, this));
+	}
+
+	return pSqe;
+}
+
+void IoUringService::QueueReceive(int aHandle)
+{
+	Slot& s = mSlots[aHandle];
+	io_uring_sqe* pSqe = this->GetSqe();
+	pSqe->opcode = IORING_OP_RECV;
+	pSqe->fd = s.fd;
+	pSqe->flags = IOSQE_BUFFER_SELECT;
+	pSqe->ioprio = IORING_RECV_MULTISHOT;
+	pSqe->buf_group = BUFFER_GROUP;
+	pSqe->user_data = UserData(aHandle, OP_RECV);
+	s.receiving = true;
+	++s.numOps;
+}
+
+void IoUringService::QueueSend(int aHandle)
+{
+	Slot& s = mSlots[aHandle];
+	size_t remaining = s.sendSize - s.sendOffset;
+	io_uring_sqe* pSqe = this->GetSqe();
+	pSqe->fd = s.fd;
+	pSqe->len = static_cast<boost::uint32_t>(remaining);
+	pSqe->user_data = UserData(aHandle, OP_SEND);
+
+	if(s.sendSize > SEND_SLOT_SIZE) {
+		pSqe->opcode = IORING_OP_SEND;
+		pSqe->addr = reinterpret_cast<boost::uint64_t>(&s.overflow[s.sendOffset]);
+		pSqe->msg_flags = MSG_NOSIGNAL;
+	} else if(mFixedSends) {
+		pSqe->opcode = IORING_OP_WRITE_FIXED;
+		pSqe->addr = reinterpret_cast<boost::uint64_t>(this->SendSlot(aHandle) + s.sendOffset);
+		pSqe->buf_index = 0;
+	} else {
+		pSqe->opcode = IORING_OP_SEND;
+		pSqe->addr = reinterpret_cast<boost::uint64_t>(this->SendSlot(aHandle) + s.sendOffset);
+		pSqe->msg_flags = MSG_NOSIGNAL;
+	}
+	++s.numOps;
+}
+
+void IoUringService::QueueCancel(int aHandle, Operation aOp)
+{
+	io_uring_sqe* pSqe = this->GetSqe();
+	pSqe->opcode = IORING_OP_ASYNC_CANCEL;
+	pSqe->fd = -1;
+	pSqe->addr = UserData(aHandle, aOp);
+	pSqe->user_data = UserData(aHandle, OP_CANCEL);
+	++mSlots[aHandle].numOps;
+}
+
+void IoUringService::Submit()
+{
+	if(mNumQueued == 0) return;
+
+	__atomic_store_n(mpSqTail, mSqLocalTail, __ATOMIC_RELEASE);
+
+	while(mNumQueued > 0) {
+		int num = SysEnter(mRingFd, mNumQueued);
+		++mNumSubmitCalls;
+		if(num < 0) {
+			if(errno == EINTR) continue;
+			if(errno == EAGAIN || errno == EBUSY) {
+				// the completion queue is backed up, try again after the next reap
+				if(!mFlushPosted) {
+					mFlushPosted = true;
+					mpService->post(boost::bind(&IoUringService::OnFlush, this));
+				}
+				return;
+			}
+			throw Exception(LOCATION, Describe("io_uring_enter", errno));
+		}
+		mNumQueued -= num;
+		mNumSubmitted += num;
+	}
+}
+
+void IoUringService::OnFlush()
+{
+	mFlushPosted = false;
+	this->Submit();
+}
+
+void IoUringService::StartWait()
+{
+	mEvents.async_read_some(buffer(&mEventCount, sizeof(mEventCount)),
+	                        boost::bind(&IoUringService::OnEvent, this, boost::asio::placeholders::error));
+}
+
+void IoUringService::OnEvent(const boost::system::error_code& arErr)
+{
+	if(arErr) {
+		if(arErr != error::operation_aborted) LOG_BLOCK(LEV_ERROR, "Error waiting for io_uring completions: " << arErr.message());
+		return;
+	}
+
+	// the eventfd is read before reaping, so a completion that lands while reaping signals it again
+	this->Reap();
+	this->StartWait();
+}
+
+void IoUringService::Reap()
+{
+	unsigned head = *mpCqHead;
+	unsigned tail = __atomic_load_n(mpCqTail, __ATOMIC_ACQUIRE);
+
+	while(head != tail) {
+		io_uring_cqe* pCqe = &mpCqes[head & mCqMask];
+		boost::uint64_t userData = pCqe->user_data;
+		boost::int32_t result = pCqe->res;
+		boost::uint32_t flags = pCqe->flags;
+		__atomic_store_n(mpCqHead, ++head, __ATOMIC_RELEASE);
+		++mNumCompletions;
+
+		this->Complete(userData, result, flags);
+		tail = __atomic_load_n(mpCqTail, __ATOMIC_ACQUIRE);
+	}
+}
+
+void IoUringService::Complete(boost::uint64_t aUserData, boost::int32_t aResult, boost::uint32_t aFlags)
+{
+	int handle = static_cast<int>(aUserData >> 8);
+	switch(aUserData & 0xFF) {
+	case(OP_RECV):
+		this->OnReceiveComplete(handle, aResult, aFlags);
+		break;
+	case(OP_SEND):
+		this->OnSendComplete(handle, aResult);
+		break;
+	default:
+		--mSlots[handle].numOps;
+		break;
+	}
+	this->ReleaseIfDone(handle);
+}
+
+void IoUringService::OnReceiveComplete(int aHandle, boost::int32_t aResult, boost::uint32_t aFlags)
+{
+	bool more = (aFlags & IORING_CQE_F_MORE) != 0;
+	if(!more) {
+		mSlots[aHandle].receiving = false;
+		--mSlots[aHandle].numOps;
+	}
+
+	if(aFlags & IORING_CQE_F_BUFFER) {
+		boost::uint16_t id = static_cast<boost::uint16_t>(aFlags >> IORING_CQE_BUFFER_SHIFT);
+		IHandler* pHandler = mSlots[aHandle].pHandler;
+		if(pHandler != NULL && aResult > 0) pHandler->OnReceive(mpRecvBuffers + id * RECV_BUFFER_SIZE, aResult);
+		this->RecycleBuffer(id);
+	}
+
+	// the handler may have detached during the callback
+	Slot& s = mSlots[aHandle];
+	if(more || s.pHandler == NULL) return;
+
+	if(aResult > 0 || aResult == -ENOBUFS) {
+		// the kernel ended the multishot receive early, e.g. the buffers ran out while a burst was reaped
+		this->QueueReceive(aHandle);
+	} else {
+		boost::system::error_code ec = (aResult == 0) ? error::eof : boost::system::error_code(-aResult, boost::system::system_category());
+		s.pHandler->OnReceiveClosed(ec);
+	}
+}
+
+void IoUringService::OnSendComplete(int aHandle, boost::int32_t aResult)
+{
+	Slot& s = mSlots[aHandle];
+	--s.numOps;
+
+	if(aResult > 0) s.sendOffset += aResult;
+	bool done = aResult < 0 || s.sendOffset == s.sendSize;
+	if(!done && s.pHandler != NULL) {
+		this->QueueSend(aHandle); // short send, keep going with the rest
+		return;
+	}
+
+	s.sending = false;
+	s.overflow.clear();
+	if(s.pHandler == NULL) return;
+
+	if(aResult < 0) s.pHandler->OnSend(boost::system::error_code(-aResult, boost::system::system_category()), 0);
+	else s.pHandler->OnSend(boost::system::error_code(), s.sendSize);
+}
+
+void IoUringService::ReleaseIfDone(int aHandle)
+{
+	Slot& s = mSlots[aHandle];
+	if(s.fd < 0 || s.pHandler != NULL || s.numOps > 0) return;
+
+	s.fd = -1;
+	s.receiving = s.sending = false;
+	std::vector<boost::uint8_t>().swap(s.overflow);
+	mFreeSlots.push_back(aHandle);
+}
+
+void IoUringService::RecycleBuffer(boost::uint16_t aId)
+{
+	// the tail overlays the reserved field of the first entry, but the header's flexible array
+	// member is preceded by an empty struct when compiled as C++, so index the entries directly
+	io_uring_buf* pBuf = reinterpret_cast<io_uring_buf*>(mpBufRing) + (mBufTail & (NUM_RECV_BUFFERS - 1));
+	pBuf->addr = reinterpret_cast<boost::uint64_t>(mpRecvBuffers + aId * RECV_BUFFER_SIZE);
+	pBuf->len = RECV_BUFFER_SIZE;
+	pBuf->bid = aId;
+	__atomic_store_n(&mpBufRing->tail, ++mBufTail, __ATOMIC_RELEASE);
+}
+
+}
+
+#endif
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,223 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __IO_URING_SERVICE_H_
+#define __IO_URING_SERVICE_H_
+
+#ifdef __linux__
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+#define APL_HAS_IO_URING	// the kernel headers know about multishot receives and provided buffer rings
+#endif
+#endif
+
+#ifdef APL_HAS_IO_URING
+
+#include <boost/asio.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <vector>
+
+#include "Loggable.h"
+#include "Uncopyable.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace apl
+{
+
+/**
+	Drives the reads and writes of many connected sockets through a single
+	Linux io_uring instead of one reactor registration per socket.
+
+	Every attached socket has a multishot receive outstanding that the
+	kernel completes into a shared ring of provided buffers, so an idle
+	socket costs nothing until bytes arrive. Sends are copied into a slot
+	of a registered buffer. Requests queued while a handler runs are
+	submitted together with one io_uring_enter() call from a handler
+	posted to the io_service, and completions are signalled through an
+	eventfd that asio waits on, so thousands of sockets share one wakeup.
+
+	All methods and callbacks run on the io_service thread.
+*/
+class IoUringService : public Loggable, private Uncopyable
+{
+public:
+
+	/// Callbacks for an attached socket
+	class IHandler
+	{
+	public:
+		virtual ~IHandler() {}
+
+		/// Bytes received on the socket, only valid for the duration of the call
+		virtual void OnReceive(const boost::uint8_t* apData, size_t aNumBytes) = 0;
+
+		/// The socket won't receive anything more, arErr is eof if the peer closed it
+		virtual void OnReceiveClosed(const boost::system::error_code& arErr) = 0;
+
+		virtual void OnSend(const boost::system::error_code& arErr, size_t aNumBytes) = 0;
+	};
+
+	static const size_t DEFAULT_MAX_SOCKETS = 4096;
+
+	/// Sends up to this size are copied into a registered buffer, larger ones into the heap
+	static const size_t SEND_SLOT_SIZE = 512;
+
+	static const size_t NUM_RECV_BUFFERS = 1024;
+	static const size_t RECV_BUFFER_SIZE = 2048;
+
+	/// @throw Exception if the ring can't be created
+	IoUringService(Logger* apLogger, boost::asio::io_service* apService, size_t aMaxSockets = DEFAULT_MAX_SOCKETS);
+	~IoUringService();
+
+	/// @return true if the running kernel supports io_uring with provided buffer rings
+	static bool IsSupported();
+
+	/// Stops waiting for completions so the io_service can run out of work, call once every socket is detached
+	void Stop();
+
+	/**
+		Starts receiving on a connected socket. The caller still owns the
+		descriptor but mustn't close it until it's detached.
+		@return a handle to use with the other calls
+		@throw Exception if the maximum number of sockets are attached
+	*/
+	int Attach(int aFd, IHandler* apHandler);
+
+	/// Cancels the receive and any send in progress, the handler gets no more callbacks
+	void Detach(int aHandle);
+
+	/// Starts a send of a copy of the bytes, only one send per handle may be in progress
+	void Send(int aHandle, const boost::uint8_t* apData, size_t aNumBytes);
+
+	/// Number of io_uring_enter() calls made to submit requests
+	boost::int64_t NumSubmitCalls() const {
+		return mNumSubmitCalls;
+	}
+
+	/// Number of requests submitted
+	boost::int64_t NumSubmitted() const {
+		return mNumSubmitted;
+	}
+
+	/// Number of completions reaped
+	boost::int64_t NumCompletions() const {
+		return mNumCompletions;
+	}
+
+private:
+
+	enum Operation {
+		OP_RECV = 1,
+		OP_SEND = 2,
+		OP_CANCEL = 3
+	};
+
+	struct Slot {
+		Slot();
+
+		int fd;
+		IHandler* pHandler;		// NULL when free or detached
+		int numOps;				// requests the kernel hasn't completed yet
+		bool receiving;			// the multishot receive is armed
+		bool sending;
+		size_t sendSize;
+		size_t sendOffset;
+		std::vector<boost::uint8_t> overflow;	// sends that don't fit in the registered slot
+	};
+
+	void CreateRing(size_t aMaxSockets);
+	void RegisterBuffers();
+	void Teardown();
+
+	::io_uring_sqe* GetSqe();
+	void QueueReceive(int aHandle);
+	void QueueSend(int aHandle);
+	void QueueCancel(int aHandle, Operation aOp);
+
+	void Submit();
+	void OnFlush();
+
+	void StartWait();
+	void OnEvent(const boost::system::error_code& arErr);
+	void Reap();
+	void Complete(boost::uint64_t aUserData, boost::int32_t aResult, boost::uint32_t aFlags);
+	void OnReceiveComplete(int aHandle, boost::int32_t aResult, boost::uint32_t aFlags);
+	void OnSendComplete(int aHandle, boost::int32_t aResult);
+	void ReleaseIfDone(int aHandle);
+	void RecycleBuffer(boost::uint16_t aId);
+
+	boost::uint8_t* SendSlot(int aHandle) {
+		return mpSendBuffers + aHandle * SEND_SLOT_SIZE;
+	}
+
+	boost::asio::io_service* mpService;
+	int mRingFd;
+	int mEventFd;
+
+	// submission queue
+	void* mpSqRing;
+	size_t mSqRingSize;
+	::io_uring_sqe* mpSqes;
+	size_t mSqesSize;
+	unsigned* mpSqHead;
+	unsigned* mpSqTail;
+	unsigned* mpSqArray;
+	unsigned mSqMask;
+	unsigned mSqEntries;
+	unsigned mSqLocalTail;		// queued requests not yet published to the kernel
+	unsigned mNumQueued;
+	bool mFlushPosted;
+
+	// completion queue, shares the sq mapping on every kernel that has provided buffer rings
+	unsigned* mpCqHead;
+	unsigned* mpCqTail;
+	::io_uring_cqe* mpCqes;
+	unsigned mCqMask;
+
+	// provided buffers for the multishot receives
+	::io_uring_buf_ring* mpBufRing;
+	size_t mBufRingSize;
+	boost::uint8_t* mpRecvBuffers;
+	unsigned short mBufTail;
+
+	// send slots, registered with the kernel when the memlock limit allows it
+	boost::uint8_t* mpSendBuffers;
+	size_t mSendBuffersSize;
+	bool mFixedSends;
+
+	std::vector<Slot> mSlots;
+	std::vector<int> mFreeSlots;
+
+	boost::asio::posix::stream_descriptor mEvents;
+	boost::uint64_t mEventCount;
+
+	boost::int64_t mNumSubmitCalls;
+	boost::int64_t mNumSubmitted;
+	boost::int64_t mNumCompletions;
+};
+
+}
+
+#endif
+
+#endif
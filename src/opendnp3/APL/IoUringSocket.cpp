@@ -0,0 +1,162 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "IoUringSocket.h"
+
+#ifdef APL_HAS_IO_URING
+
+#include <boost/bind.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace boost;
+using namespace boost::asio;
+
+namespace apl
+{
+
+IoUringSocket::IoUringSocket(IoUringService* apUring, boost::asio::io_service* apService, const ReadHandler& arReadHandler, const WriteHandler& arWriteHandler) :
+	mpUring(apUring),
+	mpService(apService),
+	mReadHandler(arReadHandler),
+	mWriteHandler(arWriteHandler),
+	mFd(-1),
+	mHandle(-1),
+	mpReadBuffer(NULL),
+	mReadSize(0),
+	mWriting(false),
+	mReceiveClosed(false)
+{
+
+}
+
+IoUringSocket::~IoUringSocket()
+{
+	if(mHandle >= 0) {
+		mpUring->Detach(mHandle);
+		shutdown(mFd, SHUT_RDWR);
+		close(mFd);
+	}
+}
+
+void IoUringSocket::Open(int aFd)
+{
+	assert(mHandle < 0);
+	mFd = aFd;
+	mReceived.clear();
+	mReceiveClosed = false;
+	mReceiveError = system::error_code();
+	mHandle = mpUring->Attach(aFd, this);
+}
+
+void IoUringSocket::Close()
+{
+	if(mHandle < 0) return;
+
+	mpUring->Detach(mHandle);
+	mHandle = -1;
+	shutdown(mFd, SHUT_RDWR);
+	close(mFd);
+	mFd = -1;
+
+	if(mpReadBuffer != NULL) mpService->post(boost::bind(&IoUringSocket::DeliverRead, this));
+	if(mWriting) {
+		mWriting = false;
+		mpService->post(boost::bind(mWriteHandler, system::error_code(error::operation_aborted), 0));
+	}
+}
+
+void IoUringSocket::AsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
+{
+	assert(mpReadBuffer == NULL);
+	mpReadBuffer = apBuffer;
+	mReadSize = aMaxBytes;
+
+	// like asio, a read never completes from inside the call that started it
+	if(!mReceived.empty() || mReceiveClosed || mHandle < 0) mpService->post(boost::bind(&IoUringSocket::DeliverRead, this));
+}
+
+void IoUringSocket::AsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	assert(!mWriting);
+	if(mHandle < 0) {
+		mpService->post(boost::bind(mWriteHandler, system::error_code(error::bad_descriptor), 0));
+		return;
+	}
+	mWriting = true;
+	mpUring->Send(mHandle, apBuffer, aNumBytes);
+}
+
+void IoUringSocket::OnReceive(const boost::uint8_t* apData, size_t aNumBytes)
+{
+	if(mpReadBuffer != NULL && mReceived.empty()) {
+		size_t num = std::min(aNumBytes, mReadSize);
+		memcpy(mpReadBuffer, apData, num);
+		mReceived.insert(mReceived.end(), apData + num, apData + aNumBytes);
+		boost::uint8_t* pBuffer = mpReadBuffer;
+		mpReadBuffer = NULL;
+		mReadHandler(system::error_code(), pBuffer, num);
+	} else {
+		mReceived.insert(mReceived.end(), apData, apData + aNumBytes);
+		this->DeliverRead();
+	}
+}
+
+void IoUringSocket::OnReceiveClosed(const boost::system::error_code& arErr)
+{
+	mReceiveClosed = true;
+	mReceiveError = arErr;
+	this->DeliverRead();
+}
+
+void IoUringSocket::OnSend(const boost::system::error_code& arErr, size_t aNumBytes)
+{
+	mWriting = false;
+	mWriteHandler(arErr, aNumBytes);
+}
+
+void IoUringSocket::DeliverRead()
+{
+	if(mpReadBuffer == NULL) return;
+
+	boost::uint8_t* pBuffer = mpReadBuffer;
+	if(!mReceived.empty()) {
+		size_t num = std::min(mReceived.size(), mReadSize);
+		std::copy(mReceived.begin(), mReceived.begin() + num, pBuffer);
+		mReceived.erase(mReceived.begin(), mReceived.begin() + num);
+		mpReadBuffer = NULL;
+		mReadHandler(system::error_code(), pBuffer, num);
+	} else if(mHandle < 0) {
+		mpReadBuffer = NULL;
+		mReadHandler(system::error_code(error::operation_aborted), pBuffer, 0);
+	} else if(mReceiveClosed) {
+		mpReadBuffer = NULL;
+		mReadHandler(mReceiveError, pBuffer, 0);
+	}
+}
+
+}
+
+#endif
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,91 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __IO_URING_SOCKET_H_
+#define __IO_URING_SOCKET_H_
+
+#include "IoUringService.h"
+
+#ifdef APL_HAS_IO_URING
+
+#include <boost/function.hpp>
+
+#include <deque>
+
+namespace apl
+{
+
+/**
+	Adapts a connected socket attached to an IoUringService to the one
+	read, one write model of the physical layers. Bytes that arrive while
+	no read is outstanding are queued until the next read.
+*/
+class IoUringSocket : private IoUringService::IHandler, private Uncopyable
+{
+public:
+
+	typedef boost::function<void (const boost::system::error_code&, boost::uint8_t*, size_t)> ReadHandler;
+	typedef boost::function<void (const boost::system::error_code&, size_t)> WriteHandler;
+
+	IoUringSocket(IoUringService* apUring, boost::asio::io_service* apService, const ReadHandler& arReadHandler, const WriteHandler& arWriteHandler);
+	~IoUringSocket();
+
+	/// Takes ownership of a connected socket descriptor and starts receiving on it
+	void Open(int aFd);
+
+	/// Shuts down and closes the socket, an outstanding read or write completes with operation_aborted
+	void Close();
+
+	bool IsOpen() const {
+		return mHandle >= 0;
+	}
+
+	void AsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes);
+	void AsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes);
+
+private:
+
+	void OnReceive(const boost::uint8_t* apData, size_t aNumBytes);
+	void OnReceiveClosed(const boost::system::error_code& arErr);
+	void OnSend(const boost::system::error_code& arErr, size_t aNumBytes);
+
+	/// Completes the outstanding read if there's anything to give it
+	void DeliverRead();
+
+	IoUringService* mpUring;
+	boost::asio::io_service* mpService;
+	ReadHandler mReadHandler;
+	WriteHandler mWriteHandler;
+
+	int mFd;
+	int mHandle;
+
+	boost::uint8_t* mpReadBuffer;		// NULL unless a read is outstanding
+	size_t mReadSize;
+	bool mWriting;
+
+	std::deque<boost::uint8_t> mReceived;
+	bool mReceiveClosed;
+	boost::system::error_code mReceiveError;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "LatencyTrace.h"
+
+#include "Logger.h"
+#include "Metrics.h"
+
+#include <iomanip>
+#include <vector>
+
+#ifdef APL_PLATFORM_WIN
+#include <windows.h>
+#define APL_THREAD_LOCAL __declspec(thread)
+#else
+#include <time.h>
+#define APL_THREAD_LOCAL __thread
+#endif
+
+namespace apl
+{
+
+namespace
+{
+
+struct TraceContext {
+	bool active;
+	boost::int64_t stamps[TS_NUM_STAGES];	// 0 if the stage hasn't been reached
+};
+
+APL_THREAD_LOCAL TraceContext tContext;
+
+const char* STAGE_NAMES[TS_NUM_STAGES] = { "read", "link", "transport", "app", "publish" };
+
+}
+
+atomic_int64_t LatencyTrace::msSampleRate = 0;
+atomic_int64_t LatencyTrace::msSampleCount = 0;
+
+void LatencyTrace::SetSampleRate(size_t aOneIn)
+{
+	AtomicStoreRelaxed(&msSampleRate, static_cast<boost::int64_t>(aOneIn));
+}
+
+size_t LatencyTrace::GetSampleRate()
+{
+	return static_cast<size_t>(AtomicLoadRelaxed(&msSampleRate));
+}
+
+bool LatencyTrace::Sample()
+{
+	boost::int64_t rate = AtomicLoadRelaxed(&msSampleRate);
+	if(rate == 0) return false;
+	AtomicAddRelaxed(&msSampleCount, 1);
+	return (AtomicLoadRelaxed(&msSampleCount) % rate) == 0;
+}
+
+boost::int64_t LatencyTrace::Now()
+{
+#ifdef APL_PLATFORM_WIN
+	LARGE_INTEGER count, freq;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&freq);
+	return (count.QuadPart / freq.QuadPart) * 1000000 + ((count.QuadPart % freq.QuadPart) * 1000000) / freq.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<boost::int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+void LatencyTrace::DoBegin()
+{
+	tContext.active = Sample();
+	if(tContext.active) {
+		for(size_t i = 0; i < TS_NUM_STAGES; ++i) tContext.stamps[i] = 0;
+		tContext.stamps[TS_READ] = Now();
+	}
+}
+
+void LatencyTrace::DoMark(TraceStage aStage)
+{
+	if(tContext.active) tContext.stamps[aStage] = Now();
+}
+
+void LatencyTrace::DoComplete(TraceHistograms& arHistograms)
+{
+	if(!tContext.active) return;
+	tContext.active = false; // a read only publishes once
+
+	tContext.stamps[TS_PUBLISH] = Now();
+	boost::int64_t last = tContext.stamps[TS_READ];
+	for(size_t i = TS_LINK; i < TS_NUM_STAGES; ++i) {
+		if(tContext.stamps[i] == 0) continue; // stage not instrumented on this path
+		arHistograms.mpStages[i]->Observe(tContext.stamps[i] - last);
+		last = tContext.stamps[i];
+	}
+	arHistograms.mpTotal->Observe(tContext.stamps[TS_PUBLISH] - tContext.stamps[TS_READ]);
+}
+
+void LatencyTrace::DoEnd()
+{
+	tContext.active = false;
+}
+
+namespace
+{
+
+void WriteBound(std::ostream& arStream, boost::int64_t aBound)
+{
+	arStream << std::setw(10);
+	if(aBound < 0) arStream << "inf";
+	else arStream << aBound;
+}
+
+}
+
+void LatencyTrace::WriteReport(const MetricsRegistry& arRegistry, std::ostream& arStream)
+{
+	std::vector<MetricSample> samples;
+	arRegistry.Snapshot(samples);
+
+	arStream << std::left << std::setw(20) << "source" << std::setw(28) << "stage" << std::right;
+	arStream << std::setw(10) << "count" << std::setw(10) << "mean us" << std::setw(10) << "p50 <=" << std::setw(10) << "p99 <=" << "\r\n";
+
+	for(std::vector<MetricSample>::iterator s = samples.begin(); s != samples.end(); ++s) {
+		if(s->type != MT_HISTOGRAM || s->name.compare(0, 6, "trace_") != 0) continue;
+		arStream << std::left << std::setw(20) << s->source << std::setw(28) << s->name.substr(6) << std::right;
+		arStream << std::setw(10) << s->value << std::setw(10) << (s->value > 0 ? s->sum / s->value : 0);
+		WriteBound(arStream, MetricHistogram::Percentile(*s, 50));
+		WriteBound(arStream, MetricHistogram::Percentile(*s, 99));
+		arStream << "\r\n";
+	}
+}
+
+TraceHistograms::TraceHistograms(Logger* apLogger)
+{
+	mpStages[TS_READ] = NULL;
+	for(size_t i = TS_LINK; i < TS_NUM_STAGES; ++i) {
+		std::string name("trace_");
+		name += STAGE_NAMES[i];
+		name += "_us";
+		mpStages[i] = apLogger->GetHistogram(name, std::string("Microseconds from the previous traced stage until the ") + STAGE_NAMES[i] + " stage completed");
+	}
+	mpTotal = apLogger->GetHistogram("trace_total_us", "Microseconds from the physical layer read to the publish of the data");
+}
+
+}
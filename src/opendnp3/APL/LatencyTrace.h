@@ -0,0 +1,133 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __LATENCY_TRACE_H_
+#define __LATENCY_TRACE_H_
+
+#include "AtomicOps.h"
+
+#include <ostream>
+
+namespace apl
+{
+
+class Logger;
+class MetricHistogram;
+class MetricsRegistry;
+
+/**
+	Points on the receive path, in the order they are reached
+*/
+enum TraceStage {
+	TS_READ,		// physical layer read completed
+	TS_LINK,		// link frame validated
+	TS_TRANSPORT,	// fragment reassembled by the transport layer
+	TS_APP,			// fragment parsed by the application layer
+	TS_PUBLISH,		// measurements published to the IDataObserver
+	TS_NUM_STAGES
+};
+
+class TraceHistograms;
+
+/**
+	Sampled latency tracing of the receive path. A trace starts when a
+	physical layer read completes, each layer marks the time its stage
+	finished, and the user layer completes the trace once the data has been
+	published. Everything between the read and the publish happens in the
+	same io_service callback, so the trace lives in thread local storage and
+	nothing is carried through the layers.
+
+	Tracing is off by default. When off, each trace point is a single relaxed
+	load and a branch.
+
+	Multi-frame fragments are timed from the read that completed them.
+*/
+class LatencyTrace
+{
+public:
+
+	/// Traces 1 in aOneIn reads (or slave update batches), 0 turns tracing off
+	static void SetSampleRate(size_t aOneIn);
+	static size_t GetSampleRate();
+
+	static bool IsEnabled() {
+		return AtomicLoadRelaxed(&msSampleRate) != 0;
+	}
+
+	/// @return true if the next event should be traced, advancing the sample counter
+	static bool Sample();
+
+	/// Starts a trace on this thread if this read is sampled
+	static void Begin() {
+		if(IsEnabled()) DoBegin();
+	}
+
+	/// Timestamps a stage of the trace in progress on this thread, if any
+	static void Mark(TraceStage aStage) {
+		if(IsEnabled()) DoMark(aStage);
+	}
+
+	/// Marks TS_PUBLISH and records the trace in arHistograms
+	static void Complete(TraceHistograms& arHistograms) {
+		if(IsEnabled()) DoComplete(arHistograms);
+	}
+
+	/// Drops the trace in progress on this thread when the read callback returns without a publish
+	static void End() {
+		if(IsEnabled()) DoEnd();
+	}
+
+	/// Monotonic time in microseconds, only meaningful as a difference
+	static boost::int64_t Now();
+
+	/**
+		Writes a table of every trace_* histogram in the registry with the
+		count, mean and approximate 50th / 99th percentiles of each stage
+	*/
+	static void WriteReport(const MetricsRegistry& arRegistry, std::ostream& arStream);
+
+private:
+
+	static void DoBegin();
+	static void DoMark(TraceStage aStage);
+	static void DoComplete(TraceHistograms& arHistograms);
+	static void DoEnd();
+
+	static atomic_int64_t msSampleRate;
+	static atomic_int64_t msSampleCount;
+};
+
+/**
+	Per stack histograms that receive path traces are recorded in, one per
+	stage measured from the previous stage plus the total from the read
+*/
+class TraceHistograms
+{
+	friend class LatencyTrace;
+
+public:
+	TraceHistograms(Logger* apLogger);
+
+private:
+	MetricHistogram* mpStages[TS_NUM_STAGES];	// indexed by the stage that ends the interval, TS_READ is unused
+	MetricHistogram* mpTotal;
+};
+
+}
+
+#endif
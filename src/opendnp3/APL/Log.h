@@ -30,6 +30,7 @@
 #include "EventLock.h"
 #include "Uncopyable.h"
 #include "LogEntryCircularBuffer.h"
+#include "Metrics.h"
 
 namespace apl
 {
@@ -65,6 +66,11 @@ public:
 	void Log( const LogEntry& arEntry );
 	void SetVar(const std::string& aSource, const std::string& aVarName, int aValue);
 
+	/// Registry holding the counters, gauges and histograms of every logger
+	MetricsRegistry* GetMetrics() {
+		return &mMetrics;
+	}
+
 private:
 
 	bool SetContains(const std::set<int>& arSet, int aValue);
@@ -77,6 +83,7 @@ private:
 	typedef std::map<ILogBase*, std::set<int> > SubscriberMap;
 	SubscriberMap mSubscribers;
 
+	MetricsRegistry mMetrics;
 };
 
 
@@ -73,6 +73,26 @@ void Logger::Log( FilterLevel aFilterLevel, const std::string& arLocation, const
 	}
 }
 
+MetricCounter* Logger::GetCounter(const std::string& arName, const std::string& arHelp)
+{
+	return mpLog->GetMetrics()->GetCounter(mVarName, arName, arHelp);
+}
+
+MetricGauge* Logger::GetGauge(const std::string& arName, const std::string& arHelp)
+{
+	return mpLog->GetMetrics()->GetGauge(mVarName, arName, arHelp);
+}
+
+MetricHistogram* Logger::GetHistogram(const std::string& arName, const std::string& arHelp)
+{
+	return mpLog->GetMetrics()->GetHistogram(mVarName, arName, arHelp);
+}
+
+MetricsRegistry* Logger::GetMetrics()
+{
+	return mpLog->GetMetrics();
+}
+
 void Logger::Set(const std::string& aVar, int aValue)
 {
 	mpLog->SetVar(mVarName, aVar, aValue);
@@ -26,6 +26,7 @@
 #include "LogEntry.h"
 #include "LogBase.h"
 #include "LogVar.h"
+#include "Metrics.h"
 
 
 namespace apl
@@ -36,7 +37,6 @@ typedef LogVar<int> IntLogVar;
 
 class Logger
 {
-	friend class LogCounter;
 	friend class LogVariable;
 
 public:
@@ -67,6 +67,18 @@ public:
 	Logger* GetSubLogger(std::string aSubName, int aFilterBits);
 	Logger* GetSubLogger(std::string aSubName, FilterLevel aFilter);
 
+	/**
+		Metrics registered against this logger's var name (the stack or port),
+		see MetricsRegistry. Meant to be called once at construction, the
+		returned pointer is then updated without any lookup.
+	*/
+	MetricCounter* GetCounter(const std::string& arName, const std::string& arHelp = "");
+	MetricGauge* GetGauge(const std::string& arName, const std::string& arHelp = "");
+	MetricHistogram* GetHistogram(const std::string& arName, const std::string& arHelp = "");
+
+	/// The registry shared by every logger of the EventLog
+	MetricsRegistry* GetMetrics();
+
 private:
 
 	void Set(const std::string& aVar, int aValue);
@@ -77,24 +89,27 @@ private:
 	std::string			mVarName;
 };
 
+/**
+	Counter backed by the metrics registry, incrementing it is a single
+	relaxed atomic add.
+*/
 class LogCounter
 {
 public:
-	LogCounter(Logger* apLogger, const std::string& arName) :
-		mpLogger(apLogger),
-		mName(arName),
-		mValue(-1) {
-		this->Increment();
+	LogCounter(Logger* apLogger, const std::string& arName, const std::string& arHelp = "") :
+		mpCounter(apLogger->GetCounter(arName, arHelp))
+	{}
+
+	void Increment(boost::int64_t aDelta = 1) {
+		mpCounter->Increment(aDelta);
 	}
 
-	void Increment() {
-		mpLogger->Set(mName, ++mValue);
+	boost::int64_t Get() const {
+		return mpCounter->Get();
 	}
 
 private:
-	Logger* mpLogger;
-	std::string mName;
-	int mValue;
+	MetricCounter* mpCounter;
 };
 
 class LogVariable
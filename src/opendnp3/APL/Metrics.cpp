@@ -0,0 +1,234 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "Metrics.h"
+
+#include "Exception.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+
+namespace apl
+{
+
+const boost::int64_t MetricHistogram::BOUNDS[MetricHistogram::NUM_BUCKETS - 1] =
+{
+	1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000,
+	100000, 200000, 500000, 1000000, 2000000, 5000000, 10000000
+};
+
+void MetricCounter::Read(MetricSample& arSample) const
+{
+	arSample.value = this->Get();
+}
+
+void MetricGauge::Read(MetricSample& arSample) const
+{
+	arSample.value = this->Get();
+}
+
+MetricHistogram::MetricHistogram() : mSum(0)
+{
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) mBuckets[i] = 0;
+}
+
+void MetricHistogram::Observe(boost::int64_t aValue)
+{
+	size_t i = 0;
+	while(i < (NUM_BUCKETS - 1) && aValue > BOUNDS[i]) ++i;
+	AtomicAddRelaxed(&mBuckets[i], 1);
+	AtomicAddRelaxed(&mSum, aValue);
+}
+
+boost::int64_t MetricHistogram::GetCount() const
+{
+	boost::int64_t count = 0;
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) count += this->GetBucket(i);
+	return count;
+}
+
+void MetricHistogram::Read(MetricSample& arSample) const
+{
+	arSample.buckets.resize(NUM_BUCKETS);
+	arSample.value = 0;
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) {
+		arSample.buckets[i] = this->GetBucket(i);
+		arSample.value += arSample.buckets[i];
+	}
+	arSample.sum = this->GetSum();
+}
+
+boost::int64_t MetricHistogram::Percentile(const MetricSample& arSample, size_t aPercent)
+{
+	if(arSample.value == 0) return 0;
+	boost::int64_t target = (arSample.value * aPercent + 99) / 100;
+	boost::int64_t cumulative = 0;
+	for(size_t i = 0; i < arSample.buckets.size() - 1; ++i) {
+		cumulative += arSample.buckets[i];
+		if(cumulative >= target) return BOUNDS[i];
+	}
+	return -1;
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+	for(FamilyMap::iterator i = mFamilies.begin(); i != mFamilies.end(); ++i) {
+		for(std::map<std::string, IMetric*>::iterator j = i->second.metrics.begin(); j != i->second.metrics.end(); ++j) {
+			delete j->second;
+		}
+	}
+}
+
+MetricCounter* MetricsRegistry::GetCounter(const std::string& arSource, const std::string& arName, const std::string& arHelp)
+{
+	return this->Get<MetricCounter>(arSource, arName, arHelp, MT_COUNTER);
+}
+
+MetricGauge* MetricsRegistry::GetGauge(const std::string& arSource, const std::string& arName, const std::string& arHelp)
+{
+	return this->Get<MetricGauge>(arSource, arName, arHelp, MT_GAUGE);
+}
+
+MetricHistogram* MetricsRegistry::GetHistogram(const std::string& arSource, const std::string& arName, const std::string& arHelp)
+{
+	return this->Get<MetricHistogram>(arSource, arName, arHelp, MT_HISTOGRAM);
+}
+
+template <class T>
+T* MetricsRegistry::Get(const std::string& arSource, const std::string& arName, const std::string& arHelp, MetricType aType)
+{
+	CriticalSection cs(&mLock);
+
+	FamilyMap::iterator i = mFamilies.find(arName);
+	if(i == mFamilies.end()) {
+		i = mFamilies.insert(FamilyMap::value_type(arName, Family())).first;
+		i->second.type = aType;
+		i->second.help = arHelp;
+	} else if(i->second.type != aType) {
+		throw ArgumentException(LOCATION, "Metric already registered with a different type: " + arName);
+	}
+
+	IMetric*& pMetric = i->second.metrics[arSource];
+	if(pMetric == NULL) pMetric = new T();
+	return static_cast<T*>(pMetric);
+}
+
+void MetricsRegistry::Snapshot(std::vector<MetricSample>& arSamples) const
+{
+	CriticalSection cs(&mLock);
+	for(FamilyMap::const_iterator i = mFamilies.begin(); i != mFamilies.end(); ++i) {
+		for(std::map<std::string, IMetric*>::const_iterator j = i->second.metrics.begin(); j != i->second.metrics.end(); ++j) {
+			MetricSample s;
+			s.source = j->first;
+			s.name = i->first;
+			s.type = i->second.type;
+			j->second->Read(s);
+			arSamples.push_back(s);
+		}
+	}
+}
+
+namespace
+{
+
+const char* TypeName(MetricType aType)
+{
+	switch(aType) {
+	case(MT_COUNTER): return "counter";
+	case(MT_GAUGE): return "gauge";
+	default: return "histogram";
+	}
+}
+
+// label values may contain anything, names in the registry are trusted
+std::string EscapeLabel(const std::string& arValue)
+{
+	std::string ret;
+	for(size_t i = 0; i < arValue.size(); ++i) {
+		switch(arValue[i]) {
+		case('\\'): ret += "\\\\"; break;
+		case('"'): ret += "\\\""; break;
+		case('\n'): ret += "\\n"; break;
+		default: ret += arValue[i]; break;
+		}
+	}
+	return ret;
+}
+
+}
+
+void MetricsRegistry::WritePrometheus(std::ostream& arStream, const std::string& arPrefix) const
+{
+	std::vector<MetricSample> samples;
+	this->Snapshot(samples);
+
+	std::string family;
+	for(std::vector<MetricSample>::iterator s = samples.begin(); s != samples.end(); ++s) {
+		std::string name = arPrefix + s->name;
+		std::string source = "source=\"" + EscapeLabel(s->source) + "\"";
+
+		if(s->name != family) {
+			family = s->name;
+			std::string help;
+			{
+				CriticalSection cs(&mLock);
+				help = mFamilies.find(family)->second.help;
+			}
+			if(!help.empty()) arStream << "# HELP " << name << " " << help << "\n";
+			arStream << "# TYPE " << name << " " << TypeName(s->type) << "\n";
+		}
+
+		if(s->type == MT_HISTOGRAM) {
+			boost::int64_t cumulative = 0;
+			for(size_t i = 0; i < s->buckets.size(); ++i) {
+				cumulative += s->buckets[i];
+				arStream << name << "_bucket{" << source << ",le=\"";
+				if(i < MetricHistogram::NUM_BUCKETS - 1) arStream << MetricHistogram::BOUNDS[i];
+				else arStream << "+Inf";
+				arStream << "\"} " << cumulative << "\n";
+			}
+			arStream << name << "_sum{" << source << "} " << s->sum << "\n";
+			arStream << name << "_count{" << source << "} " << s->value << "\n";
+		} else {
+			arStream << name << "{" << source << "} " << s->value << "\n";
+		}
+	}
+}
+
+void MetricsRegistry::DumpPrometheus(const std::string& arPath, const std::string& arPrefix) const
+{
+	std::string tmp = arPath + ".tmp";
+	{
+		std::ofstream file(tmp.c_str(), std::ios::out | std::ios::trunc);
+		if(!file) throw Exception(LOCATION, "Unable to open metrics file: " + tmp);
+		this->WritePrometheus(file, arPrefix);
+		if(!file) throw Exception(LOCATION, "Unable to write metrics file: " + tmp);
+	}
+
+#ifdef APL_PLATFORM_WIN
+	std::remove(arPath.c_str()); // rename doesn't replace on windows
+#endif
+
+	if(std::rename(tmp.c_str(), arPath.c_str()) != 0) {
+		throw Exception(LOCATION, "Unable to replace metrics file: " + arPath);
+	}
+}
+
+}
@@ -0,0 +1,219 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __METRICS_H_
+#define __METRICS_H_
+
+#include "AtomicOps.h"
+#include "Lock.h"
+#include "Uncopyable.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace apl
+{
+
+enum MetricType {
+	MT_COUNTER,
+	MT_GAUGE,
+	MT_HISTOGRAM
+};
+
+/**
+	Point in time copy of a single metric
+*/
+struct MetricSample {
+
+	MetricSample() : type(MT_COUNTER), value(0), sum(0)
+	{}
+
+	std::string source;		// stack or port the metric belongs to
+	std::string name;
+	MetricType type;
+	boost::int64_t value;	// the counter or gauge value, or the number of histogram observations
+	boost::int64_t sum;		// histograms only, sum of the observations
+	std::vector<boost::int64_t> buckets; // histograms only, non-cumulative count per bucket
+};
+
+/**
+	Common interface used by the registry to read any metric
+*/
+class IMetric : private Uncopyable
+{
+public:
+	virtual ~IMetric() {}
+
+	virtual MetricType GetType() const = 0;
+	virtual void Read(MetricSample& arSample) const = 0;
+};
+
+/**
+	Monotonically increasing count. Increment() is a single relaxed atomic
+	add, so counters can sit on the frame/APDU path of any thread.
+*/
+class MetricCounter : public IMetric
+{
+public:
+	MetricCounter() : mValue(0) {}
+
+	void Increment(boost::int64_t aDelta = 1) {
+		AtomicAddRelaxed(&mValue, aDelta);
+	}
+
+	boost::int64_t Get() const {
+		return AtomicLoadRelaxed(&mValue);
+	}
+
+	MetricType GetType() const {
+		return MT_COUNTER;
+	}
+	void Read(MetricSample& arSample) const;
+
+private:
+	atomic_int64_t mValue;
+};
+
+/**
+	Value that can go up and down, e.g. the depth of a buffer.
+*/
+class MetricGauge : public IMetric
+{
+public:
+	MetricGauge() : mValue(0) {}
+
+	void Set(boost::int64_t aValue) {
+		AtomicStoreRelaxed(&mValue, aValue);
+	}
+
+	boost::int64_t Get() const {
+		return AtomicLoadRelaxed(&mValue);
+	}
+
+	MetricType GetType() const {
+		return MT_GAUGE;
+	}
+	void Read(MetricSample& arSample) const;
+
+private:
+	atomic_int64_t mValue;
+};
+
+/**
+	Distribution of durations over a fixed 1-2-5 series of buckets, the unit
+	(ms or us) is part of the metric name. Observe() costs a short scan of
+	the bounds and two relaxed atomic adds.
+*/
+class MetricHistogram : public IMetric
+{
+public:
+
+	/// Upper bounds (inclusive) of every bucket but the last, which is unbounded
+	static const boost::int64_t BOUNDS[];
+	static const size_t NUM_BUCKETS = 23;
+
+	MetricHistogram();
+
+	void Observe(boost::int64_t aValue);
+
+	boost::int64_t GetBucket(size_t aIndex) const {
+		return AtomicLoadRelaxed(&mBuckets[aIndex]);
+	}
+
+	boost::int64_t GetSum() const {
+		return AtomicLoadRelaxed(&mSum);
+	}
+
+	boost::int64_t GetCount() const;
+
+	MetricType GetType() const {
+		return MT_HISTOGRAM;
+	}
+	void Read(MetricSample& arSample) const;
+
+	/// @return upper bound of the bucket holding the aPercent percentile of a sample, -1 if it's in the unbounded bucket
+	static boost::int64_t Percentile(const MetricSample& arSample, size_t aPercent);
+
+private:
+	atomic_int64_t mBuckets[NUM_BUCKETS];
+	atomic_int64_t mSum;
+};
+
+/**
+	Owns every metric in the process. Metrics are registered once by name and
+	source (normally the stack or port name) when a component is constructed,
+	then updated through the returned pointer without touching the registry.
+	Pointers stay valid for the lifetime of the registry, so a stack that is
+	removed and re-added under the same name keeps counting where it left off.
+*/
+class MetricsRegistry : private Uncopyable
+{
+public:
+
+	~MetricsRegistry();
+
+	/**
+		Finds or creates a metric
+
+		@param arSource Stack or port that the metric describes
+		@param arName Metric name, lower case with underscores
+		@param arHelp Description for the exporter, only the first registration counts
+		@throw ArgumentException if the name is already registered with a different type
+	*/
+	MetricCounter* GetCounter(const std::string& arSource, const std::string& arName, const std::string& arHelp = "");
+	MetricGauge* GetGauge(const std::string& arSource, const std::string& arName, const std::string& arHelp = "");
+	MetricHistogram* GetHistogram(const std::string& arSource, const std::string& arName, const std::string& arHelp = "");
+
+	/// Appends a sample of every metric ordered by name, then source
+	void Snapshot(std::vector<MetricSample>& arSamples) const;
+
+	/// Writes every metric in the Prometheus text exposition format
+	void WritePrometheus(std::ostream& arStream, const std::string& arPrefix = "opendnp3_") const;
+
+	/**
+		Writes the Prometheus text to a temporary file and renames it over
+		arPath, so a scraper reading the file never sees a partial dump.
+
+		@throw Exception if the file can't be written
+	*/
+	void DumpPrometheus(const std::string& arPath, const std::string& arPrefix = "opendnp3_") const;
+
+private:
+
+	struct Family {
+		Family() : type(MT_COUNTER) {}
+
+		MetricType type;
+		std::string help;
+		std::map<std::string, IMetric*> metrics; // by source
+	};
+
+	template <class T>
+	T* Get(const std::string& arSource, const std::string& arName, const std::string& arHelp, MetricType aType);
+
+	typedef std::map<std::string, Family> FamilyMap;
+
+	mutable SigLock mLock;
+	FamilyMap mFamilies;
+};
+
+}
+
+#endif
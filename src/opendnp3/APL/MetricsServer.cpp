@@ -0,0 +1,130 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "MetricsServer.h"
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+
+#include <sstream>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+using namespace boost::asio;
+
+namespace apl
+{
+
+MetricsServer::MetricsServer(Logger* apLogger, boost::asio::io_service* apIOService, MetricsRegistry* apRegistry, const std::string& arEndpoint, boost::uint16_t aPort) :
+	Loggable(apLogger),
+	mpRegistry(apRegistry),
+	mStopped(false),
+	mLocalEndpoint(ip::tcp::v4(), aPort),
+	mAcceptor(*apIOService),
+	mSocket(*apIOService)
+{
+	boost::system::error_code ec;
+	mLocalEndpoint.address(ip::address::from_string(arEndpoint, ec));
+	if(ec) throw ArgumentException(LOCATION, "endpoint: " + arEndpoint + " is invalid");
+}
+
+void MetricsServer::Start()
+{
+	boost::system::error_code ec;
+	mAcceptor.open(mLocalEndpoint.protocol(), ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	mAcceptor.set_option(ip::tcp::acceptor::reuse_address(true));
+	mAcceptor.bind(mLocalEndpoint, ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	mAcceptor.listen(socket_base::max_connections, ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	LOG_BLOCK(LEV_INFO, "Serving metrics on: " << mLocalEndpoint);
+	this->Accept();
+}
+
+void MetricsServer::Stop()
+{
+	mStopped = true;
+	boost::system::error_code ec;
+	mAcceptor.close(ec);
+	mSocket.close(ec);
+}
+
+void MetricsServer::Accept()
+{
+	mAcceptor.async_accept(mSocket, boost::bind(&MetricsServer::OnAccept, this, placeholders::error));
+}
+
+void MetricsServer::OnAccept(const boost::system::error_code& arErr)
+{
+	if(mStopped) return;
+
+	if(arErr) {
+		LOG_BLOCK(LEV_WARNING, "Error accepting metrics connection: " << arErr.message());
+		this->Accept();
+		return;
+	}
+
+	// read the request first, closing with unread data would reset the connection
+	async_read_until(mSocket, mRequest, "\r\n\r\n", boost::bind(&MetricsServer::OnRequest, this, placeholders::error));
+}
+
+void MetricsServer::OnRequest(const boost::system::error_code& arErr)
+{
+	if(mStopped) return;
+
+	mRequest.consume(mRequest.size());
+	if(arErr) {
+		boost::system::error_code ec;
+		mSocket.close(ec);
+		this->Accept();
+		return;
+	}
+
+	std::ostringstream body;
+	mpRegistry->WritePrometheus(body);
+
+	std::ostringstream oss;
+	oss << "HTTP/1.0 200 OK\r\n";
+	oss << "Content-Type: text/plain; version=0.0.4\r\n";
+	oss << "Content-Length: " << body.str().size() << "\r\n";
+	oss << "Connection: close\r\n\r\n";
+	oss << body.str();
+	mResponse = oss.str();
+
+	async_write(mSocket, buffer(mResponse), boost::bind(&MetricsServer::OnWrite, this, placeholders::error));
+}
+
+void MetricsServer::OnWrite(const boost::system::error_code& arErr)
+{
+	if(mStopped) return;
+
+	if(arErr) LOG_BLOCK(LEV_WARNING, "Error writing metrics: " << arErr.message());
+
+	boost::system::error_code ec;
+	mSocket.shutdown(ip::tcp::socket::shutdown_both, ec);
+	mSocket.close(ec);
+	this->Accept();
+}
+
+}
@@ -0,0 +1,78 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __METRICS_SERVER_H_
+#define __METRICS_SERVER_H_
+
+#include "Loggable.h"
+#include "Uncopyable.h"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <string>
+
+namespace apl
+{
+
+class MetricsRegistry;
+
+/**
+	Minimal HTTP endpoint for Prometheus scrapers. Every request receives the
+	registry in the text exposition format and the connection is then closed,
+	whatever the path was. Connections are served one at a time on the
+	io_service.
+*/
+class MetricsServer : private Loggable, private Uncopyable
+{
+public:
+
+	MetricsServer(Logger* apLogger, boost::asio::io_service* apIOService, MetricsRegistry* apRegistry, const std::string& arEndpoint, boost::uint16_t aPort);
+
+	/**
+		Binds the endpoint and starts accepting connections
+
+		@throw Exception if the endpoint can't be bound
+	*/
+	void Start();
+
+	/// Closes the acceptor and any connection, must be called from the io_service thread
+	void Stop();
+
+private:
+
+	void Accept();
+	void OnAccept(const boost::system::error_code& arErr);
+	void OnRequest(const boost::system::error_code& arErr);
+	void OnWrite(const boost::system::error_code& arErr);
+
+	MetricsRegistry* mpRegistry;
+	bool mStopped;
+	boost::asio::streambuf mRequest;
+	std::string mResponse;
+
+	boost::asio::ip::tcp::endpoint mLocalEndpoint;
+	boost::asio::ip::tcp::acceptor mAcceptor;
+	boost::asio::ip::tcp::socket mSocket;
+};
+
+}
+
+#endif
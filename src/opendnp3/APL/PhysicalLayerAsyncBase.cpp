@@ -21,6 +21,8 @@
 #include "IHandlerAsync.h"
 #include "Logger.h"
 #include "Exception.h"
+#include "LatencyTrace.h"
+#include "CaptureFile.h"
 
 #include <sstream>
 
@@ -121,7 +123,8 @@ std::string PhysicalLayerAsyncBase::State::ConvertStateToString() const
 
 PhysicalLayerAsyncBase::PhysicalLayerAsyncBase(Logger* apLogger) :
 	Loggable(apLogger),
-	mpHandler(NULL)
+	mpHandler(NULL),
+	mpCapture(NULL)
 {
 
 }
@@ -164,6 +167,7 @@ void PhysicalLayerAsyncBase::AsyncWrite(const boost::uint8_t* apBuff, size_t aNu
 
 	if(mState.CanWrite()) {
 		mState.mWriting = true;
+		if(mpCapture) mpCapture->Record(CD_WRITE, apBuff, aNumBytes);
 		this->DoAsyncWrite(apBuff, aNumBytes);
 	} else throw InvalidStateException(LOCATION, "AsyncWrite: " + this->ConvertStateToString());
 }
@@ -220,7 +224,10 @@ void PhysicalLayerAsyncBase::OnReadCallback(const boost::system::error_code& arE
 			if(mState.mClosing) {
 				LOG_BLOCK(LEV_DEBUG, "Ignoring received bytes since layer is closing: " << aSize);
 			} else {
+				if(mpCapture) mpCapture->Record(CD_READ, apBuff, aSize);
+				LatencyTrace::Begin();
 				this->DoReadCallback(apBuff, aSize);
+				LatencyTrace::End();
 			}
 		}
 
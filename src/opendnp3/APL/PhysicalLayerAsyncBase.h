@@ -28,6 +28,7 @@ namespace apl
 {
 
 class PLAS_Base;
+class CaptureWriter;
 
 // This is the base class for the new async physical layers. It assumes that all of the functions
 // are called from a single thread.
@@ -115,6 +116,15 @@ public:
 	// Not an event delegated to the states
 	void SetHandler(IHandlerAsync* apHandler);
 
+	/**
+		Records every completed read and every write to a capture, NULL stops
+		recording. The writer isn't owned and must outlive the recording.
+		Must be called from the io_service thread or while it's paused.
+	*/
+	void SetCapture(CaptureWriter* apCapture) {
+		mpCapture = apCapture;
+	}
+
 	/* Actions taken by the states - These must be implemented by the concrete
 	classes inherited from this class */
 	virtual void DoOpen() = 0;
@@ -155,6 +165,8 @@ protected:
 private:
 
 	void StartClose();
+
+	CaptureWriter* mpCapture;
 };
 
 inline void PhysicalLayerAsyncBase::SetHandler(IHandlerAsync* apHandler)
@@ -26,8 +26,13 @@
 
 #include "Exception.h"
 #include "IHandlerAsync.h"
+#include "IoUringService.h"
 #include "Logger.h"
 
+#ifdef APL_HAS_IO_URING
+#include <unistd.h>
+#endif
+
 using namespace boost;
 using namespace boost::asio;
 using namespace boost::system;
@@ -43,16 +48,47 @@ PhysicalLayerAsyncBaseTCP::PhysicalLayerAsyncBaseTCP(Logger* apLogger, boost::as
 	//mSocket.set_option(ip::tcp::no_delay(true));
 }
 
+PhysicalLayerAsyncBaseTCP::~PhysicalLayerAsyncBaseTCP()
+{
+
+}
+
+void PhysicalLayerAsyncBaseTCP::SetIoUring(IoUringService* apUring)
+{
+#ifdef APL_HAS_IO_URING
+	assert(this->IsClosed());
+	if(apUring == NULL) mpUringSocket.reset();
+	else mpUringSocket.reset(new IoUringSocket(apUring, mpService,
+		                         boost::bind(&PhysicalLayerAsyncBaseTCP::OnReadCallback, this, _1, _2, _3),
+		                         boost::bind(&PhysicalLayerAsyncBaseTCP::OnWriteCallback, this, _1, _2)));
+#else
+	if(apUring != NULL) throw ArgumentException(LOCATION, "io_uring isn't available on this platform");
+#endif
+}
+
 /* Implement the actions */
 
 void PhysicalLayerAsyncBaseTCP::DoClose()
 {
+#ifdef APL_HAS_IO_URING
+	if(mpUringSocket.get() != NULL && mpUringSocket->IsOpen()) {
+		mpUringSocket->Close();
+		return;
+	}
+#endif
 	this->ShutdownSocket();
 	this->CloseSocket();
 }
 
 void PhysicalLayerAsyncBaseTCP::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
 {
+#ifdef APL_HAS_IO_URING
+	if(mpUringSocket.get() != NULL) {
+		this->StartIoUring();
+		mpUringSocket->AsyncRead(apBuffer, aMaxBytes);
+		return;
+	}
+#endif
 	mSocket.async_read_some(buffer(apBuffer, aMaxBytes),
 	                        boost::bind(&PhysicalLayerAsyncBaseTCP::OnReadCallback,
 	                                    this,
@@ -63,6 +99,13 @@ void PhysicalLayerAsyncBaseTCP::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMa
 
 void PhysicalLayerAsyncBaseTCP::DoAsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
 {
+#ifdef APL_HAS_IO_URING
+	if(mpUringSocket.get() != NULL) {
+		this->StartIoUring();
+		mpUringSocket->AsyncWrite(apBuffer, aNumBytes);
+		return;
+	}
+#endif
 	async_write(mSocket, buffer(apBuffer, aNumBytes),
 	            boost::bind(&PhysicalLayerAsyncBaseTCP::OnWriteCallback,
 	                        this,
@@ -92,6 +135,19 @@ void PhysicalLayerAsyncBaseTCP::ShutdownSocket()
 	if(ec) LOG_BLOCK(LEV_WARNING, "Error while shutting down socket: " << ec.message());
 }
 
+#ifdef APL_HAS_IO_URING
+void PhysicalLayerAsyncBaseTCP::StartIoUring()
+{
+	if(mpUringSocket->IsOpen()) return;
+
+	// closing the asio socket removes it from epoll, the duplicate keeps the connection open
+	int fd = dup(mSocket.native_handle());
+	if(fd < 0) throw Exception(LOCATION, "Unable to duplicate socket for io_uring");
+	this->CloseSocket();
+	mpUringSocket->Open(fd);
+}
+#endif
+
 boost::asio::ip::address PhysicalLayerAsyncBaseTCP::ResolveAddress(const std::string& arEndpoint)
 {
 	try {
@@ -20,6 +20,7 @@
 #define __PHYSICAL_LAYER_ASYNC_BASE_TCP_H_
 
 #include "PhysicalLayerAsyncASIO.h"
+#include "IoUringSocket.h"
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <memory>
@@ -27,6 +28,8 @@
 namespace apl
 {
 
+class IoUringService;
+
 /**
 Common socket object and some shared implementations for server/client.
 */
@@ -35,7 +38,15 @@ class PhysicalLayerAsyncBaseTCP : public PhysicalLayerAsyncASIO
 public:
 	PhysicalLayerAsyncBaseTCP(Logger*, boost::asio::io_service* apIOService);
 
-	virtual ~PhysicalLayerAsyncBaseTCP() {}
+	virtual ~PhysicalLayerAsyncBaseTCP();
+
+	/**
+		Reads and writes through apUring instead of the asio reactor once
+		the socket is connected, NULL goes back to asio. Must be set while
+		the layer is closed. Connecting and accepting always use asio.
+		@throw ArgumentException if io_uring isn't available on this platform
+	*/
+	void SetIoUring(IoUringService* apUring);
 
 	/* Implement the shared client/server actions */
 	void DoClose();
@@ -43,15 +54,23 @@ public:
 	void DoAsyncWrite(const boost::uint8_t*, size_t);
 	void DoOpenFailure();
 
+	/// @return the address of a dotted quad or host name, @throw ArgumentException if it can't be resolved
+	static boost::asio::ip::address ResolveAddress(const std::string& arEndpoint);
+
 protected:
 	boost::asio::ip::tcp::socket mSocket;
 	void CloseSocket();
 
-	boost::asio::ip::address ResolveAddress(const std::string& arEndpoint);
-
 private:
 	void ShutdownSocket();
 
+#ifdef APL_HAS_IO_URING
+	/// Hands the connected socket over to the ring, so it's no longer registered with the reactor
+	void StartIoUring();
+
+	std::auto_ptr<IoUringSocket> mpUringSocket;
+#endif
+
 };
 }
 
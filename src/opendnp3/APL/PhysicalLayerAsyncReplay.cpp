@@ -0,0 +1,120 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "PhysicalLayerAsyncReplay.h"
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+
+#include <cstring>
+
+#include "LatencyTrace.h"
+#include "Logger.h"
+
+using namespace boost;
+using namespace boost::asio;
+
+namespace apl
+{
+
+PhysicalLayerAsyncReplay::PhysicalLayerAsyncReplay(Logger* apLogger, boost::asio::io_service* apService, const std::string& arPath, bool aRealTime) :
+	PhysicalLayerAsyncASIO(apLogger, apService),
+	mIndex(0),
+	mOffset(0),
+	mRealTime(aRealTime),
+	mOrigin(0),
+	mTimer(*apService)
+{
+	CaptureReader reader(arPath);
+	CaptureRecord rec;
+	while(reader.Next(rec)) {
+		if(rec.direction == CD_READ && rec.data.Size() > 0) mReads.push_back(rec);
+	}
+	LOG_BLOCK(LEV_INFO, "Loaded " << mReads.size() << " reads from: " << arPath);
+}
+
+void PhysicalLayerAsyncReplay::DoOpen()
+{
+	system::error_code ec;
+	if(this->IsFinished()) ec = error::eof;
+	else mOrigin = LatencyTrace::Now() - mReads[mIndex].time;
+
+	mpService->post(boost::bind(&PhysicalLayerAsyncReplay::OnOpenCallback, this, ec));
+}
+
+void PhysicalLayerAsyncReplay::DoClose()
+{
+	system::error_code ec;
+	mTimer.cancel(ec);
+}
+
+void PhysicalLayerAsyncReplay::DoAsyncRead(boost::uint8_t* apBuff, size_t aMaxBytes)
+{
+	if(this->IsFinished()) {
+		system::error_code ec = error::eof;
+		mpService->post(boost::bind(&PhysicalLayerAsyncReplay::OnReadCallback, this, ec, apBuff, 0));
+		return;
+	}
+
+	boost::int64_t delay = mRealTime ? (mOrigin + mReads[mIndex].time - LatencyTrace::Now()) : 0;
+
+	if(mOffset > 0 || delay <= 0) {
+		mpService->post(boost::bind(&PhysicalLayerAsyncReplay::Deliver, this, apBuff, aMaxBytes));
+	} else {
+		mTimer.expires_from_now(posix_time::microseconds(delay));
+		mTimer.async_wait(boost::bind(&PhysicalLayerAsyncReplay::OnTimer, this, boost::asio::placeholders::error, apBuff, aMaxBytes));
+	}
+}
+
+void PhysicalLayerAsyncReplay::DoAsyncWrite(const boost::uint8_t*, size_t aNumBytes)
+{
+	mpService->post(boost::bind(&PhysicalLayerAsyncReplay::OnWriteCallback, this, system::error_code(), aNumBytes));
+}
+
+void PhysicalLayerAsyncReplay::OnTimer(const boost::system::error_code& arErr, boost::uint8_t* apBuff, size_t aMaxBytes)
+{
+	if(arErr) this->OnReadCallback(arErr, apBuff, 0);
+	else this->Deliver(apBuff, aMaxBytes);
+}
+
+void PhysicalLayerAsyncReplay::Deliver(boost::uint8_t* apBuff, size_t aMaxBytes)
+{
+	const CaptureRecord& rec = mReads[mIndex];
+	size_t num = rec.data.Size() - mOffset;
+	if(num > aMaxBytes) num = aMaxBytes;
+
+	memcpy(apBuff, rec.data.Buffer() + mOffset, num);
+	mOffset += num;
+	if(mOffset == rec.data.Size()) {
+		mOffset = 0;
+		++mIndex;
+	}
+
+	this->OnReadCallback(system::error_code(), apBuff, num);
+
+	if(this->IsFinished() && mOffset == 0 && mFinishedHandler) {
+		LOG_BLOCK(LEV_INFO, "Replay finished after " << mReads.size() << " reads");
+		FunctionVoidZero handler = mFinishedHandler;
+		mFinishedHandler.clear();
+		handler();
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,90 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_REPLAY_H_
+#define __PHYSICAL_LAYER_ASYNC_REPLAY_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+#include "CaptureFile.h"
+#include "Function.h"
+
+#include <boost/asio/deadline_timer.hpp>
+
+#include <vector>
+
+namespace apl
+{
+
+/**
+	Plays back the reads of a capture file made with
+	PhysicalLayerAsyncBase::SetCapture(). Every read completes with the next
+	captured read, either as soon as it's requested or at the same offset from
+	the open as it was recorded. Writes always succeed and are discarded.
+
+	Once the capture is exhausted the next read fails with eof and the layer
+	can't be opened again.
+*/
+class PhysicalLayerAsyncReplay : public PhysicalLayerAsyncASIO
+{
+public:
+
+	/**
+		@param arPath Capture to replay, loaded completely by the constructor
+		@param aRealTime If true reads complete at the recorded timing, otherwise as fast as possible
+		@throw Exception if the capture can't be read
+	*/
+	PhysicalLayerAsyncReplay(Logger* apLogger, boost::asio::io_service* apService, const std::string& arPath, bool aRealTime);
+
+	/// Called from the io_service when the last captured read has been delivered
+	void SetFinishedHandler(const FunctionVoidZero& arHandler) {
+		mFinishedHandler = arHandler;
+	}
+
+	size_t NumReads() const {
+		return mReads.size();
+	}
+	size_t NumReplayed() const {
+		return mIndex;
+	}
+	bool IsFinished() const {
+		return mIndex == mReads.size();
+	}
+
+	/* Implement the actions */
+	void DoOpen();
+	void DoClose();
+	void DoAsyncRead(boost::uint8_t*, size_t);
+	void DoAsyncWrite(const boost::uint8_t*, size_t);
+
+private:
+
+	void OnTimer(const boost::system::error_code& arErr, boost::uint8_t* apBuff, size_t aMaxBytes);
+	void Deliver(boost::uint8_t* apBuff, size_t aMaxBytes);
+
+	std::vector<CaptureRecord> mReads;
+	size_t mIndex;
+	size_t mOffset;			// bytes of the current read already delivered to a smaller buffer
+	bool mRealTime;
+	boost::int64_t mOrigin;	// LatencyTrace::Now() that the capture's time 0 maps to
+	boost::asio::deadline_timer mTimer;
+	FunctionVoidZero mFinishedHandler;
+};
+
+}
+
+#endif
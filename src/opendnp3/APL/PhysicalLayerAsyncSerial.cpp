@@ -24,11 +24,19 @@
 #include <boost/asio.hpp>
 #include <string>
 
+#include "Configure.h"
 #include "Exception.h"
 #include "IHandlerAsync.h"
 #include "Logger.h"
 #include "ASIOSerialHelpers.h"
 
+#ifndef APL_PLATFORM_WIN
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 using namespace boost;
 using namespace boost::asio;
 using namespace boost::system;
@@ -45,15 +53,46 @@ PhysicalLayerAsyncSerial::PhysicalLayerAsyncSerial(
 	PhysicalLayerAsyncASIO(apLogger, apIOService),
 	mSettings(arSettings),
 	mpService(apIOService),
-	mPort(*apIOService)
+	mPort(*apIOService),
+	mpReadBuffer(NULL),
+	mReadSize(0),
+	mNeeded(0),
+	mMinChars(0),
+	mLastAvailable(0),
+	mGapDetected(false),
+	mGapTimer(*apIOService),
+	mTurnaroundTimer(*apIOService),
+	mReads(apLogger, "serial_reads", "Reads completed by the serial port"),
+	mGaps(apLogger, "serial_gaps", "Framed reads ended early by a gap on the line")
 {
+#ifdef APL_PLATFORM_WIN
+	if(mSettings.mReadMode == READ_FRAMED) {
+		LOG_BLOCK(LEV_WARNING, "Framed reads need termios, reading as a stream");
+		mSettings.mReadMode = READ_STREAM;
+	}
+#endif
+}
 
+posix_time::time_duration PhysicalLayerAsyncSerial::CharTime() const
+{
+	boost::int64_t bits = 1 + mSettings.mDataBits + mSettings.mStopBits + ((mSettings.mParity == PAR_NONE) ? 0 : 1);
+	boost::int64_t baud = (mSettings.mBaud > 0) ? mSettings.mBaud : 1;
+	return posix_time::microseconds((1000000 * bits + baud - 1) / baud);
+}
+
+posix_time::time_duration PhysicalLayerAsyncSerial::InterCharGap() const
+{
+	if(mSettings.mInterCharGap > 0) return posix_time::milliseconds(mSettings.mInterCharGap);
+	return this->CharTime() * 4;
 }
 
 /* Implement the actions */
 
 void PhysicalLayerAsyncSerial::DoOpen()
 {
+	mMinChars = 0;
+	mLastRead = posix_time::ptime();
+
 	boost::system::error_code ec;
 	mPort.open(mSettings.mDevice, ec);
 
@@ -65,6 +104,10 @@ void PhysicalLayerAsyncSerial::DoOpen()
 
 void PhysicalLayerAsyncSerial::DoClose()
 {
+	boost::system::error_code ignored;
+	mGapTimer.cancel(ignored);
+	mTurnaroundTimer.cancel(ignored);
+
 	boost::system::error_code ec;
 	mPort.close(ec);
 	if(ec) LOG_BLOCK(LEV_WARNING, ec.message());
@@ -77,8 +120,20 @@ void PhysicalLayerAsyncSerial::DoOpenSuccess()
 
 void PhysicalLayerAsyncSerial::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
 {
+	if(mSettings.mReadMode == READ_FRAMED) {
+		size_t needed = mpHandler ? mpHandler->NumBytesToFrameEnd() : 0;
+		if(needed == 0 || needed > aMaxBytes) needed = aMaxBytes;
+
+		mpReadBuffer = apBuffer;
+		mReadSize = aMaxBytes;
+		mNeeded = (needed < MAX_FRAMED_READ) ? needed : MAX_FRAMED_READ;
+		mGapDetected = false;
+		this->WaitForFrame();
+		return;
+	}
+
 	mPort.async_read_some(buffer(apBuffer, aMaxBytes),
-	                      boost::bind(&PhysicalLayerAsyncSerial::OnReadCallback,
+	                      boost::bind(&PhysicalLayerAsyncSerial::OnRead,
 	                                  this,
 	                                  boost::asio::placeholders::error,
 	                                  apBuffer,
@@ -86,6 +141,34 @@ void PhysicalLayerAsyncSerial::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMax
 }
 
 void PhysicalLayerAsyncSerial::DoAsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	// a half duplex line needs the other end to have stopped driving it before we start
+	if(mSettings.mTurnaround > 0 && !mLastRead.is_not_a_date_time()) {
+		posix_time::ptime start = mLastRead + posix_time::milliseconds(mSettings.mTurnaround);
+		if(start > posix_time::microsec_clock::universal_time()) {
+			mTurnaroundTimer.expires_at(start);
+			mTurnaroundTimer.async_wait(boost::bind(&PhysicalLayerAsyncSerial::OnTurnaround,
+			                                        this,
+			                                        boost::asio::placeholders::error,
+			                                        apBuffer,
+			                                        aNumBytes));
+			return;
+		}
+	}
+
+	this->StartWrite(apBuffer, aNumBytes);
+}
+
+void PhysicalLayerAsyncSerial::OnRead(const boost::system::error_code& arErr, boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	if(!arErr) {
+		mReads.Increment();
+		mLastRead = posix_time::microsec_clock::universal_time();
+	}
+	this->OnReadCallback(arErr, apBuffer, aNumBytes);
+}
+
+void PhysicalLayerAsyncSerial::StartWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
 {
 	async_write(mPort, buffer(apBuffer, aNumBytes),
 	            boost::bind(&PhysicalLayerAsyncSerial::OnWriteCallback,
@@ -94,6 +177,113 @@ void PhysicalLayerAsyncSerial::DoAsyncWrite(const boost::uint8_t* apBuffer, size
 	                        aNumBytes));
 }
 
+void PhysicalLayerAsyncSerial::OnTurnaround(const boost::system::error_code& arErr, const boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	if(arErr) this->OnWriteCallback(arErr, 0);
+	else this->StartWrite(apBuffer, aNumBytes);
+}
+
+void PhysicalLayerAsyncSerial::WaitForFrame()
+{
+	size_t available = this->NumAvailable();
+	if(available >= mNeeded) {
+		// the port won't signal for bytes that are already waiting, and reads never complete from inside DoAsyncRead
+		mpService->post(boost::bind(&PhysicalLayerAsyncSerial::CompleteFramedRead, this));
+		return;
+	}
+
+	mLastAvailable = available;
+	this->SetMinChars(mNeeded);
+	this->StartGapTimer(mNeeded - available);
+	mPort.async_read_some(null_buffers(),
+	                      boost::bind(&PhysicalLayerAsyncSerial::OnReadable,
+	                                  this,
+	                                  boost::asio::placeholders::error));
+}
+
+void PhysicalLayerAsyncSerial::StartGapTimer(size_t aNumChars)
+{
+	mGapTimer.expires_from_now(this->CharTime() * static_cast<int>(aNumChars) + this->InterCharGap());
+	mGapTimer.async_wait(boost::bind(&PhysicalLayerAsyncSerial::OnGapTimeout, this, boost::asio::placeholders::error));
+}
+
+void PhysicalLayerAsyncSerial::OnReadable(const boost::system::error_code& arErr)
+{
+	boost::system::error_code ignored;
+	mGapTimer.cancel(ignored);
+
+	if(arErr) {
+		boost::uint8_t* pBuffer = mpReadBuffer;
+		mpReadBuffer = NULL;
+		this->OnReadCallback(arErr, pBuffer, 0);
+		return;
+	}
+
+	size_t available = this->NumAvailable();
+	if(available >= mNeeded || (available > 0 && mGapDetected)) this->CompleteFramedRead();
+	else this->WaitForFrame(); // the first byte arrived on an idle line
+}
+
+void PhysicalLayerAsyncSerial::OnGapTimeout(const boost::system::error_code& arErr)
+{
+	// ignore expiries that were already queued when the timer was cancelled or restarted
+	if(arErr || mpReadBuffer == NULL || mGapTimer.expires_at() > posix_time::microsec_clock::universal_time()) return;
+
+	size_t available = this->NumAvailable();
+	if(available == 0) {
+		// nothing has started arriving, so wait for the first byte instead of polling an idle line
+		this->SetMinChars(1);
+	} else if(available == mLastAvailable) {
+		// the line went quiet part way through, dropping VMIN wakes the pending wait
+		mGapDetected = true;
+		this->SetMinChars(1);
+	} else if(available < mNeeded) {
+		mLastAvailable = available;
+		this->StartGapTimer(mNeeded - available);
+	}
+}
+
+void PhysicalLayerAsyncSerial::CompleteFramedRead()
+{
+	if(mGapDetected) mGaps.Increment();
+
+	boost::uint8_t* pBuffer = mpReadBuffer;
+	mpReadBuffer = NULL;
+
+	// bytes are waiting, so this doesn't block
+	boost::system::error_code ec;
+	size_t num = mPort.read_some(buffer(pBuffer, mReadSize), ec);
+	this->OnRead(ec, pBuffer, num);
+}
+
+size_t PhysicalLayerAsyncSerial::NumAvailable()
+{
+#ifndef APL_PLATFORM_WIN
+	int num = 0;
+	if(ioctl(mPort.native_handle(), FIONREAD, &num) == 0 && num > 0) return static_cast<size_t>(num);
+#endif
+	return 0;
+}
+
+void PhysicalLayerAsyncSerial::SetMinChars(size_t aNumChars)
+{
+#ifndef APL_PLATFORM_WIN
+	if(aNumChars == mMinChars) return;
+
+	termios tio;
+	int fd = mPort.native_handle();
+	if(tcgetattr(fd, &tio) == 0) {
+		tio.c_cc[VMIN] = static_cast<cc_t>(aNumChars);
+		tio.c_cc[VTIME] = 0;
+		if(tcsetattr(fd, TCSANOW, &tio) == 0) {
+			mMinChars = aNumChars;
+			return;
+		}
+	}
+	LOG_BLOCK(LEV_WARNING, "Unable to set VMIN: " << strerror(errno));
+#endif
+}
+
 }
 
 /* vim: set ts=4 sw=4: */
@@ -21,7 +21,10 @@
 
 #include "PhysicalLayerAsyncASIO.h"
 #include "SerialTypes.h"
+#include "Logger.h"
+
 #include <boost/asio/serial_port.hpp>
+#include <boost/asio/deadline_timer.hpp>
 
 #include <memory>
 
@@ -29,6 +32,13 @@ namespace apl
 {
 
 /** Serial implementation of PhysicalLayerAsyncASIO
+
+	With READ_FRAMED, a read waits for the bytes the handler needs to finish
+	the frame it's parsing, see IHandlerAsync::NumBytesToFrameEnd(). Termios
+	VMIN keeps the port from waking until they've arrived, so a frame costs
+	one callback instead of one every few characters. A silence of
+	SerialSettings::mInterCharGap completes the read early with whatever
+	arrived, which is how truncated frames and line noise get through.
 */
 class PhysicalLayerAsyncSerial : public PhysicalLayerAsyncASIO
 {
@@ -43,11 +53,48 @@ public:
 
 	void DoOpen();
 
+	/// Time a character takes on the line at the configured settings
+	boost::posix_time::time_duration CharTime() const;
+
+	/// The silence that ends a framed read, mInterCharGap or 4 character times
+	boost::posix_time::time_duration InterCharGap() const;
+
 protected:
 
 	SerialSettings mSettings;
 	boost::asio::io_service* mpService;
 	boost::asio::serial_port mPort;
+
+private:
+
+	/// VMIN is a cc_t, so a framed read waits for at most this many bytes
+	static const size_t MAX_FRAMED_READ = 255;
+
+	void OnRead(const boost::system::error_code& arErr, boost::uint8_t* apBuffer, size_t aNumBytes);
+	void StartWrite(const boost::uint8_t* apBuffer, size_t aNumBytes);
+	void OnTurnaround(const boost::system::error_code& arErr, const boost::uint8_t* apBuffer, size_t aNumBytes);
+
+	void WaitForFrame();
+	void StartGapTimer(size_t aNumChars);
+	void OnReadable(const boost::system::error_code& arErr);
+	void OnGapTimeout(const boost::system::error_code& arErr);
+	void CompleteFramedRead();
+	size_t NumAvailable();
+	void SetMinChars(size_t aNumChars);
+
+	boost::uint8_t* mpReadBuffer;
+	size_t mReadSize;
+	size_t mNeeded;				// bytes the framed read in progress waits for
+	size_t mMinChars;			// VMIN last set on the port, 0 if unknown
+	size_t mLastAvailable;		// bytes waiting at the last gap check
+	bool mGapDetected;
+	boost::posix_time::ptime mLastRead;
+
+	boost::asio::deadline_timer mGapTimer;
+	boost::asio::deadline_timer mTurnaroundTimer;
+
+	LogCounter mReads;
+	LogCounter mGaps;
 };
 }
 
@@ -0,0 +1,375 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "PhysicalLayerAsyncSharedMemory.h"
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#include <boost/bind.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <cstdio>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "SharedByteRing.h"
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::interprocess;
+
+namespace apl
+{
+
+namespace
+{
+
+const boost::uint8_t READY = 0x00;
+const boost::uint8_t WAKEUP = 0x01;
+
+void IgnoreSent(const boost::system::error_code&) {}
+
+}
+
+PhysicalLayerAsyncSharedMemory::PhysicalLayerAsyncSharedMemory(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName, bool aServer, size_t aCapacity) :
+	PhysicalLayerAsyncASIO(apLogger, apIOService),
+	mEndpoint(GetSocketPath(arName)),
+	mAcceptor(*apIOService),
+	mSocket(*apIOService),
+	mName(arName),
+	mServer(aServer),
+	mCapacity(aCapacity),
+	mConnected(false),
+	mpReadBuffer(NULL),
+	mReadMax(0),
+	mpWriteBuffer(NULL),
+	mWriteSize(0),
+	mWritten(0),
+	mPumpPosted(false),
+	mWakeupSending(false),
+	mWakeupAgain(false),
+	mNumWakeups(0)
+{
+	if(mCapacity == 0) throw ArgumentException(LOCATION, "Ring capacity must be > 0");
+}
+
+PhysicalLayerAsyncSharedMemory::~PhysicalLayerAsyncSharedMemory()
+{
+	mpTx.reset();
+	mpRx.reset();
+	mpRegion.reset();
+	if(mServer) {
+		shared_memory_object::remove(mName.c_str());
+		std::remove(mEndpoint.path().c_str());
+	}
+}
+
+std::string PhysicalLayerAsyncSharedMemory::GetSocketPath(const std::string& arName)
+{
+	return "/tmp/opendnp3-" + arName + ".sock";
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncSharedMemory::DoOpen()
+{
+	if(!mServer) {
+		mSocket.async_connect(mEndpoint, boost::bind(&PhysicalLayerAsyncSharedMemory::OnConnect, this, boost::asio::placeholders::error));
+		return;
+	}
+
+	if(mpRegion.get() == NULL) this->CreateSegment();
+
+	if(!mAcceptor.is_open()) {
+		system::error_code ec;
+		std::remove(mEndpoint.path().c_str()); // left behind by a previous listener
+		mAcceptor.open(mEndpoint.protocol(), ec);
+		if(ec) throw Exception(LOCATION, ec.message());
+
+		mAcceptor.bind(mEndpoint, ec);
+		if(ec) throw Exception(LOCATION, ec.message());
+
+		mAcceptor.listen(socket_base::max_connections, ec);
+		if(ec) throw Exception(LOCATION, ec.message());
+	}
+
+	mAcceptor.async_accept(mSocket, boost::bind(&PhysicalLayerAsyncSharedMemory::OnAccept, this, boost::asio::placeholders::error));
+}
+
+void PhysicalLayerAsyncSharedMemory::DoOpeningClose()
+{
+	system::error_code ec;
+	mAcceptor.close(ec);
+	this->CloseSocket();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, (mServer ? "Accepted client of: " : "Connected to: ") << mName);
+	mConnected = true;
+	mPeerError = system::error_code();
+	mWakeupSending = false;
+	mWakeupAgain = false;
+	this->StartWakeupRead();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoOpenFailure()
+{
+	this->CloseSocket();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoClose()
+{
+	mConnected = false;
+
+	system::error_code ec;
+	mSocket.shutdown(local::stream_protocol::socket::shutdown_both, ec);
+	this->CloseSocket();
+
+	// posted after the socket's aborted completions so those run first
+	if(mpReadBuffer != NULL) {
+		mpService->post(boost::bind(&PhysicalLayerAsyncSharedMemory::OnReadCallback, this, system::error_code(error::operation_aborted), mpReadBuffer, 0));
+		mpReadBuffer = NULL;
+	}
+	if(mpWriteBuffer != NULL) {
+		mpService->post(boost::bind(&PhysicalLayerAsyncSharedMemory::OnWriteCallback, this, system::error_code(error::operation_aborted), 0));
+		mpWriteBuffer = NULL;
+	}
+}
+
+void PhysicalLayerAsyncSharedMemory::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
+{
+	mpReadBuffer = apBuffer;
+	mReadMax = aMaxBytes;
+	this->PostPump();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoAsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	mpWriteBuffer = apBuffer;
+	mWriteSize = aNumBytes;
+
+	// copy what fits right away, like a socket's speculative write, the callback is still posted
+	mWritten = mpTx->Write(apBuffer, aNumBytes);
+	if(mWritten > 0 && mpTx->TakeReader()) this->SendWakeup();
+
+	this->PostPump();
+}
+
+/* Helpers */
+
+void PhysicalLayerAsyncSharedMemory::CreateSegment()
+{
+	size_t size = 2 * SharedByteRing::GetRequiredSize(mCapacity);
+
+	try {
+		shared_memory_object::remove(mName.c_str());
+		shared_memory_object shm(create_only, mName.c_str(), read_write);
+		shm.truncate(static_cast<offset_t>(size));
+		mpRegion.reset(new mapped_region(shm, read_write, 0, size));
+	} catch(const interprocess_exception& ex) {
+		throw Exception(LOCATION, "Unable to create shared memory segment " + mName + ": " + ex.what());
+	}
+}
+
+void PhysicalLayerAsyncSharedMemory::MapRings(bool aFormat)
+{
+	mpTx.reset();
+	mpRx.reset();
+
+	if(!mServer) {
+		mpRegion.reset();
+		try {
+			shared_memory_object shm(open_only, mName.c_str(), read_write);
+			mpRegion.reset(new mapped_region(shm, read_write));
+		} catch(const interprocess_exception& ex) {
+			throw Exception(LOCATION, "Unable to open shared memory segment " + mName + ": " + ex.what());
+		}
+	}
+
+	// the server writes the first ring and the client the second
+	boost::uint8_t* pBase = reinterpret_cast<boost::uint8_t*>(mpRegion->get_address());
+	size_t size = mpRegion->get_size();
+	if(aFormat) SharedByteRing::Format(pBase, mCapacity);
+	std::auto_ptr<SharedByteRing> pFirst(new SharedByteRing(pBase, size));
+
+	size_t offset = pFirst->Size();
+	if(offset > size) throw Exception(LOCATION, "Shared memory segment is too small: " + mName);
+	if(aFormat) SharedByteRing::Format(pBase + offset, mCapacity);
+	std::auto_ptr<SharedByteRing> pSecond(new SharedByteRing(pBase + offset, size - offset));
+
+	mpTx = mServer ? pFirst : pSecond;
+	mpRx = mServer ? pSecond : pFirst;
+}
+
+void PhysicalLayerAsyncSharedMemory::CloseSocket()
+{
+	system::error_code ec;
+	mSocket.close(ec);
+	if(ec) LOG_BLOCK(LEV_WARNING, "Error while closing socket: " << ec.message());
+}
+
+/* Opening */
+
+void PhysicalLayerAsyncSharedMemory::OnAccept(const boost::system::error_code& arErr)
+{
+	system::error_code ec;
+	mAcceptor.close(ec);
+
+	if(!arErr) {
+		// the client doesn't touch the rings until it has the ready byte
+		this->MapRings(true);
+		mSocket.async_send(buffer(&READY, 1), boost::bind(&IgnoreSent, boost::asio::placeholders::error));
+	}
+
+	this->OnOpenCallback(arErr);
+}
+
+void PhysicalLayerAsyncSharedMemory::OnConnect(const boost::system::error_code& arErr)
+{
+	if(arErr) this->OnOpenCallback(arErr);
+	else async_read(mSocket, buffer(mWakeupBuffer, 1), boost::bind(&PhysicalLayerAsyncSharedMemory::OnReady, this, boost::asio::placeholders::error));
+}
+
+void PhysicalLayerAsyncSharedMemory::OnReady(const boost::system::error_code& arErr)
+{
+	system::error_code ec = arErr;
+	if(!ec) {
+		try {
+			this->MapRings(false);
+		} catch(const Exception& ex) {
+			LOG_BLOCK(LEV_WARNING, ex.GetErrorString());
+			ec = error::not_connected;
+		}
+	}
+	this->OnOpenCallback(ec);
+}
+
+/* Wakeups */
+
+void PhysicalLayerAsyncSharedMemory::StartWakeupRead()
+{
+	mSocket.async_read_some(buffer(mWakeupBuffer, sizeof(mWakeupBuffer)),
+	                        boost::bind(&PhysicalLayerAsyncSharedMemory::OnWakeup,
+	                                    this,
+	                                    boost::asio::placeholders::error,
+	                                    boost::asio::placeholders::bytes_transferred));
+}
+
+void PhysicalLayerAsyncSharedMemory::OnWakeup(const boost::system::error_code& arErr, size_t)
+{
+	if(!mConnected) return;
+
+	if(arErr) {
+		LOG_BLOCK(LEV_INFO, "Other side of " << mName << " went away: " << arErr.message());
+		mPeerError = arErr;
+	} else {
+		this->StartWakeupRead();
+	}
+
+	this->Pump();
+}
+
+void PhysicalLayerAsyncSharedMemory::SendWakeup()
+{
+	if(mWakeupSending) {
+		mWakeupAgain = true;
+		return;
+	}
+
+	mWakeupSending = true;
+	++mNumWakeups;
+	mSocket.async_send(buffer(&WAKEUP, 1), boost::bind(&PhysicalLayerAsyncSharedMemory::OnWakeupSent, this, boost::asio::placeholders::error));
+}
+
+void PhysicalLayerAsyncSharedMemory::OnWakeupSent(const boost::system::error_code& arErr)
+{
+	mWakeupSending = false;
+
+	// the wakeup in flight may already have been consumed, so send another
+	if(mWakeupAgain && !arErr && mConnected) {
+		mWakeupAgain = false;
+		this->SendWakeup();
+	}
+	mWakeupAgain = false;
+}
+
+/* Data */
+
+void PhysicalLayerAsyncSharedMemory::PostPump()
+{
+	if(mPumpPosted) return;
+	mPumpPosted = true;
+	mpService->post(boost::bind(&PhysicalLayerAsyncSharedMemory::Pump, this));
+}
+
+void PhysicalLayerAsyncSharedMemory::Pump()
+{
+	mPumpPosted = false;
+	if(!mConnected) return;
+
+	bool wakeup = false;
+	bool again = false;
+
+	const boost::uint8_t* pWrite = mpWriteBuffer;
+	bool writeDone = false;
+	if(pWrite != NULL) {
+		size_t num = mpTx->Write(pWrite + mWritten, mWriteSize - mWritten);
+		mWritten += num;
+		if(num > 0 && mpTx->TakeReader()) wakeup = true;
+
+		if(mWritten == mWriteSize || mPeerError) writeDone = true;
+		else if(!mpTx->ArmWriter()) again = true;
+	}
+
+	boost::uint8_t* pRead = mpReadBuffer;
+	size_t numRead = 0;
+	bool readDone = false;
+	if(pRead != NULL) {
+		numRead = mpRx->Read(pRead, mReadMax);
+		if(numRead > 0) {
+			if(mpRx->TakeWriter()) wakeup = true;
+			readDone = true;
+		} else if(mPeerError) {
+			readDone = true;
+		} else if(!mpRx->ArmReader()) {
+			again = true;
+		}
+	}
+
+	if(wakeup) this->SendWakeup();
+	if(again) this->PostPump();
+
+	// either callback can close the layer, which clears the other pending operation
+	if(readDone) {
+		mpReadBuffer = NULL;
+		this->OnReadCallback((numRead > 0) ? system::error_code() : mPeerError, pRead, numRead);
+	}
+	if(writeDone && mpWriteBuffer == pWrite) {
+		mpWriteBuffer = NULL;
+		if(mWritten == mWriteSize) this->OnWriteCallback(system::error_code(), mWriteSize);
+		else this->OnWriteCallback(mPeerError, 0);
+	}
+}
+
+}
+
+#endif
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,140 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_H_
+#define __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+
+#include <boost/asio.hpp>
+
+#include <memory>
+#include <string>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace apl
+{
+
+class SharedByteRing;
+
+/**
+	Physical layer between two processes on the same host that exchanges
+	bytes through a pair of SharedByteRings in a named shared memory
+	segment instead of through the kernel.
+
+	The server side creates the segment and listens on a unix domain socket
+	at GetSocketPath(name); the client side connects to it. The socket
+	carries no data. It tells each side when the other connects or goes
+	away, and a single byte on it wakes a side that is waiting for its
+	ring, so under load frames are exchanged without any system calls.
+	Only one client can be connected at a time.
+
+	Only built where asio supports local sockets, i.e. not on Windows.
+*/
+class PhysicalLayerAsyncSharedMemory : public PhysicalLayerAsyncASIO
+{
+public:
+
+	static const size_t DEFAULT_CAPACITY = 65536;
+
+	/**
+		@param arName		Name of the shared memory segment
+		@param aServer		true to create the segment and wait for a client, false to connect to one
+		@param aCapacity	Bytes in each direction's ring, only used by the server
+	*/
+	PhysicalLayerAsyncSharedMemory(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName, bool aServer, size_t aCapacity = DEFAULT_CAPACITY);
+	~PhysicalLayerAsyncSharedMemory();
+
+	/// @return path of the unix domain socket the two sides of segment arName rendezvous on
+	static std::string GetSocketPath(const std::string& arName);
+
+	/* Implement the actions */
+	void DoOpen();
+	void DoOpeningClose();
+	void DoOpenSuccess();
+	void DoOpenFailure();
+	void DoClose();
+	void DoAsyncRead(boost::uint8_t*, size_t);
+	void DoAsyncWrite(const boost::uint8_t*, size_t);
+
+	/// @return number of wakeups sent to the other side
+	size_t NumWakeups() const {
+		return mNumWakeups;
+	}
+
+private:
+
+	void CreateSegment();
+	void MapRings(bool aFormat);
+	void CloseSocket();
+
+	void OnAccept(const boost::system::error_code& arErr);
+	void OnConnect(const boost::system::error_code& arErr);
+	void OnReady(const boost::system::error_code& arErr);
+
+	void StartWakeupRead();
+	void OnWakeup(const boost::system::error_code& arErr, size_t aNum);
+	void SendWakeup();
+	void OnWakeupSent(const boost::system::error_code& arErr);
+
+	// moves bytes between the pending read and write and the rings
+	void PostPump();
+	void Pump();
+
+	boost::asio::local::stream_protocol::endpoint mEndpoint;
+	boost::asio::local::stream_protocol::acceptor mAcceptor;
+	boost::asio::local::stream_protocol::socket mSocket;
+
+	std::string mName;
+	bool mServer;
+	size_t mCapacity;
+
+	std::auto_ptr<boost::interprocess::mapped_region> mpRegion;
+	std::auto_ptr<SharedByteRing> mpTx;
+	std::auto_ptr<SharedByteRing> mpRx;
+
+	bool mConnected;
+	boost::system::error_code mPeerError;		// why the other side went away
+
+	boost::uint8_t* mpReadBuffer;
+	size_t mReadMax;
+	const boost::uint8_t* mpWriteBuffer;
+	size_t mWriteSize;
+	size_t mWritten;
+	bool mPumpPosted;
+
+	bool mWakeupSending;
+	bool mWakeupAgain;			// a wakeup was needed while one was being sent
+	size_t mNumWakeups;
+	boost::uint8_t mWakeupBuffer[64];
+};
+
+}
+
+#endif
+
+#endif
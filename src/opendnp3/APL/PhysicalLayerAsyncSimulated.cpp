@@ -0,0 +1,148 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "PhysicalLayerAsyncSimulated.h"
+
+#include "Logger.h"
+#include "VirtualTimerSource.h"
+
+#include <boost/asio/error.hpp>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace boost;
+using namespace boost::posix_time;
+
+namespace apl
+{
+
+PhysicalLayerAsyncSimulated::PhysicalLayerAsyncSimulated(Logger* apLogger, VirtualTimerSource* apTimerSrc, const LineModel& arModel, boost::uint32_t aSeed) :
+	PhysicalLayerAsyncBase(apLogger),
+	mpTimerSrc(apTimerSrc),
+	mModel(arModel),
+	mRandom(aSeed),
+	mpPeer(NULL),
+	mLineFree(min_date_time),
+	mLastArrival(min_date_time),
+	mpWriteTimer(NULL),
+	mpReadBuffer(NULL),
+	mReadSize(0),
+	mNumLost(0),
+	mNumBytesReceived(0),
+	mMaxBuffered(0)
+{
+
+}
+
+void PhysicalLayerAsyncSimulated::Connect(PhysicalLayerAsyncSimulated* apFirst, PhysicalLayerAsyncSimulated* apSecond)
+{
+	assert(apFirst->mpPeer == NULL && apSecond->mpPeer == NULL);
+	apFirst->mpPeer = apSecond;
+	apSecond->mpPeer = apFirst;
+}
+
+void PhysicalLayerAsyncSimulated::DoOpen()
+{
+	mReceived.clear();
+	mpTimerSrc->Post(bind(&PhysicalLayerAsyncSimulated::OnOpenCallback, this, system::error_code()));
+}
+
+void PhysicalLayerAsyncSimulated::DoClose()
+{
+	if(mpWriteTimer != NULL) {
+		mpWriteTimer->Cancel();
+		mpWriteTimer = NULL;
+		mpTimerSrc->Post(bind(&PhysicalLayerAsyncSimulated::OnWriteCallback, this, system::error_code(asio::error::operation_aborted), 0));
+	}
+
+	if(mpReadBuffer != NULL) {
+		boost::uint8_t* pBuffer = mpReadBuffer;
+		mpReadBuffer = NULL;
+		mpTimerSrc->Post(bind(&PhysicalLayerAsyncSimulated::OnReadCallback, this, system::error_code(asio::error::operation_aborted), pBuffer, 0));
+	}
+}
+
+void PhysicalLayerAsyncSimulated::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
+{
+	assert(mpReadBuffer == NULL);
+	mpReadBuffer = apBuffer;
+	mReadSize = aMaxBytes;
+	this->CheckForRead();
+}
+
+void PhysicalLayerAsyncSimulated::DoAsyncWrite(const boost::uint8_t* apData, size_t aNumBytes)
+{
+	assert(mpWriteTimer == NULL);
+
+	ptime now = mpTimerSrc->GetUTC();
+	ptime start = (mLineFree > now) ? mLineFree : now;
+	millis_t clocked = (mModel.mBitsPerSecond > 0) ? (aNumBytes * 10 * 1000) / mModel.mBitsPerSecond : 0;
+	mLineFree = start + milliseconds(clocked);
+
+	mpWriteTimer = mpTimerSrc->Start(mLineFree, bind(&PhysicalLayerAsyncSimulated::OnWriteDone, this, aNumBytes));
+
+	if(mModel.mLoss > 0 && mRandom.Next() < mModel.mLoss) {
+		++mNumLost;
+		return;
+	}
+
+	if(mpPeer == NULL) return;
+
+	millis_t jitter = (mModel.mJitter > 0) ? static_cast<millis_t>(mRandom.Next() * (mModel.mJitter + 1)) : 0;
+	ptime arrival = mLineFree + milliseconds(mModel.mLatency + std::min(jitter, mModel.mJitter));
+	if(arrival < mLastArrival) arrival = mLastArrival;
+	mLastArrival = arrival;
+
+	mpTimerSrc->Start(arrival, bind(&PhysicalLayerAsyncSimulated::Deliver, mpPeer, CopyableBuffer(apData, aNumBytes)));
+}
+
+void PhysicalLayerAsyncSimulated::OnWriteDone(size_t aNumBytes)
+{
+	mpWriteTimer = NULL;
+	this->OnWriteCallback(system::error_code(), aNumBytes);
+}
+
+void PhysicalLayerAsyncSimulated::Deliver(const CopyableBuffer& arData)
+{
+	if(!this->IsOpen() || this->IsClosing()) return;
+
+	mReceived.insert(mReceived.end(), arData.Buffer(), arData.Buffer() + arData.Size());
+	mNumBytesReceived += arData.Size();
+	if(mReceived.size() > mMaxBuffered) mMaxBuffered = mReceived.size();
+	this->CheckForRead();
+}
+
+void PhysicalLayerAsyncSimulated::CheckForRead()
+{
+	if(mpReadBuffer == NULL || mReceived.empty()) return;
+
+	size_t num = std::min(mReadSize, mReceived.size());
+	std::copy(mReceived.begin(), mReceived.begin() + num, mpReadBuffer);
+	mReceived.erase(mReceived.begin(), mReceived.begin() + num);
+
+	// like asio, a read never completes from inside the call that started it
+	boost::uint8_t* pBuffer = mpReadBuffer;
+	mpReadBuffer = NULL;
+	mpTimerSrc->Post(bind(&PhysicalLayerAsyncSimulated::OnReadCallback, this, system::error_code(), pBuffer, num));
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,115 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SIMULATED_H_
+#define __PHYSICAL_LAYER_ASYNC_SIMULATED_H_
+
+#include "PhysicalLayerAsyncBase.h"
+#include "CopyableBuffer.h"
+#include "RandomDouble.h"
+
+#include <deque>
+
+namespace apl
+{
+
+class ITimer;
+class VirtualTimerSource;
+
+/**
+	Delay and loss applied to everything one end of a simulated line writes
+*/
+struct LineModel {
+	LineModel() :
+		mLatency(0),
+		mJitter(0),
+		mLoss(0.0),
+		mBitsPerSecond(0)
+	{}
+
+	millis_t mLatency;				// one way delay from the end of a write to its delivery
+	millis_t mJitter;				// extra delay drawn uniformly from [0, mJitter] for every write, deliveries never reorder
+	double mLoss;					// probability that a write is dropped, the router writes one link frame at a time
+	boost::uint32_t mBitsPerSecond;	// writes take 10 bits per byte at this rate, 0 for no limit
+};
+
+/**
+	In-memory physical layer for simulations. Two of them joined with Connect()
+	form a line, and everything runs in the virtual time of a
+	VirtualTimerSource.
+
+	A write finishes once its bytes have been clocked out at the line rate and
+	arrives at the other end after the latency, unless the loss model drops it.
+	Bytes that arrive while the other end is closed are lost, like on a serial
+	line.
+*/
+class PhysicalLayerAsyncSimulated : public PhysicalLayerAsyncBase
+{
+public:
+	PhysicalLayerAsyncSimulated(Logger*, VirtualTimerSource*, const LineModel& arModel, boost::uint32_t aSeed = 0);
+
+	/// Joins two ends, neither may be connected already
+	static void Connect(PhysicalLayerAsyncSimulated*, PhysicalLayerAsyncSimulated*);
+
+	/// @return writes the loss model dropped
+	size_t NumLost() const {
+		return mNumLost;
+	}
+
+	/// @return bytes delivered to this end
+	size_t NumBytesReceived() const {
+		return mNumBytesReceived;
+	}
+
+	/// @return the most bytes that were ever delivered to this end but not yet read
+	size_t MaxBuffered() const {
+		return mMaxBuffered;
+	}
+
+private:
+
+	void DoOpen();
+	void DoClose();
+	void DoAsyncRead(boost::uint8_t*, size_t);
+	void DoAsyncWrite(const boost::uint8_t*, size_t);
+
+	void OnWriteDone(size_t aNumBytes);
+	void Deliver(const CopyableBuffer& arData);
+	void CheckForRead();
+
+	VirtualTimerSource* mpTimerSrc;
+	LineModel mModel;
+	RandomDouble mRandom;
+	PhysicalLayerAsyncSimulated* mpPeer;
+
+	boost::posix_time::ptime mLineFree;		// when the line finishes clocking out the writes so far
+	boost::posix_time::ptime mLastArrival;	// keeps deliveries in order when the jitter varies
+	ITimer* mpWriteTimer;
+
+	std::deque<boost::uint8_t> mReceived;
+	boost::uint8_t* mpReadBuffer;
+	size_t mReadSize;
+
+	size_t mNumLost;
+	size_t mNumBytesReceived;
+	size_t mMaxBuffered;
+};
+
+}
+
+#endif
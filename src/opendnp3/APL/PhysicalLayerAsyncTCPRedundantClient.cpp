@@ -0,0 +1,337 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "PhysicalLayerAsyncTCPRedundantClient.h"
+
+#include <boost/bind.hpp>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PhysicalLayerAsyncBaseTCP.h"
+
+using namespace boost;
+using namespace boost::asio;
+
+namespace apl
+{
+
+PhysicalLayerAsyncTCPRedundantClient::Slot::Slot(boost::asio::io_service& arService, const boost::asio::ip::tcp::endpoint& arEndpoint) :
+	mEndpoint(arEndpoint),
+	mSocket(arService),
+	mState(SS_IDLE),
+	mRacing(false),
+	mGeneration(0)
+{}
+
+PhysicalLayerAsyncTCPRedundantClient::PhysicalLayerAsyncTCPRedundantClient(Logger* apLogger, boost::asio::io_service* apIOService, const TCPRedundantSettings& arSettings) :
+	PhysicalLayerAsyncASIO(apLogger, apIOService),
+	mStagger(arSettings.mStagger),
+	mNumStandbys(arSettings.mNumStandbys),
+	mStaggerTimer(*apIOService),
+	mActive(0),
+	mOpenPending(false),
+	mOpen(0),
+	mNextAttempt(0),
+	mNumRacing(0),
+	mPeerFailure(false)
+{
+	if(arSettings.mEndpoints.empty()) throw ArgumentException(LOCATION, "At least one endpoint is required");
+	if(mStagger < 0) throw ArgumentException(LOCATION, "Stagger must be >= 0");
+
+	for(size_t i = 0; i < arSettings.mEndpoints.size(); ++i) {
+		const TCPEndpoint& ep = arSettings.mEndpoints[i];
+		ip::tcp::endpoint remote(PhysicalLayerAsyncBaseTCP::ResolveAddress(ep.mAddress), ep.mPort);
+		mSlots.push_back(new Slot(*apIOService, remote));
+	}
+	mActive = mSlots.size();
+}
+
+PhysicalLayerAsyncTCPRedundantClient::~PhysicalLayerAsyncTCPRedundantClient()
+{
+	for(size_t i = 0; i < mSlots.size(); ++i) delete mSlots[i];
+}
+
+size_t PhysicalLayerAsyncTCPRedundantClient::NumStandbys() const
+{
+	size_t num = 0;
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		if(mSlots[i]->mState == SS_STANDBY) ++num;
+	}
+	return num;
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncTCPRedundantClient::DoOpen()
+{
+	mOpenPending = true;
+	mPeerFailure = false;
+	++mOpen;
+
+	// a connected standby needs no connect at all
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		Slot* pSlot = mSlots[i];
+		if(pSlot->mState != SS_STANDBY) continue;
+
+		system::error_code ec;
+		pSlot->mSocket.cancel(ec); // stop discarding
+		++pSlot->mGeneration;
+		pSlot->mState = SS_ACTIVE;
+		mActive = i;
+		LOG_BLOCK(LEV_INFO, "Promoting standby connection to: " << pSlot->mEndpoint);
+		mpService->post(boost::bind(&PhysicalLayerAsyncTCPRedundantClient::FinishOpen, this, system::error_code()));
+		return;
+	}
+
+	mNextAttempt = 0;
+	mNumRacing = 0;
+	mLastError = error::not_connected;
+
+	// standbys still connecting join the race
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		if(mSlots[i]->mState == SS_CONNECTING) {
+			mSlots[i]->mRacing = true;
+			++mNumRacing;
+		}
+	}
+
+	if(this->StartNextAttempt() || mNumRacing > 0) this->StartStagger();
+	else mpService->post(boost::bind(&PhysicalLayerAsyncTCPRedundantClient::FinishOpen, this, mLastError));
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::DoOpeningClose()
+{
+	if(mActive < mSlots.size()) return; // a promotion is already posted, the base closes it
+
+	system::error_code ec;
+	mStaggerTimer.cancel(ec);
+	for(size_t i = 0; i < mSlots.size(); ++i) this->CloseSlot(i);
+	mNumRacing = 0;
+	mpService->post(boost::bind(&PhysicalLayerAsyncTCPRedundantClient::FinishOpen, this, system::error_code(error::operation_aborted)));
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Connected to: " << mSlots[mActive]->mEndpoint);
+	this->FillStandbys();
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::DoClose()
+{
+	// the standbys are closed first so their aborted completions run ahead of the active read's
+	if(!mPeerFailure) this->CloseInactiveSlots();
+
+	if(mActive < mSlots.size()) {
+		system::error_code ec;
+		mSlots[mActive]->mSocket.shutdown(ip::tcp::socket::shutdown_both, ec);
+		if(ec) LOG_BLOCK(LEV_DEBUG, "Error while shutting down socket: " << ec.message());
+		this->CloseSlot(mActive);
+		mActive = mSlots.size();
+	}
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
+{
+	mSlots[mActive]->mSocket.async_read_some(buffer(apBuffer, aMaxBytes),
+	        boost::bind(&PhysicalLayerAsyncTCPRedundantClient::OnActiveRead,
+	                    this,
+	                    boost::asio::placeholders::error,
+	                    apBuffer,
+	                    boost::asio::placeholders::bytes_transferred));
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::DoAsyncWrite(const boost::uint8_t* apBuffer, size_t aNumBytes)
+{
+	async_write(mSlots[mActive]->mSocket, buffer(apBuffer, aNumBytes),
+	            boost::bind(&PhysicalLayerAsyncTCPRedundantClient::OnActiveWrite,
+	                        this,
+	                        boost::asio::placeholders::error,
+	                        aNumBytes));
+}
+
+/* Helpers */
+
+void PhysicalLayerAsyncTCPRedundantClient::StartConnect(size_t aIndex, bool aRacing)
+{
+	Slot* pSlot = mSlots[aIndex];
+	pSlot->mState = SS_CONNECTING;
+	pSlot->mRacing = aRacing;
+	LOG_BLOCK(LEV_DEBUG, (aRacing ? "Connecting to: " : "Connecting standby to: ") << pSlot->mEndpoint);
+	pSlot->mSocket.async_connect(pSlot->mEndpoint,
+	                             boost::bind(&PhysicalLayerAsyncTCPRedundantClient::OnConnect,
+	                                         this,
+	                                         boost::asio::placeholders::error,
+	                                         aIndex,
+	                                         pSlot->mGeneration));
+}
+
+bool PhysicalLayerAsyncTCPRedundantClient::StartNextAttempt()
+{
+	while(mNextAttempt < mSlots.size()) {
+		size_t i = mNextAttempt++;
+		if(mSlots[i]->mState == SS_IDLE) {
+			this->StartConnect(i, true);
+			++mNumRacing;
+			return true;
+		}
+	}
+	return false;
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::StartStagger()
+{
+	if(mNextAttempt >= mSlots.size()) return;
+	mStaggerTimer.expires_from_now(posix_time::milliseconds(mStagger));
+	mStaggerTimer.async_wait(boost::bind(&PhysicalLayerAsyncTCPRedundantClient::OnStagger, this, boost::asio::placeholders::error, mOpen));
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::StartStandbyRead(size_t aIndex)
+{
+	Slot* pSlot = mSlots[aIndex];
+	pSlot->mSocket.async_read_some(buffer(pSlot->mDiscard, sizeof(pSlot->mDiscard)),
+	                               boost::bind(&PhysicalLayerAsyncTCPRedundantClient::OnStandbyRead,
+	                                           this,
+	                                           boost::asio::placeholders::error,
+	                                           aIndex,
+	                                           pSlot->mGeneration));
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::FillStandbys()
+{
+	size_t num = 0;
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		if(mSlots[i]->mState == SS_STANDBY || mSlots[i]->mState == SS_CONNECTING) ++num;
+	}
+
+	for(size_t i = 0; i < mSlots.size() && num < mNumStandbys; ++i) {
+		if(mSlots[i]->mState == SS_IDLE) {
+			this->StartConnect(i, false);
+			++num;
+		}
+	}
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::CloseSlot(size_t aIndex)
+{
+	Slot* pSlot = mSlots[aIndex];
+	if(pSlot->mState == SS_IDLE) return;
+
+	system::error_code ec;
+	pSlot->mSocket.close(ec);
+	if(ec) LOG_BLOCK(LEV_WARNING, "Error while closing socket: " << ec.message());
+	pSlot->mState = SS_IDLE;
+	pSlot->mRacing = false;
+	++pSlot->mGeneration;
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::CloseInactiveSlots()
+{
+	system::error_code ec;
+	mStaggerTimer.cancel(ec);
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		if(i != mActive) this->CloseSlot(i);
+	}
+}
+
+/* Completions */
+
+void PhysicalLayerAsyncTCPRedundantClient::OnConnect(const boost::system::error_code& arErr, size_t aIndex, size_t aGeneration)
+{
+	Slot* pSlot = mSlots[aIndex];
+	if(aGeneration != pSlot->mGeneration) return;
+
+	bool racing = pSlot->mRacing;
+	pSlot->mRacing = false;
+	if(racing) --mNumRacing;
+
+	if(arErr) {
+		LOG_BLOCK(LEV_INFO, "Connect to " << pSlot->mEndpoint << " failed: " << arErr.message());
+		this->CloseSlot(aIndex);
+		if(racing) {
+			mLastError = arErr;
+			if(!this->IsClosing()) this->StartNextAttempt();
+			if(mNumRacing == 0) this->FinishOpen(mLastError);
+		}
+	} else if(racing) {
+		pSlot->mState = SS_ACTIVE;
+		mActive = aIndex;
+		this->FinishOpen(arErr);
+	} else {
+		LOG_BLOCK(LEV_INFO, "Standby connected to: " << pSlot->mEndpoint);
+		pSlot->mState = SS_STANDBY;
+		this->StartStandbyRead(aIndex);
+	}
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::OnStagger(const boost::system::error_code& arErr, size_t aOpen)
+{
+	if(arErr || aOpen != mOpen || !mOpenPending || this->IsClosing()) return;
+	if(this->StartNextAttempt()) this->StartStagger();
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::OnStandbyRead(const boost::system::error_code& arErr, size_t aIndex, size_t aGeneration)
+{
+	Slot* pSlot = mSlots[aIndex];
+	if(aGeneration != pSlot->mGeneration) return;
+
+	if(arErr) {
+		LOG_BLOCK(LEV_INFO, "Standby connection to " << pSlot->mEndpoint << " closed: " << arErr.message());
+		this->CloseSlot(aIndex);
+	} else {
+		this->StartStandbyRead(aIndex);
+	}
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::OnActiveRead(const boost::system::error_code& arErr, boost::uint8_t* apBuffer, size_t aSize)
+{
+	if(arErr) mPeerFailure = true;
+	this->OnReadCallback(arErr, apBuffer, aSize);
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::OnActiveWrite(const boost::system::error_code& arErr, size_t aSize)
+{
+	if(arErr) mPeerFailure = true;
+	this->OnWriteCallback(arErr, aSize);
+}
+
+void PhysicalLayerAsyncTCPRedundantClient::FinishOpen(const boost::system::error_code& arErr)
+{
+	if(!mOpenPending) return;
+	mOpenPending = false;
+
+	system::error_code ec;
+	mStaggerTimer.cancel(ec);
+
+	// the losers of the race either become standbys or are abandoned
+	size_t standbys = arErr ? mNumStandbys : this->NumStandbys();
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		Slot* pSlot = mSlots[i];
+		if(!pSlot->mRacing) continue;
+		if(standbys < mNumStandbys) {
+			pSlot->mRacing = false;
+			++standbys;
+		} else this->CloseSlot(i);
+	}
+	mNumRacing = 0;
+
+	this->OnOpenCallback(arErr);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,124 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_TCP_REDUNDANT_CLIENT_H_
+#define __PHYSICAL_LAYER_ASYNC_TCP_REDUNDANT_CLIENT_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+#include "TCPTypes.h"
+
+#include <boost/asio.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <vector>
+
+namespace apl
+{
+
+/**
+	TCP client that connects to the first of several endpoints to answer.
+
+	An open starts connecting to the most preferred endpoint and, every
+	mStagger ms or as soon as an attempt fails, to the next one as well.
+	The first connect to succeed wins and the rest are abandoned, so an
+	unreachable primary costs one stagger instead of an OS connect timeout.
+
+	With mNumStandbys > 0, idle connections are kept to the other endpoints
+	once the layer is open. If the active connection fails, the next open
+	promotes a standby instead of connecting. Anything a device sends on a
+	standby connection is discarded. Standbys that fail are replaced on the
+	next successful open. An orderly close, i.e. one not caused by a read
+	or write error, closes the standbys too.
+*/
+class PhysicalLayerAsyncTCPRedundantClient : public PhysicalLayerAsyncASIO
+{
+public:
+	PhysicalLayerAsyncTCPRedundantClient(Logger* apLogger, boost::asio::io_service* apIOService, const TCPRedundantSettings& arSettings);
+	~PhysicalLayerAsyncTCPRedundantClient();
+
+	/* Implement the actions */
+	void DoOpen();
+	void DoOpeningClose();
+	void DoOpenSuccess();
+	void DoClose();
+	void DoAsyncRead(boost::uint8_t*, size_t);
+	void DoAsyncWrite(const boost::uint8_t*, size_t);
+
+	/// @return index of the endpoint the layer is open through, or the number of endpoints if it isn't
+	size_t GetActiveEndpoint() const {
+		return mActive;
+	}
+
+	/// @return number of standby connections that are connected
+	size_t NumStandbys() const;
+
+private:
+
+	enum SlotState {
+		SS_IDLE,
+		SS_CONNECTING,
+		SS_STANDBY,
+		SS_ACTIVE
+	};
+
+	// one endpoint and the socket connected or connecting to it
+	struct Slot {
+		Slot(boost::asio::io_service& arService, const boost::asio::ip::tcp::endpoint& arEndpoint);
+
+		boost::asio::ip::tcp::endpoint mEndpoint;
+		boost::asio::ip::tcp::socket mSocket;
+		SlotState mState;
+		bool mRacing;			// the connect is part of the current open
+		size_t mGeneration;		// completions bound to an older generation are stale
+		boost::uint8_t mDiscard[64];
+	};
+
+	typedef std::vector<Slot*> SlotVector;
+
+	void StartConnect(size_t aIndex, bool aRacing);
+	bool StartNextAttempt();
+	void StartStagger();
+	void StartStandbyRead(size_t aIndex);
+	void FillStandbys();
+	void CloseSlot(size_t aIndex);
+	void CloseInactiveSlots();
+
+	void OnConnect(const boost::system::error_code& arErr, size_t aIndex, size_t aGeneration);
+	void OnStagger(const boost::system::error_code& arErr, size_t aOpen);
+	void OnStandbyRead(const boost::system::error_code& arErr, size_t aIndex, size_t aGeneration);
+	void OnActiveRead(const boost::system::error_code& arErr, boost::uint8_t* apBuffer, size_t aSize);
+	void OnActiveWrite(const boost::system::error_code& arErr, size_t aSize);
+	void FinishOpen(const boost::system::error_code& arErr);
+
+	SlotVector mSlots;
+	millis_t mStagger;
+	size_t mNumStandbys;
+	boost::asio::deadline_timer mStaggerTimer;
+
+	size_t mActive;				// index of the open slot, mSlots.size() if closed
+	bool mOpenPending;			// an open hasn't called back yet
+	size_t mOpen;				// counts opens so stale stagger timeouts are ignored
+	size_t mNextAttempt;		// next endpoint the current open will try
+	size_t mNumRacing;			// connects outstanding for the current open
+	boost::system::error_code mLastError;
+	bool mPeerFailure;			// the active connection failed rather than being closed
+};
+
+}
+
+#endif
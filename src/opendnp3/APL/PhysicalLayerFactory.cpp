@@ -20,7 +20,9 @@
 #include "PhysicalLayerFactory.h"
 
 #include "PhysicalLayerAsyncSerial.h"
+#include "PhysicalLayerAsyncSharedMemory.h"
 #include "PhysicalLayerAsyncTCPClient.h"
+#include "PhysicalLayerAsyncTCPRedundantClient.h"
 #include "PhysicalLayerAsyncTCPServer.h"
 
 #include "Log.h"
@@ -36,14 +38,24 @@ IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetSerialAsync(SerialSettings
 	return boost::bind(&PhysicalLayerFactory::FGetSerialAsync, s, _2, _1);
 }
 
-IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetTCPClientAsync(std::string aAddress, boost::uint16_t aPort)
+IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, IoUringService* apUring)
 {
-	return boost::bind(&PhysicalLayerFactory::FGetTCPClientAsync, aAddress, aPort, _2, _1);
+	return boost::bind(&PhysicalLayerFactory::FGetTCPClientAsync, aAddress, aPort, _2, _1, apUring);
 }
 
-IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort)
+IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, IoUringService* apUring)
 {
-	return boost::bind(&PhysicalLayerFactory::FGetTCPServerAsync, aEndpoint, aPort, _2, _1);
+	return boost::bind(&PhysicalLayerFactory::FGetTCPServerAsync, aEndpoint, aPort, _2, _1, apUring);
+}
+
+IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetTCPRedundantClientAsync(TCPRedundantSettings s)
+{
+	return boost::bind(&PhysicalLayerFactory::FGetTCPRedundantClientAsync, s, _2, _1);
+}
+
+IPhysicalLayerAsyncFactory PhysicalLayerFactory :: GetSharedMemoryAsync(std::string aSegment, bool aServer)
+{
+	return boost::bind(&PhysicalLayerFactory::FGetSharedMemoryAsync, aSegment, aServer, _2, _1);
 }
 
 IPhysicalLayerAsync* PhysicalLayerFactory :: FGetSerialAsync(SerialSettings s, boost::asio::io_service* apSrv, Logger* apLogger)
@@ -51,14 +63,32 @@ IPhysicalLayerAsync* PhysicalLayerFactory :: FGetSerialAsync(SerialSettings s, b
 	return new PhysicalLayerAsyncSerial(apLogger, apSrv, s);
 }
 
-IPhysicalLayerAsync* PhysicalLayerFactory :: FGetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger)
+IPhysicalLayerAsync* PhysicalLayerFactory :: FGetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger, IoUringService* apUring)
+{
+	PhysicalLayerAsyncTCPClient* pClient = new PhysicalLayerAsyncTCPClient(apLogger, apSrv, aAddress, aPort);
+	if(apUring != NULL) pClient->SetIoUring(apUring);
+	return pClient;
+}
+
+IPhysicalLayerAsync* PhysicalLayerFactory :: FGetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger, IoUringService* apUring)
+{
+	PhysicalLayerAsyncTCPServer* pServer = new PhysicalLayerAsyncTCPServer(apLogger, apSrv, aEndpoint, aPort);
+	if(apUring != NULL) pServer->SetIoUring(apUring);
+	return pServer;
+}
+
+IPhysicalLayerAsync* PhysicalLayerFactory :: FGetTCPRedundantClientAsync(TCPRedundantSettings s, boost::asio::io_service* apSrv, Logger* apLogger)
 {
-	return new PhysicalLayerAsyncTCPClient(apLogger, apSrv, aAddress, aPort);
+	return new PhysicalLayerAsyncTCPRedundantClient(apLogger, apSrv, s);
 }
 
-IPhysicalLayerAsync* PhysicalLayerFactory :: FGetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger)
+IPhysicalLayerAsync* PhysicalLayerFactory :: FGetSharedMemoryAsync(std::string aSegment, bool aServer, boost::asio::io_service* apSrv, Logger* apLogger)
 {
-	return new PhysicalLayerAsyncTCPServer(apLogger, apSrv, aEndpoint, aPort);
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+	return new PhysicalLayerAsyncSharedMemory(apLogger, apSrv, aSegment, aServer);
+#else
+	throw NotImplementedException(LOCATION, "Shared memory physical layers need local socket support");
+#endif
 }
 
 }
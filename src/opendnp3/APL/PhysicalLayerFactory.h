@@ -21,6 +21,7 @@
 
 
 #include "SerialTypes.h"
+#include "TCPTypes.h"
 #include "Exception.h"
 #include "PhysicalLayerFunctors.h"
 #include <map>
@@ -30,18 +31,25 @@
 namespace apl
 {
 
+class IoUringService;
+
 class PhysicalLayerFactory
 {
 public:
 
 	static IPhysicalLayerAsyncFactory GetSerialAsync(SerialSettings s);
-	static IPhysicalLayerAsyncFactory GetTCPClientAsync(std::string aAddress, boost::uint16_t aPort);
-	static IPhysicalLayerAsyncFactory GetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort);
+	// apUring reads and writes through an io_uring instead of the asio reactor when it isn't NULL
+	static IPhysicalLayerAsyncFactory GetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, IoUringService* apUring = NULL);
+	static IPhysicalLayerAsyncFactory GetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, IoUringService* apUring = NULL);
+	static IPhysicalLayerAsyncFactory GetTCPRedundantClientAsync(TCPRedundantSettings s);
+	static IPhysicalLayerAsyncFactory GetSharedMemoryAsync(std::string aSegment, bool aServer);
 
 	//normal factory functions
 	static IPhysicalLayerAsync* FGetSerialAsync(SerialSettings s, boost::asio::io_service* apSrv, Logger* apLogger);
-	static IPhysicalLayerAsync* FGetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger);
-	static IPhysicalLayerAsync* FGetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger);
+	static IPhysicalLayerAsync* FGetTCPClientAsync(std::string aAddress, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger, IoUringService* apUring = NULL);
+	static IPhysicalLayerAsync* FGetTCPServerAsync(std::string aEndpoint, boost::uint16_t aPort, boost::asio::io_service* apSrv, Logger* apLogger, IoUringService* apUring = NULL);
+	static IPhysicalLayerAsync* FGetTCPRedundantClientAsync(TCPRedundantSettings s, boost::asio::io_service* apSrv, Logger* apLogger);
+	static IPhysicalLayerAsync* FGetSharedMemoryAsync(std::string aSegment, bool aServer, boost::asio::io_service* apSrv, Logger* apLogger);
 };
 }
 
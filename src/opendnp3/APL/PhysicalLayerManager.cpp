@@ -31,7 +31,8 @@ using namespace std;
 namespace apl
 {
 PhysicalLayerManager :: PhysicalLayerManager(Logger* apBaseLogger, boost::asio::io_service* apService) :
-	PhysicalLayerMap(apBaseLogger, apService)
+	PhysicalLayerMap(apBaseLogger, apService),
+	mpUring(NULL)
 {
 
 }
@@ -62,14 +63,28 @@ void PhysicalLayerManager ::AddPhysicalLayer(const std::string& arName, PhysLaye
 
 void PhysicalLayerManager ::AddTCPClient(const std::string& arName, PhysLayerSettings s, const std::string& arAddr, boost::uint16_t aPort)
 {
-	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPClientAsync(arAddr, aPort);
+	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPClientAsync(arAddr, aPort, mpUring);
+	PhysLayerInstance pli(fac);
+	this->AddLayer(arName, s, pli);
+}
+
+void PhysicalLayerManager ::AddTCPRedundantClient(const std::string& arName, PhysLayerSettings s, const TCPRedundantSettings& arSettings)
+{
+	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPRedundantClientAsync(arSettings);
+	PhysLayerInstance pli(fac);
+	this->AddLayer(arName, s, pli);
+}
+
+void PhysicalLayerManager ::AddSharedMemory(const std::string& arName, PhysLayerSettings s, const std::string& arSegment, bool aServer)
+{
+	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetSharedMemoryAsync(arSegment, aServer);
 	PhysLayerInstance pli(fac);
 	this->AddLayer(arName, s, pli);
 }
 
 void PhysicalLayerManager ::AddTCPServer(const std::string& arName, PhysLayerSettings s, const std::string& arEndpoint, boost::uint16_t aPort)
 {
-	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPServerAsync(arEndpoint, aPort);
+	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPServerAsync(arEndpoint, aPort, mpUring);
 	PhysLayerInstance pli(fac);
 	this->AddLayer(arName, s, pli);
 }
@@ -22,12 +22,14 @@
 
 #include "PhysicalLayerMap.h"
 #include "SerialTypes.h"
+#include "TCPTypes.h"
 //#include "PhysicalLayerInstance.h"
 
 namespace apl
 {
 class EventLog;
 class IPhysicalLayerObserver;
+class IoUringService;
 
 class PhysicalLayerManager : public PhysicalLayerMap
 {
@@ -37,15 +39,26 @@ public:
 	PhysicalLayerManager(Logger*, boost::asio::io_service* apService);
 	virtual ~PhysicalLayerManager();
 
+	/// TCP clients and servers added after this read and write through apUring, NULL goes back to asio
+	void SetIoUring(IoUringService* apUring) {
+		mpUring = apUring;
+	}
+
 	//function for manually adding entires
 
 	void AddTCPClient(const std::string& arName, PhysLayerSettings, const std::string& arAddr, boost::uint16_t aPort);
 	void AddTCPServer(const std::string& arName, PhysLayerSettings, const std::string& arEndpoint, boost::uint16_t aPort);
+	void AddTCPRedundantClient(const std::string& arName, PhysLayerSettings, const TCPRedundantSettings&);
+	void AddSharedMemory(const std::string& arName, PhysLayerSettings, const std::string& arSegment, bool aServer);
 	void AddSerial(const std::string& arName, PhysLayerSettings, SerialSettings);
 	void AddPhysicalLayer(const std::string& arName, PhysLayerSettings, IPhysicalLayerAsync*);
 
 	// Removes a physical layer and deletes it if the manager has ownership.
 	void Remove(const std::string& arName);
+
+private:
+
+	IoUringService* mpUring;
 };
 }
 
@@ -23,13 +23,16 @@ namespace apl
 
 PostingNotifier::PostingNotifier(ITimerSource* apTimerSrc, const FunctionVoidZero& arHandler) :
 	mpTimerSrc(apTimerSrc),
-	mHandler(arHandler)
+	mHandler(arHandler),
+	mProfile(HandlerProfiler::Current())
 {
 
 }
 
 void PostingNotifier::Notify()
 {
+	// Notify() is usually called from a user thread, so the handler belongs to whoever created the notifier
+	ProfileScope scope(mProfile);
 	mpTimerSrc->Post(mHandler);
 }
 
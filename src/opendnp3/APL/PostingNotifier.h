@@ -19,6 +19,7 @@
 #ifndef __POSTING_NOTIFIER_H_
 #define __POSTING_NOTIFIER_H_
 
+#include "HandlerProfiler.h"
 #include "INotifier.h"
 #include "ITimerSource.h"
 
@@ -38,6 +39,7 @@ public:
 private:
 	ITimerSource* mpTimerSrc;
 	FunctionVoidZero mHandler;
+	HandlerProfile mProfile;
 };
 
 }
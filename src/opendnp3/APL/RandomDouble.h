@@ -46,6 +46,14 @@ public:
 
 	}
 
+	/// Repeatable sequence for simulations
+	RandomDouble(boost::uint32_t aSeed) :
+		rng(aSeed),
+		dist(0.0, 1.0),
+		nextRand(rng, dist) {
+
+	}
+
 	double Next() { return nextRand(); }
 
 private:
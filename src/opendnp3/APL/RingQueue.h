@@ -0,0 +1,144 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __RING_QUEUE_H_
+#define __RING_QUEUE_H_
+
+#include <assert.h>
+#include <cstddef>
+#include <vector>
+
+namespace apl
+{
+
+/**
+	FIFO queue over a circular array whose slots are reused in place. Once
+	the queue has grown to its working size, pushing and popping never
+	allocate, unlike a std::deque of large elements which allocates a node
+	for nearly every item.
+
+	Push() without an argument hands back the recycled tail slot so the
+	caller can fill it directly instead of copying a temporary into the
+	queue. Popped elements aren't destroyed, they keep their old value until
+	they're overwritten, so T must be default constructible and assignable.
+*/
+template <class T>
+class RingQueue
+{
+public:
+
+	RingQueue(size_t aInitialCapacity = 8) :
+		mSlots(aInitialCapacity > 0 ? aInitialCapacity : 1),
+		mHead(0),
+		mSize(0)
+	{}
+
+	size_t Size() const {
+		return mSize;
+	}
+
+	bool Empty() const {
+		return mSize == 0;
+	}
+
+	/// @return number of elements the queue can hold before it has to grow
+	size_t Capacity() const {
+		return mSlots.size();
+	}
+
+	/// @return the recycled slot at the back of the queue, which the caller must overwrite
+	T& Push() {
+		if(mSize == mSlots.size()) this->Grow();
+		T& slot = mSlots[this->Wrap(mHead + mSize)];
+		++mSize;
+		return slot;
+	}
+
+	void Push(const T& arValue) {
+		this->Push() = arValue;
+	}
+
+	void PushFront(const T& arValue) {
+		if(mSize == mSlots.size()) this->Grow();
+		mHead = (mHead == 0) ? mSlots.size() - 1 : mHead - 1;
+		++mSize;
+		mSlots[mHead] = arValue;
+	}
+
+	void Pop() {
+		assert(mSize > 0);
+		mHead = this->Wrap(mHead + 1);
+		--mSize;
+	}
+
+	T& Front() {
+		assert(mSize > 0);
+		return mSlots[mHead];
+	}
+
+	const T& Front() const {
+		assert(mSize > 0);
+		return mSlots[mHead];
+	}
+
+	T& Back() {
+		assert(mSize > 0);
+		return mSlots[this->Wrap(mHead + mSize - 1)];
+	}
+
+	/// @return the element aIndex places from the front
+	T& operator[](size_t aIndex) {
+		assert(aIndex < mSize);
+		return mSlots[this->Wrap(mHead + aIndex)];
+	}
+
+	const T& operator[](size_t aIndex) const {
+		assert(aIndex < mSize);
+		return mSlots[this->Wrap(mHead + aIndex)];
+	}
+
+	/// Empties the queue but keeps the storage
+	void Clear() {
+		mHead = 0;
+		mSize = 0;
+	}
+
+private:
+
+	size_t Wrap(size_t aPos) const {
+		return (aPos < mSlots.size()) ? aPos : aPos - mSlots.size();
+	}
+
+	// doubles the storage, unrolling the ring so the front lands at slot 0
+	void Grow() {
+		std::vector<T> slots(mSlots.size() * 2);
+		for(size_t i = 0; i < mSize; ++i) slots[i] = mSlots[this->Wrap(mHead + i)];
+		mSlots.swap(slots);
+		mHead = 0;
+	}
+
+	std::vector<T> mSlots;
+	size_t mHead;
+	size_t mSize;
+};
+
+}
+
+#endif
+
+/* vim: set ts=4 sw=4: */
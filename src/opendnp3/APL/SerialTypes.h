@@ -21,6 +21,8 @@
 
 #include <string>
 
+#include "Types.h"
+
 namespace apl
 {
 
@@ -36,13 +38,38 @@ enum FlowType {
 	FLOW_XONXOFF
 };
 
+enum ReadModeType {
+	READ_STREAM,	// reads complete as soon as any bytes arrive
+	READ_FRAMED		// reads complete at the end of the frame being parsed or at a gap on the line
+};
+
 struct SerialSettings {
+	SerialSettings() :
+		mBaud(9600),
+		mDataBits(8),
+		mStopBits(1),
+		mParity(PAR_NONE),
+		mFlowType(FLOW_NONE),
+		mReadMode(READ_STREAM),
+		mInterCharGap(0),
+		mTurnaround(0)
+	{}
+
 	std::string mDevice;
 	int mBaud;
 	int mDataBits;
 	int mStopBits;
 	ParityType mParity;
 	FlowType mFlowType;
+
+	/// READ_FRAMED uses termios VMIN so the port only wakes when a frame is complete, POSIX only
+	ReadModeType mReadMode;
+
+	/// Silence that ends a framed read early, 0 for 4 character times at mBaud
+	millis_t mInterCharGap;
+
+	/// Quiet time after the last received byte before a write starts, for half duplex RS-485 lines
+	millis_t mTurnaround;
 };
 
 }
@@ -0,0 +1,152 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SharedByteRing.h"
+
+#include "Exception.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace apl
+{
+
+size_t SharedByteRing::GetRequiredSize(size_t aCapacity)
+{
+	return sizeof(Header) + aCapacity;
+}
+
+void SharedByteRing::Format(void* apMemory, size_t aCapacity)
+{
+	if(aCapacity == 0) throw ArgumentException(LOCATION, "The ring can't be empty");
+
+	memset(apMemory, 0, sizeof(Header));
+
+	Header* pHeader = reinterpret_cast<Header*>(apMemory);
+	pHeader->capacity = static_cast<boost::uint32_t>(aCapacity);
+	pHeader->version = VERSION;
+
+	// readers check the magic first, so it's written last
+	AtomicFenceRelease();
+	pHeader->magic = MAGIC;
+}
+
+SharedByteRing::SharedByteRing(void* apMemory, size_t aSize) :
+	mpHeader(reinterpret_cast<Header*>(apMemory)),
+	mpData(reinterpret_cast<boost::uint8_t*>(apMemory) + sizeof(Header)),
+	mCapacity(0)
+{
+	if(aSize < sizeof(Header) || mpHeader->magic != MAGIC) {
+		throw Exception(LOCATION, "Memory doesn't hold a shared byte ring");
+	}
+	AtomicFenceAcquire();
+	if(mpHeader->version != VERSION) {
+		std::ostringstream oss;
+		oss << "Shared byte ring version " << mpHeader->version << " isn't supported";
+		throw Exception(LOCATION, oss.str());
+	}
+
+	mCapacity = mpHeader->capacity;
+	if(aSize < GetRequiredSize(mCapacity)) {
+		std::ostringstream oss;
+		oss << "Shared byte ring needs " << GetRequiredSize(mCapacity) << " bytes, only " << aSize << " are mapped";
+		throw Exception(LOCATION, oss.str());
+	}
+}
+
+size_t SharedByteRing::Write(const boost::uint8_t* apData, size_t aNumBytes)
+{
+	boost::int64_t written = AtomicLoadRelaxed(&mpHeader->written);
+	boost::int64_t read = AtomicLoadAcquire(&mpHeader->read);
+
+	size_t space = mCapacity - static_cast<size_t>(written - read);
+	size_t num = (aNumBytes < space) ? aNumBytes : space;
+	if(num == 0) return 0;
+
+	size_t pos = static_cast<size_t>(written % mCapacity);
+	size_t first = (num < mCapacity - pos) ? num : mCapacity - pos;
+	memcpy(mpData + pos, apData, first);
+	memcpy(mpData, apData + first, num - first);
+
+	AtomicStoreRelease(&mpHeader->written, written + num);
+	return num;
+}
+
+size_t SharedByteRing::Read(boost::uint8_t* apData, size_t aMaxBytes)
+{
+	boost::int64_t read = AtomicLoadRelaxed(&mpHeader->read);
+	boost::int64_t written = AtomicLoadAcquire(&mpHeader->written);
+
+	size_t available = static_cast<size_t>(written - read);
+	size_t num = (aMaxBytes < available) ? aMaxBytes : available;
+	if(num == 0) return 0;
+
+	size_t pos = static_cast<size_t>(read % mCapacity);
+	size_t first = (num < mCapacity - pos) ? num : mCapacity - pos;
+	memcpy(apData, mpData + pos, first);
+	memcpy(apData + first, mpData, num - first);
+
+	AtomicStoreRelease(&mpHeader->read, read + num);
+	return num;
+}
+
+bool SharedByteRing::ArmWriter()
+{
+	AtomicStoreRelaxed(&mpHeader->writerWaiting, 1);
+	AtomicFenceFull();
+	boost::int64_t written = AtomicLoadRelaxed(&mpHeader->written);
+	if(written - AtomicLoadAcquire(&mpHeader->read) < static_cast<boost::int64_t>(mCapacity)) {
+		AtomicStoreRelaxed(&mpHeader->writerWaiting, 0);
+		return false;
+	}
+	return true;
+}
+
+bool SharedByteRing::ArmReader()
+{
+	AtomicStoreRelaxed(&mpHeader->readerWaiting, 1);
+	AtomicFenceFull();
+	if(AtomicLoadAcquire(&mpHeader->written) != AtomicLoadRelaxed(&mpHeader->read)) {
+		AtomicStoreRelaxed(&mpHeader->readerWaiting, 0);
+		return false;
+	}
+	return true;
+}
+
+bool SharedByteRing::TakeReader()
+{
+	return Take(&mpHeader->readerWaiting);
+}
+
+bool SharedByteRing::TakeWriter()
+{
+	return Take(&mpHeader->writerWaiting);
+}
+
+bool SharedByteRing::Take(atomic_int64_t* apFlag)
+{
+	// pairs with the fence in Arm*(): either the other side sees our count or we see its flag
+	AtomicFenceFull();
+	if(AtomicLoadRelaxed(apFlag) == 0) return false;
+	AtomicStoreRelaxed(apFlag, 0);
+	return true;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,113 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_BYTE_RING_H_
+#define __SHARED_BYTE_RING_H_
+
+#include "AtomicOps.h"
+
+#include <stddef.h>
+
+namespace apl
+{
+
+/**
+	View of a block of memory, normally in a shared memory segment, that
+	holds a lock-free byte ring with a single writer and a single reader.
+
+	The writer and reader each own a running byte count and only ever read
+	the other's, so neither waits for the other. Sleeping is left to the
+	caller: a side that finds nothing to do arms its waiting flag and, if
+	the ring still doesn't let it proceed, waits for a wakeup. A side that
+	makes progress takes the other's flag and, if it was set, sends the
+	wakeup. The flags are checked with full fences, so a wakeup can't be
+	lost between the check and the sleep.
+*/
+class SharedByteRing
+{
+public:
+
+	static const boost::uint32_t MAGIC = 0x474E4952; // "RING" in little endian
+	static const boost::uint32_t VERSION = 1;
+
+	/// @return the number of bytes a ring holding aCapacity bytes needs
+	static size_t GetRequiredSize(size_t aCapacity);
+
+	/// Lays out an empty ring in apMemory, which must be GetRequiredSize() bytes long
+	static void Format(void* apMemory, size_t aCapacity);
+
+	/// Wraps a formatted ring, @throw Exception if aSize is too small or the header doesn't match
+	SharedByteRing(void* apMemory, size_t aSize);
+
+	size_t Capacity() const {
+		return mCapacity;
+	}
+
+	/// @return the number of bytes the ring and its header occupy
+	size_t Size() const {
+		return GetRequiredSize(mCapacity);
+	}
+
+	// --- writer ---
+
+	/// Copies as many of the bytes as fit, @return the number copied
+	size_t Write(const boost::uint8_t* apData, size_t aNumBytes);
+
+	/// Sets the writer's waiting flag, @return false if space appeared and it was cleared again
+	bool ArmWriter();
+
+	/// Clears the reader's waiting flag, @return true if it was set and the reader needs a wakeup
+	bool TakeReader();
+
+	// --- reader ---
+
+	/// Copies up to aMaxBytes, @return the number copied
+	size_t Read(boost::uint8_t* apData, size_t aMaxBytes);
+
+	/// Sets the reader's waiting flag, @return false if data appeared and it was cleared again
+	bool ArmReader();
+
+	/// Clears the writer's waiting flag, @return true if it was set and the writer needs a wakeup
+	bool TakeWriter();
+
+private:
+
+	// the counts are on separate cache lines so the two sides don't false share
+	struct Header {
+		boost::uint32_t magic;
+		boost::uint32_t version;
+		boost::uint32_t capacity;
+		boost::uint32_t pad;
+		atomic_int64_t written;
+		atomic_int64_t writerWaiting;
+		boost::uint8_t pad1[32];
+		atomic_int64_t read;
+		atomic_int64_t readerWaiting;
+		boost::uint8_t pad2[48];
+	};
+
+	static bool Take(atomic_int64_t* apFlag);
+
+	Header* mpHeader;
+	boost::uint8_t* mpData;
+	size_t mCapacity;
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SharedMemoryDataObserver.h"
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include "Exception.h"
+
+using namespace boost::interprocess;
+
+namespace apl
+{
+
+SharedMemoryDataObserver::SharedMemoryDataObserver(const std::string& arName, const SharedPointTableSizes& arSizes) :
+	mName(arName),
+	mNumChanges(0),
+	mNumDropped(0)
+{
+	size_t size = SharedPointTable::GetRequiredSize(arSizes);
+
+	try {
+		shared_memory_object::remove(mName.c_str());
+		shared_memory_object shm(create_only, mName.c_str(), read_write);
+		shm.truncate(static_cast<offset_t>(size));
+		mpRegion.reset(new mapped_region(shm, read_write, 0, size));
+	} catch(const interprocess_exception& ex) {
+		throw Exception(LOCATION, "Unable to create shared memory segment " + mName + ": " + ex.what());
+	}
+
+	SharedPointTable::Format(mpRegion->get_address(), arSizes);
+	mpTable.reset(new SharedPointTable(mpRegion->get_address(), mpRegion->get_size()));
+}
+
+SharedMemoryDataObserver::~SharedMemoryDataObserver()
+{
+	mpTable.reset();
+	mpRegion.reset();
+	shared_memory_object::remove(mName.c_str());
+}
+
+void SharedMemoryDataObserver::_End()
+{
+	mpTable->Publish(mNumChanges);
+}
+
+void SharedMemoryDataObserver::_Update(const Binary& arPoint, size_t aIndex)
+{
+	this->Write(SPT_BINARY, arPoint, aIndex);
+}
+
+void SharedMemoryDataObserver::_Update(const Analog& arPoint, size_t aIndex)
+{
+	this->Write(SPT_ANALOG, arPoint, aIndex);
+}
+
+void SharedMemoryDataObserver::_Update(const Counter& arPoint, size_t aIndex)
+{
+	this->Write(SPT_COUNTER, arPoint, aIndex);
+}
+
+void SharedMemoryDataObserver::_Update(const ControlStatus& arPoint, size_t aIndex)
+{
+	this->Write(SPT_CONTROL_STATUS, arPoint, aIndex);
+}
+
+void SharedMemoryDataObserver::_Update(const SetpointStatus& arPoint, size_t aIndex)
+{
+	this->Write(SPT_SETPOINT_STATUS, arPoint, aIndex);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
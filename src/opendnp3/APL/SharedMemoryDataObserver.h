@@ -0,0 +1,105 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_MEMORY_DATA_OBSERVER_H_
+#define __SHARED_MEMORY_DATA_OBSERVER_H_
+
+#include "DataInterfaces.h"
+#include "SharedPointTable.h"
+
+#include <memory>
+#include <string>
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace apl
+{
+
+/**
+	DataObserver that publishes the last value of every point into a named
+	shared memory segment laid out as a SharedPointTable. Any number of local
+	processes can then read snapshots and poll for changes with a
+	SharedMemoryDataReader, without locks and without involving the thread
+	that feeds the observer.
+
+	Use one observer per stack, combined with other observers through a
+	MultiplexingDataObserver if needed. Changes become visible to readers
+	when each update transaction ends. Updates to indices outside the
+	configured sizes are dropped.
+
+	The segment is created when the observer is constructed, replacing any
+	segment left behind with the same name, and its name is removed when the
+	observer is destroyed. Readers that already have it open keep working.
+*/
+class SharedMemoryDataObserver : public IDataObserver
+{
+public:
+
+	/// @throw Exception if the segment can't be created
+	SharedMemoryDataObserver(const std::string& arName, const SharedPointTableSizes& arSizes);
+	~SharedMemoryDataObserver();
+
+	const std::string& GetName() const {
+		return mName;
+	}
+
+	/// @return number of updates dropped because their index was out of range
+	size_t NumDropped() const {
+		return mNumDropped;
+	}
+
+private:
+
+	void _Start() {}
+	void _End();
+
+	void _Update(const Binary& arPoint, size_t aIndex);
+	void _Update(const Analog& arPoint, size_t aIndex);
+	void _Update(const Counter& arPoint, size_t aIndex);
+	void _Update(const ControlStatus& arPoint, size_t aIndex);
+	void _Update(const SetpointStatus& arPoint, size_t aIndex);
+
+	template <class T>
+	void Write(SharedPointType aType, const T& arPoint, size_t aIndex);
+
+	std::string mName;
+	std::auto_ptr<boost::interprocess::mapped_region> mpRegion;
+	std::auto_ptr<SharedPointTable> mpTable;
+	boost::int64_t mNumChanges;
+	size_t mNumDropped;
+};
+
+template <class T>
+void SharedMemoryDataObserver::Write(SharedPointType aType, const T& arPoint, size_t aIndex)
+{
+	if(mpTable->Write(aType, aIndex, static_cast<double>(arPoint.GetValue()), arPoint.GetQuality(), arPoint.GetTime())) {
+		mpTable->AddChange(mNumChanges++, aType, aIndex);
+	} else {
+		++mNumDropped;
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SharedMemoryDataReader.h"
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include "Exception.h"
+
+using namespace boost::interprocess;
+
+namespace apl
+{
+
+SharedMemoryDataReader::SharedMemoryDataReader(const std::string& arName) :
+	mCursor(0),
+	mNumRetries(0)
+{
+	try {
+		shared_memory_object shm(open_only, arName.c_str(), read_only);
+		mpRegion.reset(new mapped_region(shm, read_only));
+	} catch(const interprocess_exception& ex) {
+		throw Exception(LOCATION, "Unable to open shared memory segment " + arName + ": " + ex.what());
+	}
+
+	mpTable.reset(new SharedPointTable(mpRegion->get_address(), mpRegion->get_size()));
+	mCursor = mpTable->NumChanges();
+}
+
+SharedMemoryDataReader::~SharedMemoryDataReader()
+{
+
+}
+
+size_t SharedMemoryDataReader::NumPoints(SharedPointType aType) const
+{
+	return mpTable->NumPoints(aType);
+}
+
+bool SharedMemoryDataReader::Read(SharedPointType aType, size_t aIndex, SharedPointValue& arValue)
+{
+	return mpTable->Read(aType, aIndex, arValue, mNumRetries);
+}
+
+bool SharedMemoryDataReader::PollChanges(std::vector<SharedPointChange>& arChanges)
+{
+	boost::int64_t start = mCursor;
+	mCursor = mpTable->NumChanges();
+
+	if(mCursor - start > static_cast<boost::int64_t>(mpTable->RingSize())) return false;
+
+	size_t initial = arChanges.size();
+	for(boost::int64_t i = start; i < mCursor; ++i) {
+		SharedPointChange change;
+		if(!mpTable->ReadChange(i, change)) {
+			arChanges.resize(initial);
+			return false;
+		}
+		arChanges.push_back(change);
+	}
+
+	return true;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,83 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_MEMORY_DATA_READER_H_
+#define __SHARED_MEMORY_DATA_READER_H_
+
+#include "SharedPointTable.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace apl
+{
+
+/**
+	Reads a shared memory segment published by a SharedMemoryDataObserver,
+	normally from another process. Reads never block the writer. A reader
+	instance isn't thread safe, but each thread or process can open its own.
+*/
+class SharedMemoryDataReader
+{
+public:
+
+	/// @throw Exception if the segment doesn't exist or doesn't hold a shared point table
+	SharedMemoryDataReader(const std::string& arName);
+	~SharedMemoryDataReader();
+
+	size_t NumPoints(SharedPointType aType) const;
+
+	/// Copies the latest value of a point, returns false if the index is out of range or the point hasn't been published
+	bool Read(SharedPointType aType, size_t aIndex, SharedPointValue& arValue);
+
+	/**
+		Appends every change published since the previous call, or since the
+		reader was opened, to arChanges. A point that changed several times
+		is listed several times.
+
+		@return false if the writer got more than a ring ahead and changes were
+				lost. The cursor is moved to the latest change, so the caller
+				should re-read every point it's interested in.
+	*/
+	bool PollChanges(std::vector<SharedPointChange>& arChanges);
+
+	/// @return number of times Read() raced the writer and had to copy a point again
+	size_t NumRetries() const {
+		return mNumRetries;
+	}
+
+private:
+
+	std::auto_ptr<boost::interprocess::mapped_region> mpRegion;
+	std::auto_ptr<SharedPointTable> mpTable;
+	boost::int64_t mCursor;
+	size_t mNumRetries;
+};
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SharedPointTable.h"
+
+#include "Exception.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace apl
+{
+
+namespace
+{
+
+const size_t CACHE_LINE = 64;
+
+size_t RoundUp(size_t aSize)
+{
+	return ((aSize + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+}
+
+SharedPointTableSizes::SharedPointTableSizes(size_t aNumBinary, size_t aNumAnalog, size_t aNumCounter,
+        size_t aNumControlStatus, size_t aNumSetpointStatus, size_t aRingSize) :
+	RingSize(aRingSize)
+{
+	NumPoints[SPT_BINARY] = aNumBinary;
+	NumPoints[SPT_ANALOG] = aNumAnalog;
+	NumPoints[SPT_COUNTER] = aNumCounter;
+	NumPoints[SPT_CONTROL_STATUS] = aNumControlStatus;
+	NumPoints[SPT_SETPOINT_STATUS] = aNumSetpointStatus;
+}
+
+size_t SharedPointTable::GetHeaderSize()
+{
+	return RoundUp(sizeof(Header));
+}
+
+size_t SharedPointTable::GetRequiredSize(const SharedPointTableSizes& arSizes)
+{
+	size_t size = GetHeaderSize();
+	for(size_t i = 0; i < SPT_NUM_TYPES; ++i) size += RoundUp(arSizes.NumPoints[i] * sizeof(Point));
+	return size + arSizes.RingSize * sizeof(Change);
+}
+
+void SharedPointTable::Format(void* apMemory, const SharedPointTableSizes& arSizes)
+{
+	if(arSizes.RingSize == 0) throw ArgumentException(LOCATION, "The change ring can't be empty");
+
+	size_t size = GetRequiredSize(arSizes);
+	memset(apMemory, 0, size);
+
+	// the ring is at the end, mark every slot as empty
+	Change* pRing = reinterpret_cast<Change*>(reinterpret_cast<boost::uint8_t*>(apMemory) + size - arSizes.RingSize * sizeof(Change));
+	for(size_t i = 0; i < arSizes.RingSize; ++i) pRing[i].num = -1;
+
+	Header* pHeader = reinterpret_cast<Header*>(apMemory);
+	for(size_t i = 0; i < SPT_NUM_TYPES; ++i) pHeader->numPoints[i] = static_cast<boost::uint32_t>(arSizes.NumPoints[i]);
+	pHeader->ringSize = static_cast<boost::uint32_t>(arSizes.RingSize);
+	pHeader->version = VERSION;
+
+	// readers check the magic first, so it's written last
+	AtomicFenceRelease();
+	pHeader->magic = MAGIC;
+}
+
+SharedPointTable::SharedPointTable(void* apMemory, size_t aSize) :
+	mpHeader(reinterpret_cast<Header*>(apMemory)),
+	mpRing(NULL),
+	mRingSize(0)
+{
+	if(aSize < GetHeaderSize() || mpHeader->magic != MAGIC) {
+		throw Exception(LOCATION, "Memory doesn't hold a shared point table");
+	}
+	AtomicFenceAcquire();
+	if(mpHeader->version != VERSION) {
+		std::ostringstream oss;
+		oss << "Shared point table version " << mpHeader->version << " isn't supported";
+		throw Exception(LOCATION, oss.str());
+	}
+
+	SharedPointTableSizes sizes(0, 0, 0, 0, 0, mpHeader->ringSize);
+	for(size_t i = 0; i < SPT_NUM_TYPES; ++i) sizes.NumPoints[i] = mpHeader->numPoints[i];
+
+	if(aSize < GetRequiredSize(sizes)) {
+		std::ostringstream oss;
+		oss << "Shared point table needs " << GetRequiredSize(sizes) << " bytes, only " << aSize << " are mapped";
+		throw Exception(LOCATION, oss.str());
+	}
+
+	boost::uint8_t* pPos = reinterpret_cast<boost::uint8_t*>(apMemory) + GetHeaderSize();
+	for(size_t i = 0; i < SPT_NUM_TYPES; ++i) {
+		mpPoints[i] = reinterpret_cast<Point*>(pPos);
+		mNumPoints[i] = sizes.NumPoints[i];
+		pPos += RoundUp(mNumPoints[i] * sizeof(Point));
+	}
+
+	mpRing = reinterpret_cast<Change*>(pPos);
+	mRingSize = sizes.RingSize;
+}
+
+size_t SharedPointTable::NumPoints(SharedPointType aType) const
+{
+	return mNumPoints[aType];
+}
+
+boost::int64_t SharedPointTable::NumChanges() const
+{
+	return AtomicLoadAcquire(&mpHeader->numChanges);
+}
+
+bool SharedPointTable::Write(SharedPointType aType, size_t aIndex, double aValue, boost::uint8_t aQuality, millis_t aTime)
+{
+	if(aIndex >= mNumPoints[aType]) return false;
+
+	Point& point = mpPoints[aType][aIndex];
+	boost::int64_t seq = AtomicLoadRelaxed(&point.seq);
+
+	AtomicStoreRelaxed(&point.seq, seq + 1);
+	AtomicFenceRelease();
+
+	point.value = aValue;
+	point.time = aTime;
+	point.quality = aQuality;
+
+	AtomicStoreRelease(&point.seq, seq + 2);
+	return true;
+}
+
+void SharedPointTable::AddChange(boost::int64_t aNum, SharedPointType aType, size_t aIndex)
+{
+	Change& change = mpRing[aNum % mRingSize];
+
+	// invalidate the slot first so a reader can't match the old number against the new contents
+	AtomicStoreRelaxed(&change.num, -1);
+	AtomicFenceRelease();
+
+	change.type = static_cast<boost::uint32_t>(aType);
+	change.index = static_cast<boost::uint32_t>(aIndex);
+
+	AtomicStoreRelease(&change.num, aNum);
+}
+
+void SharedPointTable::Publish(boost::int64_t aNumChanges)
+{
+	AtomicStoreRelease(&mpHeader->numChanges, aNumChanges);
+}
+
+bool SharedPointTable::Read(SharedPointType aType, size_t aIndex, SharedPointValue& arValue, size_t& arRetries) const
+{
+	if(aIndex >= mNumPoints[aType]) return false;
+
+	const Point& point = mpPoints[aType][aIndex];
+
+	for(;;) {
+		boost::int64_t before = AtomicLoadAcquire(&point.seq);
+		if(before == 0) return false;
+
+		if((before & 1) == 0) {
+			arValue.Value = point.value;
+			arValue.Time = point.time;
+			arValue.Quality = static_cast<boost::uint8_t>(point.quality);
+
+			AtomicFenceAcquire();
+			if(AtomicLoadRelaxed(&point.seq) == before) return true;
+		}
+
+		++arRetries;
+	}
+}
+
+bool SharedPointTable::ReadChange(boost::int64_t aNum, SharedPointChange& arChange) const
+{
+	const Change& change = mpRing[aNum % mRingSize];
+
+	if(AtomicLoadAcquire(&change.num) != aNum) return false;
+
+	arChange.Type = static_cast<SharedPointType>(change.type);
+	arChange.Index = change.index;
+
+	AtomicFenceAcquire();
+	return AtomicLoadRelaxed(&change.num) == aNum;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
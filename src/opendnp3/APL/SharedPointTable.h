@@ -0,0 +1,166 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_POINT_TABLE_H_
+#define __SHARED_POINT_TABLE_H_
+
+#include "AtomicOps.h"
+#include "Types.h"
+
+#include <stddef.h>
+
+namespace apl
+{
+
+enum SharedPointType {
+	SPT_BINARY,
+	SPT_ANALOG,
+	SPT_COUNTER,
+	SPT_CONTROL_STATUS,
+	SPT_SETPOINT_STATUS,
+	SPT_NUM_TYPES
+};
+
+/// Number of points of each type and the length of the change ring
+struct SharedPointTableSizes {
+	SharedPointTableSizes(size_t aNumBinary = 0, size_t aNumAnalog = 0, size_t aNumCounter = 0,
+	                      size_t aNumControlStatus = 0, size_t aNumSetpointStatus = 0, size_t aRingSize = 4096);
+
+	size_t NumPoints[SPT_NUM_TYPES];
+	size_t RingSize;
+};
+
+/// A consistent copy of one point, taken with SharedPointTable::Read()
+struct SharedPointValue {
+	SharedPointValue() : Value(0), Quality(0), Time(0) {}
+
+	double Value;				// bool types are 0 or 1
+	boost::uint8_t Quality;
+	millis_t Time;
+};
+
+/// Identifies a point that changed
+struct SharedPointChange {
+	SharedPointChange() : Type(SPT_BINARY), Index(0) {}
+	SharedPointChange(SharedPointType aType, size_t aIndex) : Type(aType), Index(aIndex) {}
+
+	SharedPointType Type;
+	size_t Index;
+};
+
+/**
+	View of a block of memory, normally a shared memory segment, that holds
+	the last value of every point of a stack and a ring of the most recent
+	changes. There's a single writer and any number of lock-free readers.
+
+	The block is a header followed by one array per point type and then the
+	change ring. Each point is guarded by its own seqlock: the writer makes
+	the sequence odd, writes the point and makes it even again, and readers
+	retry until they see the same even sequence before and after copying it.
+
+	The writer adds changes to the ring as it writes points and publishes
+	them by advancing the header's change count. Readers keep their own
+	cursor into the ring. Each ring entry holds the change number it was
+	written for, so a reader that falls more than a ring behind can tell
+	that it missed changes.
+*/
+class SharedPointTable
+{
+public:
+
+	static const boost::uint32_t MAGIC = 0x33504E44; // "DNP3" in little endian
+	static const boost::uint32_t VERSION = 1;
+
+	/// @return the number of bytes a table of the given sizes needs
+	static size_t GetRequiredSize(const SharedPointTableSizes& arSizes);
+
+	/// Lays out an empty table in apMemory, which must be GetRequiredSize() bytes long
+	static void Format(void* apMemory, const SharedPointTableSizes& arSizes);
+
+	/// Wraps a formatted table, @throw Exception if aSize is too small or the header doesn't match
+	SharedPointTable(void* apMemory, size_t aSize);
+
+	size_t NumPoints(SharedPointType aType) const;
+
+	size_t RingSize() const {
+		return mRingSize;
+	}
+
+	/// Number of changes the writer has published
+	boost::int64_t NumChanges() const;
+
+	// --- writer ---
+
+	/// Writes a point, returns false if the index is out of range
+	bool Write(SharedPointType aType, size_t aIndex, double aValue, boost::uint8_t aQuality, millis_t aTime);
+
+	/// Adds change number aNum to the ring, it becomes visible when Publish() is called with a higher count
+	void AddChange(boost::int64_t aNum, SharedPointType aType, size_t aIndex);
+
+	/// Makes the first aNumChanges changes visible to readers
+	void Publish(boost::int64_t aNumChanges);
+
+	// --- readers ---
+
+	/**
+		Copies a point
+
+		@param arRetries	incremented each time the copy raced the writer and had to be repeated
+		@return				false if the index is out of range or the point hasn't been written
+	*/
+	bool Read(SharedPointType aType, size_t aIndex, SharedPointValue& arValue, size_t& arRetries) const;
+
+	/// Copies change number aNum, returns false if it has already been overwritten
+	bool ReadChange(boost::int64_t aNum, SharedPointChange& arChange) const;
+
+private:
+
+	struct Header {
+		boost::uint32_t magic;
+		boost::uint32_t version;
+		boost::uint32_t numPoints[SPT_NUM_TYPES];
+		boost::uint32_t ringSize;
+		atomic_int64_t numChanges;
+	};
+
+	struct Point {
+		atomic_int64_t seq;
+		double value;
+		boost::int64_t time;
+		boost::uint32_t quality;
+		boost::uint32_t pad;
+	};
+
+	struct Change {
+		atomic_int64_t num;
+		boost::uint32_t type;
+		boost::uint32_t index;
+	};
+
+	static size_t GetHeaderSize();
+
+	Header* mpHeader;
+	Point* mpPoints[SPT_NUM_TYPES];
+	size_t mNumPoints[SPT_NUM_TYPES];
+	Change* mpRing;
+	size_t mRingSize;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __TCP_TYPES_H_
+#define __TCP_TYPES_H_
+
+#include "Types.h"
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+namespace apl
+{
+
+/// Which machinery reads and writes the connected sockets of TCP ports
+enum TCPBackend {
+	TCPB_ASIO,		//!< the asio reactor, epoll on Linux
+	TCPB_IO_URING	//!< a shared Linux io_uring, see IoUringService
+};
+
+struct TCPEndpoint {
+	TCPEndpoint(const std::string& arAddress, boost::uint16_t aPort) :
+		mAddress(arAddress),
+		mPort(aPort)
+	{}
+
+	std::string mAddress;
+	boost::uint16_t mPort;
+};
+
+/**
+	Settings for a TCP client that can reach the same device through more
+	than one endpoint, e.g. the redundant ports of an RTU or a backup
+	terminal server.
+*/
+struct TCPRedundantSettings {
+	TCPRedundantSettings() :
+		mStagger(250),
+		mNumStandbys(0)
+	{}
+
+	void AddEndpoint(const std::string& arAddress, boost::uint16_t aPort) {
+		mEndpoints.push_back(TCPEndpoint(arAddress, aPort));
+	}
+
+	/// Endpoints in order of preference
+	std::vector<TCPEndpoint> mEndpoints;
+
+	/// How long an open waits for a connect before starting the next endpoint's in parallel
+	millis_t mStagger;
+
+	/// Number of idle connections kept to the other endpoints so a failover doesn't have to connect
+	size_t mNumStandbys;
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "TimerASIO.h"
 #include "AsyncResult.h"
+#include "HandlerProfiler.h"
 
 #include <boost/asio.hpp>
 #include <boost/foreach.hpp>
@@ -58,7 +59,7 @@ ITimer* TimerSourceASIO::Start(const boost::posix_time::ptime& arTime, const Fun
 
 void TimerSourceASIO::Post(const FunctionVoidZero& arHandler)
 {
-	mpService->post(arHandler);
+	mpService->post(HandlerProfiler::BindIfEnabled(arHandler));
 }
 
 void TimerSourceASIO::PostSync(const FunctionVoidZero& arHandler)
@@ -100,7 +101,7 @@ TimerASIO* TimerSourceASIO::GetTimer()
 
 void TimerSourceASIO::StartTimer(TimerASIO* apTimer, const FunctionVoidZero& arCallback)
 {
-	apTimer->mTimer.async_wait(boost::bind(&TimerSourceASIO::OnTimerCallback, this, _1, apTimer, arCallback));
+	apTimer->mTimer.async_wait(boost::bind(&TimerSourceASIO::OnTimerCallback, this, _1, apTimer, HandlerProfiler::BindIfEnabled(arCallback)));
 }
 
 void TimerSourceASIO::OnTimerCallback(const boost::system::error_code& ec, TimerASIO* apTimer, FunctionVoidZero aCallback)
@@ -0,0 +1,150 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "VirtualTimerSource.h"
+
+#include "TimeBoost.h"
+
+#include <boost/foreach.hpp>
+
+using namespace boost::posix_time;
+
+namespace apl
+{
+
+VirtualTimerSource::VirtualTimerSource(const boost::posix_time::ptime& arStart) :
+	mStart(arStart),
+	mNow(arStart),
+	mSequence(0),
+	mNumRun(0)
+{
+
+}
+
+VirtualTimerSource::~VirtualTimerSource()
+{
+	BOOST_FOREACH(VirtualTimer * pTimer, mAllTimers) {
+		delete pTimer;
+	}
+}
+
+ITimer* VirtualTimerSource::Start(millis_t aDelay, const FunctionVoidZero& arCallback)
+{
+	return this->Schedule(mNow + milliseconds(aDelay), arCallback);
+}
+
+ITimer* VirtualTimerSource::Start(const boost::posix_time::ptime& arTime, const FunctionVoidZero& arCallback)
+{
+	return this->Schedule(arTime, arCallback);
+}
+
+void VirtualTimerSource::Post(const FunctionVoidZero& arHandler)
+{
+	this->Schedule(mNow, arHandler);
+}
+
+void VirtualTimerSource::PostSync(const FunctionVoidZero& arHandler)
+{
+	arHandler();
+}
+
+TimeStamp_t VirtualTimerSource::GetTimeStampUTC()
+{
+	TimeBoost t(mNow);
+	return TimeStamp_t(t.GetValueMS());
+}
+
+bool VirtualTimerSource::RunOne()
+{
+	if(mEvents.empty()) return false;
+
+	VirtualTimer* pTimer = *mEvents.begin();
+	mEvents.erase(mEvents.begin());
+
+	// a timer set in the past runs now, virtual time never goes backwards
+	if(pTimer->mTime > mNow) mNow = pTimer->mTime;
+
+	// the callback may start new timers, so the slot is released before it runs
+	FunctionVoidZero callback;
+	callback.swap(pTimer->mCallback);
+	pTimer->mActive = false;
+	mIdle.push_back(pTimer);
+
+	++mNumRun;
+	callback();
+	return true;
+}
+
+size_t VirtualTimerSource::RunUntil(const boost::posix_time::ptime& arTime)
+{
+	size_t num = 0;
+	while(!mEvents.empty() && (*mEvents.begin())->mTime <= arTime) {
+		this->RunOne();
+		++num;
+	}
+	if(arTime > mNow) mNow = arTime;
+	return num;
+}
+
+size_t VirtualTimerSource::RunFor(millis_t aDuration)
+{
+	return this->RunUntil(mNow + milliseconds(aDuration));
+}
+
+VirtualTimer* VirtualTimerSource::Schedule(const boost::posix_time::ptime& arTime, const FunctionVoidZero& arCallback)
+{
+	VirtualTimer* pTimer;
+	if(mIdle.empty()) {
+		pTimer = new VirtualTimer(this);
+		mAllTimers.push_back(pTimer);
+	} else {
+		pTimer = mIdle.front();
+		mIdle.pop_front();
+	}
+
+	pTimer->mTime = arTime;
+	pTimer->mSequence = mSequence++;
+	pTimer->mCallback = arCallback;
+	pTimer->mActive = true;
+	mEvents.insert(pTimer);
+	return pTimer;
+}
+
+void VirtualTimerSource::Cancel(VirtualTimer* apTimer)
+{
+	if(!apTimer->mActive) return;
+	mEvents.erase(apTimer);
+	apTimer->mActive = false;
+	apTimer->mCallback.clear();
+	mIdle.push_back(apTimer);
+}
+
+bool VirtualTimerSource::EventOrder::operator()(const VirtualTimer* apLeft, const VirtualTimer* apRight) const
+{
+	if(apLeft->mTime != apRight->mTime) return apLeft->mTime < apRight->mTime;
+	return apLeft->mSequence < apRight->mSequence;
+}
+
+void VirtualTimer::Cancel()
+{
+	mpSource->Cancel(this);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
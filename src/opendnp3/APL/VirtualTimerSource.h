@@ -0,0 +1,140 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __VIRTUAL_TIMER_SOURCE_H_
+#define __VIRTUAL_TIMER_SOURCE_H_
+
+#include "ITimerSource.h"
+#include "ITimeSource.h"
+#include "Uncopyable.h"
+
+#include <deque>
+#include <set>
+
+namespace apl
+{
+
+class VirtualTimer;
+
+/**
+ * Discrete event timer source that runs everything on the calling thread in
+ * virtual time. The clock only moves when RunOne() takes the next event off
+ * the queue, so a simulated day of polls and timeouts takes as long as the
+ * callbacks themselves.
+ *
+ * It is also the ITimeSource of whatever it drives, so task schedules,
+ * statistics and timeouts all agree on the virtual time. Events due at the
+ * same time run in the order they were started or posted.
+ *
+ * Not thread safe, PostSync() runs the handler immediately.
+ */
+class VirtualTimerSource : public ITimerSource, public ITimeSource, private Uncopyable
+{
+	friend class VirtualTimer;
+
+public:
+	VirtualTimerSource(const boost::posix_time::ptime& arStart = boost::posix_time::ptime(boost::gregorian::date(2000, 1, 1)));
+	~VirtualTimerSource();
+
+	// Implement ITimerSource
+	ITimer* Start(millis_t, const FunctionVoidZero&);
+	ITimer* Start(const boost::posix_time::ptime&, const FunctionVoidZero&);
+	void Post(const FunctionVoidZero&);
+	void PostSync(const FunctionVoidZero&);
+
+	// Implement ITimeSource
+	boost::posix_time::ptime GetUTC() {
+		return mNow;
+	}
+	TimeStamp_t GetTimeStampUTC();
+
+	/** Moves the clock to the next event and runs it
+		@return false if nothing is scheduled */
+	bool RunOne();
+
+	/** Runs every event due at or before arTime, then leaves the clock at arTime
+		@return the number of events run */
+	size_t RunUntil(const boost::posix_time::ptime& arTime);
+
+	/// Runs the next aDuration ms of virtual time
+	size_t RunFor(millis_t aDuration);
+
+	/// @return ms of virtual time since the source was constructed
+	millis_t Elapsed() const {
+		return (mNow - mStart).total_milliseconds();
+	}
+
+	/// @return timers and posts waiting to run
+	size_t NumPending() const {
+		return mEvents.size();
+	}
+
+	/// @return events run since construction
+	boost::uint64_t NumRun() const {
+		return mNumRun;
+	}
+
+private:
+
+	VirtualTimer* Schedule(const boost::posix_time::ptime& arTime, const FunctionVoidZero&);
+	void Cancel(VirtualTimer* apTimer);
+
+	// orders by expiration, then by when the event was scheduled
+	struct EventOrder {
+		bool operator()(const VirtualTimer* apLeft, const VirtualTimer* apRight) const;
+	};
+
+	typedef std::set<VirtualTimer*, EventOrder> EventSet;
+	typedef std::deque<VirtualTimer*> TimerQueue;
+
+	boost::posix_time::ptime mStart;
+	boost::posix_time::ptime mNow;
+	boost::uint64_t mSequence;
+	boost::uint64_t mNumRun;
+
+	EventSet mEvents;
+	TimerQueue mIdle;
+	TimerQueue mAllTimers;
+};
+
+/** Timer handed out by VirtualTimerSource */
+class VirtualTimer : public ITimer
+{
+	friend class VirtualTimerSource;
+
+public:
+	VirtualTimer(VirtualTimerSource* apSource) : mpSource(apSource), mSequence(0), mActive(false)
+	{}
+
+	// Implement ITimer
+	void Cancel();
+	boost::posix_time::ptime ExpiresAt() {
+		return mTime;
+	}
+
+private:
+	VirtualTimerSource* mpSource;
+	boost::posix_time::ptime mTime;
+	boost::uint64_t mSequence;
+	bool mActive;
+	FunctionVoidZero mCallback;
+};
+
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <boost/bind.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
 #include <queue>
+#include <map>
 
 using namespace apl;
 using namespace boost;
@@ -73,6 +74,24 @@ private:
 	}
 };
 
+typedef std::map<ITask*, size_t> CountMap;
+
+// Runs a group for aDuration with every task occupying it for aServiceTime, like polls on a shared line
+void Simulate(MockTaskHandler& arHandler, MockTimerSource& arTimers, MockTimeSource& arTime, millis_t aDuration, millis_t aServiceTime, CountMap& arCounts)
+{
+	ptime end = arTime.GetUTC() + milliseconds(aDuration);
+	while(arTime.GetUTC() < end) {
+		if(arHandler.Size() > 0) {
+			++arCounts[arHandler.Front()];
+			arTime.Advance(aServiceTime);
+			arHandler.Complete(true);
+		} else {
+			arTime.Advance(100);
+			arTimers.DispatchOne();
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE(AsyncTaskSuite)
 
 BOOST_AUTO_TEST_CASE(DependencyAnalysis)
@@ -211,6 +230,37 @@ BOOST_AUTO_TEST_CASE(PriorityBreaksTies)
 	BOOST_REQUIRE_EQUAL(mth.Front(), pT2);
 }
 
+BOOST_AUTO_TEST_CASE(PreemptedTaskRunsAgainAfterHigherPriority)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fakeTime;
+	fakeTime.SetToNow();
+	AsyncTaskScheduler ats(&mts, &fakeTime);
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+
+	AsyncTaskBase* pPoll = pGroup->Add(2000, 100, 0, mth.GetHandler());
+	AsyncTaskBase* pCommand = pGroup->Add(-1, 100, 1, mth.GetHandler());
+
+	pPoll->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Size(), 1);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pPoll);
+
+	pCommand->SilentEnable();
+	mth.Pop();
+	pPoll->OnPreempted();
+	BOOST_REQUIRE_EQUAL(mth.Size(), 1);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pCommand);
+
+	// the preempted task is still due, so it runs as soon as the command is done
+	mth.Complete(true);
+	BOOST_REQUIRE_EQUAL(mth.Size(), 1);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pPoll);
+
+	// and preempting a task that isn't running is an error
+	BOOST_REQUIRE_THROW(pCommand->OnPreempted(), InvalidStateException);
+}
+
 BOOST_AUTO_TEST_CASE(DependenciesEnforced)
 {
 	MockTaskHandler mth;
@@ -260,4 +310,170 @@ BOOST_AUTO_TEST_CASE(TimerUsage)
 	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(true);
 }
 
+BOOST_AUTO_TEST_CASE(EarliestDueTimeBreaksTies)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	fake_time.SetToNow();
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	AsyncTaskBase* pT1 = pGroup->Add(1000, 100, 0, mth.GetHandler());
+	AsyncTaskBase* pT2 = pGroup->Add(500, 100, 0, mth.GetHandler());
+
+	pGroup->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1); mth.Complete(true);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(true);
+
+	// both are expired, but T2 has been due the longest
+	fake_time.Advance(1000);
+	BOOST_REQUIRE(mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(true);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1); mth.Complete(true);
+}
+
+BOOST_AUTO_TEST_CASE(LeastRecentlyDispatchedBreaksTies)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	fake_time.SetToNow();
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	AsyncTaskBase* pT1 = pGroup->Add(1000, 100, 0, mth.GetHandler());
+	AsyncTaskBase* pT2 = pGroup->Add(1000, 100, 0, mth.GetHandler());
+
+	pT2->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(false);
+	pT1->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1); mth.Complete(false);
+
+	// both retry at the same time, T2 goes first since it ran longer ago
+	fake_time.Advance(100);
+	BOOST_REQUIRE(mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(false);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1); mth.Complete(false);
+}
+
+BOOST_AUTO_TEST_CASE(PeriodIsMeasuredFromDispatch)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	fake_time.SetToNow();
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	AsyncTaskBase* pT1 = pGroup->Add(1000, 100, 0, mth.GetHandler());
+
+	pGroup->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1);
+	fake_time.Advance(300);
+	mth.Complete(true);
+
+	fake_time.Advance(700);
+	BOOST_REQUIRE(mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1);
+}
+
+BOOST_AUTO_TEST_CASE(StatisticsTrackUtilizationAndLatency)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	fake_time.SetToNow();
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	pGroup->Add(1000, 100, 0, mth.GetHandler());
+
+	pGroup->Enable();
+	fake_time.Advance(250);
+	mth.Complete(true);
+
+	TaskGroupStatistics stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.NumDispatched, 1);
+	BOOST_REQUIRE_EQUAL(stats.NumScheduled, 0); // the first run has no due time
+	BOOST_REQUIRE_EQUAL(stats.Busy, 250);
+
+	fake_time.Advance(1000); // 250 ms late
+	BOOST_REQUIRE(mts.DispatchOne());
+	fake_time.Advance(250);
+
+	stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.Busy, 500); // includes the running task
+	mth.Complete(true);
+
+	stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.NumDispatched, 2);
+	BOOST_REQUIRE_EQUAL(stats.NumScheduled, 1);
+	BOOST_REQUIRE_EQUAL(stats.Elapsed, 1500);
+	BOOST_REQUIRE_EQUAL(stats.Busy, 500);
+	BOOST_REQUIRE_EQUAL(stats.MaxLatency, 250);
+	BOOST_REQUIRE_CLOSE(stats.GetMeanLatency(), 250.0, 0.001);
+	BOOST_REQUIRE_CLOSE(stats.GetUtilization(), 1.0 / 3.0, 0.001);
+
+	pGroup->ResetStatistics();
+	stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.NumDispatched, 0);
+	BOOST_REQUIRE_EQUAL(stats.Elapsed, 0);
+	BOOST_REQUIRE_EQUAL(stats.GetUtilization(), 0.0);
+}
+
+// 10 outstations polled every 10s over a line where each poll takes 500ms
+BOOST_AUTO_TEST_CASE(MultiDropRatesAreRespected)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	fake_time.SetToNow();
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	for(size_t i = 0; i < 10; ++i) pGroup->Add(10000, 1000, 0, mth.GetHandler());
+	pGroup->Enable();
+
+	CountMap counts;
+	Simulate(mth, mts, fake_time, 200000, 500, counts);
+
+	BOOST_REQUIRE_EQUAL(counts.size(), 10);
+	for(CountMap::iterator i = counts.begin(); i != counts.end(); ++i) {
+		BOOST_REQUIRE_EQUAL(i->second, 20);
+	}
+
+	TaskGroupStatistics stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.MaxLatency, 0);
+	BOOST_REQUIRE_CLOSE(stats.GetUtilization(), 0.5, 1.0);
+}
+
+// 30 outstations that need more line time than is available are served evenly and the line never idles
+BOOST_AUTO_TEST_CASE(MultiDropOverloadIsShared)
+{
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	fake_time.SetToNow();
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	for(size_t i = 0; i < 30; ++i) pGroup->Add(10000, 1000, 0, mth.GetHandler());
+	pGroup->Enable();
+
+	CountMap counts;
+	Simulate(mth, mts, fake_time, 150000, 500, counts);
+
+	BOOST_REQUIRE_EQUAL(counts.size(), 30);
+	for(CountMap::iterator i = counts.begin(); i != counts.end(); ++i) {
+		BOOST_REQUIRE_EQUAL(i->second, 10);
+	}
+
+	TaskGroupStatistics stats = pGroup->GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.Busy, stats.Elapsed);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
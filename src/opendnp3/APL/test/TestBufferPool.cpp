@@ -0,0 +1,86 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/BufferPool.h>
+
+using namespace apl;
+
+
+
+BOOST_AUTO_TEST_SUITE(BufferPoolSuite)
+
+BOOST_AUTO_TEST_CASE(AcquireAllocatesWhenEmpty)
+{
+	BufferPool pool;
+	CopyableBuffer buff;
+
+	pool.Acquire(buff, 100);
+	BOOST_REQUIRE_EQUAL(buff.Size(), 100);
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 1);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumBytesAllocated(), 100);
+
+	// already holds storage
+	pool.Acquire(buff, 100);
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedStorageIsReused)
+{
+	BufferPool pool;
+	CopyableBuffer a;
+	pool.Acquire(a, 100);
+	const boost::uint8_t* pStorage = a.Buffer();
+
+	pool.Release(a);
+	BOOST_REQUIRE_EQUAL(a.Size(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 1);
+
+	// releasing an empty buffer does nothing
+	pool.Release(a);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 1);
+
+	CopyableBuffer b;
+	pool.Acquire(b, 100);
+	BOOST_REQUIRE_EQUAL(b.Buffer(), pStorage);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumBytesAllocated(), 100);
+	pool.Release(b);
+}
+
+BOOST_AUTO_TEST_CASE(FreeListsAreKeyedBySize)
+{
+	BufferPool pool;
+	CopyableBuffer small;
+	pool.Acquire(small, 10);
+	pool.Release(small);
+
+	CopyableBuffer large;
+	pool.Acquire(large, 1000);
+	BOOST_REQUIRE_EQUAL(large.Size(), 1000);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 1);
+	BOOST_REQUIRE_EQUAL(pool.NumBytesAllocated(), 1010);
+	pool.Release(large);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,246 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+
+#include <opendnp3/APL/CaptureFile.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/PhysicalLayerAsyncReplay.h>
+#include <opendnp3/APL/ToHex.h>
+
+#include <opendnp3/APL/test/util/AsyncTestObjectASIO.h>
+#include <opendnp3/APL/test/util/BufferHelpers.h>
+#include <opendnp3/APL/test/util/MockPhysicalLayerAsync.h>
+#include <opendnp3/APL/test/util/MockUpperLayer.h>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+using namespace apl;
+
+namespace
+{
+
+const char CAPTURE_PATH[] = "capture_test.cap";
+
+// deletes the capture file when the test finishes
+class TempCapture
+{
+public:
+	~TempCapture() {
+		std::remove(CAPTURE_PATH);
+	}
+};
+
+void Record(CaptureWriter& arWriter, CaptureDirection aDirection, const std::string& arHex)
+{
+	HexSequence hs(arHex);
+	arWriter.Record(aDirection, hs, hs.Size());
+}
+
+void SetFlag(bool* apFlag)
+{
+	*apFlag = true;
+}
+
+std::string Hex(const CaptureRecord& arRecord)
+{
+	return toHex(arRecord.data, arRecord.data.Size(), true);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(CaptureSuite)
+
+BOOST_AUTO_TEST_CASE(WriteAndReadBack)
+{
+	TempCapture temp;
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		Record(writer, CD_READ, "05 64 0A");
+		Record(writer, CD_WRITE, "C0 01");
+		BOOST_REQUIRE_EQUAL(writer.NumRecords(), 2);
+	}
+
+	CaptureReader reader(CAPTURE_PATH);
+	CaptureRecord rec;
+
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.direction, CD_READ);
+	BOOST_REQUIRE_EQUAL(Hex(rec), "05 64 0A");
+	boost::int64_t first = rec.time;
+
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.direction, CD_WRITE);
+	BOOST_REQUIRE_EQUAL(Hex(rec), "C0 01");
+	BOOST_REQUIRE(rec.time >= first);
+
+	BOOST_REQUIRE_FALSE(reader.Next(rec));
+}
+
+BOOST_AUTO_TEST_CASE(SplitsLargeRecords)
+{
+	TempCapture temp;
+	size_t max = CaptureFile::MAX_RECORD_DATA;
+	std::vector<boost::uint8_t> data(max + 10, 0xAB);
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		writer.Record(CD_READ, &data[0], data.size());
+		BOOST_REQUIRE_EQUAL(writer.NumRecords(), 2);
+	}
+
+	CaptureReader reader(CAPTURE_PATH);
+	CaptureRecord rec;
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.data.Size(), max);
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.data.Size(), 10);
+	BOOST_REQUIRE_FALSE(reader.Next(rec));
+}
+
+BOOST_AUTO_TEST_CASE(RejectsFilesWithoutMagic)
+{
+	TempCapture temp;
+	{
+		ofstream file(CAPTURE_PATH);
+		file << "not a capture";
+	}
+	BOOST_REQUIRE_THROW(CaptureReader reader(CAPTURE_PATH), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsTruncatedRecords)
+{
+	TempCapture temp;
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		Record(writer, CD_READ, "01 02 03 04");
+	}
+	{
+		// chop off the last byte of data
+		ifstream in(CAPTURE_PATH, ios::binary);
+		string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+		in.close();
+		ofstream out(CAPTURE_PATH, ios::binary | ios::trunc);
+		out.write(contents.data(), contents.size() - 1);
+	}
+
+	CaptureReader reader(CAPTURE_PATH);
+	CaptureRecord rec;
+	BOOST_REQUIRE_THROW(reader.Next(rec), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(PhysicalLayerRecordsReadsAndWrites)
+{
+	TempCapture temp;
+	EventLog log;
+	MockPhysicalLayerAsync phys(log.GetLogger(LEV_INFO, "phys"));
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		phys.SetCapture(&writer);
+
+		phys.AsyncOpen();
+		phys.SignalOpenSuccess();
+
+		boost::uint8_t buff[100];
+		phys.AsyncRead(buff, 100);
+		phys.TriggerRead("01 02 03");
+
+		HexSequence hs("AA BB");
+		phys.AsyncWrite(hs, hs.Size());
+		phys.SignalSendSuccess();
+
+		phys.SetCapture(NULL);
+		phys.AsyncRead(buff, 100);
+		phys.TriggerRead("04"); // not recorded
+	}
+
+	CaptureReader reader(CAPTURE_PATH);
+	CaptureRecord rec;
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.direction, CD_READ);
+	BOOST_REQUIRE_EQUAL(Hex(rec), "01 02 03");
+	BOOST_REQUIRE(reader.Next(rec));
+	BOOST_REQUIRE_EQUAL(rec.direction, CD_WRITE);
+	BOOST_REQUIRE_EQUAL(Hex(rec), "AA BB");
+	BOOST_REQUIRE_FALSE(reader.Next(rec));
+}
+
+BOOST_AUTO_TEST_CASE(ReplayDeliversCapturedReads)
+{
+	TempCapture temp;
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		Record(writer, CD_READ, "01 02 03");
+		Record(writer, CD_WRITE, "FF");
+		Record(writer, CD_READ, "04 05");
+	}
+
+	EventLog log;
+	AsyncTestObjectASIO test;
+	PhysicalLayerAsyncReplay replay(log.GetLogger(LEV_INFO, "replay"), test.GetService(), CAPTURE_PATH, false);
+	LowerLayerToPhysAdapter adapter(log.GetLogger(LEV_INFO, "adapter"), &replay);
+	MockUpperLayer upper(log.GetLogger(LEV_INFO, "upper"));
+	adapter.SetUpperLayer(&upper);
+
+	bool finished = false;
+	replay.SetFinishedHandler(boost::bind(&SetFlag, &finished));
+
+	BOOST_REQUIRE_EQUAL(replay.NumReads(), 2);
+	replay.AsyncOpen();
+	BOOST_REQUIRE(test.ProceedUntil(boost::bind(&PhysicalLayerAsyncReplay::IsFinished, &replay)));
+	BOOST_REQUIRE(upper.BufferEquals("01 02 03 04 05"));
+	BOOST_REQUIRE(finished);
+
+	// the eof read closes the layer and it can't be reopened
+	BOOST_REQUIRE(test.ProceedUntil(boost::bind(&PhysicalLayerAsyncReplay::IsClosed, &replay)));
+	BOOST_REQUIRE_EQUAL(upper.GetState().mNumLayerDown, 1);
+	replay.AsyncOpen();
+	BOOST_REQUIRE(test.ProceedUntil(boost::bind(&PhysicalLayerAsyncReplay::IsClosed, &replay)));
+	BOOST_REQUIRE_EQUAL(upper.GetState().mNumLayerUp, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ReplayDiscardsWrites)
+{
+	TempCapture temp;
+	{
+		CaptureWriter writer(CAPTURE_PATH);
+		Record(writer, CD_READ, "01");
+	}
+
+	EventLog log;
+	AsyncTestObjectASIO test;
+	PhysicalLayerAsyncReplay replay(log.GetLogger(LEV_INFO, "replay"), test.GetService(), CAPTURE_PATH, false);
+	LowerLayerToPhysAdapter adapter(log.GetLogger(LEV_INFO, "adapter"), &replay, false);
+	MockUpperLayer upper(log.GetLogger(LEV_INFO, "upper"));
+	adapter.SetUpperLayer(&upper);
+
+	replay.AsyncOpen();
+	BOOST_REQUIRE(test.ProceedUntil(boost::bind(&PhysicalLayerAsyncReplay::IsOpen, &replay)));
+	upper.SendDown("AA BB");
+	BOOST_REQUIRE(test.ProceedUntil(boost::bind(&MockUpperLayer::CountersEqual, &upper, 1, 0)));
+	BOOST_REQUIRE_EQUAL(replay.NumReplayed(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
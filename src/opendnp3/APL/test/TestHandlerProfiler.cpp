@@ -0,0 +1,209 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/HandlerProfiler.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/PostingNotifier.h>
+#include <opendnp3/APL/TimerSourceASIO.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace apl;
+
+namespace
+{
+
+// restores the default so other suites run unprofiled
+class Profiling
+{
+public:
+	Profiling() {
+		HandlerProfiler::SetEnabled(true);
+	}
+	~Profiling() {
+		HandlerProfiler::SetEnabled(false);
+	}
+};
+
+Logger* GetOwner(EventLog& arLog, const std::string& arName)
+{
+	Logger* pLogger = arLog.GetLogger(LEV_WARNING, arName);
+	pLogger->SetVarName(arName);
+	return pLogger;
+}
+
+boost::int64_t TimeOf(Logger* apLogger)
+{
+	return apLogger->GetCounter("handler_time_ns")->Get();
+}
+
+boost::int64_t CallsOf(Logger* apLogger)
+{
+	return apLogger->GetCounter("handler_calls")->Get();
+}
+
+void Spin(boost::int64_t aNanos)
+{
+	boost::int64_t end = HandlerProfiler::Now() + aNanos;
+	while(HandlerProfiler::Now() < end);
+}
+
+void RecordOwner(bool* apOwned)
+{
+	*apOwned = HandlerProfiler::Current().HasOwner();
+}
+
+const boost::int64_t MS = 1000000;
+
+}
+
+BOOST_AUTO_TEST_SUITE(HandlerProfilerSuite)
+
+BOOST_AUTO_TEST_CASE(DisabledByDefault)
+{
+	EventLog log;
+	Logger* pLogger = GetOwner(log, "stack");
+
+	BOOST_REQUIRE(!HandlerProfiler::IsEnabled());
+	{
+		ProfileScope scope((HandlerProfile(pLogger)));
+		BOOST_REQUIRE(HandlerProfiler::Current().HasOwner()); // ownership is tracked regardless
+		Spin(MS);
+	}
+	BOOST_REQUIRE(!HandlerProfiler::Current().HasOwner());
+	BOOST_REQUIRE_EQUAL(CallsOf(pLogger), 0);
+	BOOST_REQUIRE_EQUAL(TimeOf(pLogger), 0);
+}
+
+BOOST_AUTO_TEST_CASE(NestedScopesAreExclusive)
+{
+	EventLog log;
+	Logger* pChannel = GetOwner(log, "channel");
+	Logger* pStack = GetOwner(log, "stack");
+	Profiling on;
+
+	boost::int64_t start = HandlerProfiler::Now();
+	{
+		ProfileScope outer((HandlerProfile(pChannel)));
+		Spin(2 * MS);
+		{
+			ProfileScope inner((HandlerProfile(pStack)));
+			Spin(4 * MS);
+		}
+		Spin(2 * MS);
+	}
+	boost::int64_t elapsed = HandlerProfiler::Now() - start;
+
+	BOOST_REQUIRE_EQUAL(CallsOf(pChannel), 1);
+	BOOST_REQUIRE_EQUAL(CallsOf(pStack), 1);
+	BOOST_REQUIRE(TimeOf(pChannel) >= 4 * MS);
+	BOOST_REQUIRE(TimeOf(pStack) >= 4 * MS);
+	BOOST_REQUIRE(TimeOf(pChannel) + TimeOf(pStack) <= elapsed);
+}
+
+BOOST_AUTO_TEST_CASE(PostedHandlersAndTimersInheritTheOwner)
+{
+	EventLog log;
+	Logger* pLogger = GetOwner(log, "stack");
+	Profiling on;
+
+	boost::asio::io_service service;
+	TimerSourceASIO timers(&service);
+	bool posted = false;
+	bool timed = false;
+	{
+		ProfileScope scope((HandlerProfile(pLogger)));
+		timers.Post(boost::bind(&RecordOwner, &posted));
+		timers.Start(0, boost::bind(&RecordOwner, &timed));
+	}
+	service.run();
+
+	BOOST_REQUIRE(posted);
+	BOOST_REQUIRE(timed);
+	BOOST_REQUIRE_EQUAL(CallsOf(pLogger), 3);
+}
+
+BOOST_AUTO_TEST_CASE(NotifiersBelongToTheirCreator)
+{
+	EventLog log;
+	Logger* pLogger = GetOwner(log, "stack");
+
+	boost::asio::io_service service;
+	TimerSourceASIO timers(&service);
+	bool owned = false;
+
+	// created while profiling is off, like a stack added before it's turned on
+	std::auto_ptr<PostingNotifier> pNotifier;
+	{
+		ProfileScope scope((HandlerProfile(pLogger)));
+		pNotifier.reset(new PostingNotifier(&timers, boost::bind(&RecordOwner, &owned)));
+	}
+
+	Profiling on;
+	pNotifier->Notify(); // from a thread that doesn't belong to anyone
+	service.run();
+
+	BOOST_REQUIRE(owned);
+	BOOST_REQUIRE_EQUAL(CallsOf(pLogger), 2);
+}
+
+BOOST_AUTO_TEST_CASE(TopIsSortedByTime)
+{
+	EventLog log;
+	Logger* pQuiet = GetOwner(log, "quiet");
+	Logger* pBusy = GetOwner(log, "busy");
+	Logger* pIdle = GetOwner(log, "idle");
+	HandlerProfile idle(pIdle); // registered, but never runs
+	Profiling on;
+
+	for(size_t i = 0; i < 3; ++i) {
+		{
+			ProfileScope scope((HandlerProfile(pQuiet)));
+			Spin(MS / 10);
+		}
+		{
+			ProfileScope scope((HandlerProfile(pBusy)));
+			Spin(MS);
+		}
+	}
+
+	std::vector<HandlerUsage> top;
+	HandlerProfiler::GetTop(*log.GetMetrics(), 10, top);
+	BOOST_REQUIRE_EQUAL(top.size(), 2);
+	BOOST_REQUIRE_EQUAL(top[0].owner, "busy");
+	BOOST_REQUIRE_EQUAL(top[0].calls, 3);
+	BOOST_REQUIRE_EQUAL(top[1].owner, "quiet");
+	BOOST_REQUIRE(top[0].nanos > top[1].nanos);
+
+	top.clear();
+	HandlerProfiler::GetTop(*log.GetMetrics(), 1, top);
+	BOOST_REQUIRE_EQUAL(top.size(), 1);
+	BOOST_REQUIRE_EQUAL(top[0].owner, "busy");
+
+	ostringstream oss;
+	HandlerProfiler::WriteReport(*log.GetMetrics(), 10, oss);
+	BOOST_REQUIRE(oss.str().find("busy") < oss.str().find("quiet"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/ChangeBuffer.h>
+#include <opendnp3/APL/FlexibleDataObserver.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace apl;
+
+namespace
+{
+
+// restores the default so other suites run untraced
+class TraceRate
+{
+public:
+	TraceRate(size_t aOneIn) {
+		LatencyTrace::SetSampleRate(aOneIn);
+	}
+	~TraceRate() {
+		LatencyTrace::SetSampleRate(0);
+	}
+};
+
+void TraceRead(TraceHistograms& arHist)
+{
+	LatencyTrace::Begin();
+	LatencyTrace::Mark(TS_LINK);
+	LatencyTrace::Mark(TS_APP);
+	LatencyTrace::Complete(arHist);
+	LatencyTrace::End();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(LatencyTraceSuite)
+
+BOOST_AUTO_TEST_CASE(DisabledByDefault)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "stack");
+	TraceHistograms hist(pLogger);
+
+	BOOST_REQUIRE_FALSE(LatencyTrace::IsEnabled());
+	TraceRead(hist);
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_total_us")->GetCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RecordsMarkedStages)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "stack");
+	TraceHistograms hist(pLogger);
+	TraceRate rate(1);
+
+	TraceRead(hist);
+	TraceRead(hist);
+
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_total_us")->GetCount(), 2);
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_link_us")->GetCount(), 2);
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_app_us")->GetCount(), 2);
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_publish_us")->GetCount(), 2);
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_transport_us")->GetCount(), 0); // never marked
+}
+
+BOOST_AUTO_TEST_CASE(CompletesOncePerRead)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "stack");
+	TraceHistograms hist(pLogger);
+	TraceRate rate(1);
+
+	LatencyTrace::Begin();
+	LatencyTrace::Complete(hist);
+	LatencyTrace::Complete(hist);
+	LatencyTrace::End();
+	LatencyTrace::Complete(hist); // outside of any read
+
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_total_us")->GetCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(SamplesOneInN)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "stack");
+	TraceHistograms hist(pLogger);
+	TraceRate rate(4);
+
+	for(size_t i = 0; i < 40; ++i) TraceRead(hist);
+
+	BOOST_REQUIRE_EQUAL(pLogger->GetHistogram("trace_total_us")->GetCount(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(ChangeBufferTimesOldestChange)
+{
+	ChangeBuffer<SigLock> buffer;
+	{
+		Transaction tr(&buffer);
+		buffer.Update(Binary(true), 0);
+	}
+	BOOST_REQUIRE_EQUAL(buffer.GetTraceStart(), 0); // tracing disabled
+
+	TraceRate rate(1);
+	{
+		Transaction tr(&buffer);
+		buffer.Update(Binary(false), 0);
+	}
+	boost::int64_t start = buffer.GetTraceStart();
+	BOOST_REQUIRE(start != 0);
+	{
+		Transaction tr(&buffer);
+		buffer.Update(Binary(true), 0);
+	}
+	BOOST_REQUIRE_EQUAL(buffer.GetTraceStart(), start);
+
+	FlexibleDataObserver fdo;
+	buffer.FlushUpdates(&fdo);
+	BOOST_REQUIRE_EQUAL(buffer.GetTraceStart(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReportListsTraceHistograms)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "stack");
+	TraceHistograms hist(pLogger);
+	pLogger->GetCounter("frames");
+	TraceRate rate(1);
+	TraceRead(hist);
+
+	ostringstream oss;
+	LatencyTrace::WriteReport(*log.GetMetrics(), oss);
+	string report = oss.str();
+
+	BOOST_REQUIRE(report.find("total_us") != string::npos);
+	BOOST_REQUIRE(report.find("link_us") != string::npos);
+	BOOST_REQUIRE(report.find("frames") == string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
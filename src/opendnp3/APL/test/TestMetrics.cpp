@@ -0,0 +1,148 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/Metrics.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace apl;
+
+BOOST_AUTO_TEST_SUITE(MetricsSuite)
+
+BOOST_AUTO_TEST_CASE(CounterAndGauge)
+{
+	MetricCounter c;
+	c.Increment();
+	c.Increment(10);
+	BOOST_REQUIRE_EQUAL(c.Get(), 11);
+
+	MetricGauge g;
+	g.Set(5);
+	g.Set(-3);
+	BOOST_REQUIRE_EQUAL(g.Get(), -3);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramBuckets)
+{
+	MetricHistogram h;
+	h.Observe(0);		// <= 1
+	h.Observe(1);		// <= 1
+	h.Observe(3);		// <= 5
+	h.Observe(10000000);	// <= 10000000
+	h.Observe(10000001);	// +Inf
+
+	BOOST_REQUIRE_EQUAL(h.GetBucket(0), 2);
+	BOOST_REQUIRE_EQUAL(h.GetBucket(2), 1);
+	BOOST_REQUIRE_EQUAL(h.GetBucket(MetricHistogram::NUM_BUCKETS - 2), 1);
+	BOOST_REQUIRE_EQUAL(h.GetBucket(MetricHistogram::NUM_BUCKETS - 1), 1);
+	BOOST_REQUIRE_EQUAL(h.GetCount(), 5);
+	BOOST_REQUIRE_EQUAL(h.GetSum(), 20000005);
+}
+
+BOOST_AUTO_TEST_CASE(RegistryReturnsSameMetric)
+{
+	MetricsRegistry reg;
+	MetricCounter* pA = reg.GetCounter("stack1", "frames");
+	BOOST_REQUIRE_EQUAL(pA, reg.GetCounter("stack1", "frames"));
+	BOOST_REQUIRE(pA != reg.GetCounter("stack2", "frames"));
+}
+
+BOOST_AUTO_TEST_CASE(RegistryRejectsTypeConflict)
+{
+	MetricsRegistry reg;
+	reg.GetCounter("stack1", "frames");
+	BOOST_REQUIRE_THROW(reg.GetGauge("stack2", "frames"), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(PrometheusFormat)
+{
+	MetricsRegistry reg;
+	reg.GetCounter("b", "frames", "Frames seen")->Increment(3);
+	reg.GetCounter("a", "frames")->Increment(2);
+	reg.GetGauge("a\"x", "depth")->Set(7);
+	MetricHistogram* pHist = reg.GetHistogram("a", "latency_ms");
+	pHist->Observe(4);
+	pHist->Observe(20000000);
+
+	ostringstream oss;
+	reg.WritePrometheus(oss, "test_");
+
+	ostringstream expected;
+	expected << "# TYPE test_depth gauge\n";
+	expected << "test_depth{source=\"a\\\"x\"} 7\n";
+	expected << "# HELP test_frames Frames seen\n";
+	expected << "# TYPE test_frames counter\n";
+	expected << "test_frames{source=\"a\"} 2\n";
+	expected << "test_frames{source=\"b\"} 3\n";
+	expected << "# TYPE test_latency_ms histogram\n";
+	const char* bounds[] = {
+		"1", "2", "5", "10", "20", "50", "100", "200", "500", "1000", "2000", "5000", "10000", "20000", "50000",
+		"100000", "200000", "500000", "1000000", "2000000", "5000000", "10000000", "+Inf"
+	};
+	for(size_t i = 0; i < MetricHistogram::NUM_BUCKETS; ++i) {
+		size_t cumulative = (i < 2) ? 0 : ((i < MetricHistogram::NUM_BUCKETS - 1) ? 1 : 2);
+		expected << "test_latency_ms_bucket{source=\"a\",le=\"" << bounds[i] << "\"} " << cumulative << "\n";
+	}
+	expected << "test_latency_ms_sum{source=\"a\"} 20000004\n";
+	expected << "test_latency_ms_count{source=\"a\"} 2\n";
+
+	BOOST_REQUIRE_EQUAL(oss.str(), expected.str());
+}
+
+BOOST_AUTO_TEST_CASE(DumpReplacesFile)
+{
+	MetricsRegistry reg;
+	reg.GetCounter("a", "frames")->Increment();
+	reg.DumpPrometheus("metrics_test.prom");
+	reg.GetCounter("a", "frames")->Increment();
+	reg.DumpPrometheus("metrics_test.prom");
+
+	ifstream file("metrics_test.prom");
+	ostringstream oss;
+	oss << file.rdbuf();
+	file.close();
+	std::remove("metrics_test.prom");
+
+	BOOST_REQUIRE_EQUAL(oss.str(), "# TYPE opendnp3_frames counter\nopendnp3_frames{source=\"a\"} 2\n");
+}
+
+BOOST_AUTO_TEST_CASE(LogCounterUsesVarName)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "root");
+	pLogger->SetVarName("stack");
+	Logger* pSub = pLogger->GetSubLogger("link");
+
+	LogCounter counter(pSub, "crc_failure");
+	counter.Increment();
+	counter.Increment();
+
+	BOOST_REQUIRE_EQUAL(counter.Get(), 2);
+	BOOST_REQUIRE_EQUAL(log.GetMetrics()->GetCounter("stack", "crc_failure")->Get(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/IoUringService.h>
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/PhysicalLayerAsyncTCPClient.h>
+#include <opendnp3/APL/PhysicalLayerAsyncTCPServer.h>
+
+#include <opendnp3/APL/test/util/AsyncTestObjectASIO.h>
+#include <opendnp3/APL/test/util/BufferHelpers.h>
+#include <opendnp3/APL/test/util/LogTester.h>
+#include <opendnp3/APL/test/util/MockUpperLayer.h>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <memory>
+
+#ifdef APL_HAS_IO_URING
+
+using namespace apl;
+using namespace boost;
+
+namespace
+{
+
+const boost::uint16_t PORT = 50010;
+
+// a tcp client and server on one io_service, either of which can use the ring
+class IoUringTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	IoUringTestObject(bool aUringClient = true, bool aUringServer = true) :
+		mUring(mLog.GetLogger(LEV_INFO, "uring"), this->GetService()),
+		mTCPClient(mLog.GetLogger(LEV_INFO, "TCPClient"), this->GetService(), "127.0.0.1", PORT),
+		mTCPServer(mLog.GetLogger(LEV_INFO, "TCPServer"), this->GetService(), "127.0.0.1", PORT),
+		mClientAdapter(mLog.GetLogger(LEV_INFO, "ClientAdapter"), &mTCPClient),
+		mServerAdapter(mLog.GetLogger(LEV_INFO, "ServerAdapter"), &mTCPServer),
+		mClientUpper(mLog.GetLogger(LEV_INFO, "MockUpperClient")),
+		mServerUpper(mLog.GetLogger(LEV_INFO, "MockUpperServer"))
+	{
+		if(aUringClient) mTCPClient.SetIoUring(&mUring);
+		if(aUringServer) mTCPServer.SetIoUring(&mUring);
+		mClientAdapter.SetUpperLayer(&mClientUpper);
+		mServerAdapter.SetUpperLayer(&mServerUpper);
+	}
+
+	bool Connect() {
+		mTCPServer.AsyncOpen();
+		mTCPClient.AsyncOpen();
+		return this->ProceedUntil(bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)) &&
+		       this->ProceedUntil(bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper));
+	}
+
+	bool BothDown() {
+		return this->ProceedUntilFalse(bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)) &&
+		       this->ProceedUntilFalse(bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper));
+	}
+
+	IoUringService mUring;	// outlives the layers
+
+	PhysicalLayerAsyncTCPClient mTCPClient;
+	PhysicalLayerAsyncTCPServer mTCPServer;
+
+	LowerLayerToPhysAdapter mClientAdapter;
+	LowerLayerToPhysAdapter mServerAdapter;
+
+	MockUpperLayer mClientUpper;
+	MockUpperLayer mServerUpper;
+};
+
+// containers and sandboxes often block io_uring, so the tests pass without checking anything there
+bool Supported()
+{
+	if(IoUringService::IsSupported()) return true;
+	BOOST_TEST_MESSAGE("io_uring isn't available, skipping");
+	return false;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncIoUringSuite)
+
+BOOST_AUTO_TEST_CASE(ConnectDisconnect)
+{
+	if(!Supported()) return;
+	IoUringTestObject t;
+
+	for(size_t i = 0; i < 10; ++i) {
+		BOOST_REQUIRE(t.Connect());
+
+		// reads are outstanding, so closing either side brings both down
+		if( (i % 2) == 0 ) t.mTCPServer.AsyncClose();
+		else t.mTCPClient.AsyncClose();
+		BOOST_REQUIRE(t.BothDown());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SendShutdown)
+{
+	if(!Supported()) return;
+	IoUringTestObject t;
+	BOOST_REQUIRE(t.Connect());
+
+	ByteStr bs(1024, 77);
+	t.mClientUpper.SendDown(bs.Buffer(), bs.Size());
+
+	t.mTCPClient.AsyncClose();
+	BOOST_REQUIRE(t.BothDown());
+}
+
+BOOST_AUTO_TEST_CASE(TwoWaySend)
+{
+	if(!Supported()) return;
+	const size_t SEND_SIZE = 1 << 20; // far bigger than a send slot and the receive buffer ring
+
+	IoUringTestObject t;
+	BOOST_REQUIRE(t.Connect());
+
+	ByteStr bs(SEND_SIZE, 77);
+	t.mClientUpper.SendDown(bs.Buffer(), bs.Size());
+	t.mServerUpper.SendDown(bs.Buffer(), bs.Size());
+
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, SEND_SIZE)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, SEND_SIZE)));
+	BOOST_REQUIRE(t.mClientUpper.BufferEquals(bs.Buffer(), bs.Size()));
+	BOOST_REQUIRE(t.mServerUpper.BufferEquals(bs.Buffer(), bs.Size()));
+
+	t.mTCPServer.AsyncClose();
+	BOOST_REQUIRE(t.BothDown());
+}
+
+BOOST_AUTO_TEST_CASE(InteroperatesWithAsio)
+{
+	if(!Supported()) return;
+	IoUringTestObject t(true, false);
+	BOOST_REQUIRE(t.Connect());
+
+	t.mClientUpper.SendDown("01 02 03");
+	t.mServerUpper.SendDown("04 05");
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, 3)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, 2)));
+	BOOST_REQUIRE(t.mServerUpper.BufferEquals("01 02 03"));
+	BOOST_REQUIRE(t.mClientUpper.BufferEquals("04 05"));
+
+	t.mTCPServer.AsyncClose();
+	BOOST_REQUIRE(t.BothDown());
+}
+
+BOOST_AUTO_TEST_CASE(SendsFromOneHandlerShareASubmission)
+{
+	if(!Supported()) return;
+	IoUringTestObject t;
+	BOOST_REQUIRE(t.Connect());
+	t.ProceedForTime(100); // lets the receives queued by the first reads reach the kernel
+
+	boost::int64_t calls = t.mUring.NumSubmitCalls();
+	boost::int64_t submitted = t.mUring.NumSubmitted();
+
+	t.mClientUpper.SendDown("01 02 03");
+	t.mServerUpper.SendDown("04 05");
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, 3)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, 2)));
+
+	BOOST_REQUIRE_EQUAL(t.mUring.NumSubmitted() - submitted, 2);
+	BOOST_REQUIRE_EQUAL(t.mUring.NumSubmitCalls() - calls, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
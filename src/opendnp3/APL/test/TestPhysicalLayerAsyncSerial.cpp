@@ -28,11 +28,107 @@
 #include <opendnp3/APL/Log.h>
 #include <opendnp3/APL/test/util/BufferHelpers.h>
 #include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/ToHex.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 using namespace apl;
 using namespace boost;
 
+#ifndef WIN32
+namespace
+{
+
+// tells the port how many bytes finish the "frame", like the link layer router does
+class FramingAdapter : public LowerLayerToPhysAdapter
+{
+public:
+	FramingAdapter(Logger* apLogger, IPhysicalLayerAsync* apPhys) :
+		Loggable(apLogger),
+		LowerLayerToPhysAdapter(apLogger, apPhys),
+		mFrameSize(0)
+	{}
+
+	size_t NumBytesToFrameEnd() const {
+		return mFrameSize;
+	}
+
+	size_t mFrameSize;
+};
+
+// a serial port on the slave side of a pseudo terminal, the test writes the line from the master side
+class PtyTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	PtyTestObject(const SerialSettings& arSettings) :
+		mMaster(OpenMaster()),
+		mPort(mLog.GetLogger(LEV_INFO, "Serial"), this->GetService(), WithDevice(arSettings, mMaster)),
+		mAdapter(mLog.GetLogger(LEV_INFO, "Adapter"), &mPort),
+		mUpper(mLog.GetLogger(LEV_INFO, "MockUpper"))
+	{
+		mAdapter.SetUpperLayer(&mUpper);
+	}
+
+	~PtyTestObject() {
+		close(mMaster);
+	}
+
+	bool Open() {
+		mPort.AsyncOpen();
+		return this->ProceedUntil(bind(&MockUpperLayer::IsLowerLayerUp, &mUpper));
+	}
+
+	void WriteLine(const std::string& arHex) {
+		HexSequence hs(arHex);
+		BOOST_REQUIRE_EQUAL(write(mMaster, hs, hs.Size()), static_cast<ssize_t>(hs.Size()));
+	}
+
+	std::string ReadLine() {
+		boost::uint8_t buff[100];
+		ssize_t num = read(mMaster, buff, sizeof(buff));
+		return (num > 0) ? toHex(buff, num, true) : "";
+	}
 
+	boost::int64_t Counter(const std::string& arName) {
+		return mLog.GetMetrics()->GetCounter("Serial", arName)->Get();
+	}
+
+	int mMaster;
+	PhysicalLayerAsyncSerial mPort;
+	FramingAdapter mAdapter;
+	MockUpperLayer mUpper;
+
+private:
+
+	static int OpenMaster() {
+		int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+		BOOST_REQUIRE(fd >= 0);
+		BOOST_REQUIRE(grantpt(fd) == 0 && unlockpt(fd) == 0);
+		return fd;
+	}
+
+	static SerialSettings WithDevice(SerialSettings aSettings, int aMaster) {
+		aSettings.mDevice = ptsname(aMaster);
+		return aSettings;
+	}
+};
+
+SerialSettings FramedSettings(millis_t aGap)
+{
+	SerialSettings s;
+	s.mBaud = 115200;
+	s.mReadMode = READ_FRAMED;
+	s.mInterCharGap = aGap;
+	return s;
+}
+
+}
+#endif
 
 //run the tests on arm to give us some protection
 BOOST_AUTO_TEST_SUITE(PhysicalLayerSerialSuite)
@@ -61,5 +157,86 @@ BOOST_AUTO_TEST_CASE(TestSendReceiveLoopback)
 
 #endif
 
+#ifndef WIN32
+
+BOOST_AUTO_TEST_CASE(FramedReadWaitsForTheWholeFrame)
+{
+	PtyTestObject t(FramedSettings(1000));
+	t.mAdapter.mFrameSize = 5;
+	BOOST_REQUIRE(t.Open());
+
+	t.WriteLine("01 02");
+	t.ProceedForTime(50);
+	BOOST_REQUIRE(t.mUpper.SizeEquals(0));
+
+	t.WriteLine("03 04 05");
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::SizeEquals, &t.mUpper, 5)));
+	BOOST_REQUIRE(t.mUpper.BufferEquals("01 02 03 04 05"));
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_reads"), 1);
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_gaps"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FramedReadEndsAtAGap)
+{
+	PtyTestObject t(FramedSettings(20));
+	t.mAdapter.mFrameSize = 5;
+	BOOST_REQUIRE(t.Open());
+
+	t.WriteLine("01 02");
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::SizeEquals, &t.mUpper, 2)));
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_gaps"), 1);
+
+	// the next frame starts on an idle line
+	t.WriteLine("03 04 05 06 07");
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::SizeEquals, &t.mUpper, 7)));
+	BOOST_REQUIRE(t.mUpper.BufferEquals("01 02 03 04 05 06 07"));
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_reads"), 2);
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_gaps"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FramedReadWithoutAHintUsesTheGap)
+{
+	PtyTestObject t(FramedSettings(20));
+	BOOST_REQUIRE(t.Open());
+
+	t.WriteLine("01 02 03");
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::SizeEquals, &t.mUpper, 3)));
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_reads"), 1);
+	BOOST_REQUIRE_EQUAL(t.Counter("serial_gaps"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CloseAbortsAFramedRead)
+{
+	PtyTestObject t(FramedSettings(1000));
+	t.mAdapter.mFrameSize = 5;
+	BOOST_REQUIRE(t.Open());
+
+	t.WriteLine("01 02");
+	t.mPort.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(bind(&MockUpperLayer::IsLowerLayerUp, &t.mUpper)));
+	BOOST_REQUIRE(t.mUpper.SizeEquals(0));
+}
+
+BOOST_AUTO_TEST_CASE(WritesWaitForTheTurnaround)
+{
+	SerialSettings s;
+	s.mTurnaround = 200;
+	PtyTestObject t(s);
+	BOOST_REQUIRE(t.Open());
+
+	t.WriteLine("01");
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::SizeEquals, &t.mUpper, 1)));
+
+	HexSequence hs("AA BB"); // the port holds onto the buffer until the write finishes
+	t.mUpper.SendDown(hs, hs.Size());
+	t.ProceedForTime(50);
+	BOOST_REQUIRE_EQUAL(t.ReadLine(), "");
+
+	BOOST_REQUIRE(t.ProceedUntil(bind(&MockUpperLayer::CountersEqual, &t.mUpper, 1, 0)));
+	BOOST_REQUIRE_EQUAL(t.ReadLine(), "AA BB");
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,178 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSharedMemory.h>
+
+#include <opendnp3/APL/test/util/AsyncTestObjectASIO.h>
+#include <opendnp3/APL/test/util/BufferHelpers.h>
+#include <opendnp3/APL/test/util/LogTester.h>
+#include <opendnp3/APL/test/util/MockUpperLayer.h>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+using namespace apl;
+using namespace boost;
+
+namespace
+{
+
+const char SEGMENT[] = "test-apl-shm";
+
+// a server and a client sharing a segment, driven from one io_service
+class SharedMemoryTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	SharedMemoryTestObject(size_t aCapacity = PhysicalLayerAsyncSharedMemory::DEFAULT_CAPACITY) :
+		mServer(mLog.GetLogger(LEV_INFO, "server"), this->GetService(), SEGMENT, true, aCapacity),
+		mClient(mLog.GetLogger(LEV_INFO, "client"), this->GetService(), SEGMENT, false),
+		mServerAdapter(mLog.GetLogger(LEV_INFO, "ServerAdapter"), &mServer),
+		mClientAdapter(mLog.GetLogger(LEV_INFO, "ClientAdapter"), &mClient),
+		mServerUpper(mLog.GetLogger(LEV_INFO, "MockUpperServer")),
+		mClientUpper(mLog.GetLogger(LEV_INFO, "MockUpperClient"))
+	{
+		mServerAdapter.SetUpperLayer(&mServerUpper);
+		mClientAdapter.SetUpperLayer(&mClientUpper);
+	}
+
+	void Connect() {
+		mServer.AsyncOpen();
+		mClient.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+		BOOST_REQUIRE(this->ProceedUntil(bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+	}
+
+	void RequireBothDown() {
+		BOOST_REQUIRE(this->ProceedUntilFalse(bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+		BOOST_REQUIRE(this->ProceedUntilFalse(bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+	}
+
+	PhysicalLayerAsyncSharedMemory mServer;
+	PhysicalLayerAsyncSharedMemory mClient;
+
+	LowerLayerToPhysAdapter mServerAdapter;
+	LowerLayerToPhysAdapter mClientAdapter;
+
+	MockUpperLayer mServerUpper;
+	MockUpperLayer mClientUpper;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncSharedMemorySuite)
+
+BOOST_AUTO_TEST_CASE(ClientFailsWithoutServer)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mClient.AsyncOpen();
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ServerAcceptCanceled)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mServer.AsyncOpen();
+		t.mServer.AsyncClose();
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mServerAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConnectDisconnect)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 10; ++i) {
+		t.Connect();
+
+		// either side closing takes the other down
+		if( (i % 2) == 0 ) t.mServer.AsyncClose();
+		else t.mClient.AsyncClose();
+		t.RequireBothDown();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TwoWaySend)
+{
+	const size_t SEND_SIZE = 1 << 20; // 1 MB
+
+	// a small ring makes both sides wait on each other many times
+	SharedMemoryTestObject t(4096);
+	t.Connect();
+
+	ByteStr bs(SEND_SIZE, 77);
+	t.mClientUpper.SendDown(bs.Buffer(), bs.Size());
+	t.mServerUpper.SendDown(bs.Buffer(), bs.Size());
+
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, SEND_SIZE)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, SEND_SIZE)));
+
+	BOOST_REQUIRE(t.mClientUpper.BufferEquals(bs.Buffer(), bs.Size()));
+	BOOST_REQUIRE(t.mServerUpper.BufferEquals(bs.Buffer(), bs.Size()));
+
+	t.mClient.AsyncClose();
+	t.RequireBothDown();
+}
+
+BOOST_AUTO_TEST_CASE(IdleSideIsWokenOnce)
+{
+	SharedMemoryTestObject t;
+	t.Connect();
+	t.ProceedForTime(100); // lets both sides find their rings empty and arm their reads
+
+	// the client is waiting, so the first frame needs a wakeup
+	t.mServerUpper.SendDown("05 64 05 C0 01 00");
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, 6)));
+	BOOST_REQUIRE(t.mClientUpper.BufferEquals("05 64 05 C0 01 00"));
+	BOOST_REQUIRE_EQUAL(t.mServer.NumWakeups(), 1);
+	BOOST_REQUIRE_EQUAL(t.mClient.NumWakeups(), 0);
+
+	t.mServer.AsyncClose();
+	t.RequireBothDown();
+}
+
+BOOST_AUTO_TEST_CASE(ReconnectsAfterPeerClose)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 3; ++i) {
+		t.Connect();
+		t.mClientUpper.SendDown("01 02 03");
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, 3)));
+		BOOST_REQUIRE(t.mServerUpper.BufferEquals("01 02 03"));
+		t.mServerUpper.ClearBuffer();
+
+		t.mClient.AsyncClose();
+		t.RequireBothDown();
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
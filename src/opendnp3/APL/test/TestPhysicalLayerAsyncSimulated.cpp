@@ -0,0 +1,163 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSimulated.h>
+#include <opendnp3/APL/VirtualTimerSource.h>
+
+#include <opendnp3/APL/test/util/BufferHelpers.h>
+#include <opendnp3/APL/test/util/LogTester.h>
+#include <opendnp3/APL/test/util/MockUpperLayer.h>
+
+using namespace apl;
+
+namespace
+{
+
+// two ends of a simulated line, each with a mock upper layer
+class SimulatedLineTestObject : public LogTester
+{
+public:
+	SimulatedLineTestObject(const LineModel& arModel) :
+		mA(mLog.GetLogger(LEV_INFO, "A"), &mTimers, arModel, 1),
+		mB(mLog.GetLogger(LEV_INFO, "B"), &mTimers, arModel, 2),
+		mAdapterA(mLog.GetLogger(LEV_INFO, "AdapterA"), &mA),
+		mAdapterB(mLog.GetLogger(LEV_INFO, "AdapterB"), &mB),
+		mUpperA(mLog.GetLogger(LEV_INFO, "UpperA")),
+		mUpperB(mLog.GetLogger(LEV_INFO, "UpperB"))
+	{
+		PhysicalLayerAsyncSimulated::Connect(&mA, &mB);
+		mAdapterA.SetUpperLayer(&mUpperA);
+		mAdapterB.SetUpperLayer(&mUpperB);
+	}
+
+	void Open() {
+		mA.AsyncOpen();
+		mB.AsyncOpen();
+		mTimers.RunFor(0);
+		BOOST_REQUIRE(mUpperA.IsLowerLayerUp() && mUpperB.IsLowerLayerUp());
+	}
+
+	VirtualTimerSource mTimers;
+	PhysicalLayerAsyncSimulated mA;
+	PhysicalLayerAsyncSimulated mB;
+	LowerLayerToPhysAdapter mAdapterA;
+	LowerLayerToPhysAdapter mAdapterB;
+	MockUpperLayer mUpperA;
+	MockUpperLayer mUpperB;
+};
+
+LineModel Latency(millis_t aLatency)
+{
+	LineModel m;
+	m.mLatency = aLatency;
+	return m;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncSimulatedSuite)
+
+BOOST_AUTO_TEST_CASE(WritesArriveAfterTheLatency)
+{
+	SimulatedLineTestObject t(Latency(100));
+	t.Open();
+
+	HexSequence hs("01 02 03");
+	t.mUpperA.SendDown(hs, hs.Size());
+	t.mTimers.RunFor(99);
+	BOOST_REQUIRE(t.mUpperA.CountersEqual(1, 0));
+	BOOST_REQUIRE(t.mUpperB.SizeEquals(0));
+
+	t.mTimers.RunFor(1);
+	BOOST_REQUIRE(t.mUpperB.BufferEquals("01 02 03"));
+	BOOST_REQUIRE_EQUAL(t.mB.NumBytesReceived(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(WritesTakeTheLineRate)
+{
+	LineModel m;
+	m.mBitsPerSecond = 1000; // 10 ms a byte
+	SimulatedLineTestObject t(m);
+	t.Open();
+
+	ByteStr bs(10, 0x55);
+	t.mUpperA.SendDown(bs, bs.Size());
+	t.mTimers.RunFor(99);
+	BOOST_REQUIRE(t.mUpperA.CountersEqual(0, 0));
+	t.mTimers.RunFor(1);
+	BOOST_REQUIRE(t.mUpperA.CountersEqual(1, 0));
+	BOOST_REQUIRE(t.mUpperB.SizeEquals(10));
+}
+
+BOOST_AUTO_TEST_CASE(LostWritesStillComplete)
+{
+	LineModel m;
+	m.mLoss = 1.0;
+	SimulatedLineTestObject t(m);
+	t.Open();
+
+	HexSequence hs("01 02 03");
+	t.mUpperA.SendDown(hs, hs.Size());
+	t.mTimers.RunFor(1000);
+	BOOST_REQUIRE(t.mUpperA.CountersEqual(1, 0));
+	BOOST_REQUIRE(t.mUpperB.SizeEquals(0));
+	BOOST_REQUIRE_EQUAL(t.mA.NumLost(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(JitterNeverReorders)
+{
+	LineModel m;
+	m.mLatency = 10;
+	m.mJitter = 100;
+	SimulatedLineTestObject t(m);
+	t.Open();
+
+	boost::uint8_t data[50];
+	for(size_t i = 0; i < 50; ++i) {
+		data[i] = static_cast<boost::uint8_t>(i);
+		t.mUpperA.SendDown(data + i, 1);
+		t.mTimers.RunFor(0);
+	}
+	t.mTimers.RunFor(1000);
+
+	BOOST_REQUIRE(t.mUpperB.BufferEquals(data, 50));
+	BOOST_REQUIRE(t.mB.MaxBuffered() >= 1);
+}
+
+BOOST_AUTO_TEST_CASE(CloseAbortsTheRead)
+{
+	SimulatedLineTestObject t(Latency(100));
+	t.Open();
+
+	t.mA.AsyncClose();
+	t.mTimers.RunFor(0);
+	BOOST_REQUIRE(!t.mUpperA.IsLowerLayerUp());
+
+	// bytes sent to a closed end are lost
+	HexSequence hs("01 02 03");
+	t.mUpperB.SendDown(hs, hs.Size());
+	t.mTimers.RunFor(1000);
+	BOOST_REQUIRE_EQUAL(t.mA.NumBytesReceived(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,265 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/PhysicalLayerAsyncTCPRedundantClient.h>
+#include <opendnp3/APL/PhysicalLayerAsyncTCPServer.h>
+
+#include <opendnp3/APL/test/util/AsyncTestObjectASIO.h>
+#include <opendnp3/APL/test/util/LogTester.h>
+#include <opendnp3/APL/test/util/MockUpperLayer.h>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <memory>
+#include <vector>
+
+using namespace apl;
+using namespace boost;
+
+namespace
+{
+
+const boost::uint16_t PRIMARY_PORT = 50010;
+const boost::uint16_t BACKUP_PORT = 50011;
+const boost::uint16_t HANGING_PORT = 50012;
+const boost::uint16_t REFUSED_PORT = 50013;
+
+TCPRedundantSettings Settings(boost::uint16_t aFirst, boost::uint16_t aSecond, size_t aNumStandbys = 0, millis_t aStagger = 250)
+{
+	TCPRedundantSettings s;
+	s.AddEndpoint("127.0.0.1", aFirst);
+	s.AddEndpoint("127.0.0.1", aSecond);
+	s.mNumStandbys = aNumStandbys;
+	s.mStagger = aStagger;
+	return s;
+}
+
+// a redundant client and a server for the primary and backup endpoints
+class RedundantTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	RedundantTestObject(const TCPRedundantSettings& arSettings) :
+		mClient(mLog.GetLogger(LEV_INFO, "client"), this->GetService(), arSettings),
+		mPrimary(mLog.GetLogger(LEV_INFO, "primary"), this->GetService(), "127.0.0.1", PRIMARY_PORT),
+		mBackup(mLog.GetLogger(LEV_INFO, "backup"), this->GetService(), "127.0.0.1", BACKUP_PORT),
+		mClientAdapter(mLog.GetLogger(LEV_INFO, "ClientAdapter"), &mClient),
+		mPrimaryAdapter(mLog.GetLogger(LEV_INFO, "PrimaryAdapter"), &mPrimary),
+		mBackupAdapter(mLog.GetLogger(LEV_INFO, "BackupAdapter"), &mBackup),
+		mClientUpper(mLog.GetLogger(LEV_INFO, "MockUpperClient")),
+		mPrimaryUpper(mLog.GetLogger(LEV_INFO, "MockUpperPrimary")),
+		mBackupUpper(mLog.GetLogger(LEV_INFO, "MockUpperBackup"))
+	{
+		mClientAdapter.SetUpperLayer(&mClientUpper);
+		mPrimaryAdapter.SetUpperLayer(&mPrimaryUpper);
+		mBackupAdapter.SetUpperLayer(&mBackupUpper);
+	}
+
+	// reopens the client after its connection failed and times the first byte from the backup
+	boost::int64_t TimeToFirstByte() {
+		boost::int64_t start = LatencyTrace::Now();
+		mClient.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &mBackupUpper)));
+		mBackupUpper.SendDown("05 64");
+		BOOST_REQUIRE(this->ProceedUntil(boost::bind(&MockUpperLayer::SizeEquals, &mClientUpper, 2)));
+		return LatencyTrace::Now() - start;
+	}
+
+	PhysicalLayerAsyncTCPRedundantClient mClient;
+	PhysicalLayerAsyncTCPServer mPrimary;
+	PhysicalLayerAsyncTCPServer mBackup;
+
+	LowerLayerToPhysAdapter mClientAdapter;
+	LowerLayerToPhysAdapter mPrimaryAdapter;
+	LowerLayerToPhysAdapter mBackupAdapter;
+
+	MockUpperLayer mClientUpper;
+	MockUpperLayer mPrimaryUpper;
+	MockUpperLayer mBackupUpper;
+};
+
+/**
+	A listener that never accepts. Its backlog is filled first so the
+	kernel drops further SYNs and connects to it hang like they would to
+	a dead host.
+*/
+class HangingListener
+{
+public:
+	HangingListener(boost::asio::io_service* apService) : mAcceptor(*apService) {
+		asio::ip::tcp::endpoint ep(asio::ip::address::from_string("127.0.0.1"), HANGING_PORT);
+		mAcceptor.open(ep.protocol());
+		mAcceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+		mAcceptor.bind(ep);
+		mAcceptor.listen(0);
+		for(size_t i = 0; i < 4; ++i) {
+			asio::ip::tcp::socket* pSocket = new asio::ip::tcp::socket(*apService);
+			pSocket->async_connect(ep, boost::bind(&HangingListener::OnConnect, asio::placeholders::error));
+			mFillers.push_back(pSocket);
+		}
+	}
+
+	~HangingListener() {
+		for(size_t i = 0; i < mFillers.size(); ++i) delete mFillers[i];
+	}
+
+private:
+	static void OnConnect(const boost::system::error_code&) {}
+
+	asio::ip::tcp::acceptor mAcceptor;
+	std::vector<asio::ip::tcp::socket*> mFillers;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncTCPRedundantClientSuite)
+
+BOOST_AUTO_TEST_CASE(RequiresAnEndpoint)
+{
+	AsyncTestObjectASIO test;
+	EventLog log;
+	BOOST_REQUIRE_THROW(PhysicalLayerAsyncTCPRedundantClient client(log.GetLogger(LEV_INFO, "client"), test.GetService(), TCPRedundantSettings()), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(ConnectsToPreferredEndpoint)
+{
+	RedundantTestObject t(Settings(PRIMARY_PORT, BACKUP_PORT));
+	t.mPrimary.AsyncOpen();
+	t.mBackup.AsyncOpen();
+	t.mClient.AsyncOpen();
+
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mPrimaryUpper)));
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 0);
+	BOOST_REQUIRE_FALSE(t.mBackupUpper.IsLowerLayerUp());
+
+	t.mClient.AsyncClose();
+	t.mBackup.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mPrimaryUpper)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mBackupAdapter, 1)));
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(RefusedEndpointMovesOnImmediately)
+{
+	RedundantTestObject t(Settings(REFUSED_PORT, BACKUP_PORT, 0, 60000));
+	t.mBackup.AsyncOpen();
+	t.mClient.AsyncOpen();
+
+	// the stagger is a minute, so only the refusal can have started the backup's connect
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 1);
+
+	t.mClient.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mBackupUpper)));
+}
+
+BOOST_AUTO_TEST_CASE(FailsWhenNoEndpointAccepts)
+{
+	RedundantTestObject t(Settings(REFUSED_PORT, BACKUP_PORT));
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mClient.AsyncOpen();
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(CloseWhileConnectingFailsTheOpen)
+{
+	RedundantTestObject t(Settings(PRIMARY_PORT, BACKUP_PORT));
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mClient.AsyncOpen();
+		t.mClient.AsyncClose();
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(StaggerStartsBackupWhilePrimaryHangs)
+{
+	RedundantTestObject t(Settings(HANGING_PORT, BACKUP_PORT, 0, 50));
+	HangingListener hanging(t.GetService());
+	t.mBackup.AsyncOpen();
+
+	boost::int64_t start = LatencyTrace::Now();
+	t.mClient.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	boost::int64_t elapsed = LatencyTrace::Now() - start;
+	BOOST_TEST_MESSAGE("Connected past a hanging primary in " << elapsed << " us");
+
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 1);
+	BOOST_REQUIRE(elapsed >= 50000);
+
+	t.mClient.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mBackupUpper)));
+}
+
+BOOST_AUTO_TEST_CASE(StandbyIsPromotedWhenPrimaryDrops)
+{
+	RedundantTestObject t(Settings(PRIMARY_PORT, BACKUP_PORT, 1));
+	t.mPrimary.AsyncOpen();
+	t.mBackup.AsyncOpen();
+	t.mClient.AsyncOpen();
+
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mBackupUpper)));
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&PhysicalLayerAsyncTCPRedundantClient::NumStandbys, &t.mClient) == 1));
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 0);
+
+	t.mPrimary.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	BOOST_REQUIRE_EQUAL(t.mClient.NumStandbys(), 1);
+
+	// the backup's acceptor closed when it accepted the standby, so this can't be a new connection
+	boost::int64_t ttfb = t.TimeToFirstByte();
+	BOOST_TEST_MESSAGE("First byte after failover to a standby in " << ttfb << " us");
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 1);
+	BOOST_REQUIRE_EQUAL(t.mClient.NumStandbys(), 0);
+
+	// an orderly close leaves nothing connected
+	t.mClient.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mBackupUpper)));
+}
+
+BOOST_AUTO_TEST_CASE(ReconnectsToBackupWithoutStandby)
+{
+	RedundantTestObject t(Settings(PRIMARY_PORT, BACKUP_PORT));
+	t.mPrimary.AsyncOpen();
+	t.mClient.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+
+	t.mBackup.AsyncOpen();
+	t.mPrimary.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+
+	// the primary now refuses, which starts the backup without waiting for the stagger
+	boost::int64_t ttfb = t.TimeToFirstByte();
+	BOOST_TEST_MESSAGE("First byte after failover by connecting in " << ttfb << " us");
+	BOOST_REQUIRE_EQUAL(t.mClient.GetActiveEndpoint(), 1);
+
+	t.mClient.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mBackupUpper)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
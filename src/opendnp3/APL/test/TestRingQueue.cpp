@@ -0,0 +1,106 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/RingQueue.h>
+
+using namespace apl;
+
+
+
+BOOST_AUTO_TEST_SUITE(RingQueueSuite)
+
+BOOST_AUTO_TEST_CASE(FirstInFirstOut)
+{
+	RingQueue<int> q(4);
+	BOOST_REQUIRE(q.Empty());
+
+	for(int i = 0; i < 3; ++i) q.Push(i);
+	BOOST_REQUIRE_EQUAL(q.Size(), 3);
+	BOOST_REQUIRE_EQUAL(q.Front(), 0);
+	BOOST_REQUIRE_EQUAL(q.Back(), 2);
+
+	for(int i = 0; i < 3; ++i) {
+		BOOST_REQUIRE_EQUAL(q.Front(), i);
+		q.Pop();
+	}
+	BOOST_REQUIRE(q.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(WrapsWithoutGrowing)
+{
+	RingQueue<int> q(4);
+	for(int i = 0; i < 100; ++i) {
+		q.Push(i);
+		q.Push(i + 1000);
+		BOOST_REQUIRE_EQUAL(q.Front(), i);
+		q.Pop();
+		BOOST_REQUIRE_EQUAL(q.Front(), i + 1000);
+		q.Pop();
+	}
+	BOOST_REQUIRE_EQUAL(q.Capacity(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsAcrossTheWrap)
+{
+	RingQueue<int> q(4);
+	q.Push(-1);
+	q.Push(-2);
+	q.Pop();
+	q.Pop();
+
+	// the front is now in the middle of the storage when the queue grows
+	for(int i = 0; i < 10; ++i) q.Push(i);
+	BOOST_REQUIRE_EQUAL(q.Capacity(), 16);
+	BOOST_REQUIRE_EQUAL(q.Size(), 10);
+	for(int i = 0; i < 10; ++i) BOOST_REQUIRE_EQUAL(q[i], i);
+}
+
+BOOST_AUTO_TEST_CASE(PushFrontAndClear)
+{
+	RingQueue<int> q(2);
+	q.Push(1);
+	q.PushFront(0);
+	q.PushFront(-1);
+	BOOST_REQUIRE_EQUAL(q.Size(), 3);
+	for(int i = 0; i < 3; ++i) BOOST_REQUIRE_EQUAL(q[i], i - 1);
+
+	size_t capacity = q.Capacity();
+	q.Clear();
+	BOOST_REQUIRE(q.Empty());
+	BOOST_REQUIRE_EQUAL(q.Capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(PushReturnsRecycledSlot)
+{
+	RingQueue<int> q(2);
+	q.Push() = 5;
+	q.Pop();
+	q.Push(); // slot 1
+	q.Pop();
+
+	// popped slots keep their old value until they're overwritten
+	int& slot = q.Push();
+	BOOST_REQUIRE_EQUAL(slot, 5);
+	slot = 6;
+	BOOST_REQUIRE_EQUAL(q.Front(), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
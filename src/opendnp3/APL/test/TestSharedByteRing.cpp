@@ -0,0 +1,121 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/SharedByteRing.h>
+
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace apl;
+
+namespace
+{
+
+// a formatted ring in heap memory
+class RingTestObject
+{
+public:
+	RingTestObject(size_t aCapacity) : mMemory(SharedByteRing::GetRequiredSize(aCapacity)) {
+		SharedByteRing::Format(&mMemory[0], aCapacity);
+		mpRing.reset(new SharedByteRing(&mMemory[0], mMemory.size()));
+	}
+
+	std::vector<boost::uint8_t> mMemory;
+	std::auto_ptr<SharedByteRing> mpRing;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(SharedByteRingSuite)
+
+BOOST_AUTO_TEST_CASE(RejectsBadHeaders)
+{
+	std::vector<boost::uint8_t> memory(SharedByteRing::GetRequiredSize(16), 0);
+	BOOST_REQUIRE_THROW(SharedByteRing ring(&memory[0], memory.size()), Exception);
+
+	SharedByteRing::Format(&memory[0], 16);
+	BOOST_REQUIRE_THROW(SharedByteRing ring(&memory[0], memory.size() - 1), Exception);
+	SharedByteRing ring(&memory[0], memory.size());
+	BOOST_REQUIRE_EQUAL(ring.Capacity(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(WritesOnlyWhatFits)
+{
+	RingTestObject t(4);
+	boost::uint8_t in[] = { 1, 2, 3, 4, 5, 6 };
+	boost::uint8_t out[6];
+
+	BOOST_REQUIRE_EQUAL(t.mpRing->Write(in, 6), 4);
+	BOOST_REQUIRE_EQUAL(t.mpRing->Write(in, 6), 0);
+	BOOST_REQUIRE_EQUAL(t.mpRing->Read(out, 6), 4);
+	BOOST_REQUIRE_EQUAL(memcmp(in, out, 4), 0);
+	BOOST_REQUIRE_EQUAL(t.mpRing->Read(out, 6), 0);
+}
+
+BOOST_AUTO_TEST_CASE(WrapsAround)
+{
+	RingTestObject t(5);
+	boost::uint8_t out[5];
+
+	for(boost::uint8_t i = 0; i < 20; ++i) {
+		boost::uint8_t in[] = { i, static_cast<boost::uint8_t>(i + 1), static_cast<boost::uint8_t>(i + 2) };
+		BOOST_REQUIRE_EQUAL(t.mpRing->Write(in, 3), 3);
+		BOOST_REQUIRE_EQUAL(t.mpRing->Read(out, 5), 3);
+		BOOST_REQUIRE_EQUAL(memcmp(in, out, 3), 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ReaderWaitsForData)
+{
+	RingTestObject t(8);
+	boost::uint8_t b = 0xAA;
+
+	// nothing to read, so the reader arms and the writer owes it a wakeup
+	BOOST_REQUIRE(t.mpRing->ArmReader());
+	BOOST_REQUIRE_EQUAL(t.mpRing->Write(&b, 1), 1);
+	BOOST_REQUIRE(t.mpRing->TakeReader());
+	BOOST_REQUIRE_FALSE(t.mpRing->TakeReader());
+
+	// data is already there, so arming fails and nobody needs a wakeup
+	BOOST_REQUIRE_FALSE(t.mpRing->ArmReader());
+	BOOST_REQUIRE_FALSE(t.mpRing->TakeReader());
+}
+
+BOOST_AUTO_TEST_CASE(WriterWaitsForSpace)
+{
+	RingTestObject t(2);
+	boost::uint8_t in[] = { 1, 2 };
+	boost::uint8_t out[2];
+
+	BOOST_REQUIRE_EQUAL(t.mpRing->Write(in, 2), 2);
+	BOOST_REQUIRE(t.mpRing->ArmWriter());
+	BOOST_REQUIRE_EQUAL(t.mpRing->Read(out, 1), 1);
+	BOOST_REQUIRE(t.mpRing->TakeWriter());
+
+	BOOST_REQUIRE_FALSE(t.mpRing->ArmWriter());
+	BOOST_REQUIRE_FALSE(t.mpRing->TakeWriter());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/DataTypes.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/SharedMemoryDataObserver.h>
+#include <opendnp3/APL/SharedMemoryDataReader.h>
+
+#include <vector>
+
+using namespace apl;
+
+namespace
+{
+
+const char SEGMENT_NAME[] = "apl_test_shared_points";
+
+}
+
+BOOST_AUTO_TEST_SUITE(SharedMemorySuite)
+
+BOOST_AUTO_TEST_CASE(TableLayout)
+{
+	SharedPointTableSizes sizes(1, 2, 3, 4, 5, 16);
+	std::vector<boost::uint8_t> memory(SharedPointTable::GetRequiredSize(sizes));
+	SharedPointTable::Format(&memory[0], sizes);
+
+	SharedPointTable table(&memory[0], memory.size());
+	BOOST_REQUIRE_EQUAL(table.NumPoints(SPT_BINARY), 1);
+	BOOST_REQUIRE_EQUAL(table.NumPoints(SPT_SETPOINT_STATUS), 5);
+	BOOST_REQUIRE_EQUAL(table.RingSize(), 16);
+	BOOST_REQUIRE_EQUAL(table.NumChanges(), 0);
+
+	BOOST_REQUIRE_THROW(SharedPointTable(&memory[0], memory.size() - 1), Exception);
+	memory[0] = 0;
+	BOOST_REQUIRE_THROW(SharedPointTable(&memory[0], memory.size()), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ReaderSeesPublishedValues)
+{
+	SharedMemoryDataObserver obs(SEGMENT_NAME, SharedPointTableSizes(2, 2, 2, 2, 2));
+	SharedMemoryDataReader reader(SEGMENT_NAME);
+	BOOST_REQUIRE_EQUAL(reader.NumPoints(SPT_ANALOG), 2);
+
+	SharedPointValue value;
+	BOOST_REQUIRE_FALSE(reader.Read(SPT_ANALOG, 1, value)); // not published yet
+
+	{
+		Transaction t(&obs);
+		Analog a(12.5, AQ_ONLINE);
+		a.SetTime(1000);
+		obs.Update(a, 1);
+		obs.Update(Binary(true, BQ_ONLINE), 0);
+		obs.Update(Counter(42, CQ_ONLINE), 1);
+	}
+
+	BOOST_REQUIRE(reader.Read(SPT_ANALOG, 1, value));
+	BOOST_REQUIRE_EQUAL(value.Value, 12.5);
+	BOOST_REQUIRE_EQUAL(value.Quality, AQ_ONLINE);
+	BOOST_REQUIRE_EQUAL(value.Time, 1000);
+
+	BOOST_REQUIRE(reader.Read(SPT_BINARY, 0, value));
+	BOOST_REQUIRE_EQUAL(value.Value, 1);
+
+	BOOST_REQUIRE(reader.Read(SPT_COUNTER, 1, value));
+	BOOST_REQUIRE_EQUAL(value.Value, 42);
+
+	BOOST_REQUIRE_FALSE(reader.Read(SPT_COUNTER, 2, value));
+	BOOST_REQUIRE_EQUAL(reader.NumRetries(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfRangeUpdatesAreDropped)
+{
+	SharedMemoryDataObserver obs(SEGMENT_NAME, SharedPointTableSizes(1));
+	{
+		Transaction t(&obs);
+		obs.Update(Binary(true, BQ_ONLINE), 1);
+		obs.Update(Analog(1, AQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE_EQUAL(obs.NumDropped(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(PollChangesSinceLastCall)
+{
+	SharedMemoryDataObserver obs(SEGMENT_NAME, SharedPointTableSizes(0, 10));
+	SharedMemoryDataReader reader(SEGMENT_NAME);
+	std::vector<SharedPointChange> changes;
+
+	{
+		Transaction t(&obs);
+		obs.Update(Analog(1, AQ_ONLINE), 3);
+		obs.Update(Analog(2, AQ_ONLINE), 7);
+
+		// nothing is visible until the transaction ends
+		BOOST_REQUIRE(reader.PollChanges(changes));
+		BOOST_REQUIRE(changes.empty());
+	}
+
+	BOOST_REQUIRE(reader.PollChanges(changes));
+	BOOST_REQUIRE_EQUAL(changes.size(), 2);
+	BOOST_REQUIRE_EQUAL(changes[0].Type, SPT_ANALOG);
+	BOOST_REQUIRE_EQUAL(changes[0].Index, 3);
+	BOOST_REQUIRE_EQUAL(changes[1].Index, 7);
+
+	changes.clear();
+	BOOST_REQUIRE(reader.PollChanges(changes));
+	BOOST_REQUIRE(changes.empty());
+}
+
+BOOST_AUTO_TEST_CASE(PollDetectsOverrun)
+{
+	SharedMemoryDataObserver obs(SEGMENT_NAME, SharedPointTableSizes(0, 1, 0, 0, 0, 4));
+	SharedMemoryDataReader reader(SEGMENT_NAME);
+	std::vector<SharedPointChange> changes;
+
+	{
+		Transaction t(&obs);
+		for(int i = 0; i < 5; ++i) obs.Update(Analog(i, AQ_ONLINE), 0);
+	}
+
+	BOOST_REQUIRE_FALSE(reader.PollChanges(changes));
+	BOOST_REQUIRE(changes.empty());
+
+	// the cursor was moved to the latest change
+	{
+		Transaction t(&obs);
+		obs.Update(Analog(6, AQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE(reader.PollChanges(changes));
+	BOOST_REQUIRE_EQUAL(changes.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(OpeningMissingSegmentThrows)
+{
+	BOOST_REQUIRE_THROW(SharedMemoryDataReader reader("apl_test_no_such_segment"), Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
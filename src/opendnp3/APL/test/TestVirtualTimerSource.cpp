@@ -0,0 +1,141 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+
+#include <opendnp3/APL/VirtualTimerSource.h>
+
+#include <vector>
+
+using namespace apl;
+using namespace boost::posix_time;
+
+namespace
+{
+
+class Recorder
+{
+public:
+	Recorder(VirtualTimerSource* apSource) : mpSource(apSource)
+	{}
+
+	void Record(int aId) {
+		mIds.push_back(aId);
+		mTimes.push_back(mpSource->Elapsed());
+	}
+
+	// restarts itself, like a periodic task
+	void Repeat(millis_t aPeriod) {
+		this->Record(0);
+		mpSource->Start(aPeriod, boost::bind(&Recorder::Repeat, this, aPeriod));
+	}
+
+	VirtualTimerSource* mpSource;
+	std::vector<int> mIds;
+	std::vector<millis_t> mTimes;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(VirtualTimerSourceSuite)
+
+BOOST_AUTO_TEST_CASE(RunsTimersInTimeOrder)
+{
+	VirtualTimerSource src;
+	Recorder r(&src);
+
+	src.Start(300, boost::bind(&Recorder::Record, &r, 3));
+	src.Start(100, boost::bind(&Recorder::Record, &r, 1));
+	src.Start(200, boost::bind(&Recorder::Record, &r, 2));
+	BOOST_REQUIRE_EQUAL(src.NumPending(), 3);
+
+	while(src.RunOne());
+
+	BOOST_REQUIRE_EQUAL(r.mIds.size(), 3);
+	for(int i = 0; i < 3; ++i) {
+		BOOST_REQUIRE_EQUAL(r.mIds[i], i + 1);
+		BOOST_REQUIRE_EQUAL(r.mTimes[i], (i + 1) * 100);
+	}
+	BOOST_REQUIRE_EQUAL(src.NumRun(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(SimultaneousEventsRunInTheOrderScheduled)
+{
+	VirtualTimerSource src;
+	Recorder r(&src);
+
+	src.Start(0, boost::bind(&Recorder::Record, &r, 1));
+	src.Post(boost::bind(&Recorder::Record, &r, 2));
+	src.Start(src.GetUTC(), boost::bind(&Recorder::Record, &r, 3));
+
+	BOOST_REQUIRE_EQUAL(src.RunFor(0), 3);
+	BOOST_REQUIRE_EQUAL(r.mIds[0], 1);
+	BOOST_REQUIRE_EQUAL(r.mIds[1], 2);
+	BOOST_REQUIRE_EQUAL(r.mIds[2], 3);
+	BOOST_REQUIRE_EQUAL(src.Elapsed(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CanceledTimersDontRun)
+{
+	VirtualTimerSource src;
+	Recorder r(&src);
+
+	ITimer* pTimer = src.Start(100, boost::bind(&Recorder::Record, &r, 1));
+	src.Start(200, boost::bind(&Recorder::Record, &r, 2));
+	pTimer->Cancel();
+
+	BOOST_REQUIRE_EQUAL(src.NumPending(), 1);
+	while(src.RunOne());
+	BOOST_REQUIRE_EQUAL(r.mIds.size(), 1);
+	BOOST_REQUIRE_EQUAL(r.mIds[0], 2);
+}
+
+BOOST_AUTO_TEST_CASE(RunUntilLeavesTheClockAtTheDeadline)
+{
+	VirtualTimerSource src;
+	Recorder r(&src);
+
+	src.Start(100, boost::bind(&Recorder::Record, &r, 1));
+	src.Start(1000, boost::bind(&Recorder::Record, &r, 2));
+
+	BOOST_REQUIRE_EQUAL(src.RunFor(500), 1);
+	BOOST_REQUIRE_EQUAL(src.Elapsed(), 500);
+	BOOST_REQUIRE_EQUAL(src.NumPending(), 1);
+
+	// a timer in the past runs at the current time
+	src.Start(src.GetUTC() - seconds(10), boost::bind(&Recorder::Record, &r, 3));
+	BOOST_REQUIRE_EQUAL(src.RunFor(0), 1);
+	BOOST_REQUIRE_EQUAL(r.mTimes[1], 500);
+}
+
+BOOST_AUTO_TEST_CASE(ADayPassesWithoutWaiting)
+{
+	VirtualTimerSource src;
+	Recorder r(&src);
+
+	src.Post(boost::bind(&Recorder::Repeat, &r, 1000));
+	src.RunFor(24 * 60 * 60 * 1000);
+
+	BOOST_REQUIRE_EQUAL(r.mIds.size(), 24 * 60 * 60 + 1);
+	BOOST_REQUIRE_EQUAL(r.mTimes.back(), 24 * 60 * 60 * 1000);
+	BOOST_REQUIRE(src.GetUTC() - ptime(boost::gregorian::date(2000, 1, 1)) == hours(24));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
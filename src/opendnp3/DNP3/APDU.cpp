@@ -136,6 +136,17 @@ void APDU::Reset()
 	mObjectHeaders.clear();
 }
 
+void APDU::AcquireBuffer(BufferPool* apPool, size_t aFragSize)
+{
+	apPool->Acquire(mBuffer, aFragSize);
+}
+
+void APDU::ReleaseBuffer(BufferPool* apPool)
+{
+	this->Reset();
+	apPool->Release(mBuffer);
+}
+
 void APDU::Write(const boost::uint8_t* apData, size_t aLength)
 {
 	if(aLength > mBuffer.Size()) {
@@ -22,6 +22,7 @@
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/CopyableBuffer.h>
+#include <opendnp3/APL/BufferPool.h>
 
 #include "AppHeader.h"
 #include "ObjectHeader.h"
@@ -107,6 +108,23 @@ public:
 	 */
 	void Reset();
 
+	/**
+		Give an APDU constructed with a fragment size of 0 a buffer
+		borrowed from a pool.
+
+		@param apPool				the pool to borrow from
+		@param aFragSize			the size of the fragment
+	 */
+	void AcquireBuffer(BufferPool* apPool, size_t aFragSize);
+
+	/**
+		Reset the buffer to be empty and return it to the pool it was
+		borrowed from.
+
+		@param apPool				the pool passed to AcquireBuffer()
+	 */
+	void ReleaseBuffer(BufferPool* apPool);
+
 	/**
 		Reset the buffer to be empty and then write the provided byte
 		stream into the buffer.  aLength must be less than MaxSize().
@@ -0,0 +1,131 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include "AdaptivePollPolicy.h"
+
+#include "MasterConfig.h"
+
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/Metrics.h>
+
+#include <boost/foreach.hpp>
+
+using namespace boost::posix_time;
+
+namespace apl
+{
+namespace dnp
+{
+
+AdaptivePollPolicy::AdaptivePollPolicy(Logger* apLogger, const MasterConfig& arCfg) :
+	Loggable(apLogger),
+	mBaseIntegrityRate(arCfg.IntegrityRate),
+	mMaxIntegrityRate(arCfg.MaxIntegrityRate > arCfg.IntegrityRate ? arCfg.MaxIntegrityRate : arCfg.IntegrityRate),
+	mMinScanRate(arCfg.MinScanRate),
+	mHealthyWindow(arCfg.UnsolHealthyWindow),
+	mIntegrityRate(arCfg.IntegrityRate),
+	mScanShift(0),
+	mMaxScanShift(0),
+	mOverflowed(false),
+	mpBytesSaved(apLogger->GetCounter("poll_bytes_saved", "Integrity poll bytes avoided by stretching the integrity period")),
+	mpIntegrityRateGauge(apLogger->GetGauge("integrity_rate_ms", "Current integrity poll period")),
+	mpScanShiftGauge(apLogger->GetGauge("scan_speedup", "Factor the exception scan periods are currently divided by"))
+{
+	BOOST_FOREACH(ExceptionScan e, arCfg.mScans) {
+		mBaseScanRates.push_back(e.ScanRate);
+		size_t shift = 0;
+		while(shift < MAX_SCAN_SHIFT && (e.ScanRate >> shift) > mMinScanRate) ++shift;
+		if(shift > mMaxScanShift) mMaxScanShift = shift;
+	}
+	this->Reset();
+}
+
+void AdaptivePollPolicy::Reset()
+{
+	mOverflowed = false;
+	mLastUnsol = not_a_date_time;
+	this->SetIntegrityRate(mBaseIntegrityRate);
+	this->SetScanShift(0);
+}
+
+void AdaptivePollPolicy::OnUnsol(const ptime& arNow)
+{
+	mLastUnsol = arNow;
+}
+
+void AdaptivePollPolicy::OnEventBufferOverflow()
+{
+	mOverflowed = true;
+	this->SetIntegrityRate(mBaseIntegrityRate);
+	this->SetScanShift(mMaxScanShift);
+}
+
+void AdaptivePollPolicy::OnIntegrityPoll(const ptime& arNow, size_t aNumBytes)
+{
+	if(mBaseIntegrityRate <= 0) return;
+
+	// the poll that just completed stood in for this many fixed rate polls
+	mpBytesSaved->Increment(static_cast<boost::int64_t>(aNumBytes) * (mIntegrityRate - mBaseIntegrityRate) / mBaseIntegrityRate);
+
+	bool healthy = !mOverflowed && !mLastUnsol.is_special() && (arNow - mLastUnsol) <= milliseconds(mHealthyWindow);
+	mOverflowed = false;
+
+	if(healthy) {
+		millis_t rate = mIntegrityRate * 2;
+		this->SetIntegrityRate(rate < mMaxIntegrityRate ? rate : mMaxIntegrityRate);
+	} else {
+		this->SetIntegrityRate(mBaseIntegrityRate);
+	}
+}
+
+void AdaptivePollPolicy::OnEventScan(bool aFoundEvents)
+{
+	if(aFoundEvents) {
+		if(mScanShift < mMaxScanShift) this->SetScanShift(mScanShift + 1);
+	} else {
+		if(mScanShift > 0) this->SetScanShift(mScanShift - 1);
+	}
+}
+
+millis_t AdaptivePollPolicy::GetScanRate(size_t aIndex) const
+{
+	millis_t base = mBaseScanRates[aIndex];
+	if(base <= mMinScanRate) return base;
+	millis_t rate = base >> mScanShift;
+	return (rate > mMinScanRate) ? rate : mMinScanRate;
+}
+
+void AdaptivePollPolicy::SetIntegrityRate(millis_t aRate)
+{
+	if(aRate != mIntegrityRate) LOG_BLOCK(LEV_INFO, "Integrity period: " << aRate << " ms");
+	mIntegrityRate = aRate;
+	mpIntegrityRateGauge->Set(aRate);
+}
+
+void AdaptivePollPolicy::SetScanShift(size_t aShift)
+{
+	if(aShift != mScanShift) LOG_BLOCK(LEV_INFO, "Exception scans sped up by: " << (1 << aShift));
+	mScanShift = aShift;
+	mpScanShiftGauge->Set(1 << aShift);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
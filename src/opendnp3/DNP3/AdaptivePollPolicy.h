@@ -0,0 +1,117 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ADAPTIVE_POLL_POLICY_H_
+#define __ADAPTIVE_POLL_POLICY_H_
+
+#include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/Types.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <vector>
+
+namespace apl
+{
+
+class MetricCounter;
+class MetricGauge;
+
+namespace dnp
+{
+
+struct MasterConfig;
+
+/**
+ * Decides the integrity and exception scan periods of a master from how
+ * well unsolicited reporting is working, when MasterConfig::AdaptivePolling
+ * is set.
+ *
+ * While unsolicited responses keep arriving within UnsolHealthyWindow and
+ * the outstation reports no event buffer overflow, every integrity poll
+ * doubles the integrity period up to MaxIntegrityRate. Otherwise the
+ * integrity period drops back to IntegrityRate.
+ *
+ * An exception scan that returns events means unsolicited reporting missed
+ * them, so every such scan halves the exception scan periods down to
+ * MinScanRate, and an event buffer overflow drops them to MinScanRate
+ * immediately. Each empty scan doubles them back toward their configured
+ * rates.
+ *
+ * Integrity bytes that the stretched polls avoided are counted in the
+ * poll_bytes_saved metric.
+ */
+class AdaptivePollPolicy : public Loggable
+{
+public:
+
+	AdaptivePollPolicy(Logger* apLogger, const MasterConfig& arCfg);
+
+	/// Returns to the configured rates, e.g. when the link is lost
+	void Reset();
+
+	/// An unsolicited response arrived at arNow
+	void OnUnsol(const boost::posix_time::ptime& arNow);
+
+	/// The outstation reported that its event buffer overflowed
+	void OnEventBufferOverflow();
+
+	/// An integrity poll whose responses totaled aNumBytes completed at arNow
+	void OnIntegrityPoll(const boost::posix_time::ptime& arNow, size_t aNumBytes);
+
+	/// An exception scan completed, aFoundEvents if any of its responses carried objects
+	void OnEventScan(bool aFoundEvents);
+
+	millis_t GetIntegrityRate() const {
+		return mIntegrityRate;
+	}
+
+	/// @return the period for the aIndex'th exception scan in MasterConfig::mScans
+	millis_t GetScanRate(size_t aIndex) const;
+
+	/// Exception scans are never sped up by more than 2^MAX_SCAN_SHIFT
+	static const size_t MAX_SCAN_SHIFT = 10;
+
+private:
+
+	void SetIntegrityRate(millis_t aRate);
+	void SetScanShift(size_t aShift);
+
+	millis_t mBaseIntegrityRate;
+	millis_t mMaxIntegrityRate;
+	millis_t mMinScanRate;
+	millis_t mHealthyWindow;
+	std::vector<millis_t> mBaseScanRates;
+
+	millis_t mIntegrityRate;				// current integrity period
+	size_t mScanShift;						// exception scan periods are divided by 2^mScanShift
+	size_t mMaxScanShift;					// shift at which every scan is at mMinScanRate
+	bool mOverflowed;						// overflow IIN seen since the last integrity poll
+	boost::posix_time::ptime mLastUnsol;	// not_a_date_time until the first one arrives
+
+	MetricCounter* mpBytesSaved;
+	MetricGauge* mpIntegrityRateGauge;
+	MetricGauge* mpScanShiftGauge;
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -84,7 +84,7 @@ void ACS_Base::ProcessResponse(AppLayerChannel* c, APDU& arAPDU, bool aExpectFIR
 
 	if(acf.SEQ == c->Sequence()) {
 		if(acf.FIR == aExpectFIR) {
-			c->CancelTimer();
+			c->CompleteTimer();
 
 			if(acf.FIN) {
 				c->ChangeState(ACS_Idle::Inst());
@@ -217,7 +217,7 @@ void ACS_WaitForConfirm::OnConfirm(AppLayerChannel* c, int aSeq)
 {
 	// does the confirm sequence match what we expect?
 	if(c->Sequence() == aSeq) {
-		c->CancelTimer();
+		c->CompleteTimer();
 		c->ChangeState(ACS_Idle::Inst());
 		c->DoSendSuccess();
 	} else {
@@ -238,6 +238,14 @@ void ACS_WaitForConfirm::OnTimeout(AppLayerChannel* c)
 
 // ---- ACS_WaitForResponseBase ----
 
+void ACS_WaitForResponseBase::Cancel(AppLayerChannel* c)
+{
+	// the rest of the response is ignored as a response without context
+	c->ChangeState(ACS_Idle::Inst());
+	c->CancelTimer();
+	c->DoFailure();
+}
+
 void ACS_WaitForResponseBase::OnTimeout(AppLayerChannel* c)
 {
 	LOGGER_BLOCK(c->GetLogger(), LEV_WARNING, "Timeout while waiting for response");
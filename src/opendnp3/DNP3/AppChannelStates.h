@@ -124,6 +124,7 @@ class ACS_WaitForConfirm : public ACS_Base
 class ACS_WaitForResponseBase : public ACS_Base
 {
 public:
+	void Cancel(AppLayerChannel*);
 	void OnTimeout(AppLayerChannel*);
 	bool AcceptsResponse() {
 		return true;
@@ -31,12 +31,13 @@ namespace dnp
 */
 struct AppConfig {
 	// Default constructor
-	AppConfig() : RspTimeout(5000), NumRetry(0), FragSize(DEFAULT_FRAG_SIZE) {}
+	AppConfig() : RspTimeout(5000), NumRetry(0), FragSize(DEFAULT_FRAG_SIZE), Lightweight(false) {}
 
-	AppConfig(millis_t aRspTimeout, size_t aNumRetry = 0, size_t aFragSize = DEFAULT_FRAG_SIZE) :
+	AppConfig(millis_t aRspTimeout, size_t aNumRetry = 0, size_t aFragSize = DEFAULT_FRAG_SIZE, bool aLightweight = false) :
 		RspTimeout(aRspTimeout),
 		NumRetry(aNumRetry),
-		FragSize(aFragSize)
+		FragSize(aFragSize),
+		Lightweight(aLightweight)
 	{}
 
 	// The response/confirm timeout in millisec
@@ -48,6 +49,11 @@ struct AppConfig {
 	// The maximum size of received application layer fragments
 	size_t FragSize;
 
+	// If true, the stack borrows its transport and application receive/transmit
+	// buffers from a pool shared by all stacks on the same io thread, and only
+	// holds them while a fragment is in flight. Cuts the memory used by idle stacks.
+	bool Lightweight;
+
 };
 
 }
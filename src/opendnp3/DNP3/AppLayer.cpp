@@ -22,6 +22,7 @@
 
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/ITimerSource.h>
+#include <opendnp3/APL/LatencyTrace.h>
 
 using namespace std;
 
@@ -30,17 +31,20 @@ namespace apl
 namespace dnp
 {
 
-AppLayer::AppLayer(apl::Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aAppCfg) :
+AppLayer::AppLayer(apl::Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aAppCfg, BufferPool* apPool) :
 	Loggable(apLogger),
 	IUpperLayer(apLogger),
-	mIncoming(aAppCfg.FragSize),
+	mpPool(apPool),
+	M_FRAG_SIZE(aAppCfg.FragSize),
+	mIncoming(apPool == NULL ? aAppCfg.FragSize : 0),
 	mConfirm(2), // only need 2 bytes for a confirm message
 	mSending(false),
 	mConfirmSending(false),
 	mpUser(NULL),
 	mSolicited(apLogger->GetSubLogger("sol"), this, apTimerSrc, aAppCfg.RspTimeout),
 	mUnsolicited(apLogger->GetSubLogger("unsol"), this, apTimerSrc, aAppCfg.RspTimeout),
-	mNumRetry(aAppCfg.NumRetry)
+	mNumRetry(aAppCfg.NumRetry),
+	mRxFragments(apLogger, "app_rx_fragments", "Application layer fragments received")
 {
 	mConfirm.SetFunction(FC_CONFIRM);
 }
@@ -99,9 +103,13 @@ void AppLayer::_OnReceive(const boost::uint8_t* apBuffer, size_t aSize)
 	if(!this->IsLowerLayerUp())
 		throw InvalidStateException(LOCATION, "LowerLaterDown");
 
+	if(mpPool != NULL) mIncoming.AcquireBuffer(mpPool, M_FRAG_SIZE);
+
 	try {
+		mRxFragments.Increment();
 		mIncoming.Write(apBuffer, aSize);
 		mIncoming.Interpret();
+		LatencyTrace::Mark(TS_APP);
 
 		LOG_BLOCK(LEV_INTERPRET, "<= AL " << mIncoming.ToString());
 
@@ -128,6 +136,8 @@ void AppLayer::_OnReceive(const boost::uint8_t* apBuffer, size_t aSize)
 	} catch(Exception ex) {
 		EXCEPTION_BLOCK(LEV_WARNING, ex);
 	}
+
+	if(mpPool != NULL) mIncoming.ReleaseBuffer(mpPool);
 }
 
 void AppLayer::_OnLowerLayerUp()
@@ -21,6 +21,7 @@
 
 #include <queue>
 #include <opendnp3/APL/AsyncLayerInterfaces.h>
+#include <opendnp3/APL/Logger.h>
 
 #include "APDU.h"
 #include "AppInterfaces.h"
@@ -54,7 +55,11 @@ class AppLayer : public IUpperLayer, public IAppLayer
 
 public:
 
-	AppLayer(apl::Logger* apLogger, ITimerSource*, AppConfig aAppCfg);
+	/**
+		@param apPool If not NULL, the buffer used to parse incoming fragments
+		is borrowed from the pool only while a fragment is being processed
+	*/
+	AppLayer(apl::Logger* apLogger, ITimerSource*, AppConfig aAppCfg, BufferPool* apPool = NULL);
 
 	void SetUser(IAppUser*);
 
@@ -99,6 +104,8 @@ private:
 
 	typedef std::deque<const APDU*> SendQueue;
 
+	BufferPool* mpPool;					// Optional pool that mIncoming borrows from
+	const size_t M_FRAG_SIZE;
 	APDU mIncoming;						// Fragment used to parse all incoming requests
 	APDU mConfirm;						// Fragment used to do confirms
 
@@ -111,6 +118,7 @@ private:
 	SolicitedChannel mSolicited;			// Channel used for solicited communications
 	UnsolicitedChannel mUnsolicited;		// Channel used for unsolicited communications
 	size_t mNumRetry;
+	LogCounter mRxFragments;
 
 
 	////////////////////
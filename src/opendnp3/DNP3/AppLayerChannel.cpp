@@ -25,6 +25,7 @@
 #include "AppChannelStates.h"
 
 #include <boost/bind.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
 
 namespace apl
 {
@@ -39,7 +40,9 @@ AppLayerChannel::AppLayerChannel(const std::string& arName, Logger* apLogger, Ap
 	mpTimerSrc(apTimerSrc),
 	mpTimer(NULL),
 	M_TIMEOUT(aTimeout),
-	M_NAME(arName)
+	M_NAME(arName),
+	mRetries(apLogger, "app_retries", "Application layer fragments retransmitted after a timeout"),
+	mpLatency(apLogger->GetHistogram("app_" + boost::algorithm::to_lower_copy(arName) + "_latency_ms", "Milliseconds waited for a response or confirm"))
 {
 	this->Reset();
 }
@@ -95,6 +98,7 @@ bool AppLayerChannel::Retry(ACS_Base* apState)
 {
 	if(mNumRetry > 0) {
 		--mNumRetry;
+		mRetries.Increment();
 		LOG_BLOCK(LEV_INFO, "App layer retry, " << mNumRetry << " remaining");
 		this->ChangeState(apState);
 		mpAppLayer->QueueFrame(*mpSendAPDU);
@@ -118,6 +122,7 @@ void AppLayerChannel::StartTimer()
 {
 	if(mpTimer != NULL) throw InvalidStateException(LOCATION, "");
 	mpTimer = mpTimerSrc->Start(M_TIMEOUT, boost::bind(&AppLayerChannel::Timeout, this));
+	mStopWatch.Restart();
 }
 
 void AppLayerChannel::CancelTimer()
@@ -127,6 +132,12 @@ void AppLayerChannel::CancelTimer()
 	mpTimer = NULL;
 }
 
+void AppLayerChannel::CompleteTimer()
+{
+	this->CancelTimer();
+	mpLatency->Observe(mStopWatch.Elapsed(false));
+}
+
 void AppLayerChannel::ChangeState(ACS_Base* apState)
 {
 	if(apState != mpState) {
@@ -21,6 +21,8 @@
 
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/TimingTools.h>
 
 namespace apl
 {
@@ -98,6 +100,7 @@ protected:
 
 	void StartTimer();
 	void CancelTimer();
+	void CompleteTimer(); // cancels the timer on a reply, recording how long it took
 	Logger* GetLogger() {
 		return mpLogger;
 	}
@@ -121,6 +124,10 @@ private:
 	bool mConfirming;
 	const millis_t M_TIMEOUT;
 	const std::string M_NAME;
+
+	StopWatch mStopWatch;	// time since the last timer was started
+	LogCounter mRetries;
+	MetricHistogram* mpLatency;	// time from the send to the response or confirm
 };
 
 }
@@ -30,9 +30,16 @@
 #include <opendnp3/APL/IPhysicalLayerAsync.h>
 #include <opendnp3/APL/SuspendTimerSource.h>
 #include <opendnp3/APL/AsyncTaskGroup.h>
+#include <opendnp3/APL/CaptureFile.h>
+#include <opendnp3/APL/IoUringService.h>
+#include <opendnp3/APL/PhysicalLayerAsyncBase.h>
 #include <opendnp3/APL/GetKeys.h>
+#include <opendnp3/APL/HandlerProfiler.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/MetricsServer.h>
 
 #include <opendnp3/DNP3/MasterStack.h>
+#include <opendnp3/DNP3/SharedDatabase.h>
 #include <opendnp3/DNP3/SlaveStack.h>
 #include <opendnp3/DNP3/DeviceTemplate.h>
 #include <opendnp3/DNP3/VtoRouter.h>
@@ -48,7 +55,7 @@ namespace apl
 namespace dnp
 {
 
-AsyncStackManager::AsyncStackManager(Logger* apLogger) :
+AsyncStackManager::AsyncStackManager(Logger* apLogger, TCPBackend aBackend) :
 	Loggable(apLogger),
 	mService(),
 	mTimerSrc(mService.Get()),
@@ -60,6 +67,7 @@ AsyncStackManager::AsyncStackManager(Logger* apLogger) :
 	mpInfiniteTimer(mTimerSrc.StartInfinite()),
 	mIsShutdown(false)
 {
+	if(aBackend == TCPB_IO_URING) this->StartIoUring();
 	mThread.Start();
 }
 
@@ -70,6 +78,24 @@ AsyncStackManager::~AsyncStackManager()
 	 */
 	this->Shutdown();
 
+	BOOST_FOREACH(SharedDatabaseMap::value_type v, mSharedDatabases) {
+		delete v.second;
+	}
+}
+
+void AsyncStackManager::StartIoUring()
+{
+#ifdef APL_HAS_IO_URING
+	try {
+		mpUring.reset(new IoUringService(mpLogger->GetSubLogger("io_uring"), mService.Get()));
+		mMgr.SetIoUring(mpUring.get());
+		return;
+	} catch(const Exception& ex) {
+		LOG_BLOCK(LEV_WARNING, "Using asio for TCP ports, io_uring is unavailable: " << ex.GetErrorString());
+	}
+#else
+	LOG_BLOCK(LEV_WARNING, "Using asio for TCP ports, io_uring isn't supported on this platform");
+#endif
 }
 
 std::vector<std::string> AsyncStackManager::GetStackNames()
@@ -83,18 +109,112 @@ std::vector<std::string> AsyncStackManager::GetPortNames()
 	return GetKeys<ChannelToChannelMap, string>(mChannelNameToChannel);
 }
 
+TaskGroupStatistics AsyncStackManager::GetPortStatistics(const std::string& arPortName)
+{
+	this->ThrowIfAlreadyShutdown();
+	LinkChannel* pChannel = this->GetChannelOrExcept(arPortName);
+	Transaction tr(&mSuspendTimerSource); //the group is only safe to read while execution is paused
+	return pChannel->GetGroup()->GetStatistics();
+}
+
+void AsyncStackManager::ResetPortStatistics(const std::string& arPortName)
+{
+	this->ThrowIfAlreadyShutdown();
+	LinkChannel* pChannel = this->GetChannelOrExcept(arPortName);
+	Transaction tr(&mSuspendTimerSource);
+	pChannel->GetGroup()->ResetStatistics();
+}
+
+void AsyncStackManager::StartMetricsServer(boost::uint16_t aPort, const std::string& arEndpoint)
+{
+	this->ThrowIfAlreadyShutdown();
+	if(mpMetricsServer.get() != NULL) throw InvalidStateException(LOCATION, "Metrics server is already running");
+
+	std::auto_ptr<MetricsServer> pServer(new MetricsServer(mpLogger->GetSubLogger("metrics"), mService.Get(), mpLogger->GetMetrics(), arEndpoint, aPort));
+	{
+		Transaction tr(&mSuspendTimerSource);
+		pServer->Start();
+	}
+	mpMetricsServer = pServer;
+}
+
+void AsyncStackManager::DumpMetrics(const std::string& arPath)
+{
+	mpLogger->GetMetrics()->DumpPrometheus(arPath);
+}
+
+void AsyncStackManager::SetHandlerProfiling(bool aEnabled)
+{
+	HandlerProfiler::SetEnabled(aEnabled);
+}
+
+std::vector<HandlerUsage> AsyncStackManager::GetTopStacks(size_t aCount)
+{
+	std::vector<HandlerUsage> usage;
+	HandlerProfiler::GetTop(*mpLogger->GetMetrics(), aCount, usage);
+	return usage;
+}
+
+void AsyncStackManager::StartCapture(const std::string& arPortName, const std::string& arPath)
+{
+	this->ThrowIfAlreadyShutdown();
+	LinkChannel* pChannel = this->GetChannelOrExcept(arPortName);
+	PhysicalLayerAsyncBase* pPhys = dynamic_cast<PhysicalLayerAsyncBase*>(pChannel->GetPhysicalLayer());
+	if(pPhys == NULL) throw ArgumentException(LOCATION, "Port doesn't support capture: " + arPortName);
+	if(mCaptures.find(arPortName) != mCaptures.end()) throw InvalidStateException(LOCATION, "Port is already being captured: " + arPortName);
+
+	std::auto_ptr<CaptureWriter> pCapture(new CaptureWriter(arPath));
+	{
+		Transaction tr(&mSuspendTimerSource);
+		pPhys->SetCapture(pCapture.get());
+	}
+	mCaptures[arPortName] = pCapture.release();
+}
+
+void AsyncStackManager::StopCapture(const std::string& arPortName)
+{
+	this->ThrowIfAlreadyShutdown();
+	CaptureMap::iterator i = mCaptures.find(arPortName);
+	if(i == mCaptures.end()) throw ArgumentException(LOCATION, "Port isn't being captured: " + arPortName);
+
+	std::auto_ptr<CaptureWriter> pCapture(i->second);
+	mCaptures.erase(i);
+
+	LinkChannel* pChannel = this->GetChannelOrExcept(arPortName);
+	Transaction tr(&mSuspendTimerSource);
+	static_cast<PhysicalLayerAsyncBase*>(pChannel->GetPhysicalLayer())->SetCapture(NULL);
+}
+
 void AsyncStackManager::AddTCPClient(const std::string& arName, PhysLayerSettings aSettings, const std::string& arAddr, boost::uint16_t aPort)
 {
 	this->ThrowIfAlreadyShutdown();
 	mMgr.AddTCPClient(arName, aSettings, arAddr, aPort);
 }
 
+void AsyncStackManager::AddTCPRedundantClient(const std::string& arName, PhysLayerSettings aSettings, const TCPRedundantSettings& arSettings)
+{
+	this->ThrowIfAlreadyShutdown();
+	mMgr.AddTCPRedundantClient(arName, aSettings, arSettings);
+}
+
 void AsyncStackManager::AddTCPServer(const std::string& arName, PhysLayerSettings aSettings, const std::string& arEndpoint, boost::uint16_t aPort)
 {
 	this->ThrowIfAlreadyShutdown();
 	mMgr.AddTCPServer(arName, aSettings, arEndpoint, aPort);
 }
 
+void AsyncStackManager::AddSharedMemoryServer(const std::string& arName, PhysLayerSettings aSettings, const std::string& arSegment)
+{
+	this->ThrowIfAlreadyShutdown();
+	mMgr.AddSharedMemory(arName, aSettings, arSegment, true);
+}
+
+void AsyncStackManager::AddSharedMemoryClient(const std::string& arName, PhysLayerSettings aSettings, const std::string& arSegment)
+{
+	this->ThrowIfAlreadyShutdown();
+	mMgr.AddSharedMemory(arName, aSettings, arSegment, false);
+}
+
 void AsyncStackManager::AddSerial(const std::string& arName, PhysLayerSettings aSettings, SerialSettings aSerial)
 {
 	this->ThrowIfAlreadyShutdown();
@@ -116,7 +236,12 @@ ICommandAcceptor* AsyncStackManager::AddMaster( const std::string& arPortName, c
 	Logger* pLogger = mpLogger->GetSubLogger(arStackName, aLevel);
 	pLogger->SetVarName(arStackName);
 
-	MasterStack* pMaster = new MasterStack(pLogger, &mTimerSrc, apPublisher, pChannel->GetGroup(), arCfg);
+	MasterStack* pMaster;
+	{
+		// notifiers and timers set up by the constructor belong to the stack
+		ProfileScope scope((HandlerProfile(pLogger)));
+		pMaster = new MasterStack(pLogger, &mTimerSrc, apPublisher, pChannel->GetGroup(), arCfg, arCfg.app.Lightweight ? &mBufferPool : NULL);
+	}
 	LinkRoute route(arCfg.link.RemoteAddr, arCfg.link.LocalAddr);
 
 	this->AddStackToChannel(arStackName, pMaster, pChannel, route);
@@ -130,14 +255,25 @@ ICommandAcceptor* AsyncStackManager::AddMaster( const std::string& arPortName, c
 }
 
 IDataObserver* AsyncStackManager::AddSlave( const std::string& arPortName, const std::string& arStackName, FilterLevel aLevel, ICommandAcceptor* apCmdAcceptor,
-                const SlaveStackConfig& arCfg)
+                const SlaveStackConfig& arCfg, const std::string& arSharedDatabase)
 {
 	this->ThrowIfAlreadyShutdown();
+	SharedDatabase* pShared = NULL;
+	if(!arSharedDatabase.empty()) {
+		SharedDatabaseMap::iterator i = mSharedDatabases.find(arSharedDatabase);
+		if(i == mSharedDatabases.end()) throw ArgumentException(LOCATION, "Unknown shared database: " + arSharedDatabase);
+		pShared = i->second;
+	}
+
 	LinkChannel* pChannel = this->GetOrCreateChannel(arPortName);
 	Logger* pLogger = mpLogger->GetSubLogger(arStackName, aLevel);
 	pLogger->SetVarName(arStackName);
 
-	SlaveStack* pSlave = new SlaveStack(pLogger, &mTimerSrc, apCmdAcceptor, arCfg);
+	SlaveStack* pSlave;
+	{
+		ProfileScope scope((HandlerProfile(pLogger)));
+		pSlave = new SlaveStack(pLogger, &mTimerSrc, apCmdAcceptor, arCfg, arCfg.app.Lightweight ? &mBufferPool : NULL, pShared);
+	}
 
 	LinkRoute route(arCfg.link.RemoteAddr, arCfg.link.LocalAddr);
 	this->AddStackToChannel(arStackName, pSlave, pChannel, route);
@@ -150,6 +286,16 @@ IDataObserver* AsyncStackManager::AddSlave( const std::string& arPortName, const
 	return pSlave->mSlave.GetDataObserver();
 }
 
+IDataObserver* AsyncStackManager::AddSharedDatabase(const std::string& arName, const DeviceTemplate& arDevice)
+{
+	this->ThrowIfAlreadyShutdown();
+	if(mSharedDatabases.find(arName) != mSharedDatabases.end()) throw ArgumentException(LOCATION, "Shared database already exists: " + arName);
+
+	SharedDatabase* pShared = new SharedDatabase(mpLogger->GetSubLogger(arName), &mTimerSrc, arDevice);
+	mSharedDatabases[arName] = pShared;
+	return pShared->GetDataObserver();
+}
+
 void AsyncStackManager::AddVtoChannel(const std::string& arStackName,
                                       IVtoCallbacks* apCallbacks)
 {
@@ -202,6 +348,8 @@ IVtoWriter* AsyncStackManager::GetVtoWriter(const std::string& arStackName)
 void AsyncStackManager::RemovePort(const std::string& arPortName)
 {
 	this->ThrowIfAlreadyShutdown();
+	if(mCaptures.find(arPortName) != mCaptures.end()) this->StopCapture(arPortName);
+
 	LinkChannel* pChannel = this->GetChannelMaybeNull(arPortName);
 	if(pChannel != NULL) { // the channel is in use
 		std::auto_ptr<LinkChannel> autoDeleteChannel(pChannel); //will delete at end of function
@@ -256,11 +404,22 @@ void AsyncStackManager::Shutdown()
 			LOG_BLOCK(LEV_DEBUG, "Done removing Port: " << s);
 		}
 
+		if(mpMetricsServer.get() != NULL) {
+			Transaction tr(&mSuspendTimerSource);
+			mpMetricsServer->Stop(); // aborted handlers still run on the thread, so only delete after the join
+		}
+
+		if(mpUring.get() != NULL) {
+			Transaction tr(&mSuspendTimerSource);
+			mpUring->Stop(); // the ports are gone, so nothing is attached
+		}
+
 		// if we've cleaned up correctly, canceling the infinite timer will cause the thread to stop executing
 		mpInfiniteTimer->Cancel();
 		LOG_BLOCK(LEV_DEBUG, "Joining on io_service thread");
 		mThread.WaitForStop();
 		LOG_BLOCK(LEV_DEBUG, "Join complete on io_service thread");
+		mpMetricsServer.reset();
 
 		mIsShutdown = true;
 	}
@@ -21,6 +21,7 @@
 #define __ASYNC_STACK_MANAGER_H_
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <opendnp3/APL/Loggable.h>
@@ -31,9 +32,12 @@
 #include <opendnp3/APL/IPhysicalLayerObserver.h>
 #include <opendnp3/APL/PhysicalLayerManager.h>
 #include <opendnp3/APL/AsyncTaskScheduler.h>
+#include <opendnp3/APL/AsyncTaskGroup.h>
 #include <opendnp3/APL/Lock.h>
 #include <opendnp3/APL/IOService.h>
 #include <opendnp3/APL/SuspendTimerSource.h>
+#include <opendnp3/APL/BufferPool.h>
+#include <opendnp3/APL/HandlerProfiler.h>
 
 #include "VtoDataInterface.h"
 #include "LinkRoute.h"
@@ -41,8 +45,11 @@
 
 namespace apl
 {
+class CaptureWriter;
+class IoUringService;
 class IPhysicalLayerAsync;
 class Logger;
+class MetricsServer;
 class ICommandAcceptor;
 class IDataObserver;
 }
@@ -53,7 +60,9 @@ namespace dnp
 {
 
 class LinkChannel;
+class SharedDatabase;
 class Stack;
+struct DeviceTemplate;
 struct VtoRouterSettings;
 
 struct SlaveStackConfig;
@@ -70,8 +79,10 @@ class AsyncStackManager : private Threadable, private Loggable
 public:
 	/**
 		@param apLogger - Logger to use for all other loggers
+		@param aBackend - What reads and writes the TCP ports. TCPB_IO_URING
+		falls back to asio with a warning if the kernel doesn't support it.
 	*/
-	AsyncStackManager(Logger* apLogger);
+	AsyncStackManager(Logger* apLogger, TCPBackend aBackend = TCPB_ASIO);
 	~AsyncStackManager();
 
 	// All the io_service marshalling now occurs here. It's now safe to add/remove while the manager is running.
@@ -79,9 +90,25 @@ public:
 	// Adds a TCPClient port, excepts if the port already exists
 	void AddTCPClient(const std::string& arName, PhysLayerSettings, const std::string& arAddr, boost::uint16_t aPort);
 
+	/**
+		Adds a TCP client port that races connects to several endpoints of
+		the same device and can keep standby connections for failover,
+		excepts if the port already exists
+	*/
+	void AddTCPRedundantClient(const std::string& arName, PhysLayerSettings, const TCPRedundantSettings& arSettings);
+
 	// Adds a TCPServer port, excepts if the port already exists
 	void AddTCPServer(const std::string& arName, PhysLayerSettings, const std::string& arEndpoint, boost::uint16_t aPort);
 
+	/**
+		Adds a port to another process on this host that exchanges bytes
+		through the shared memory segment arSegment. The server side
+		creates the segment and waits for the client side to connect.
+		Excepts if the port already exists.
+	*/
+	void AddSharedMemoryServer(const std::string& arName, PhysLayerSettings, const std::string& arSegment);
+	void AddSharedMemoryClient(const std::string& arName, PhysLayerSettings, const std::string& arSegment);
+
 	// Adds a Serial port, excepts if the port already exists
 	void AddSerial(const std::string& arName, PhysLayerSettings, SerialSettings);
 
@@ -127,19 +154,44 @@ public:
 									network thread and should not be
 									blocked.
 		@param arCfg				Configuration data for the master stack
+		@param arSharedDatabase		Name of a database added with
+									AddSharedDatabase() that the slave
+									serves instead of its own. arCfg.device
+									then only configures the controls.
 
 		@return						Thread-safe interface to use for
 									writing new measurement values to the
-									slave
+									slave, or to the shared database
 
-		@throw ArgumentException	if arPortName doesn't exist or if
-									arStackName already exists
+		@throw ArgumentException	if arPortName doesn't exist, if
+									arStackName already exists or if
+									arSharedDatabase doesn't exist
 	*/
 	IDataObserver* AddSlave(const std::string& arPortName,
 	                        const std::string& arStackName,
 	                        FilterLevel aLevel,
 	                        ICommandAcceptor* apCmdAcceptor,
-	                        const SlaveStackConfig&);
+	                        const SlaveStackConfig&,
+	                        const std::string& arSharedDatabase = "");
+
+	/**
+		Adds a point database that several slaves can serve, e.g. to
+		report the same points to a primary and a backup master. Updates
+		are processed once however many slaves share the database, while
+		each slave keeps its own event selection and confirmation and its
+		own unsolicited reporting. See SharedDatabase.
+
+		@param arName				Unique name of the database.
+		@param arDevice				Layout of the points, controls are
+									configured per slave
+
+		@return						Thread-safe interface to use for
+									writing new measurement values to
+									every slave that shares the database
+
+		@throw ArgumentException	if arName already exists
+	*/
+	IDataObserver* AddSharedDatabase(const std::string& arName, const DeviceTemplate& arDevice);
 
 	/**
 		Adds a VTO channel to a prexisting stack (master or slave).
@@ -247,6 +299,75 @@ public:
 	// @return a vector of all the port names
 	std::vector<std::string> GetPortNames();
 
+	/**
+		Every stack bound to a port shares the port's task scheduler, so these
+		statistics describe line utilization and poll latency across all the
+		masters on a multi-drop channel.
+
+		@param arPortName Name of a port with at least one stack bound to it
+
+		@throw ArgumentException if no stack has been added to arPortName
+
+		@return A snapshot of the port's scheduling statistics
+	*/
+	TaskGroupStatistics GetPortStatistics(const std::string& arPortName);
+
+	/// Restart the statistics returned by GetPortStatistics()
+	void ResetPortStatistics(const std::string& arPortName);
+
+	/**
+		Serves every metric of the logger's EventLog (link and application
+		layer counters, latency histograms, etc) in the Prometheus text format
+		over HTTP. The server runs on the stack's io_service until Shutdown().
+
+		@param aPort TCP port to listen on
+		@param arEndpoint Address to bind, loopback by default
+
+		@throw InvalidStateException if the server is already running
+		@throw Exception if the endpoint can't be bound
+	*/
+	void StartMetricsServer(boost::uint16_t aPort, const std::string& arEndpoint = "127.0.0.1");
+
+	/**
+		Writes every metric to a file in the Prometheus text format, e.g. for
+		the node_exporter textfile collector. The file is replaced atomically.
+
+		@throw Exception if the file can't be written
+	*/
+	void DumpMetrics(const std::string& arPath);
+
+	/**
+		Turns handler profiling on or off for the process. While it's on, the
+		time the io_service thread spends on each stack and channel adds up in
+		their handler_time_ns and handler_calls metrics, see HandlerProfiler.
+		It's cheap enough to leave on.
+	*/
+	void SetHandlerProfiling(bool aEnabled);
+
+	/// @return the aCount stacks and channels that have kept the io_service thread busiest, busiest first
+	std::vector<HandlerUsage> GetTopStacks(size_t aCount);
+
+	/**
+		Records the bytes read and written by a port to a capture file that
+		can be replayed with PhysicalLayerAsyncReplay, e.g. by dnp3bench.
+
+		@param arPortName Name of a port with at least one stack bound to it
+		@param arPath Capture file to create, replacing any existing file
+
+		@throw ArgumentException if the port doesn't exist or doesn't support capture
+		@throw InvalidStateException if the port is already being captured
+		@throw Exception if the file can't be created
+	*/
+	void StartCapture(const std::string& arPortName, const std::string& arPath);
+
+	/**
+		Stops recording a port and closes its capture file. Removing the port
+		stops the capture automatically.
+
+		@throw ArgumentException if the port isn't being captured
+	*/
+	void StopCapture(const std::string& arPortName);
+
 	/**
 	* Synchronously stops all running stacks and ports. Permanently
 	* stops the running background thread.
@@ -276,17 +397,23 @@ private:
 	void AddStackToChannel(const std::string& arStackName, Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute);
 
 	IOService mService;
+	std::auto_ptr<IoUringService> mpUring;	// NULL unless TCPB_IO_URING was chosen and works, outlives the ports
 	TimerSourceASIO mTimerSrc;
 	SuspendTimerSource mSuspendTimerSource;
 	PhysicalLayerManager mMgr;
 	AsyncTaskScheduler mScheduler;
 	VtoRouterManager mVtoManager;
+	BufferPool mBufferPool;			// shared by the stacks configured with AppConfig::Lightweight, only touched by mThread
 	Thread mThread;
 	ITimer* mpInfiniteTimer;
 	bool mIsShutdown;
+	std::auto_ptr<MetricsServer> mpMetricsServer;	// NULL until StartMetricsServer() is called
 
 	void ThrowIfAlreadyShutdown();
 
+	/// Creates mpUring and hands it to the TCP ports, logs and keeps asio if it can't be created
+	void StartIoUring();
+
 	struct StackRecord {
 		StackRecord() :
 			stack(NULL), channel(NULL)
@@ -303,6 +430,12 @@ private:
 	typedef std::map<std::string, StackRecord> StackMap; // maps a stack name the stack and it's channel
 	StackMap mStackMap;
 
+	typedef std::map<std::string, SharedDatabase*> SharedDatabaseMap;
+	SharedDatabaseMap mSharedDatabases;	// deleted after the stacks that share them
+
+	typedef std::map<std::string, CaptureWriter*> CaptureMap;
+	CaptureMap mCaptures;	// maps a port name to its capture, if it's being recorded
+
 	typedef std::map<std::string, LinkChannel*> ChannelToChannelMap;
 	ChannelToChannelMap mChannelNameToChannel;	// maps a channel name to a channel instance
 
@@ -37,6 +37,12 @@ const size_t DEFAULT_FRAG_SIZE = 2048;
  */
 const size_t DEFAULT_VTO_WRITER_QUEUE_SIZE = 1024;
 
+/*
+ * Bytes a Virtual Terminal object takes in a fragment besides its data:
+ * a 3 byte object header, a 1 byte count and a 1 byte index prefix.
+ */
+const size_t VTO_OBJECT_OVERHEAD = 5;
+
 enum DNPErrorCodes {
 
 	/// Master slave independent vto error codes
@@ -33,10 +33,12 @@ namespace dnp
 
 /* DataPoll - base class */
 
-DataPoll::DataPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
+DataPoll::DataPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader, LastValueTable* apLastValues) :
 	MasterTaskBase(apLogger),
 	mpObs(apObs),
-	mpVtoReader(apVtoReader)
+	mpVtoReader(apVtoReader),
+	mpLastValues(apLastValues),
+	mTrace(apLogger)
 {}
 
 TaskResult DataPoll::_OnPartialResponse(const APDU& f)
@@ -53,17 +55,20 @@ TaskResult DataPoll::_OnFinalResponse(const APDU& f)
 
 void DataPoll::ReadData(const APDU& f)
 {
-	ResponseLoader loader(mpLogger, mpObs, mpVtoReader);
-	HeaderReadIterator hdr = f.BeginRead();
-	for ( ; !hdr.IsEnd(); ++hdr) {
-		loader.Process(hdr);
-	}
+	{
+		ResponseLoader loader(mpLogger, mpObs, mpVtoReader, mpLastValues);
+		HeaderReadIterator hdr = f.BeginRead();
+		for ( ; !hdr.IsEnd(); ++hdr) {
+			loader.Process(hdr);
+		}
+	} // the loader publishes on destruction
+	LatencyTrace::Complete(mTrace);
 }
 
 /* Class Poll */
 
-ClassPoll::ClassPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
-	DataPoll(apLogger, apObs, apVtoReader),
+ClassPoll::ClassPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader, LastValueTable* apLastValues) :
+	DataPoll(apLogger, apObs, apVtoReader, apLastValues),
 	mClassMask(PC_INVALID)
 {}
 
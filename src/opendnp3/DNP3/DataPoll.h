@@ -21,6 +21,9 @@
 
 #include "MasterTaskBase.h"
 #include "VtoReader.h"
+#include "LastValueTable.h"
+
+#include <opendnp3/APL/LatencyTrace.h>
 
 namespace apl
 {
@@ -39,7 +42,7 @@ class DataPoll : public MasterTaskBase
 {
 public:
 
-	DataPoll(Logger*, IDataObserver*, VtoReader*);
+	DataPoll(Logger*, IDataObserver*, VtoReader*, LastValueTable* apLastValues = NULL);
 
 private:
 
@@ -53,6 +56,9 @@ private:
 
 	VtoReader* mpVtoReader;
 
+	LastValueTable* mpLastValues;
+
+	TraceHistograms mTrace;
 };
 
 /** Task that acquires class data from the outstation
@@ -61,7 +67,7 @@ class ClassPoll : public DataPoll
 {
 public:
 
-	ClassPoll(Logger*, IDataObserver*, VtoReader*);
+	ClassPoll(Logger*, IDataObserver*, VtoReader*, LastValueTable* apLastValues = NULL);
 
 	void Set(int aClassMask);
 
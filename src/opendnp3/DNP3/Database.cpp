@@ -65,6 +65,7 @@ void Database::Configure(DataTypes aType, size_t aNumPoints, bool aStartOnline)
 		this->AssignIndices(mCounterVec);
 		if ( aStartOnline )
 			this->SetAllOnline(mCounterVec);
+		this->mFrozenCounters.Configure(aNumPoints, aStartOnline ? CQ_ONLINE : CQ_RESTART);
 		break;
 	case(DT_CONTROL_STATUS):
 		this->mControlStatusVec.resize(aNumPoints);
@@ -184,6 +185,18 @@ void Database::SetDeadband(apl::DataTypes aType, size_t aIndex, double aDeadband
 	}
 }
 
+void Database::FreezeCounters(millis_t aTime, bool aClear)
+{
+	LOG_BLOCK(LEV_DEBUG, (aClear ? "Freezing and clearing " : "Freezing ") << mCounterVec.size() << " counters");
+	mFrozenCounters.FreezeAll(aTime, aClear);
+}
+
+void Database::FreezeCounters(size_t aStart, size_t aStop, millis_t aTime, bool aClear)
+{
+	LOG_BLOCK(LEV_DEBUG, (aClear ? "Freezing and clearing counters " : "Freezing counters ") << aStart << " to " << aStop);
+	mFrozenCounters.Freeze(mCounterVec, aStart, aStop, aTime, aClear);
+}
+
 void Database::SetEventBuffer(IEventBuffer* apEventBuffer)
 {
 	assert(apEventBuffer != NULL);
@@ -216,6 +229,9 @@ void Database::_Update(const apl::Analog& arPoint, size_t aIndex)
 
 void Database::_Update(const apl::Counter& arPoint, size_t aIndex)
 {
+	// the frozen value may still be the running value, it has to be set aside first
+	if(aIndex < mCounterVec.size()) mFrozenCounters.Settle(mCounterVec, aIndex);
+
 	if(UpdateValue<apl::Counter>(mCounterVec, arPoint, aIndex)) {
 		LOG_BLOCK(LEV_DEBUG, "Counter Change: " << arPoint.ToString() << " Index: " << aIndex);
 		mCounterVec[aIndex].mLastEventValue = mCounterVec[aIndex].mValue.GetValue();
@@ -22,6 +22,7 @@
 
 #include "DatabaseInterfaces.h"
 #include "DNPConstants.h"
+#include "FrozenCounterColumn.h"
 
 #include <opendnp3/APL/DataInterfaces.h>
 #include <opendnp3/APL/Exception.h>
@@ -83,6 +84,7 @@ public:
 	void Begin(AnalogIterator& arIter)		{
 		arIter = mAnalogVec.begin();
 	}
+	// the stored counter values don't reflect a freeze-and-clear, read them with GetCounter()
 	void Begin(CounterIterator& arIter)		{
 		arIter = mCounterVec.begin();
 	}
@@ -93,6 +95,34 @@ public:
 		arIter = mSetpointStatusVec.begin();
 	}
 
+	/* Frozen counters */
+
+	/// Freezes every counter at aTime in constant time, and clears the running counters if aClear
+	void FreezeCounters(millis_t aTime, bool aClear);
+
+	/// Freezes the counters [aStart, aStop] at aTime, and clears them if aClear
+	void FreezeCounters(size_t aStart, size_t aStop, millis_t aTime, bool aClear);
+
+	/// The running value of a counter
+	Counter GetCounter(size_t aIndex) const {
+		return mFrozenCounters.GetRunning(mCounterVec[aIndex].mValue, aIndex);
+	}
+
+	/// The value of a counter as of its latest freeze
+	Counter GetFrozenCounter(size_t aIndex) const {
+		return mFrozenCounters.GetFrozen(mCounterVec[aIndex].mValue, aIndex);
+	}
+
+	/// Increments every time all of the counters are frozen
+	boost::uint32_t GetFreezeGeneration() const {
+		return mFrozenCounters.Generation();
+	}
+
+	/// Bytes held for the frozen counters
+	size_t FrozenCounterMemory() const {
+		return mFrozenCounters.MemoryUsage();
+	}
+
 
 private:
 
@@ -129,6 +159,8 @@ private:
 	std::vector< PointInfo<apl::ControlStatus> > mControlStatusVec;
 	std::vector< PointInfo<apl::SetpointStatus> > mSetpointStatusVec;
 
+	FrozenCounterColumn mFrozenCounters;
+
 	IEventBuffer* mpEventBuffer;
 
 	template <typename T>
@@ -64,6 +64,23 @@ class InsertionOrderedEventBuffer : public EventBufferBase<EventType, InsertionO
 public:
 
 	InsertionOrderedEventBuffer(size_t aMaxEvents);
+
+	/**
+	 * Selects events in insertion order until their encoded size would
+	 * exceed arBytes, which is reduced by the size of the selected events.
+	 * If arBytes is too small for even the first matching event, that
+	 * event is still selected so the buffer can't stall.
+	 *
+	 * Note: EventType::mValue must have GetSize().
+	 *
+	 * @param aClass		the class of data to match
+	 * @param arBytes		bytes available for the selected events
+	 * @param aOverhead		bytes each event costs in addition to its value
+	 * @param aMaxEvent		maximum number of events to select
+	 *
+	 * @return				the number of events selected
+	 */
+	size_t SelectBySize(PointClass aClass, size_t& arBytes, size_t aOverhead, size_t aMaxEvent = std::numeric_limits<size_t>::max());
 };
 
 template <class EventType>
@@ -81,6 +98,29 @@ InsertionOrderedEventBuffer<EventType> :: InsertionOrderedEventBuffer(size_t aMa
 	EventBufferBase<EventType, InsertionOrderSet< EventType > >(aMaxEvents)
 {}
 
+template <class EventType>
+size_t InsertionOrderedEventBuffer<EventType> :: SelectBySize(PointClass aClass, size_t& arBytes, size_t aOverhead, size_t aMaxEvent)
+{
+	typename InsertionOrderSet< EventType >::Type::iterator i = this->mEventSet.begin();
+
+	size_t count = 0;
+
+	while( i != this->mEventSet.end() && count < aMaxEvent) {
+		if( ( i->mClass & aClass) != 0 ) {
+			size_t size = i->mValue.GetSize() + aOverhead;
+			if(count > 0 && size > arBytes) break;
+			arBytes = (size < arBytes) ? arBytes - size : 0;
+			this->mCounter.DecrCount(i->mClass);
+			this->mSelectedEvents.push_back(*i);
+			this->mEventSet.erase(i++);
+			++count;
+			this->mSelectedEvents.back().mWritten = false;
+		} else ++i;
+	}
+
+	return count;
+}
+
 template <class EventType>
 void SingleEventBuffer<EventType> :: _Update(const EventType& arEvent)
 {
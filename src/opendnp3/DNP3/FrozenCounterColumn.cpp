@@ -0,0 +1,110 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "FrozenCounterColumn.h"
+
+#include <opendnp3/APL/Exception.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+FrozenCounterColumn::FrozenCounterColumn() :
+	mGeneration(0),
+	mFreezeTime(0),
+	mCleared(0),
+	mPrevCleared(0)
+{
+
+}
+
+void FrozenCounterColumn::Configure(size_t aNumPoints, boost::uint8_t aQuality)
+{
+	Slot s = { 0, 0, 0, aQuality };
+	mSlots.assign(aNumPoints, s);
+	mGeneration = 0;
+	mFreezeTime = 0;
+	mCleared = 0;
+	mPrevCleared = 0;
+}
+
+void FrozenCounterColumn::FreezeAll(millis_t aTime, bool aClear)
+{
+	++mGeneration;
+	mFreezeTime = aTime;
+	if(aClear) {
+		mPrevCleared = mCleared;
+		mCleared = mGeneration;
+	}
+}
+
+void FrozenCounterColumn::Freeze(std::vector<CounterInfo>& arLive, size_t aStart, size_t aStop, millis_t aTime, bool aClear)
+{
+	if(aStart > aStop || aStop >= mSlots.size()) throw IndexOutOfBoundsException(LOCATION);
+
+	for(size_t i = aStart; i <= aStop; ++i) {
+		this->Settle(arLive, i);
+		Counter& live = arLive[i].mValue;
+		Slot& s = mSlots[i];
+		s.mValue = live.GetValue();
+		s.mQuality = live.GetQuality();
+		s.mTime = aTime;
+		if(aClear) live.SetValue(0);
+	}
+}
+
+Counter FrozenCounterColumn::GetFrozen(const Counter& arLive, size_t aIndex) const
+{
+	const Slot& s = mSlots[aIndex];
+	Counter c;
+	if(s.mGeneration == mGeneration) {
+		c.SetValue(s.mValue);
+		c.SetQuality(s.mQuality);
+		c.SetTime(TimeStamp_t(s.mTime));
+	} else {
+		c.SetValue(this->ClearedBeforeFreeze(s.mGeneration) ? 0 : arLive.GetValue());
+		c.SetQuality(arLive.GetQuality());
+		c.SetTime(TimeStamp_t(mFreezeTime));
+	}
+	return c;
+}
+
+Counter FrozenCounterColumn::GetRunning(const Counter& arLive, size_t aIndex) const
+{
+	if(mSlots[aIndex].mGeneration >= mCleared) return arLive;
+	Counter c(arLive);
+	c.SetValue(0);
+	return c;
+}
+
+void FrozenCounterColumn::Materialize(Counter& arLive, size_t aIndex)
+{
+	Counter frozen = this->GetFrozen(arLive, aIndex);
+	Slot& s = mSlots[aIndex];
+	s.mValue = frozen.GetValue();
+	s.mQuality = frozen.GetQuality();
+	s.mTime = frozen.GetTime();
+	if(s.mGeneration < mCleared) arLive.SetValue(0);
+	s.mGeneration = mGeneration;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
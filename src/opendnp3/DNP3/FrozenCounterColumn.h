@@ -0,0 +1,116 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __FROZEN_COUNTER_COLUMN_H_
+#define __FROZEN_COUNTER_COLUMN_H_
+
+#include <opendnp3/APL/DataTypes.h>
+
+#include "DNPDatabaseTypes.h"
+
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * The frozen copies of a database's counters.
+ *
+ * Freezing every counter doesn't copy anything. It starts a new freeze
+ * generation, and each point remembers the generation its frozen value was
+ * last settled in. A point that's behind the current generation hasn't
+ * changed since the freeze, because every update settles the point first, so
+ * its frozen value is its running value as of then. A freeze-and-clear is
+ * recorded the same way, and a running value that's behind the latest clear
+ * reads as zero. Freezing or clearing 100k counters costs the same as one.
+ *
+ * Ranges of points are frozen by copying, which settles them into the
+ * current generation.
+ */
+class FrozenCounterColumn
+{
+public:
+
+	FrozenCounterColumn();
+
+	/// Sizes the column to match the running counters and discards any frozen values
+	void Configure(size_t aNumPoints, boost::uint8_t aQuality);
+
+	size_t Size() const {
+		return mSlots.size();
+	}
+
+	/// Freezes every counter at aTime, optionally clearing the running values
+	void FreezeAll(millis_t aTime, bool aClear);
+
+	/// Freezes the counters [aStart, aStop] at aTime, optionally clearing the running values
+	void Freeze(std::vector<CounterInfo>& arLive, size_t aStart, size_t aStop, millis_t aTime, bool aClear);
+
+	/// Brings a point up to the current generation, call before its running value changes
+	void Settle(std::vector<CounterInfo>& arLive, size_t aIndex) {
+		if(mSlots[aIndex].mGeneration != mGeneration) this->Materialize(arLive[aIndex].mValue, aIndex);
+	}
+
+	/// The frozen value of a point given its stored running value
+	Counter GetFrozen(const Counter& arLive, size_t aIndex) const;
+
+	/// The running value of a point given its stored running value, zero if it's been cleared since
+	Counter GetRunning(const Counter& arLive, size_t aIndex) const;
+
+	/// Increments on every freeze of all of the counters
+	boost::uint32_t Generation() const {
+		return mGeneration;
+	}
+
+	/// Bytes of frozen state held for the points
+	size_t MemoryUsage() const {
+		return mSlots.capacity() * sizeof(Slot);
+	}
+
+private:
+
+	struct Slot {
+		boost::uint32_t mValue;			// frozen value as of mGeneration
+		boost::uint32_t mGeneration;	// generation the point was last settled in
+		millis_t mTime;					// when mValue was frozen
+		boost::uint8_t mQuality;
+	};
+
+	void Materialize(Counter& arLive, size_t aIndex);
+
+	// true if a point settled in aGeneration had its running value cleared before the latest freeze
+	bool ClearedBeforeFreeze(boost::uint32_t aGeneration) const {
+		return aGeneration < ((mCleared == mGeneration) ? mPrevCleared : mCleared);
+	}
+
+	std::vector<Slot> mSlots;
+
+	boost::uint32_t mGeneration;	// the latest freeze of every counter
+	millis_t mFreezeTime;			// when the latest freeze of every counter happened
+	boost::uint32_t mCleared;		// generation of the latest freeze-and-clear of every counter, 0 if none
+	boost::uint32_t mPrevCleared;	// generation of the freeze-and-clear before that, 0 if none
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -0,0 +1,75 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "LastValueTable.h"
+
+namespace apl
+{
+namespace dnp
+{
+
+LastValueTable::LastValueTable()
+{}
+
+bool LastValueTable::Update(const Binary& arPoint, size_t aIndex)
+{
+	return mBinaries.Update(arPoint, aIndex);
+}
+
+bool LastValueTable::Update(const Analog& arPoint, size_t aIndex)
+{
+	return mAnalogs.Update(arPoint, aIndex);
+}
+
+bool LastValueTable::Update(const Counter& arPoint, size_t aIndex)
+{
+	return mCounters.Update(arPoint, aIndex);
+}
+
+bool LastValueTable::Update(const ControlStatus& arPoint, size_t aIndex)
+{
+	return mControlStatii.Update(arPoint, aIndex);
+}
+
+bool LastValueTable::Update(const SetpointStatus& arPoint, size_t aIndex)
+{
+	return mSetpointStatii.Update(arPoint, aIndex);
+}
+
+void LastValueTable::Clear()
+{
+	mBinaries.Clear();
+	mAnalogs.Clear();
+	mCounters.Clear();
+	mControlStatii.Clear();
+	mSetpointStatii.Clear();
+}
+
+size_t LastValueTable::NumBytes() const
+{
+	return mBinaries.NumBytes() +
+	       mAnalogs.NumBytes() +
+	       mCounters.NumBytes() +
+	       mControlStatii.NumBytes() +
+	       mSetpointStatii.NumBytes();
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,210 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __LAST_VALUE_TABLE_H_
+#define __LAST_VALUE_TABLE_H_
+
+#include <opendnp3/APL/DataTypes.h>
+#include <opendnp3/APL/Uncopyable.h>
+
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * Master-side cache of the last value published for every point. The
+ * ResponseLoader consults it to drop measurements that are identical in
+ * value, quality and time to what the IDataObserver has already seen.
+ *
+ * Points are stored column-wise per type and indexed directly by point
+ * index, so the cost per cached point is:
+ *
+ *	Binary / ControlStatus		 9 bytes + 1 bit (quality, time, valid)
+ *	Counter						13 bytes + 1 bit (value, quality, time, valid)
+ *	Analog / SetpointStatus		17 bytes + 1 bit (value, quality, time, valid)
+ *
+ * Columns grow on demand up to MAX_INDEX. Points above that index are
+ * never cached and always reported as changed.
+ */
+class LastValueTable : private Uncopyable
+{
+public:
+
+	LastValueTable();
+
+	/**
+	 * Compares a point against the cached value and stores it.
+	 *
+	 * @param arPoint	the point decoded from a response
+	 * @param aIndex	index of the point
+	 * @return			true if the point is new or differs from the
+	 *					cached value and should be published
+	 */
+	bool Update(const Binary& arPoint, size_t aIndex);
+	bool Update(const Analog& arPoint, size_t aIndex);
+	bool Update(const Counter& arPoint, size_t aIndex);
+	bool Update(const ControlStatus& arPoint, size_t aIndex);
+	bool Update(const SetpointStatus& arPoint, size_t aIndex);
+
+	/**
+	 * Forgets every cached value so that the next poll republishes all points
+	 */
+	void Clear();
+
+	/**
+	 * @return the number of bytes currently reserved by the cache columns
+	 */
+	size_t NumBytes() const;
+
+	/// Highest point index that will be cached
+	static const size_t MAX_INDEX = 65535;
+
+private:
+
+	/**
+	 * Storage for the bool types. The value lives in the quality byte.
+	 */
+	template <class T>
+	class BoolColumn
+	{
+	public:
+		bool Update(const T& arPoint, size_t aIndex);
+		void Clear();
+		size_t NumBytes() const;
+
+	private:
+		std::vector<boost::uint8_t> mQuality;
+		std::vector<TimeStamp_t> mTime;
+		std::vector<bool> mValid;
+	};
+
+	/**
+	 * Storage for the types with a separate value field.
+	 */
+	template <class T>
+	class TypedColumn
+	{
+	public:
+		bool Update(const T& arPoint, size_t aIndex);
+		void Clear();
+		size_t NumBytes() const;
+
+	private:
+		std::vector<typename T::Type> mValue;
+		std::vector<boost::uint8_t> mQuality;
+		std::vector<TimeStamp_t> mTime;
+		std::vector<bool> mValid;
+	};
+
+	BoolColumn<Binary> mBinaries;
+	TypedColumn<Analog> mAnalogs;
+	TypedColumn<Counter> mCounters;
+	BoolColumn<ControlStatus> mControlStatii;
+	TypedColumn<SetpointStatus> mSetpointStatii;
+};
+
+template <class T>
+bool LastValueTable::BoolColumn<T>::Update(const T& arPoint, size_t aIndex)
+{
+	if(aIndex > MAX_INDEX) return true;
+
+	if(aIndex >= mValid.size()) {
+		mQuality.resize(aIndex + 1, 0);
+		mTime.resize(aIndex + 1, TimeStamp_t(0));
+		mValid.resize(aIndex + 1, false);
+	}
+
+	boost::uint8_t quality = arPoint.GetQuality();
+	TimeStamp_t time = arPoint.GetTime();
+
+	if(mValid[aIndex] && mQuality[aIndex] == quality && mTime[aIndex] == time) return false;
+
+	mQuality[aIndex] = quality;
+	mTime[aIndex] = time;
+	mValid[aIndex] = true;
+	return true;
+}
+
+template <class T>
+void LastValueTable::BoolColumn<T>::Clear()
+{
+	mQuality.clear();
+	mTime.clear();
+	mValid.clear();
+}
+
+template <class T>
+size_t LastValueTable::BoolColumn<T>::NumBytes() const
+{
+	return mQuality.capacity() * sizeof(boost::uint8_t) +
+	       mTime.capacity() * sizeof(TimeStamp_t) +
+	       mValid.capacity() / 8;
+}
+
+template <class T>
+bool LastValueTable::TypedColumn<T>::Update(const T& arPoint, size_t aIndex)
+{
+	if(aIndex > MAX_INDEX) return true;
+
+	if(aIndex >= mValid.size()) {
+		mValue.resize(aIndex + 1, 0);
+		mQuality.resize(aIndex + 1, 0);
+		mTime.resize(aIndex + 1, TimeStamp_t(0));
+		mValid.resize(aIndex + 1, false);
+	}
+
+	typename T::Type value = arPoint.GetValue();
+	boost::uint8_t quality = arPoint.GetQuality();
+	TimeStamp_t time = arPoint.GetTime();
+
+	if(mValid[aIndex] && mValue[aIndex] == value && mQuality[aIndex] == quality && mTime[aIndex] == time) return false;
+
+	mValue[aIndex] = value;
+	mQuality[aIndex] = quality;
+	mTime[aIndex] = time;
+	mValid[aIndex] = true;
+	return true;
+}
+
+template <class T>
+void LastValueTable::TypedColumn<T>::Clear()
+{
+	mValue.clear();
+	mQuality.clear();
+	mTime.clear();
+	mValid.clear();
+}
+
+template <class T>
+size_t LastValueTable::TypedColumn<T>::NumBytes() const
+{
+	return mValue.capacity() * sizeof(typename T::Type) +
+	       mQuality.capacity() * sizeof(boost::uint8_t) +
+	       mTime.capacity() * sizeof(TimeStamp_t) +
+	       mValid.capacity() / 8;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -45,7 +45,7 @@ void LinkChannel::BindStackToChannel(const std::string& arStackName, Stack* apSt
 {
 	LOG_BLOCK(LEV_DEBUG, "Linking stack to port w/ route " << arRoute);
 	apStack->mLink.SetRouter(this);
-	this->AddContext(&apStack->mLink, arRoute); // this function can throw, do it before adjusting the map
+	this->AddContext(&apStack->mLink, arRoute, apStack->mProfile); // this function can throw, do it before adjusting the map
 	mStackMap[arStackName] = StackRecord(apStack, arRoute);
 }
 
@@ -73,6 +73,10 @@ public:
 		return mpTaskGroup;
 	}
 
+	IPhysicalLayerAsync* GetPhysicalLayer() {
+		return mpPhys;
+	}
+
 	void BeginShutdown() {
 		this->Shutdown();
 	}
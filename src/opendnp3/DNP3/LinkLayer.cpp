@@ -41,6 +41,7 @@ LinkLayer::LinkLayer(apl::Logger* apLogger, ITimerSource* apTimerSrc, const Link
 	ILowerLayer(apLogger),
 	mCONFIG(arConfig),
 	mRetryRemaining(0),
+	mRetries(apLogger, "link_retries", "Link frames retransmitted after a confirm timeout"),
 	mpTimerSrc(apTimerSrc),
 	mpTimer(NULL),
 	mNextReadFCB(false),
@@ -175,6 +176,7 @@ bool LinkLayer::Retry()
 {
 	if(mRetryRemaining > 0) {
 		--mRetryRemaining;
+		mRetries.Increment();
 		return true;
 	} else return false;
 }
@@ -23,6 +23,7 @@
 #include <queue>
 #include <opendnp3/APL/AsyncLayerInterfaces.h>
 #include <opendnp3/APL/ITimerSource.h>
+#include <opendnp3/APL/Logger.h>
 
 #include "ILinkContext.h"
 #include "LinkFrame.h"
@@ -129,6 +130,7 @@ private:
 	void Transmit(const LinkFrame&);
 
 	size_t mRetryRemaining;
+	LogCounter mRetries;
 
 	ITimerSource* mpTimerSrc;
 	ITimer* mpTimer;
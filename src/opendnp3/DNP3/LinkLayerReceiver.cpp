@@ -18,6 +18,7 @@
 //
 #include <opendnp3/APL/PackingUnpacking.h>
 #include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/LatencyTrace.h>
 #include <assert.h>
 
 #include "DNPCrc.h"
@@ -37,7 +38,8 @@ LinkLayerReceiver::LinkLayerReceiver(Logger* apLogger, IFrameSink* apSink) :
 	mpSink(apSink),
 	mpState(LRS_Sync::Inst()),
 	mBuffer(BUFFER_SIZE),
-	mCrcFailures(apLogger, "crc_failure")
+	mCrcFailures(apLogger, "crc_failure", "Link frames discarded for a bad CRC"),
+	mRxFrames(apLogger, "link_rx_frames", "Valid link frames received")
 {
 
 }
@@ -57,8 +59,19 @@ void LinkLayerReceiver::OnRead(size_t aNumBytes)
 	mBuffer.Shift();
 }
 
+size_t LinkLayerReceiver::NumBytesToFrameEnd() const
+{
+	// until a header is read, the length of the frame isn't known
+	size_t target = (mpState == LRS_Body::Inst()) ? mFrameSize : static_cast<size_t>(LS_HEADER_SIZE);
+	size_t num = mBuffer.NumReadBytes();
+	return (num < target) ? (target - num) : 1;
+}
+
 void LinkLayerReceiver::PushFrame()
 {
+	mRxFrames.Increment();
+	LatencyTrace::Mark(TS_LINK);
+
 	switch(mHeader.GetFuncEnum()) {
 	case(FC_PRI_RESET_LINK_STATES):
 		mpSink->ResetLinkStates(mHeader.IsFromMaster(), mHeader.GetDest(), mHeader.GetSrc());
@@ -69,6 +69,9 @@ public:
 		return mBuffer.WriteBuff();
 	}
 
+	/// @return Bytes needed to finish the header or body being parsed, always at least 1
+	size_t NumBytesToFrameEnd() const;
+
 	//size_t NumReadBytes() const { return mBuffer.NumReadBytes(); }
 
 
@@ -107,6 +110,7 @@ private:
 	boost::uint8_t mpUserData[LS_MAX_USER_DATA_SIZE];
 	ShiftableBuffer mBuffer; //Buffer used to cache frames data as it arrives
 	LogCounter mCrcFailures;
+	LogCounter mRxFrames;
 };
 
 }
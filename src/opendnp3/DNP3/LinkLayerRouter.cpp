@@ -39,10 +39,14 @@ LinkLayerRouter::LinkLayerRouter(apl::Logger* apLogger, IPhysicalLayerAsync* apP
 	Loggable(apLogger),
 	PhysicalLayerMonitor(apLogger, apPhys, apTimerSrc, aOpenRetry),
 	mReceiver(apLogger, this),
-	mTransmitting(false)
+	mTransmitting(false),
+	mRxBytes(apLogger, "link_rx_bytes", "Bytes read from the physical layer"),
+	mTxFrames(apLogger, "link_tx_frames", "Link frames written to the physical layer"),
+	mTxBytes(apLogger, "link_tx_bytes", "Bytes written to the physical layer"),
+	mProfile(apLogger)
 {}
 
-void LinkLayerRouter::AddContext(ILinkContext* apContext, const LinkRoute& arRoute)
+void LinkLayerRouter::AddContext(ILinkContext* apContext, const LinkRoute& arRoute, const HandlerProfile& arProfile)
 {
 	assert(apContext != NULL);
 
@@ -53,15 +57,18 @@ void LinkLayerRouter::AddContext(ILinkContext* apContext, const LinkRoute& arRou
 	}
 
 	BOOST_FOREACH(AddressMap::value_type v, mAddressMap) {
-		if(apContext == v.second) {
+		if(apContext == v.second.pContext) {
 			ostringstream oss;
 			oss << "Context already is bound to route:  " << v.first;
 			throw ArgumentException(LOCATION, oss.str());
 		}
 	}
 
-	mAddressMap[arRoute] = apContext;
-	if(this->GetState() == PLS_OPEN) apContext->OnLowerLayerUp();
+	mAddressMap[arRoute] = ContextRecord(apContext, arProfile);
+	if(this->GetState() == PLS_OPEN) {
+		ProfileScope scope(arProfile);
+		apContext->OnLowerLayerUp();
+	}
 
 	this->Start();
 }
@@ -72,7 +79,7 @@ void LinkLayerRouter::RemoveContext(const LinkRoute& arRoute)
 	if(i == mAddressMap.end()) throw ArgumentException(LOCATION, "LinkRoute not bound: " + arRoute.ToString());
 	else {
 
-		ILinkContext* pContext = i->second;
+		ILinkContext* pContext = i->second.pContext;
 		mAddressMap.erase(i);
 
 		if(this->GetState() == PLS_OPEN) pContext->OnLowerLayerDown();
@@ -89,15 +96,16 @@ void LinkLayerRouter::RemoveContext(const LinkRoute& arRoute)
 ILinkContext* LinkLayerRouter::GetContext(const LinkRoute& arRoute)
 {
 	AddressMap::iterator i = mAddressMap.find(arRoute);
-	return (i == mAddressMap.end()) ? NULL : i->second;
+	return (i == mAddressMap.end()) ? NULL : i->second.pContext;
 }
 
 
-ILinkContext* LinkLayerRouter::GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc)
+const LinkLayerRouter::ContextRecord* LinkLayerRouter::GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc)
 {
 	LinkRoute route(aSrc, aDest);
 
-	ILinkContext* pDest = GetContext(route);
+	AddressMap::iterator i = mAddressMap.find(route);
+	const ContextRecord* pDest = (i == mAddressMap.end()) ? NULL : &i->second;
 
 	if(pDest == NULL && mpLogger->IsEnabled(LEV_WARNING)) {
 		std::ostringstream oss;
@@ -117,54 +125,84 @@ ILinkContext* LinkLayerRouter::GetDestination(boost::uint16_t aDest, boost::uint
 
 void LinkLayerRouter::Ack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->Ack(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->Ack(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::Nack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->Nack(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->Nack(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::LinkStatus(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->LinkStatus(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->LinkStatus(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::NotSupported (bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->NotSupported(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->NotSupported(aIsMaster, aIsRcvBuffFull, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::TestLinkStatus(bool aIsMaster, bool aFcb, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->TestLinkStatus(aIsMaster, aFcb, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->TestLinkStatus(aIsMaster, aFcb, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::ResetLinkStates(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->ResetLinkStates(aIsMaster, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->ResetLinkStates(aIsMaster, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::RequestLinkStatus(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->RequestLinkStatus(aIsMaster, aDest, aSrc);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->RequestLinkStatus(aIsMaster, aDest, aSrc);
+	}
 }
 void LinkLayerRouter::ConfirmedUserData(bool aIsMaster, bool aFcb, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->ConfirmedUserData(aIsMaster, aFcb, aDest, aSrc, apData, aDataLength);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->ConfirmedUserData(aIsMaster, aFcb, aDest, aSrc, apData, aDataLength);
+	}
 }
 void LinkLayerRouter::UnconfirmedUserData(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength)
 {
-	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->UnconfirmedUserData(aIsMaster, aDest, aSrc, apData, aDataLength);
+	const ContextRecord* pDest = GetDestination(aDest, aSrc);
+	if(pDest) {
+		ProfileScope scope(pDest->profile);
+		pDest->pContext->UnconfirmedUserData(aIsMaster, aDest, aSrc, apData, aDataLength);
+	}
 }
 
 void LinkLayerRouter::_OnReceive(const boost::uint8_t*, size_t aNumBytes)
 {
+	ProfileScope scope(mProfile);
+
 	// The order is important here. You must let the receiver process the byte or another read could write
 	// over the buffer before it is processed
+	mRxBytes.Increment(aNumBytes);
 	mReceiver.OnRead(aNumBytes); //this may trigger callbacks to the local ILinkContext interface
 	if(mpPhys->CanRead()) { // this is required because the call above could trigger the layer to be closed
 		mpPhys->AsyncRead(mReceiver.WriteBuff(), mReceiver.NumWriteBytes()); //start another read
@@ -179,7 +217,7 @@ void LinkLayerRouter::Transmit(const LinkFrame& arFrame)
 		if (!this->IsLowerLayerUp()) {
 			throw InvalidStateException(LOCATION, "LowerLayerDown");
 		}
-		this->mTransmitQueue.push_back(arFrame);
+		this->mTransmitQueue.Push(arFrame);
 		this->CheckForSend();
 	} else {
 		ostringstream oss;
@@ -190,50 +228,59 @@ void LinkLayerRouter::Transmit(const LinkFrame& arFrame)
 
 void LinkLayerRouter::_OnSendSuccess()
 {
-	assert(mTransmitQueue.size() > 0);
+	ProfileScope scope(mProfile);
 	assert(mTransmitting);
-	const LinkFrame& f = mTransmitQueue.front();
-	LinkRoute lr(f.GetDest(), f.GetSrc());
+	LinkRoute lr(mTxFrame.GetDest(), mTxFrame.GetSrc());
 	ILinkContext* pContext = this->GetContext(lr);
 	assert(pContext != NULL);
+	mTxFrames.Increment();
+	mTxBytes.Increment(mTxFrame.GetSize());
 	mTransmitting = false;
-	mTransmitQueue.pop_front();
 	this->CheckForSend();
 }
 
 void LinkLayerRouter::_OnSendFailure()
 {
+	ProfileScope scope(mProfile);
 	LOG_BLOCK(LEV_ERROR, "Unexpected _OnSendFailure");
+	if(mTransmitting) mTransmitQueue.PushFront(mTxFrame); // retry the same frame unless a close already flushed the queue
 	mTransmitting = false;
 	this->CheckForSend();
 }
 
 void LinkLayerRouter::CheckForSend()
 {
-	if(mTransmitQueue.size() > 0 && !mTransmitting) {
+	if(mTransmitQueue.Size() > 0 && !mTransmitting) {
 		mTransmitting = true;
-		const LinkFrame& f = mTransmitQueue.front();
-		LOG_BLOCK(LEV_INTERPRET, "~> " << f.ToString());
-		mpPhys->AsyncWrite(f.GetBuffer(), f.GetSize());
+		mTxFrame = mTransmitQueue.Front();
+		mTransmitQueue.Pop();
+		LOG_BLOCK(LEV_INTERPRET, "~> " << mTxFrame.ToString());
+		mpPhys->AsyncWrite(mTxFrame.GetBuffer(), mTxFrame.GetSize());
 	}
 }
 
 void LinkLayerRouter::OnPhysicalLayerOpenSuccessCallback()
 {
+	ProfileScope scope(mProfile);
+
 	if(mpPhys->CanRead())
 		mpPhys->AsyncRead(mReceiver.WriteBuff(), mReceiver.NumWriteBytes());
 
 	BOOST_FOREACH(AddressMap::value_type p, mAddressMap) {
-		p.second->OnLowerLayerUp();
+		ProfileScope stackScope(p.second.profile);
+		p.second.pContext->OnLowerLayerUp();
 	}
 }
 
 void LinkLayerRouter::OnPhysicalLayerCloseCallback()
 {
+	ProfileScope scope(mProfile);
+
 	mTransmitting = false;
-	mTransmitQueue.erase(mTransmitQueue.begin(), mTransmitQueue.end());
+	mTransmitQueue.Clear();
 	for(AddressMap::iterator i = mAddressMap.begin(); i != mAddressMap.end(); ++i) {
-		i->second->OnLowerLayerDown();
+		ProfileScope stackScope(i->second.profile);
+		i->second.pContext->OnLowerLayerDown();
 	}
 }
 
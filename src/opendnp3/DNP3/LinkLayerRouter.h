@@ -23,7 +23,9 @@
 #include <map>
 #include <queue>
 
+#include <opendnp3/APL/HandlerProfiler.h>
 #include <opendnp3/APL/PhysicalLayerMonitor.h>
+#include <opendnp3/APL/RingQueue.h>
 
 #include "LinkLayerReceiver.h"
 #include "IFrameSink.h"
@@ -52,8 +54,8 @@ public:
 
 	LinkLayerRouter(apl::Logger*, IPhysicalLayerAsync*, ITimerSource*, millis_t aOpenRetry);
 
-	// Ties the lower part of the link layer to the upper part
-	void AddContext(ILinkContext*, const LinkRoute& arRoute);
+	// Ties the lower part of the link layer to the upper part, frames for the route are charged to arProfile
+	void AddContext(ILinkContext*, const LinkRoute& arRoute, const HandlerProfile& arProfile = HandlerProfile());
 
 	// This is safe to do at runtime, so long as the request happens from the io_service thread.
 	void RemoveContext(const LinkRoute& arRoute);
@@ -72,24 +74,47 @@ public:
 	// ILinkRouter interface
 	void Transmit(const LinkFrame&);
 
+	// Lets framed serial ports complete reads on frame boundaries
+	size_t NumBytesToFrameEnd() const {
+		return mReceiver.NumBytesToFrameEnd();
+	}
+
 private:
 
-	ILinkContext* GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc);
+	struct ContextRecord {
+		ContextRecord() : pContext(NULL)
+		{}
+
+		ContextRecord(ILinkContext* apContext, const HandlerProfile& arProfile) :
+			pContext(apContext), profile(arProfile)
+		{}
+
+		ILinkContext* pContext;
+		HandlerProfile profile;
+	};
+
+	const ContextRecord* GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc);
 	ILinkContext* GetContext(const LinkRoute&);
 
 	void CheckForSend();
 
 
-	typedef std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan> AddressMap;
-	typedef std::deque<LinkFrame> TransmitQueue;
+	typedef std::map<LinkRoute, ContextRecord, LinkRoute::LessThan> AddressMap;
+	typedef RingQueue<LinkFrame> TransmitQueue;
 
 	AddressMap mAddressMap;
-	TransmitQueue mTransmitQueue;
+	TransmitQueue mTransmitQueue;	// frames waiting to be written, the slots are reused so steady traffic doesn't allocate
+	LinkFrame mTxFrame;				// the frame being written, held outside the queue because growing the queue moves its slots
 
 	// Handles the parsing of incoming frames
 	LinkLayerReceiver mReceiver;
 	bool mTransmitting;
 
+	LogCounter mRxBytes;
+	LogCounter mTxFrames;
+	LogCounter mTxBytes;
+	HandlerProfile mProfile;	// the channel's own share of the handlers, everything but the routed frames
+
 	/* Events - NVII delegates from IUpperLayer */
 
 	// Called when the physical layer has read data into to the requested buffer
@@ -47,9 +47,18 @@ namespace dnp
 
 Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IDataObserver* apPublisher, AsyncTaskGroup* apTaskGroup, ITimerSource* apTimerSrc, ITimeSource* apTimeSrc) :
 	Loggable(apLogger),
+	mCommandQueue(apTimeSrc),
 	mVtoReader(apLogger),
 	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), aCfg.VtoWriterQueueSize),
 	mRequest(aCfg.FragSize),
+	mpLastValues(aCfg.FilterUnchangedPoints ? &mLastValues : NULL),
+	mPollPolicy(apLogger, aCfg),
+	mpPollPolicy(aCfg.AdaptivePolling ? &mPollPolicy : NULL),
+	mIntegrityPolling(false),
+	mPollBytes(0),
+	mPollHadObjects(false),
+	mPreemptPolls(aCfg.PreemptPolls),
+	mPreempting(false),
 	mpAppLayer(apAppLayer),
 	mpPublisher(apPublisher),
 	mpTaskGroup(apTaskGroup),
@@ -61,13 +70,18 @@ Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IData
 	mpObserver(aCfg.mpObserver),
 	mState(SS_UNKNOWN),
 	mSchedule(apTaskGroup, this, aCfg),
-	mClassPoll(apLogger, apPublisher, &mVtoReader),
+	mClassPoll(apLogger, apPublisher, &mVtoReader, mpLastValues),
 	mClearRestart(apLogger),
 	mConfigureUnsol(apLogger),
 	mTimeSync(apLogger, apTimeSrc),
 	mExecuteBO(apLogger),
 	mExecuteSP(apLogger),
-	mVtoTransmitTask(apLogger, aCfg.FragSize, aCfg.UseNonStandardVtoFunction)
+	mVtoTransmitTask(apLogger, aCfg.FragSize, aCfg.UseNonStandardVtoFunction),
+	mpTaskDuration(apLogger->GetHistogram("task_duration_ms", "Milliseconds from the start of a master task to its completion")),
+	mpCommandWait(apLogger->GetHistogram("command_wait_ms", "Milliseconds a command was queued before the master started sending it")),
+	mpCommandWire(apLogger->GetHistogram("command_wire_ms", "Milliseconds from sending a command to its completion")),
+	mpPreemptions(apLogger->GetCounter("polls_preempted", "Class polls canceled between fragments to send a queued command")),
+	mTrace(apLogger)
 {
 	/*
 	 * Establish a link between the mCommandQueue and the
@@ -132,7 +146,14 @@ void Master::ProcessIIN(const IINField& arIIN)
 
 	if(mLastIIN.GetDeviceTrouble()) LOG_BLOCK(LEV_WARNING, "IIN Device trouble detected");
 
-	if(mLastIIN.GetEventBufferOverflow()) LOG_BLOCK(LEV_WARNING, "Event buffer overflow detected");
+	if(mLastIIN.GetEventBufferOverflow()) {
+		LOG_BLOCK(LEV_WARNING, "Event buffer overflow detected");
+		if(mpPollPolicy != NULL) {
+			mpPollPolicy->OnEventBufferOverflow();
+			this->ApplyPollRates();
+			check_state = true;
+		}
+	}
 
 	// If this is detected, we need to reset the startup tasks
 	if(mLastIIN.GetDeviceRestart()) {
@@ -157,6 +178,7 @@ void Master::ProcessCommand(ITask* apTask)
 		case(apl::CT_BINARY_OUTPUT): {
 				apl::BinaryOutput cmd;
 				mCommandQueue.Read(cmd, info);
+				this->RecordCommandWait(info);
 				mExecuteBO.Set(cmd, info, true);
 				mpState->StartTask(this, apTask, &mExecuteBO);
 			}
@@ -164,6 +186,7 @@ void Master::ProcessCommand(ITask* apTask)
 		case(apl::CT_SETPOINT): {
 				apl::Setpoint cmd;
 				mCommandQueue.Read(cmd, info);
+				this->RecordCommandWait(info);
 				mExecuteSP.Set(cmd, info, true);
 				mpState->StartTask(this, apTask, &mExecuteSP);
 			}
@@ -175,13 +198,61 @@ void Master::ProcessCommand(ITask* apTask)
 	}
 }
 
+void Master::RecordCommandWait(const CommandData& arInfo)
+{
+	boost::posix_time::time_duration waited = mpTimeSrc->GetUTC() - arInfo.mQueued;
+	mpCommandWait->Observe(waited.is_negative() ? 0 : waited.total_milliseconds());
+}
+
 void Master::StartTask(MasterTaskBase* apMasterTask, bool aInit)
 {
-	if(aInit) apMasterTask->Init();
+	if(aInit) {
+		apMasterTask->Init();
+		mTaskStart = mpTimeSrc->GetUTC();
+	}
 	apMasterTask->ConfigureRequest(mRequest);
 	mpAppLayer->SendRequest(mRequest);
 }
 
+void Master::CompleteTask(bool aSuccess)
+{
+	boost::posix_time::time_duration elapsed = mpTimeSrc->GetUTC() - mTaskStart;
+	mpTaskDuration->Observe(elapsed.is_negative() ? 0 : elapsed.total_milliseconds());
+	if(mpTask == &mExecuteBO || mpTask == &mExecuteSP) mpCommandWire->Observe(elapsed.is_negative() ? 0 : elapsed.total_milliseconds());
+
+	// the new rates must be in place before the task schedules its next run
+	if(aSuccess && mpPollPolicy != NULL && mpTask == &mClassPoll) {
+		if(mIntegrityPolling) mpPollPolicy->OnIntegrityPoll(mpTimeSrc->GetUTC(), mPollBytes);
+		else mpPollPolicy->OnEventScan(mPollHadObjects);
+		this->ApplyPollRates();
+	}
+
+	mpScheduledTask->OnComplete(aSuccess);
+}
+
+void Master::PreemptTask()
+{
+	LOG_BLOCK(LEV_INFO, "Preempting " << mpTask->Name() << " for a queued command");
+	mpPreemptions->Increment();
+
+	// the notifier that enables the command task may not have run yet
+	mSchedule.mpCommandTask->SilentEnable();
+	mPreempting = true;
+	mpAppLayer->CancelResponse();
+}
+
+void Master::RecordPollResponse(const APDU& arAPDU)
+{
+	if(mpPollPolicy == NULL || mpTask != &mClassPoll) return;
+	mPollBytes += arAPDU.Size();
+	if(!arAPDU.BeginRead().IsEnd()) mPollHadObjects = true;
+}
+
+void Master::ApplyPollRates()
+{
+	mSchedule.ApplyPollRates(mPollPolicy);
+}
+
 /* Tasks */
 
 void Master::SyncTime(ITask* apTask)
@@ -201,12 +272,18 @@ void Master::WriteIIN(ITask* apTask)
 void Master::IntegrityPoll(ITask* apTask)
 {
 	mClassPoll.Set(PC_CLASS_0);
+	mIntegrityPolling = true;
+	mPollBytes = 0;
+	mPollHadObjects = false;
 	mpState->StartTask(this, apTask, &mClassPoll);
 }
 
 void Master::EventPoll(ITask* apTask, int aClassMask)
 {
 	mClassPoll.Set(aClassMask);
+	mIntegrityPolling = false;
+	mPollBytes = 0;
+	mPollHadObjects = false;
 	mpState->StartTask(this, apTask, &mClassPoll);
 }
 
@@ -241,14 +318,22 @@ void Master::TransmitVtoData(ITask* apTask)
 
 void Master::OnLowerLayerUp()
 {
+	// start every session with a full publish of the first integrity poll
+	mLastValues.Clear();
 	mpState->OnLowerLayerUp(this);
 	mSchedule.EnableOnlineTasks();
 }
 
 void Master::OnLowerLayerDown()
 {
+	mPreempting = false;
 	mpState->OnLowerLayerDown(this);
 	mSchedule.DisableOnlineTasks();
+	if(mpPollPolicy != NULL) {
+		// unsolicited reporting has to prove itself again on the next session
+		mpPollPolicy->Reset();
+		this->ApplyPollRates();
+	}
 	this->UpdateState(SS_COMMS_DOWN);
 }
 
@@ -259,6 +344,11 @@ void Master::OnSolSendSuccess()
 
 void Master::OnSolFailure()
 {
+	if(mPreempting) {
+		mPreempting = false;
+		mpState->OnPreempted(this);
+		return;
+	}
 	this->UpdateState(SS_COMMS_DOWN);
 	mpState->OnFailure(this);
 }
@@ -277,19 +367,27 @@ void Master::OnPartialResponse(const APDU& arAPDU)
 {
 	mLastIIN = arAPDU.GetIIN();
 	this->ProcessIIN(mLastIIN);
+	this->RecordPollResponse(arAPDU);
 	mpState->OnPartialResponse(this, arAPDU);
+
+	// outstations abandon a response when a new request arrives, so the poll can't be resumed
+	if(mPreemptPolls && mpState == AMS_Waiting::Inst() && mpTask == &mClassPoll && mCommandQueue.Next() != CT_NONE) {
+		this->PreemptTask();
+	}
 }
 
 void Master::OnFinalResponse(const APDU& arAPDU)
 {
 	mLastIIN = arAPDU.GetIIN();
 	this->ProcessIIN(arAPDU.GetIIN());
+	this->RecordPollResponse(arAPDU);
 	mpState->OnFinalResponse(this, arAPDU);
 }
 
 void Master::OnUnsolResponse(const APDU& arAPDU)
 {
 	mLastIIN = arAPDU.GetIIN();
+	if(mpPollPolicy != NULL) mpPollPolicy->OnUnsol(mpTimeSrc->GetUTC());
 	this->ProcessIIN(mLastIIN);
 	mpState->OnUnsolResponse(this, arAPDU);
 }
@@ -299,13 +397,14 @@ void Master::OnUnsolResponse(const APDU& arAPDU)
 void Master::ProcessDataResponse(const APDU& arResponse)
 {
 	try {
-		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader());
+		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader(), mpLastValues);
 
 		for(HeaderReadIterator hdr = arResponse.BeginRead(); !hdr.IsEnd(); ++hdr)
 			loader.Process(hdr);
 	} catch(Exception ex) {
 		EXCEPTION_BLOCK(LEV_WARNING, ex)
 	}
+	LatencyTrace::Complete(mTrace);
 }
 
 }
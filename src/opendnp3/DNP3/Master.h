@@ -26,6 +26,7 @@
 #include <opendnp3/APL/PostingNotifierSource.h>
 #include <opendnp3/APL/CachedLogVariable.h>
 
+#include "AdaptivePollPolicy.h"
 #include "APDU.h"
 #include "AppInterfaces.h"
 #include "ObjectReadIterator.h"
@@ -33,6 +34,7 @@
 #include "ObjectInterfaces.h"
 #include "MasterSchedule.h"
 #include "IStackObserver.h"
+#include "LastValueTable.h"
 #include "VtoReader.h"
 #include "VtoWriter.h"
 
@@ -148,7 +150,12 @@ private:
 
 	void ProcessIIN(const IINField& arIIN);	// Analyze IIN bits and react accordingly
 	void ProcessDataResponse(const APDU&);	// Read data output of solicited or unsolicited response and publish
+	void RecordCommandWait(const CommandData&);	// Records how long a command was queued
 	void StartTask(MasterTaskBase*, bool aInit);	// Starts a task running
+	void CompleteTask(bool aSuccess);				// Completes the scheduled task and records its duration
+	void RecordPollResponse(const APDU&);			// Feeds the response of a class poll to the poll policy
+	void ApplyPollRates();							// Reschedules the polls if the poll policy changed their rates
+	void PreemptTask();								// Cancels the task in progress so a queued command can run
 
 	PostingNotifierSource mNotifierSource;	// way to get special notifiers for the command queue / VTO
 	CommandQueue mCommandQueue;				// Threadsafe queue for buffering command requests
@@ -170,6 +177,18 @@ private:
 
 	APDU mRequest;							// APDU that gets reused for requests
 
+	LastValueTable mLastValues;				// last published point values, used if FilterUnchangedPoints is set
+	LastValueTable* mpLastValues;			// points to mLastValues when filtering is enabled, otherwise NULL
+
+	AdaptivePollPolicy mPollPolicy;			// chooses the poll rates if AdaptivePolling is set
+	AdaptivePollPolicy* mpPollPolicy;		// points to mPollPolicy when adaptive polling is enabled, otherwise NULL
+	bool mIntegrityPolling;					// the class poll in progress is an integrity poll rather than an exception scan
+	size_t mPollBytes;						// bytes of the responses to the class poll in progress
+	bool mPollHadObjects;					// any response to the class poll in progress carried objects
+
+	bool mPreemptPolls;						// queued commands cancel multi-fragment class polls
+	bool mPreempting;						// the solicited failure in flight was caused by PreemptTask
+
 	IAppLayer* mpAppLayer;					// lower application layer
 	IDataObserver* mpPublisher;				// where the data measurements are pushed
 	AsyncTaskGroup* mpTaskGroup;			// How task execution is controlled
@@ -194,6 +213,13 @@ private:
 	SetpointTask mExecuteSP;				// task for executing setpoint
 	VtoTransmitTask mVtoTransmitTask;		// used to transmit VTO data in mVtoWriter
 
+	boost::posix_time::ptime mTaskStart;	// when the current task was started
+	MetricHistogram* mpTaskDuration;		// time from task start to completion, including every request
+	MetricHistogram* mpCommandWait;			// time a command spent queued before its task started
+	MetricHistogram* mpCommandWire;			// time from the start of a command task to its completion
+	MetricCounter* mpPreemptions;			// polls canceled to make way for a command
+	TraceHistograms mTrace;					// receive path latency of unsolicited data
+
 };
 
 }
@@ -47,6 +47,12 @@ struct MasterConfig {
 		UnsolClassMask(PC_ALL_EVENTS),
 		IntegrityRate(5000),
 		TaskRetryRate(5000),
+		FilterUnchangedPoints(false),
+		AdaptivePolling(false),
+		MaxIntegrityRate(3600000),
+		MinScanRate(1000),
+		UnsolHealthyWindow(60000),
+		PreemptPolls(true),
 		mpObserver(NULL)
 	{}
 
@@ -87,6 +93,28 @@ struct MasterConfig {
 	// Time delay between task retries
 	millis_t TaskRetryRate;
 
+	// If true, the master caches the last value of every point and only publishes
+	// measurements whose value, quality or time differ from what was last published
+	bool FilterUnchangedPoints;
+
+	// If true, the integrity and exception scan periods adapt to how well unsolicited
+	// reporting is working, see AdaptivePollPolicy. Meant to be used with EnableUnsol.
+	bool AdaptivePolling;
+
+	// Longest period the integrity poll is stretched to while unsolicited reporting is healthy
+	millis_t MaxIntegrityRate;
+
+	// Shortest period the exception scans are tightened to while unsolicited reporting misses events
+	millis_t MinScanRate;
+
+	// Unsolicited reporting is considered healthy at an integrity poll if an unsolicited
+	// response arrived within this many milliseconds of it
+	millis_t UnsolHealthyWindow;
+
+	// If true, a command queued while a class poll is reading a multi-fragment response
+	// cancels the poll between fragments. The poll starts over once the command is done.
+	bool PreemptPolls;
+
 	// vector that holds exception scans
 	std::vector<ExceptionScan> mScans;
 
@@ -21,6 +21,9 @@
 #include <opendnp3/APL/AsyncTaskBase.h>
 #include <opendnp3/APL/AsyncTaskContinuous.h>
 #include <opendnp3/APL/AsyncTaskGroup.h>
+#include <opendnp3/APL/AsyncTaskPeriodic.h>
+
+#include "AdaptivePollPolicy.h"
 
 #include <boost/foreach.hpp>
 
@@ -31,7 +34,8 @@ namespace dnp
 
 MasterSchedule::MasterSchedule(AsyncTaskGroup* apGroup, Master* apMaster, const MasterConfig& arCfg) :
 	mpGroup(apGroup),
-	mTracking(apGroup)
+	mTracking(apGroup),
+	mpIntegrity(NULL)
 {
 	this->Init(arCfg, apMaster);
 }
@@ -51,6 +55,19 @@ void MasterSchedule::ResetStartupTasks()
 	mpGroup->ResetTasks(START_UP_TASKS);
 }
 
+void MasterSchedule::ApplyPollRates(const AdaptivePollPolicy& arPolicy)
+{
+	if(mpIntegrity != NULL && mpIntegrity->GetPeriod() != arPolicy.GetIntegrityRate()) {
+		mpIntegrity->SetPeriod(arPolicy.GetIntegrityRate());
+	}
+
+	for(size_t i = 0; i < mScans.size(); ++i) {
+		if(mScans[i] != NULL && mScans[i]->GetPeriod() != arPolicy.GetScanRate(i)) {
+			mScans[i]->SetPeriod(arPolicy.GetScanRate(i));
+		}
+	}
+}
+
 void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 {
 	AsyncTaskBase* pIntegrity = mTracking.Add(
@@ -61,6 +78,7 @@ void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 	                                    "Integrity Poll");
 
 	pIntegrity->SetFlags(ONLINE_ONLY_TASKS | START_UP_TASKS);
+	mpIntegrity = dynamic_cast<AsyncTaskPeriodic*>(pIntegrity);
 
 	if (arCfg.DoUnsolOnStartup) {
 		/*
@@ -117,6 +135,7 @@ void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 
 		pEventScan->SetFlags(ONLINE_ONLY_TASKS);
 		pEventScan->AddDependency(pIntegrity);
+		mScans.push_back(dynamic_cast<AsyncTaskPeriodic*>(pEventScan));
 	}
 
 	/* Tasks are executed when the master is is idle */
@@ -24,11 +24,17 @@
 
 #include <opendnp3/APL/TrackingTaskGroup.h>
 
+#include <vector>
+
 namespace apl
 {
+
+class AsyncTaskPeriodic;
+
 namespace dnp
 {
 
+class AdaptivePollPolicy;
 class Master;
 
 /**
@@ -71,6 +77,9 @@ public:
 	// Resets all of the tasks that run on startup. This is typically done after a failure
 	void ResetStartupTasks();
 
+	// Sets the integrity and exception scan periods to those chosen by the policy
+	void ApplyPollRates(const AdaptivePollPolicy& arPolicy);
+
 private:
 
 	void Init(const MasterConfig& arCfg, Master* mpMaster);
@@ -79,6 +88,9 @@ private:
 	AsyncTaskGroup* mpGroup;
 	TrackingTaskGroup mTracking;
 
+	AsyncTaskPeriodic* mpIntegrity;			// NULL if the integrity poll only runs on startup
+	std::vector<AsyncTaskPeriodic*> mScans;	// in the order of MasterConfig::mScans
+
 	enum MasterPriority {
 		AMP_VTO_TRANSMIT,
 		AMP_POLL,
@@ -25,9 +25,9 @@ namespace apl
 namespace dnp
 {
 
-MasterStack::MasterStack(Logger* apLogger, ITimerSource* apTimerSrc, IDataObserver* apPublisher, AsyncTaskGroup* apTaskGroup, const MasterStackConfig& arCfg) :
-	Stack(apLogger, apTimerSrc, arCfg.app, arCfg.link),
-	mMaster(apLogger->GetSubLogger("master"), arCfg.master, &mApplication, apPublisher, apTaskGroup, apTimerSrc)
+MasterStack::MasterStack(Logger* apLogger, ITimerSource* apTimerSrc, IDataObserver* apPublisher, AsyncTaskGroup* apTaskGroup, const MasterStackConfig& arCfg, BufferPool* apPool, ITimeSource* apTimeSrc) :
+	Stack(apLogger, apTimerSrc, arCfg.app, arCfg.link, apPool),
+	mMaster(apLogger->GetSubLogger("master"), arCfg.master, &mApplication, apPublisher, apTaskGroup, apTimerSrc, apTimeSrc)
 {
 	mApplication.SetUser(&mMaster);
 }
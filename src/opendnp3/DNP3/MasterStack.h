@@ -38,7 +38,9 @@ public:
 	        ITimerSource* apTimerSrc,
 	        IDataObserver* apPublisher,
 	        AsyncTaskGroup* apTaskGroup,
-	        const MasterStackConfig& arCfg);
+	        const MasterStackConfig& arCfg,
+	        BufferPool* apPool = NULL,
+	        ITimeSource* apTimeSrc = TimeSource::Inst());
 
 	IVtoWriter* GetVtoWriter();
 	IVtoReader* GetVtoReader();
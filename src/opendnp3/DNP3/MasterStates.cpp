@@ -60,6 +60,11 @@ void AMS_Base::OnFailure(Master*)
 	throw InvalidStateException(LOCATION, this->Name());
 }
 
+void AMS_Base::OnPreempted(Master*)
+{
+	throw InvalidStateException(LOCATION, this->Name());
+}
+
 void AMS_Base::OnPartialResponse(Master*, const APDU&)
 {
 	throw InvalidStateException(LOCATION, this->Name());
@@ -134,7 +139,14 @@ void AMS_Waiting::OnFailure(Master* c)
 {
 	this->ChangeState(c, AMS_Idle::Inst());
 	c->mpTask->OnFailure();
-	c->mpScheduledTask->OnComplete(false);
+	c->CompleteTask(false);
+}
+
+void AMS_Waiting::OnPreempted(Master* c)
+{
+	// not a failure, the scheduled task stays due and runs again after the command
+	this->ChangeState(c, AMS_Idle::Inst());
+	c->mpScheduledTask->OnPreempted();
 }
 
 void AMS_Waiting::OnPartialResponse(Master* c, const APDU& arAPDU)
@@ -142,7 +154,7 @@ void AMS_Waiting::OnPartialResponse(Master* c, const APDU& arAPDU)
 	switch(c->mpTask->OnPartialResponse(arAPDU)) {
 	case(TR_FAIL):
 		this->ChangeState(c, AMS_Idle::Inst());
-		c->mpScheduledTask->OnComplete(false);
+		c->CompleteTask(false);
 		break;
 	case(TR_CONTINUE):
 		break;
@@ -156,14 +168,14 @@ void AMS_Waiting::OnFinalResponse(Master* c, const APDU& arAPDU)
 	switch(c->mpTask->OnFinalResponse(arAPDU)) {
 	case(TR_FAIL):
 		this->ChangeState(c, AMS_Idle::Inst());
-		c->mpScheduledTask->OnComplete(false);
+		c->CompleteTask(false);
 		break;
 	case(TR_CONTINUE):	//multi request task!
 		c->StartTask(c->mpTask, false);
 		break;
 	case(TR_SUCCESS):
 		this->ChangeState(c, AMS_Idle::Inst());
-		c->mpScheduledTask->OnComplete(true);
+		c->CompleteTask(true);
 	}
 }
 
@@ -58,6 +58,7 @@ public:
 
 	virtual void OnSendSuccess(Master*);
 	virtual void OnFailure(Master*);
+	virtual void OnPreempted(Master*);	// the request was canceled to make way for a command
 
 	virtual void OnPartialResponse(Master*, const APDU&);
 	virtual void OnFinalResponse(Master*, const APDU&);
@@ -109,6 +110,7 @@ class AMS_Waiting : public AMS_OpenBase
 	MACRO_STATE_SINGLETON_INSTANCE(AMS_Waiting);
 
 	void OnFailure(Master*);
+	void OnPreempted(Master*);
 	void OnPartialResponse(Master*, const APDU&);
 	void OnFinalResponse(Master*, const APDU&);
 
@@ -377,6 +377,88 @@ void Group22Var8::Write(boost::uint8_t* apPos, const apl::Counter& v) const
 	DNPToStream::WriteQVT(apPos, Group22Var8::Inst(), v);
 }
 
+Counter Group21Var1::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQV(apPos, Group21Var1::Inst());
+}
+Counter Group21Var2::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQV(apPos, Group21Var2::Inst());
+}
+Counter Group21Var5::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQVT(apPos, Group21Var5::Inst());
+}
+Counter Group21Var6::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQVT(apPos, Group21Var6::Inst());
+}
+Counter Group21Var9::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadV(apPos, Group21Var9::Inst());
+}
+Counter Group21Var10::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadV(apPos, Group21Var10::Inst());
+}
+void Group21Var1::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQV(apPos, Group21Var1::Inst(), v);
+}
+void Group21Var2::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQV(apPos, Group21Var2::Inst(), v);
+}
+void Group21Var5::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQVT(apPos, Group21Var5::Inst(), v);
+}
+void Group21Var6::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQVT(apPos, Group21Var6::Inst(), v);
+}
+void Group21Var9::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteV(apPos, Group21Var9::Inst(), v);
+}
+void Group21Var10::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteV(apPos, Group21Var10::Inst(), v);
+}
+
+Counter Group23Var1::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQV(apPos, Group23Var1::Inst());
+}
+Counter Group23Var2::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQV(apPos, Group23Var2::Inst());
+}
+Counter Group23Var5::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQVT(apPos, Group23Var5::Inst());
+}
+Counter Group23Var6::Read(const boost::uint8_t* apPos) const
+{
+	return DNPFromStream::ReadQVT(apPos, Group23Var6::Inst());
+}
+void Group23Var1::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQV(apPos, Group23Var1::Inst(), v);
+}
+void Group23Var2::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQV(apPos, Group23Var2::Inst(), v);
+}
+void Group23Var5::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQVT(apPos, Group23Var5::Inst(), v);
+}
+void Group23Var6::Write(boost::uint8_t* apPos, const apl::Counter& v) const
+{
+	DNPToStream::WriteQVT(apPos, Group23Var6::Inst(), v);
+}
+
 
 ///////////////////////////////
 //	Analog Input Types
@@ -271,18 +271,20 @@ struct Group21Var0 : public PlaceHolderObject {
 	MACRO_GROUP_VAR_FUNC(21, 0)
 };
 
-struct Group21Var1 : public FixedObject {
+struct Group21Var1 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var1)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 1, 5)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt32LE, 1)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
-struct Group21Var2 : public FixedObject {
+struct Group21Var2 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var2)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 2, 3)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
 struct Group21Var3 : public FixedObject {
@@ -299,20 +301,22 @@ struct Group21Var4 : public FixedObject {
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
 };
 
-struct Group21Var5 : public FixedObject {
+struct Group21Var5 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var5)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 5, 11)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt32LE, 1)
 	MACRO_DECLARE_TIME(UInt48LE, 5)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
-struct Group21Var6 : public FixedObject {
+struct Group21Var6 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var6)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 6, 9)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
 	MACRO_DECLARE_TIME(UInt48LE, 3)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
 struct Group21Var7 : public FixedObject {
@@ -331,16 +335,18 @@ struct Group21Var8 : public FixedObject {
 	MACRO_DECLARE_TIME(UInt48LE, 3)
 };
 
-struct Group21Var9 : public FixedObject {
+struct Group21Var9 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var9)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 9, 4)
 	MACRO_DECLARE_VALUE(UInt32LE, 0)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
-struct Group21Var10 : public FixedObject {
+struct Group21Var10 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group21Var10)
 	MACRO_GROUP_VAR_SIZE_FUNC(21, 10, 2)
 	MACRO_DECLARE_VALUE(UInt16LE, 0)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
 struct Group21Var11 : public FixedObject {
@@ -442,18 +448,20 @@ struct Group23Var0 : public PlaceHolderObject {
 	MACRO_GROUP_VAR_FUNC(23, 0)
 };
 
-struct Group23Var1 : public FixedObject {
+struct Group23Var1 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group23Var1)
 	MACRO_GROUP_VAR_SIZE_FUNC_WITH_EVENTS(23, 1, 5)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt32LE, 1)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
-struct Group23Var2 : public FixedObject {
+struct Group23Var2 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group23Var2)
 	MACRO_GROUP_VAR_SIZE_FUNC_WITH_EVENTS(23, 2, 3)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
 struct Group23Var3 : public FixedObject {
@@ -470,20 +478,22 @@ struct Group23Var4 : public FixedObject {
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
 };
 
-struct Group23Var5 : public FixedObject {
+struct Group23Var5 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group23Var5)
 	MACRO_GROUP_VAR_SIZE_FUNC_WITH_EVENTS(23, 5, 11)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt32LE, 1)
 	MACRO_DECLARE_TIME(UInt48LE, 5)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
-struct Group23Var6 : public FixedObject {
+struct Group23Var6 : public StreamObject<Counter> {
 	MACRO_NAME_SINGLETON_INSTANCE(Group23Var6)
 	MACRO_GROUP_VAR_SIZE_FUNC_WITH_EVENTS(23, 6, 9)
 	MACRO_DECLARE_QUALITY(UInt8, 0)
 	MACRO_DECLARE_VALUE(UInt16LE, 1)
 	MACRO_DECLARE_TIME(UInt48LE, 3)
+	MACRO_DECLARE_STREAM_TYPE(Counter)
 };
 
 struct Group23Var7 : public FixedObject {
@@ -15,8 +15,7 @@
 // under the License.
 //
 
-#include <boost/bind.hpp>
-
+#include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/Util.h>
 
@@ -25,31 +24,13 @@
 #include "ResponseContext.h"
 #include "SlaveResponseTypes.h"
 
-using namespace boost;
-
 namespace apl
 {
 namespace dnp
 {
 
-ResponseContext::ResponseKey::ResponseKey() : mType(RT_STATIC), mOrder(0)
-{}
-
-ResponseContext::ResponseKey::ResponseKey(ResponseContext::RequestType aType, size_t aOrder) : mType(aType), mOrder(aOrder)
-{}
-
-// custom less than function used by STL
-bool ResponseContext::ResponseKey::operator()(const ResponseContext::ResponseKey& a, const ResponseContext::ResponseKey& b) const
-{
-	if(a.mType < b.mType) return true;
-	else if(a.mType > b.mType) return false;
-	else {
-		return a.mOrder < b.mOrder;
-	}
-}
-
 
-ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig) :
+ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig, size_t aMaxFragSize) :
 	Loggable(apLogger),
 	mBuffer(arEventMaxConfig),
 	mMode(UNDEFINED),
@@ -57,8 +38,21 @@ ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponse
 	mFIR(true),
 	mFIN(false),
 	mpRspTypes(apRspTypes),
-	mLoadedEventData(false)
-{}
+	mLoadedEventData(false),
+	mpEventDepth(apLogger->GetGauge("event_buffer_depth", "Events buffered by the slave awaiting a read")),
+	mpEventPeak(apLogger->GetGauge("event_buffer_peak", "Most events the slave has had buffered at once")),
+	mMaxFragSize(aMaxFragSize),
+	mVtoSpace(aMaxFragSize - ResponseHeader::Inst()->GetSize()),
+	mStaticNext(0),
+	mFrozenGeneration(0),
+	mFrozenClasses(0),
+	mFrozenRemain(0),
+	mFrozenCursor(0),
+	mpFrozenEventObj(NULL)
+{
+	mStaticPlan.reserve(STATIC_PLAN_CAPACITY);
+	for(size_t i = 0; i < 3; ++i) mFrozenReported[i] = 0;
+}
 
 void ResponseContext::Reset()
 {
@@ -67,12 +61,18 @@ void ResponseContext::Reset()
 	mMode = UNDEFINED;
 	mTempIIN.Zero();
 
-	this->mStaticWriteMap.clear();
+	this->mStaticPlan.clear();
+	this->mStaticNext = 0;
+	this->mVtoSpace = mMaxFragSize - ResponseHeader::Inst()->GetSize();
 
-	this->mBinaryEvents.clear();
-	this->mAnalogEvents.clear();
-	this->mCounterEvents.clear();
-	this->mVtoEvents.clear();
+	this->mBinaryEvents.Clear();
+	this->mAnalogEvents.Clear();
+	this->mCounterEvents.Clear();
+	this->mVtoEvents.Clear();
+
+	this->mFrozenClasses = 0;
+	this->mFrozenRemain = 0;
+	this->mFrozenCursor = 0;
 
 	mBuffer.Deselect();
 }
@@ -83,7 +83,24 @@ void ResponseContext::ClearWritten()
 
 	size_t deselected = mBuffer.Deselect();
 
+	if(mFrozenClasses != 0 && mFrozenRemain == 0) {
+		// every selected frozen counter event has been confirmed
+		if(mFrozenClasses & PC_CLASS_1) mFrozenReported[0] = mFrozenGeneration;
+		if(mFrozenClasses & PC_CLASS_2) mFrozenReported[1] = mFrozenGeneration;
+		if(mFrozenClasses & PC_CLASS_3) mFrozenReported[2] = mFrozenGeneration;
+		mFrozenClasses = 0;
+		mFrozenCursor = 0;
+	}
+
 	LOG_BLOCK(LEV_DEBUG, "Clearing written events: " << written << " deselected: " << deselected);
+	this->UpdateEventDepth();
+}
+
+void ResponseContext::UpdateEventDepth()
+{
+	size_t num = mBuffer.NumType(BT_BINARY) + mBuffer.NumType(BT_ANALOG) + mBuffer.NumType(BT_COUNTER) + mBuffer.NumType(BT_VTO);
+	mpEventDepth->Set(static_cast<boost::int64_t>(num));
+	if(static_cast<boost::int64_t>(num) > mpEventPeak->Get()) mpEventPeak->Set(static_cast<boost::int64_t>(num));
 }
 
 void ResponseContext::ClearAndReset()
@@ -174,6 +191,27 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 		case(MACRO_DNP_RADIX(20, 8)):
 			this->RecordStaticObjects<CounterInfo>(Group20Var8::Inst(), hdr);
 			break;
+		case(MACRO_DNP_RADIX(21, 0)):
+			this->RecordStaticObjects<CounterInfo>(mpRspTypes->mpStaticFrozenCounter, hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 1)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var1::Inst(), hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 2)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var2::Inst(), hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 5)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var5::Inst(), hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 6)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var6::Inst(), hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 9)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var9::Inst(), hdr, true);
+			break;
+		case(MACRO_DNP_RADIX(21, 10)):
+			this->RecordStaticObjects<CounterInfo>(Group21Var10::Inst(), hdr, true);
+			break;
 		case(MACRO_DNP_RADIX(30, 0)):
 			this->RecordStaticObjects<AnalogInfo>(mpRspTypes->mpStaticAnalog, hdr);
 			break;
@@ -218,6 +256,9 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 		case(MACRO_DNP_RADIX(22, 0)):
 			this->SelectEvents(PC_ALL_EVENTS, mpRspTypes->mpEventCounter, mCounterEvents, GetEventCount(hdr.info()));
 			break;
+		case(MACRO_DNP_RADIX(23, 0)):
+			this->SelectFrozenEvents(PC_ALL_EVENTS, mpRspTypes->mpEventFrozenCounter);
+			break;
 		case(MACRO_DNP_RADIX(32, 0)):
 			this->SelectEvents(PC_ALL_EVENTS, mpRspTypes->mpEventAnalog, mAnalogEvents, GetEventCount(hdr.info()));
 			break;
@@ -232,6 +273,18 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 		case(MACRO_DNP_RADIX(2, 3)):
 			this->SelectEvents(PC_ALL_EVENTS, Group2Var3::Inst(), mBinaryEvents, GetEventCount(hdr.info()));
 			break;
+		case(MACRO_DNP_RADIX(23, 1)):
+			this->SelectFrozenEvents(PC_ALL_EVENTS, Group23Var1::Inst());
+			break;
+		case(MACRO_DNP_RADIX(23, 2)):
+			this->SelectFrozenEvents(PC_ALL_EVENTS, Group23Var2::Inst());
+			break;
+		case(MACRO_DNP_RADIX(23, 5)):
+			this->SelectFrozenEvents(PC_ALL_EVENTS, Group23Var5::Inst());
+			break;
+		case(MACRO_DNP_RADIX(23, 6)):
+			this->SelectFrozenEvents(PC_ALL_EVENTS, Group23Var6::Inst());
+			break;
 
 			// Class Objects
 		case(MACRO_DNP_RADIX(60, 1)):
@@ -243,12 +296,15 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 			break;
 		case(MACRO_DNP_RADIX(60, 2)):
 			this->SelectEvents(PC_CLASS_1, GetEventCount(hdr.info()));
+			this->SelectFrozenEvents(PC_CLASS_1, mpRspTypes->mpEventFrozenCounter);
 			break;
 		case(MACRO_DNP_RADIX(60, 3)):
 			this->SelectEvents(PC_CLASS_2, GetEventCount(hdr.info()));
+			this->SelectFrozenEvents(PC_CLASS_2, mpRspTypes->mpEventFrozenCounter);
 			break;
 		case(MACRO_DNP_RADIX(60, 4)):
 			this->SelectEvents(PC_CLASS_3, GetEventCount(hdr.info()));
+			this->SelectFrozenEvents(PC_CLASS_3, mpRspTypes->mpEventFrozenCounter);
 			break;
 		default:
 			LOG_BLOCK(LEV_WARNING, "READ for obj " << hdr->GetGroup() << " var " << hdr->GetVariation() << " not supported.");
@@ -276,23 +332,54 @@ void ResponseContext::SelectEvents(PointClass aClass, size_t aNum)
 
 size_t ResponseContext::SelectVtoEvents(PointClass aClass, const SizeByVariationObject* apObj, size_t aNum)
 {
-	// only select as many messages we are likley to be able to send
-	// TODO: remove MAX_VTO_EVENTS once eventbuffer is fixed so selecting/adding/deselecting events keeps same size
-	const size_t MAX_VTO_EVENTS = 7;
-
-	size_t selectable = apl::Min<size_t>(aNum, MAX_VTO_EVENTS);
-	size_t num = mBuffer.Select(BT_VTO, aClass, selectable);
+	/*
+	 * Only select what fits in one fragment. Anything left over stays
+	 * in the buffer for the next read or unsolicited response rather
+	 * than being held selected until the whole response is confirmed.
+	 */
+	size_t num = mBuffer.SelectVto(aClass, mVtoSpace, VTO_OBJECT_OVERHEAD, aNum);
 
-	LOG_BLOCK(LEV_INTERPRET, "Selected: " << num << " vto events");
+	LOG_BLOCK(LEV_INTERPRET, "Selected: " << num << " vto events, " << mVtoSpace << " bytes of the fragment left");
 
 	if (num > 0) {
-		VtoEventRequest r(apObj, aNum);
-		this->mVtoEvents.push_back(r);
+		VtoEventRequest& r = this->mVtoEvents.Push();
+		r.pObj = apObj;
+		r.count = aNum;
 	}
 
 	return num;
 }
 
+void ResponseContext::SelectFrozenEvents(int aClasses, const StreamObject<Counter>* apObj)
+{
+	boost::uint32_t generation = mpDB->GetFreezeGeneration();
+
+	int classes = 0;
+	if((aClasses & PC_CLASS_1) && mFrozenReported[0] != generation) classes |= PC_CLASS_1;
+	if((aClasses & PC_CLASS_2) && mFrozenReported[1] != generation) classes |= PC_CLASS_2;
+	if((aClasses & PC_CLASS_3) && mFrozenReported[2] != generation) classes |= PC_CLASS_3;
+	classes &= ~mFrozenClasses;
+	if(classes == 0) return;
+
+	size_t num = 0;
+	CounterIterator itr;
+	mpDB->Begin(itr);
+	for(size_t i = 0; i < mpDB->NumType(DT_COUNTER); ++i, ++itr) {
+		if(itr->mClass & classes) ++num;
+	}
+
+	LOG_BLOCK(LEV_INTERPRET, "Selected: " << num << " frozen counter events");
+
+	if(num == 0) return;
+
+	if(mFrozenClasses == 0) {
+		mpFrozenEventObj = apObj;
+		mFrozenGeneration = generation;
+	}
+	mFrozenClasses |= classes;
+	mFrozenRemain += num;
+}
+
 void ResponseContext::LoadResponse(APDU& arAPDU)
 {
 	//delay the setting of FIR/FIN until we know if it will be multifragmented or not
@@ -325,6 +412,7 @@ bool ResponseContext::HasEvents(ClassMask m)
 
 void ResponseContext::LoadUnsol(APDU& arAPDU, const IINField& arIIN, ClassMask m)
 {
+	this->mVtoSpace = mMaxFragSize - ResponseHeader::Inst()->GetSize();
 	this->SelectUnsol(m);
 
 	arAPDU.Set(FC_UNSOLICITED_RESPONSE, true, true, true, true);
@@ -336,20 +424,46 @@ bool ResponseContext::LoadEventData(APDU& arAPDU)
 	if (!this->LoadEvents<Binary>(arAPDU, mBinaryEvents)) return false;
 	if (!this->LoadEvents<Analog>(arAPDU, mAnalogEvents)) return false;
 	if (!this->LoadEvents<Counter>(arAPDU, mCounterEvents)) return false;
+	if (!this->LoadFrozenEvents(arAPDU)) return false;
 	if (!this->LoadVtoEvents(arAPDU)) return false;
 
 	return true;
 }
 
+bool ResponseContext::LoadFrozenEvents(APDU& arAPDU)
+{
+	if(mFrozenRemain == 0) return true;
+
+	CounterIterator first;
+	mpDB->Begin(first);
+	IndexedWriteIterator write = arAPDU.WriteIndexed(mpFrozenEventObj, mFrozenRemain, mpDB->MaxIndex(DT_COUNTER));
+
+	while(mFrozenRemain > 0) {
+		CounterIterator itr = first + mFrozenCursor;
+		if(itr->mClass & mFrozenClasses) {
+			if(write.IsEnd()) return false;		// resume from the cursor in the next fragment
+
+			write.SetIndex(itr->mIndex);
+			mpFrozenEventObj->Write(*write, mpDB->GetFrozenCounter(itr->mIndex));
+			this->mLoadedEventData = true;
+			++write;
+			--mFrozenRemain;
+		}
+		++mFrozenCursor;
+	}
+
+	return true;
+}
+
 bool ResponseContext::LoadVtoEvents(APDU& arAPDU)
 {
 	VtoDataEventIter itr;
 	mBuffer.Begin(itr);
 	size_t remain = mBuffer.NumSelected(BT_VTO);
 
-	while (this->mVtoEvents.size() > 0) {
+	while (this->mVtoEvents.Size() > 0) {
 		/* Get the number of events requested */
-		VtoEventRequest& r = this->mVtoEvents.front();
+		VtoEventRequest& r = this->mVtoEvents.Front();
 
 		if (r.count > remain) {
 			r.count = remain;
@@ -365,7 +479,7 @@ bool ResponseContext::LoadVtoEvents(APDU& arAPDU)
 
 		if (written == r.count) {
 			/* all events were written, finished with request */
-			this->mVtoEvents.pop_front();
+			this->mVtoEvents.Pop();
 		} else {
 			/* more event data remains in the queue */
 			r.count -= written;
@@ -421,13 +535,13 @@ bool ResponseContext::IsEmpty()
 
 bool ResponseContext::IsStaticEmpty()
 {
-	return this->mStaticWriteMap.empty();
+	return this->mStaticNext == this->mStaticPlan.size();
 }
 
 bool ResponseContext::IsEventEmpty()
 {
 	// are there unwritten events in the selection buffer?
-	return mBuffer.NumSelected() == 0;
+	return mBuffer.NumSelected() == 0 && mFrozenRemain == 0;
 }
 
 void ResponseContext::FinalizeResponse(APDU& arAPDU, bool aFIN)
@@ -441,13 +555,43 @@ void ResponseContext::FinalizeResponse(APDU& arAPDU, bool aFIN)
 
 bool ResponseContext::LoadStaticData(APDU& arAPDU)
 {
-	while(!this->mStaticWriteMap.empty()) {
+	while(this->mStaticNext < this->mStaticPlan.size()) {
+		if(this->WriteStaticObjects(this->mStaticPlan[this->mStaticNext], arAPDU)) {
+			++this->mStaticNext;
+		} else return false;
+	}
+
+	return true;
+}
 
-		WriteMap::iterator i = this->mStaticWriteMap.begin();
+bool ResponseContext::WriteStaticObjects(StaticRequest& arRequest, APDU& arAPDU)
+{
+	switch(arRequest.type) {
+	case(DT_BINARY):
+		return this->WriteStaticObjects<BinaryInfo>(arRequest, arAPDU);
+	case(DT_ANALOG):
+		return this->WriteStaticObjects<AnalogInfo>(arRequest, arAPDU);
+	case(DT_COUNTER):
+		return this->WriteCounterObjects(arRequest, arAPDU);
+	case(DT_CONTROL_STATUS):
+		return this->WriteStaticObjects<ControlStatusInfo>(arRequest, arAPDU);
+	case(DT_SETPOINT_STATUS):
+		return this->WriteStaticObjects<SetpointStatusInfo>(arRequest, arAPDU);
+	default:
+		throw Exception(LOCATION, "Unknown static request type");
+	}
+}
 
-		if(i->second(arAPDU)) {
-			this->mStaticWriteMap.erase(i);
-		} else return false;
+bool ResponseContext::WriteCounterObjects(StaticRequest& arRequest, APDU& arAPDU)
+{
+	StreamObject<Counter>* pObj = static_cast<StreamObject<Counter>*>(arRequest.pObj);
+	ObjectWriteIterator owi = arAPDU.WriteContiguous(pObj, arRequest.cursor, arRequest.stop);
+
+	for(size_t i = arRequest.cursor; i <= arRequest.stop; ++i) {
+		if(owi.IsEnd()) return false; // out of space in the fragment, resume from the cursor next time
+		pObj->Write(*owi, arRequest.frozen ? mpDB->GetFrozenCounter(i) : mpDB->GetCounter(i));
+		++owi;
+		++arRequest.cursor;
 	}
 
 	return true;
@@ -18,11 +18,11 @@
 #ifndef __RESPONSE_CONTEXT_H_
 #define __RESPONSE_CONTEXT_H_
 
-#include <boost/function.hpp>
-#include <boost/bind.hpp>
-#include <queue>
+#include <limits>
+#include <vector>
 
 #include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/RingQueue.h>
 
 #include "APDU.h"
 #include "ClassMask.h"
@@ -55,35 +55,30 @@ class ResponseContext : public Loggable
 		UNSOLICITED
 	};
 
-	enum RequestType {
-		RT_STATIC = 0,
-		RT_EVENT = 1
-	};
-
-	//used as a key that decides in what order response headers are packed into APDUs
-	struct ResponseKey {
-
-		ResponseKey();
-
-		ResponseKey(RequestType aType, size_t aOrder);
-
-		RequestType mType;
-		size_t mOrder;
-
-		// custom less than function used by STL
-		bool operator()(const ResponseKey& a, const ResponseKey& b) const;
+	/**
+	 * A range of static points to write in response to a read header. The
+	 * requests are kept in the order the headers were read, which is the
+	 * order they're packed into the response, and 'cursor' records how far
+	 * the range has been written so a request can resume in the next fragment.
+	 */
+	struct StaticRequest {
+		apl::DataTypes type;		// which database array to read
+		FixedObject* pObj;			// the StreamObject<T> for the type to write with
+		size_t start;				// position of the first point
+		size_t stop;				// position of the last point
+		size_t cursor;				// position of the next point to write
+		bool frozen;				// write the frozen counters rather than the running ones
 	};
 
+	// Number of static requests the plan holds without allocating, a class 0 poll uses 5
+	static const size_t STATIC_PLAN_CAPACITY = 64;
 
+public:
 	/**
-	* This function takes an APDU, writes some data to it, and modifies the current state of the
-	* ResponseContext class. It returns true if all of the data was written before the APDU was full,
-	* and false otherwise.
+		@param aMaxFragSize		Size of the response fragments, Virtual Terminal events are
+								selected a fragment at a time
 	*/
-	typedef boost::function<bool (APDU&)> WriteFunction;
-
-public:
-	ResponseContext(Logger*, Database*, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig);
+	ResponseContext(Logger*, Database*, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig, size_t aMaxFragSize = DEFAULT_FRAG_SIZE);
 
 	Mode GetMode() {
 		return mMode;
@@ -120,6 +115,9 @@ public:
 	// Clear written events and reset the state of the object
 	void ClearAndReset();
 
+	// Publish the number of buffered events to the event_buffer_depth and event_buffer_peak gauges
+	void UpdateEventDepth();
+
 private:
 
 	// configure the state for unsol, return true of events exist
@@ -143,6 +141,17 @@ private:
 	 */
 	bool LoadEventData(APDU& arAPDU);
 
+	/**
+	 * Frozen counter events aren't buffered. After every freeze of all of
+	 * the counters, each counter with an event class has one event, which
+	 * is read from the database's frozen values. A session that hasn't read
+	 * a freeze's events before the next freeze gets the newer values.
+	 *
+	 * @return					'true' if all of the selected frozen counter
+	 * 							events were written
+	 */
+	bool LoadFrozenEvents(APDU& arAPDU);
+
 	void FinalizeResponse(APDU&, bool aFIN);
 	bool IsEmpty();
 
@@ -157,9 +166,15 @@ private:
 	IINField mTempIIN;
 	bool mLoadedEventData;
 
+	MetricGauge* mpEventDepth;
+	MetricGauge* mpEventPeak;
+
+	size_t mMaxFragSize;
+	size_t mVtoSpace;			// fragment bytes still free for Virtual Terminal events in this response
+
 	template<class T>
 	struct EventRequest {
-		EventRequest(const StreamObject<T>* apObj, size_t aCount = std::numeric_limits<size_t>::max()) :
+		EventRequest(const StreamObject<T>* apObj = NULL, size_t aCount = std::numeric_limits<size_t>::max()) :
 			pObj(apObj),
 			count(aCount)
 		{}
@@ -169,7 +184,7 @@ private:
 	};
 
 	struct VtoEventRequest {
-		VtoEventRequest(const SizeByVariationObject* apObj, size_t aCount = std::numeric_limits<size_t>::max()) :
+		VtoEventRequest(const SizeByVariationObject* apObj = NULL, size_t aCount = std::numeric_limits<size_t>::max()) :
 			pObj(apObj),
 			count(aCount)
 		{}
@@ -178,15 +193,15 @@ private:
 		size_t count;						// Number of events to read
 	};
 
-	typedef std::map <ResponseKey, WriteFunction, ResponseKey >	WriteMap;
-
-	// the queue that tracks the pending static write operations
-	WriteMap mStaticWriteMap;
+	// the pending static writes in response order, mStaticPlan[mStaticNext] is the next to write.
+	// The vector is cleared rather than freed, so it only allocates for unusually long requests
+	std::vector<StaticRequest> mStaticPlan;
+	size_t mStaticNext;
 
-	typedef std::deque< EventRequest<Binary> >				BinaryEventQueue;
-	typedef std::deque< EventRequest<Analog> >				AnalogEventQueue;
-	typedef std::deque< EventRequest<Counter> >				CounterEventQueue;
-	typedef std::deque<VtoEventRequest>						VtoEventQueue;
+	typedef RingQueue< EventRequest<Binary> >				BinaryEventQueue;
+	typedef RingQueue< EventRequest<Analog> >				AnalogEventQueue;
+	typedef RingQueue< EventRequest<Counter> >				CounterEventQueue;
+	typedef RingQueue<VtoEventRequest>						VtoEventQueue;
 
 	//these queues track what events have been requested
 	BinaryEventQueue mBinaryEvents;
@@ -194,8 +209,15 @@ private:
 	CounterEventQueue mCounterEvents;
 	VtoEventQueue mVtoEvents;
 
+	boost::uint32_t mFrozenReported[3];				// the latest freeze whose class 1, 2 and 3 events were confirmed
+	boost::uint32_t mFrozenGeneration;				// the freeze whose events are selected
+	int mFrozenClasses;								// classes of the selected frozen counter events, 0 if none
+	size_t mFrozenRemain;							// selected frozen counter events not yet written
+	size_t mFrozenCursor;							// position of the next counter to consider
+	const StreamObject<Counter>* mpFrozenEventObj;	// type to write the frozen counter events with
+
 	template <class T>
-	bool LoadEvents(APDU& arAPDU, std::deque< EventRequest<T> >& arQueue);
+	bool LoadEvents(APDU& arAPDU, RingQueue< EventRequest<T> >& arQueue);
 
 	bool LoadVtoEvents(APDU& arAPDU);
 
@@ -203,10 +225,13 @@ private:
 	void SelectEvents(PointClass aClass, size_t aNum = std::numeric_limits<size_t>::max());
 
 	template <class T>
-	size_t SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum = std::numeric_limits<size_t>::max());
+	size_t SelectEvents(PointClass aClass, const StreamObject<T>* apObj, RingQueue< EventRequest<T> >& arQueue, size_t aNum = std::numeric_limits<size_t>::max());
 
 	size_t SelectVtoEvents(PointClass aClass, const SizeByVariationObject* apObj, size_t aNum);
 
+	// selects the frozen counter events of the classes in aClasses that haven't been reported yet
+	void SelectFrozenEvents(int aClasses, const StreamObject<Counter>* apObj);
+
 
 	// T is the event type
 	template <class T>
@@ -224,37 +249,44 @@ private:
 	// Static write functions
 
 	template <class T>
-	void RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter);
+	void RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter, bool aFrozen = false);
 
 	template <class T>
-	void RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop);
+	void RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, bool aFrozen);
+
+	// @return true if the whole request was written, false if the APDU filled first
+	bool WriteStaticObjects(StaticRequest& arRequest, APDU& arAPDU);
 
 	template <class T>
-	bool WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, typename StaticIter<T>::Type& arStart, typename StaticIter<T>::Type& arStop, const ResponseKey& arKey, APDU& arAPDU);
+	bool WriteStaticObjects(StaticRequest& arRequest, APDU& arAPDU);
+
+	// counters are read through the database, which resolves freezes and clears
+	bool WriteCounterObjects(StaticRequest& arRequest, APDU& arAPDU);
 };
 
 template <class T>
-size_t ResponseContext::SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum)
+size_t ResponseContext::SelectEvents(PointClass aClass, const StreamObject<T>* apObj, RingQueue< EventRequest<T> >& arQueue, size_t aNum)
 {
 	size_t num = mBuffer.Select(Convert(T::MeasEnum), aClass, aNum);
 
 	if (num > 0) {
-		EventRequest<T> r(apObj, aNum);
-		arQueue.push_back(r);
+		EventRequest<T>& r = arQueue.Push();
+		r.pObj = apObj;
+		r.count = aNum;
 	}
 
 	return num;
 }
 
 template <class T>
-void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter)
+void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter, bool aFrozen)
 {
 	size_t num = mpDB->NumType(T::MeasType::MeasEnum);
 
 	//figure out what type of read request this is
 	switch(arIter->GetHeaderType()) {
 	case(OHT_ALL_OBJECTS): {
-			if(num > 0) this->RecordStaticObjectsByRange<T>(apObject, 0, num - 1);
+			if(num > 0) this->RecordStaticObjectsByRange<T>(apObject, 0, num - 1, aFrozen);
 		}
 		break;
 
@@ -268,7 +300,7 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 				pHeader->GetRange(*arIter, ri);
 
 				if(ri.Start > max || ri.Stop > max || ri.Start > ri.Stop) this->mTempIIN.SetParameterError(true);
-				else this->RecordStaticObjectsByRange<T>(apObject, ri.Start, ri.Stop);
+				else this->RecordStaticObjectsByRange<T>(apObject, ri.Start, ri.Stop, aFrozen);
 			} else this->mTempIIN.SetParameterError(true);
 		}
 		break;
@@ -284,7 +316,7 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 					size_t stop = count - 1;
 
 					if(start > max || stop > max || start > stop) this->mTempIIN.SetParameterError(true);
-					else this->RecordStaticObjectsByRange<T>(apObject, start, stop);
+					else this->RecordStaticObjectsByRange<T>(apObject, start, stop, aFrozen);
 				} else this->mTempIIN.SetParameterError(true);
 			} else this->mTempIIN.SetParameterError(true);
 		}
@@ -293,48 +325,45 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 }
 
 template <class T>
-void ResponseContext::RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop)
+void ResponseContext::RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, bool aFrozen)
 {
-	typename StaticIter<T>::Type first;
-	typename StaticIter<T>::Type last;
-	mpDB->Begin(first);
-	last = first + aStop;
-	first = first + aStart;
-	ResponseKey key(RT_STATIC, this->mStaticWriteMap.size());
-	WriteFunction func = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, first, last, key, _1);
-	this->mStaticWriteMap[key] = func;
+	StaticRequest r = { T::MeasType::MeasEnum, apObject, aStart, aStop, aStart, aFrozen };
+	this->mStaticPlan.push_back(r);
 }
 
 template <class T>
-bool ResponseContext::WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, typename StaticIter<T>::Type& arStart, typename StaticIter<T>::Type& arStop, const ResponseKey& arKey, APDU& arAPDU)
+bool ResponseContext::WriteStaticObjects(StaticRequest& arRequest, APDU& arAPDU)
 {
-	size_t start = arStart->mIndex;
-	size_t stop = arStop->mIndex;
-	ObjectWriteIterator owi = arAPDU.WriteContiguous(apObject, start, stop);
+	StreamObject<typename T::MeasType>* pObj = static_cast<StreamObject<typename T::MeasType>*>(arRequest.pObj);
+	typename StaticIter<T>::Type first;
+	mpDB->Begin(first);
+	typename StaticIter<T>::Type itr = first + arRequest.cursor;
+
+	size_t start = itr->mIndex;
+	size_t stop = (first + arRequest.stop)->mIndex;
+	ObjectWriteIterator owi = arAPDU.WriteContiguous(pObj, start, stop);
 
 	for(size_t i = start; i <= stop; ++i) {
-		if(owi.IsEnd()) { // out of space in the fragment
-			this->mStaticWriteMap[arKey] = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, arStart, arStop, arKey, _1);
-			return false;
-		}
-		apObject->Write(*owi, arStart->mValue);
-		++arStart; //increment the iterators
+		if(owi.IsEnd()) return false; // out of space in the fragment, resume from the cursor next time
+		pObj->Write(*owi, itr->mValue);
+		++itr; //increment the iterators
 		++owi;
+		++arRequest.cursor;
 	}
 
 	return true;
 }
 
 template <class T>
-bool ResponseContext::LoadEvents(APDU& arAPDU, std::deque< EventRequest<T> >& arQueue)
+bool ResponseContext::LoadEvents(APDU& arAPDU, RingQueue< EventRequest<T> >& arQueue)
 {
 	typename EvtItr< EventInfo<T> >::Type itr;
 	mBuffer.Begin(itr);
 	size_t remain = mBuffer.NumSelected(Convert(T::MeasEnum));
 
-	while (arQueue.size() > 0) {
+	while (arQueue.Size() > 0) {
 		/* Get the number of events requested */
-		EventRequest<T>& r = arQueue.front();
+		EventRequest<T>& r = arQueue.Front();
 
 		if (r.count > remain) {
 			r.count = remain;
@@ -350,7 +379,7 @@ bool ResponseContext::LoadEvents(APDU& arAPDU, std::deque< EventRequest<T> >& ar
 
 		if (written == r.count) {
 			/* all events were written, finished with request */
-			arQueue.pop_front();
+			arQueue.Pop();
 		} else {
 			/* more event data remains in the queue */
 			r.count -= written;
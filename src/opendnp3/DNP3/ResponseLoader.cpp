@@ -28,10 +28,11 @@ namespace apl
 namespace dnp
 {
 
-ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader) :
+ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader, LastValueTable* apLastValues) :
 	Loggable(apLogger),
 	mpPublisher(apPublisher),
 	mpVtoReader(apVtoReader),
+	mpLastValues(apLastValues),
 	mTransaction(apPublisher)
 {}
 
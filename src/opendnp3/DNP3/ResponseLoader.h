@@ -25,6 +25,7 @@
 #include <opendnp3/APL/Logger.h>
 
 #include "CTOHistory.h"
+#include "LastValueTable.h"
 #include "ObjectInterfaces.h"
 #include "ObjectReadIterator.h"
 #include "VtoReader.h"
@@ -49,12 +50,15 @@ public:
 	 * 						message reporting
 	 * @param apPublisher	the IDataObserver for any responses that match
 	 * @param apVtoReader	the VtoReader for any responses that match
+	 * @param apLastValues	optional cache used to suppress points that
+	 * 						have not changed since they were last published
 	 *
 	 * @return				a new ResponseLoader instance
 	 */
 	ResponseLoader(Logger* log,
 	               IDataObserver* apPublisher,
-	               VtoReader* apVtoReader);
+	               VtoReader* apVtoReader,
+	               LastValueTable* apLastValues = NULL);
 
 	/**
 	 * Processes a DNP3 object received by the Master.  The real heavy
@@ -111,6 +115,12 @@ private:
 	 */
 	void ReadVto(HeaderReadIterator& arIter, SizeByVariationObject* apObj);
 
+	/**
+	 * Publishes a point unless the last value table says it is unchanged
+	 */
+	template <class T>
+	void Publish(const T& arPoint, size_t aIndex);
+
 	IDataObserver* mpPublisher;
 
 	/**
@@ -119,6 +129,11 @@ private:
 	 */
 	VtoReader* mpVtoReader;
 
+	/**
+	 * Cache of previously published values, NULL if filtering is disabled
+	 */
+	LastValueTable* mpLastValues;
+
 	Transaction mTransaction;
 
 	CTOHistory mCTO;
@@ -167,7 +182,7 @@ void ResponseLoader::Read(HeaderReadIterator& arIter, StreamObject<T>* apObj)
 			value.SetQuality(T::ONLINE);
 		}
 
-		mpPublisher->Update(value, index);
+		this->Publish(value, index);
 	}
 }
 
@@ -184,7 +199,15 @@ void ResponseLoader::ReadBitfield(HeaderReadIterator& arIter)
 	for (; !obj.IsEnd(); ++obj) {
 		bool val = BitfieldObject::StaticRead(*obj, obj->Start(), obj->Index());
 		b.SetValue(val);
-		mpPublisher->Update(b, obj->Index());
+		this->Publish(b, obj->Index());
+	}
+}
+
+template <class T>
+void ResponseLoader::Publish(const T& arPoint, size_t aIndex)
+{
+	if(mpLastValues == NULL || mpLastValues->Update(arPoint, aIndex)) {
+		mpPublisher->Update(arPoint, aIndex);
 	}
 }
 
@@ -0,0 +1,119 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include "SharedDatabase.h"
+
+#include "DeviceTemplate.h"
+
+#include <opendnp3/APL/Logger.h>
+
+#include <boost/bind.hpp>
+
+namespace apl
+{
+namespace dnp
+{
+
+SharedDatabase::SharedDatabase(Logger* apLogger, ITimerSource* apTimerSrc, const DeviceTemplate& arDevice) :
+	Loggable(apLogger),
+	mDB(apLogger)
+{
+	mDB.Configure(arDevice);
+	mDB.SetEventBuffer(this);
+
+	if(apTimerSrc != NULL) {
+		mChangeBuffer.AddObserver(mNotifierSource.Get(boost::bind(&SharedDatabase::Flush, this), apTimerSrc));
+	}
+}
+
+void SharedDatabase::AddSession(IEventBuffer* apBuffer, const FunctionVoidZero& arOnUpdate)
+{
+	Session s = { apBuffer, arOnUpdate };
+	CriticalSection cs(&mLock);
+	mSessions.push_back(s);
+}
+
+void SharedDatabase::RemoveSession(IEventBuffer* apBuffer)
+{
+	CriticalSection cs(&mLock);
+	for(SessionVector::iterator i = mSessions.begin(); i != mSessions.end(); ++i) {
+		if(i->pBuffer == apBuffer) {
+			mSessions.erase(i);
+			return;
+		}
+	}
+}
+
+size_t SharedDatabase::NumSessions()
+{
+	CriticalSection cs(&mLock);
+	return mSessions.size();
+}
+
+size_t SharedDatabase::Flush()
+{
+	CriticalSection cs(&mLock);
+	size_t num = 0;
+
+	try {
+		num = mChangeBuffer.FlushUpdates(&mDB);
+	} catch (Exception& ex) {
+		LOG_BLOCK(LEV_ERROR, "Error in flush updates: " << ex.Message());
+		Transaction tr(mChangeBuffer);
+		mChangeBuffer.Clear();
+		return 0;
+	}
+
+	if(num > 0) {
+		for(SessionVector::iterator i = mSessions.begin(); i != mSessions.end(); ++i) if(i->onUpdate) i->onUpdate();
+	}
+
+	return num;
+}
+
+void SharedDatabase::Update(const Binary& arEvent, PointClass aClass, size_t aIndex)
+{
+	this->FanOut(arEvent, aClass, aIndex);
+}
+
+void SharedDatabase::Update(const Analog& arEvent, PointClass aClass, size_t aIndex)
+{
+	this->FanOut(arEvent, aClass, aIndex);
+}
+
+void SharedDatabase::Update(const Counter& arEvent, PointClass aClass, size_t aIndex)
+{
+	this->FanOut(arEvent, aClass, aIndex);
+}
+
+void SharedDatabase::Update(const VtoData& arEvent, PointClass aClass, size_t aIndex)
+{
+	this->FanOut(arEvent, aClass, aIndex);
+}
+
+size_t SharedDatabase::NumVtoEventsAvailable()
+{
+	// vto data is written to each session's buffer by the session itself, never through here
+	return 0;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
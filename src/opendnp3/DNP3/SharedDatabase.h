@@ -0,0 +1,136 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_DATABASE_H_
+#define __SHARED_DATABASE_H_
+
+#include <opendnp3/APL/ChangeBuffer.h>
+#include <opendnp3/APL/Function.h>
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/PostingNotifierSource.h>
+
+#include "Database.h"
+#include "DatabaseInterfaces.h"
+
+#include <vector>
+
+namespace apl
+{
+
+class ITimerSource;
+
+namespace dnp
+{
+
+struct DeviceTemplate;
+
+/**
+ * A point database shared by several slave sessions, e.g. one outstation
+ * serving a primary and a backup master. Measurements are written once to
+ * the shared ChangeBuffer and flushed once into the shared Database, so the
+ * cost of ingesting an update doesn't depend on the number of sessions.
+ *
+ * Each session keeps its own event buffer, which holds its select/confirm
+ * state, and its own unsolicited state. Events generated by the database are
+ * appended to every session's buffer, and after every flush each session is
+ * notified as if its own ChangeBuffer had been updated.
+ *
+ * Sessions may be added and removed from any thread. Flush() must run on the
+ * thread that executes the sessions.
+ */
+class SharedDatabase : public IEventBuffer, private Loggable
+{
+public:
+
+	/**
+		@param apLogger		Logger for the database
+		@param apTimerSrc	Flush() is posted to this whenever the change buffer is
+							updated. NULL if the owner calls Flush() itself.
+		@param arDevice		Layout of the database, the controls are ignored
+	*/
+	SharedDatabase(Logger* apLogger, ITimerSource* apTimerSrc, const DeviceTemplate& arDevice);
+
+	/// Thread-safe interface for writing measurements to every session
+	IDataObserver* GetDataObserver() {
+		return &mChangeBuffer;
+	}
+
+	/// The database the sessions read static data from
+	Database* GetDatabase() {
+		return &mDB;
+	}
+
+	/**
+		Adds a session.
+
+		@param apBuffer		Where the session's events are queued
+		@param arOnUpdate	Called after every flush, on the flushing thread. May be empty
+	*/
+	void AddSession(IEventBuffer* apBuffer, const FunctionVoidZero& arOnUpdate);
+
+	/// Removes the session whose events are queued in apBuffer
+	void RemoveSession(IEventBuffer* apBuffer);
+
+	size_t NumSessions();
+
+	/// Moves pending updates into the database and notifies the sessions, @return the number of updates
+	size_t Flush();
+
+	/* Implement IEventBuffer - fans the database's events out to the sessions */
+
+	void Update(const Binary& arEvent, PointClass aClass, size_t aIndex);
+	void Update(const Analog& arEvent, PointClass aClass, size_t aIndex);
+	void Update(const Counter& arEvent, PointClass aClass, size_t aIndex);
+	void Update(const VtoData& arEvent, PointClass aClass, size_t aIndex);
+	size_t NumVtoEventsAvailable();
+
+private:
+
+	template <class T>
+	void FanOut(const T& arEvent, PointClass aClass, size_t aIndex);
+
+	struct Session {
+		IEventBuffer* pBuffer;
+		FunctionVoidZero onUpdate;
+	};
+
+	typedef std::vector<Session> SessionVector;
+
+	ChangeBuffer<SigLock> mChangeBuffer;
+	PostingNotifierSource mNotifierSource;
+	Database mDB;
+
+	SigLock mLock;					// guards mSessions against sessions being added from other threads
+	SessionVector mSessions;
+};
+
+template <class T>
+void SharedDatabase::FanOut(const T& arEvent, PointClass aClass, size_t aIndex)
+{
+	for(SessionVector::iterator i = mSessions.begin(); i != mSessions.end(); ++i) {
+		i->pBuffer->Update(arEvent, aClass, aIndex);
+	}
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
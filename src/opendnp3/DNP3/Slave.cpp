@@ -22,6 +22,7 @@
 #include "Database.h"
 #include "DNPExceptions.h"
 #include "ObjectReadIterator.h"
+#include "SharedDatabase.h"
 
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/TimingTools.h>
@@ -35,11 +36,12 @@ namespace apl
 namespace dnp
 {
 
-Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc, ITimeManager* apTime, Database* apDatabase, IDNPCommandMaster* apCmdMaster, const SlaveConfig& arCfg) :
+Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc, ITimeManager* apTime, Database* apDatabase, IDNPCommandMaster* apCmdMaster, const SlaveConfig& arCfg, SharedDatabase* apShared) :
 	Loggable(apLogger),
 	mpAppLayer(apAppLayer),
 	mpTimerSrc(apTimerSrc),
 	mpDatabase(apDatabase),
+	mpShared(apShared),
 	mpCmdMaster(apCmdMaster),
 	mpState(AS_Closed::Inst()),
 	mConfig(arCfg),
@@ -47,7 +49,7 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc,
 	mpUnsolTimer(NULL),
 	mResponse(arCfg.mMaxFragSize),
 	mUnsol(arCfg.mMaxFragSize),
-	mRspContext(apLogger, apDatabase, &mRspTypes, arCfg.mEventMaxConfig),
+	mRspContext(apLogger, apDatabase, &mRspTypes, arCfg.mEventMaxConfig, arCfg.mMaxFragSize),
 	mHaveLastRequest(false),
 	mLastRequest(arCfg.mMaxFragSize),
 	mpTime(apTime),
@@ -61,10 +63,19 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc,
 	mState(SS_UNKNOWN),
 	mpTimeTimer(NULL),
 	mVtoReader(apLogger),
-	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), arCfg.mVtoWriterQueueSize)
+	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), arCfg.mVtoWriterQueueSize),
+	mTraceStart(0),
+	mTraceFlush(0),
+	mpTraceQueue(apLogger->GetHistogram("trace_slave_queue_us", "Microseconds from a data update until the slave flushed it")),
+	mpTraceUnsol(apLogger->GetHistogram("trace_slave_unsol_us", "Microseconds from the flush of an update until it was sent unsolicited")),
+	mpTraceTotal(apLogger->GetHistogram("trace_slave_total_us", "Microseconds from a data update until it was sent unsolicited"))
 {
-	/* Link the event buffer to the database */
-	mpDatabase->SetEventBuffer(mRspContext.GetBuffer());
+	/*
+	 * Link the event buffer to the database. A shared database copies its
+	 * events to every session and tells each of them when it has flushed.
+	 */
+	if(mpShared == NULL) mpDatabase->SetEventBuffer(mRspContext.GetBuffer());
+	else mpShared->AddSession(mRspContext.GetBuffer(), boost::bind(&Slave::OnDataUpdate, this));
 
 	mIIN.SetDeviceRestart(true);	/* Always set on restart */
 
@@ -103,6 +114,7 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc,
 
 Slave::~Slave()
 {
+	if(mpShared != NULL) mpShared->RemoveSession(mRspContext.GetBuffer());
 	if(mpUnsolTimer) mpUnsolTimer->Cancel();
 	if(mpTimeTimer) mpTimeTimer->Cancel();
 
@@ -119,6 +131,12 @@ void Slave::UpdateState(StackStates aState)
 	}
 }
 
+IDataObserver* Slave::GetDataObserver()
+{
+	if(mpShared != NULL) return mpShared->GetDataObserver();
+	return &mChangeBuffer;
+}
+
 /* Implement IAppUser - external callbacks from the app layer */
 
 void Slave::OnLowerLayerUp()
@@ -254,6 +272,12 @@ size_t Slave::FlushVtoUpdates()
 size_t Slave::FlushUpdates()
 {
 	size_t num = 0;
+	boost::int64_t traceStart = mChangeBuffer.GetTraceStart();
+	if(traceStart != 0 && mTraceStart == 0 && !mConfig.mDisableUnsol) {
+		mTraceStart = traceStart;
+		mTraceFlush = LatencyTrace::Now();
+	}
+
 	try {
 		num = mChangeBuffer.FlushUpdates(mpDatabase);
 	} catch (Exception& ex) {
@@ -264,6 +288,7 @@ size_t Slave::FlushUpdates()
 	}
 
 	num += this->FlushVtoUpdates();
+	mRspContext.UpdateEventDepth();
 
 	LOG_BLOCK(LEV_DEBUG, "Processed " << num << " updates");
 	return num;
@@ -297,6 +322,13 @@ void Slave::SendUnsolicited(APDU& arAPDU)
 {
 	mRspIIN.BitwiseOR(mIIN);
 	arAPDU.SetIIN(mRspIIN);
+	if(mTraceStart != 0) {
+		boost::int64_t now = LatencyTrace::Now();
+		mpTraceQueue->Observe(mTraceFlush - mTraceStart);
+		mpTraceUnsol->Observe(now - mTraceFlush);
+		mpTraceTotal->Observe(now - mTraceStart);
+		mTraceStart = 0;
+	}
 	mpAppLayer->SendUnsolicited(arAPDU);
 }
 
@@ -427,6 +459,50 @@ void Slave::HandleWrite(const APDU& arRequest)
 	}
 }
 
+void Slave::HandleFreeze(const APDU& arRequest, bool aClear)
+{
+	for (HeaderReadIterator hdr = arRequest.BeginRead(); !hdr.IsEnd(); ++hdr) {
+		switch (MACRO_DNP_RADIX(hdr->GetGroup(), hdr->GetVariation())) {
+		case (MACRO_DNP_RADIX(20, 0)):
+			this->HandleFreezeCounters(hdr, aClear);
+			break;
+		default:
+			mRspIIN.SetFuncNotSupported(true);
+			ERROR_BLOCK(LEV_WARNING, "Object/Function mismatch", SERR_OBJ_FUNC_MISMATCH);
+			break;
+		}
+	}
+}
+
+void Slave::HandleFreezeCounters(HeaderReadIterator& arHdr, bool aClear)
+{
+	size_t num = mpDatabase->NumType(DT_COUNTER);
+	millis_t now = mpTime->GetTime();
+
+	switch(arHdr->GetHeaderType()) {
+	case(OHT_ALL_OBJECTS):
+		mpDatabase->FreezeCounters(now, aClear);
+		break;
+	case(OHT_RANGED_2_OCTET):
+	case(OHT_RANGED_4_OCTET):
+	case(OHT_RANGED_8_OCTET): {
+			RangeInfo ri;
+			reinterpret_cast<const IRangeHeader*>(arHdr->GetHeader())->GetRange(*arHdr, ri);
+			if(ri.Start > ri.Stop || ri.Stop >= num) mRspIIN.SetParameterError(true);
+			else mpDatabase->FreezeCounters(ri.Start, ri.Stop, now, aClear);
+		}
+		break;
+	case(OHT_COUNT_1_OCTET):
+	case(OHT_COUNT_2_OCTET):
+	case(OHT_COUNT_4_OCTET): {
+			size_t count = reinterpret_cast<const ICountHeader*>(arHdr->GetHeader())->GetCount(*arHdr);
+			if(count == 0 || count > num) mRspIIN.SetParameterError(true);
+			else mpDatabase->FreezeCounters(0, count - 1, now, aClear);
+		}
+		break;
+	}
+}
+
 void Slave::HandleSelect(const APDU& arRequest, SequenceInfo aSeqInfo)
 {
 	mpCmdMaster->DeselectAll();
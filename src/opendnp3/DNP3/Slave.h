@@ -51,6 +51,7 @@ namespace dnp
 {
 
 class AS_Base;
+class SharedDatabase;
 
 /**
  * @section desc DNP3 outstation.
@@ -84,7 +85,12 @@ class Slave : public Loggable, public IAppUser
 
 public:
 
-	Slave(Logger*, IAppLayer*, ITimerSource*, ITimeManager* apTime, Database*, IDNPCommandMaster*, const SlaveConfig& arCfg);
+	/**
+	 * @param apShared		If not NULL, the slave is a session of this shared
+	 *						database. apDatabase must be its database and
+	 *						updates are written to it rather than the slave.
+	 */
+	Slave(Logger*, IAppLayer*, ITimerSource*, ITimeManager* apTime, Database* apDatabase, IDNPCommandMaster*, const SlaveConfig& arCfg, SharedDatabase* apShared = NULL);
 	~Slave();
 
 	////////////////////////
@@ -122,9 +128,7 @@ public:
 	 *
 	 * @return			a pointer to the buffer
 	 */
-	IDataObserver* GetDataObserver() {
-		return &mChangeBuffer;
-	}
+	IDataObserver* GetDataObserver();
 
 	/**
 	 * Returns a pointer to the VTO reader object.  This should only be
@@ -156,6 +160,7 @@ private:
 	IAppLayer* mpAppLayer;					// lower application layer
 	ITimerSource* mpTimerSrc;				// used for post and timers
 	Database* mpDatabase;					// holds static data
+	SharedDatabase* mpShared;				// the database is shared with other slaves if not NULL
 	IDNPCommandMaster* mpCmdMaster;			// how commands are selected/operated
 	int mSequence;							// control sequence
 	CommandResponseQueue mRspQueue;			// how command responses are received
@@ -210,6 +215,8 @@ private:
 	void HandleWriteIIN(HeaderReadIterator& arHdr);
 	void HandleWriteTimeDate(HeaderReadIterator& arHWI);
 	void HandleWriteVto(HeaderReadIterator& arHdr);
+	void HandleFreeze(const APDU& arRequest, bool aClear);
+	void HandleFreezeCounters(HeaderReadIterator& arHdr, bool aClear);
 	void HandleSelect(const APDU& arRequest, SequenceInfo aSeqInfo);
 	void HandleOperate(const APDU& arRequest, SequenceInfo aSeqInfo);
 	void HandleDirectOperate(const APDU& arRequest, SequenceInfo aSeqInfo);
@@ -246,6 +253,16 @@ private:
 	 */
 	VtoWriter mVtoWriter;
 
+	/*
+	 * Latency tracing of data updates from the ChangeBuffer to the
+	 * unsolicited response that carries them, see LatencyTrace.
+	 */
+	boost::int64_t mTraceStart;				// when the traced update entered the ChangeBuffer, 0 if none pending
+	boost::int64_t mTraceFlush;				// when the traced update was flushed to the database
+	MetricHistogram* mpTraceQueue;
+	MetricHistogram* mpTraceUnsol;
+	MetricHistogram* mpTraceTotal;
+
 	/**
 	 * A structure to provide the C++ equivalent of templated typedefs.
 	 */
@@ -53,10 +53,12 @@ SlaveConfig::SlaveConfig() :
 	mStaticBinary(GrpVar(1, 2)),
 	mStaticAnalog(GrpVar(30, 1)),
 	mStaticCounter(GrpVar(20, 1)),
+	mStaticFrozenCounter(GrpVar(21, 1)),
 	mStaticSetpointStatus(GrpVar(40, 1)),
 	mEventBinary(GrpVar(2, 1)),
 	mEventAnalog(GrpVar(32, 1)),
 	mEventCounter(GrpVar(22, 1)),
+	mEventFrozenCounter(GrpVar(23, 1)),
 	mEventVto(GrpVar(113, 0)),
 	mpObserver(NULL)
 {}
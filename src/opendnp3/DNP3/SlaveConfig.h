@@ -115,6 +115,9 @@ struct SlaveConfig {
 	// The default group/variation to use for static counter responses
 	GrpVar mStaticCounter;
 
+	// The default group/variation to use for static frozen counter responses
+	GrpVar mStaticFrozenCounter;
+
 	// The default group/variation to use for static setpoint status responses
 	GrpVar mStaticSetpointStatus;
 
@@ -130,6 +133,9 @@ struct SlaveConfig {
 	// The default group/variation to use for counter event responses
 	GrpVar mEventCounter;
 
+	// The default group/variation to use for frozen counter event responses
+	GrpVar mEventFrozenCounter;
+
 	// The default group/variation to use for VTO event responses
 	GrpVar mEventVto;
 
@@ -140,6 +140,11 @@ size_t SlaveEventBuffer::Select(BufferTypes aType, PointClass aClass, size_t aMa
 	}
 }
 
+size_t SlaveEventBuffer::SelectVto(PointClass aClass, size_t& arBytes, size_t aOverhead, size_t aMaxEvent)
+{
+	return mVtoEvents.SelectBySize(aClass, arBytes, aOverhead, aMaxEvent);
+}
+
 size_t SlaveEventBuffer::Select(PointClass aClass, size_t aMaxEvent)
 {
 	size_t left = aMaxEvent;
@@ -205,6 +205,20 @@ public:
 	 */
 	size_t Select(PointClass aClass, size_t aMaxEvent = std::numeric_limits<size_t>::max());
 
+	/**
+	 * Selects Virtual Terminal events that match the given PointClass
+	 * until their encoded size would exceed arBytes.
+	 *
+	 * @param aClass		the class of data to match
+	 * @param arBytes		bytes available for the selected events, reduced
+	 * 						by the size of the events selected
+	 * @param aOverhead		bytes each event costs in addition to its data
+	 * @param aMaxEvent		maximum number of events to select
+	 *
+	 * @return				the number of events selected
+	 */
+	size_t SelectVto(PointClass aClass, size_t& arBytes, size_t aOverhead, size_t aMaxEvent = std::numeric_limits<size_t>::max());
+
 	/**
 	 * Transfers any selected events back into the buffer.
 	 */
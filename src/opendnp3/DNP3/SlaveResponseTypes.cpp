@@ -33,12 +33,14 @@ SlaveResponseTypes::SlaveResponseTypes(const SlaveConfig& arCfg)
 	mpStaticBinary = GetStaticBinary(arCfg.mStaticBinary);
 	mpStaticAnalog = GetStaticAnalog(arCfg.mStaticAnalog);
 	mpStaticCounter = GetStaticCounter(arCfg.mStaticCounter);
+	mpStaticFrozenCounter = GetStaticFrozenCounter(arCfg.mStaticFrozenCounter);
 	mpStaticControlStatus = Group10Var2::Inst();
 	mpStaticSetpointStatus = GetStaticSetpointStatus(arCfg.mStaticSetpointStatus);
 
 	mpEventBinary = GetEventBinary(arCfg.mEventBinary);
 	mpEventAnalog = GetEventAnalog(arCfg.mEventAnalog);
 	mpEventCounter = GetEventCounter(arCfg.mEventCounter);
+	mpEventFrozenCounter = GetEventFrozenCounter(arCfg.mEventFrozenCounter);
 
 	/* This is the only valid Slave VTO response, therefore it doesn't need to be configurable */
 	mpEventVto = Group113Var0::Inst();
@@ -93,6 +95,24 @@ StreamObject<Counter>* SlaveResponseTypes::GetStaticCounter(GrpVar gv)
 	throw ArgumentException(LOCATION, "Invalid static counter");
 }
 
+StreamObject<Counter>* SlaveResponseTypes::GetStaticFrozenCounter(GrpVar gv)
+{
+	switch(gv.Grp) {
+	case(21):
+		switch(gv.Var) { //frozen delta counters are obsolete and have been omitted
+		case(1): return Group21Var1::Inst();
+		case(2): return Group21Var2::Inst();
+		case(5): return Group21Var5::Inst();
+		case(6): return Group21Var6::Inst();
+		case(9): return Group21Var9::Inst();
+		case(10): return Group21Var10::Inst();
+		}
+		break;
+	}
+
+	throw ArgumentException(LOCATION, "Invalid static frozen counter");
+}
+
 StreamObject<SetpointStatus>* SlaveResponseTypes::GetStaticSetpointStatus(GrpVar gv)
 {
 	switch(gv.Grp) {
@@ -160,6 +180,22 @@ StreamObject<Counter>* SlaveResponseTypes::GetEventCounter(GrpVar gv)
 	throw ArgumentException(LOCATION, "Invalid event counter");
 }
 
+StreamObject<Counter>* SlaveResponseTypes::GetEventFrozenCounter(GrpVar gv)
+{
+	switch(gv.Grp) {
+	case(23):
+		switch(gv.Var) {
+		case(1): return Group23Var1::Inst();
+		case(2): return Group23Var2::Inst();
+		case(5): return Group23Var5::Inst();
+		case(6): return Group23Var6::Inst();
+		}
+		break;
+	}
+
+	throw ArgumentException(LOCATION, "Invalid event frozen counter");
+}
+
 
 }
 }
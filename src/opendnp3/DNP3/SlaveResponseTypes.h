@@ -43,12 +43,14 @@ public:
 	StreamObject<Binary>* mpStaticBinary;
 	StreamObject<Analog>* mpStaticAnalog;
 	StreamObject<Counter>* mpStaticCounter;
+	StreamObject<Counter>* mpStaticFrozenCounter;
 	StreamObject<ControlStatus>* mpStaticControlStatus;
 	StreamObject<SetpointStatus>* mpStaticSetpointStatus;
 
 	StreamObject<Binary>* mpEventBinary;
 	StreamObject<Analog>* mpEventAnalog;
 	StreamObject<Counter>* mpEventCounter;
+	StreamObject<Counter>* mpEventFrozenCounter;
 
 	SizeByVariationObject* mpEventVto;
 
@@ -57,11 +59,13 @@ private:
 	static StreamObject<Binary>* GetStaticBinary(GrpVar);
 	static StreamObject<Analog>* GetStaticAnalog(GrpVar);
 	static StreamObject<Counter>* GetStaticCounter(GrpVar);
+	static StreamObject<Counter>* GetStaticFrozenCounter(GrpVar);
 	static StreamObject<SetpointStatus>* GetStaticSetpointStatus(GrpVar);
 
 	static StreamObject<Binary>* GetEventBinary(GrpVar);
 	static StreamObject<Analog>* GetEventAnalog(GrpVar);
 	static StreamObject<Counter>* GetEventCounter(GrpVar);
+	static StreamObject<Counter>* GetEventFrozenCounter(GrpVar);
 
 };
 
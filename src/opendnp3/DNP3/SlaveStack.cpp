@@ -18,19 +18,21 @@
 //
 #include "SlaveStack.h"
 
+#include "SharedDatabase.h"
+
 namespace apl
 {
 namespace dnp
 {
 
-SlaveStack::SlaveStack(Logger* apLogger, ITimerSource* apTimerSrc, ICommandAcceptor* apCmdAcceptor, const SlaveStackConfig& arCfg) :
-	Stack(apLogger->GetSubLogger("slave"), apTimerSrc, arCfg.app, arCfg.link),
+SlaveStack::SlaveStack(Logger* apLogger, ITimerSource* apTimerSrc, ICommandAcceptor* apCmdAcceptor, const SlaveStackConfig& arCfg, BufferPool* apPool, SharedDatabase* apShared) :
+	Stack(apLogger->GetSubLogger("slave"), apTimerSrc, arCfg.app, arCfg.link, apPool),
 	mDB(apLogger),
 	mCmdMaster(10000),
-	mSlave(apLogger, &mApplication, apTimerSrc, &mTimeSource, &mDB, &mCmdMaster, arCfg.slave)
+	mSlave(apLogger, &mApplication, apTimerSrc, &mTimeSource, apShared ? apShared->GetDatabase() : &mDB, &mCmdMaster, arCfg.slave, apShared)
 {
 	this->mApplication.SetUser(&mSlave);
-	mDB.Configure(arCfg.device);
+	if(apShared == NULL) mDB.Configure(arCfg.device);
 	mCmdMaster.Configure(arCfg.device, apCmdAcceptor);
 }
 
@@ -31,6 +31,8 @@ namespace apl
 namespace dnp
 {
 
+class SharedDatabase;
+
 /** @section desc A stack object for a master */
 class SlaveStack : public Stack
 {
@@ -41,19 +43,23 @@ public:
 		@param apTimerSrc		Timer source used by the slave for asynchronous eventing
 		@param apCmdAcceptor	Command acceptor interface used for dispatching commands to the outside world
 		@param arCfg			Configuration struct that holds parameters for the stack
+		@param apPool			Pool the application layer borrows fragment buffers from if arCfg.app.Lightweight is set
+		@param apShared			Database to serve instead of one configured from arCfg.device, which then only configures the controls
 	*/
 	SlaveStack(
 	        Logger* apLogger,
 	        ITimerSource* apTimerSrc,
 	        ICommandAcceptor* apCmdAcceptor,
-	        const SlaveStackConfig& arCfg);
+	        const SlaveStackConfig& arCfg,
+	        BufferPool* apPool = NULL,
+	        SharedDatabase* apShared = NULL);
 
 	IVtoWriter* GetVtoWriter();
 
 	IVtoReader* GetVtoReader();
 
 	TimeSourceSystemOffset mTimeSource;
-	Database mDB;				// The database holds static event data and forwards to an event buffer
+	Database mDB;				// The database holds static event data and forwards to an event buffer, unused if shared
 	DNPCommandMaster mCmdMaster;	// Controls the execution of commands
 	Slave mSlave;				// The dnp3 outstation class
 };
@@ -99,6 +99,16 @@ void AS_Base::SwitchOnFunction(Slave* c, AS_Base* apNext, const APDU& arRequest,
 		if(aSeqInfo != SI_PREV) c->HandleWrite(arRequest);
 		c->ConfigureAndSendSimpleResponse();
 		break;
+	case (FC_FREEZE):
+	case (FC_FREEZE_CLEAR):
+		ChangeState(c, apNext);
+		if(aSeqInfo != SI_PREV) c->HandleFreeze(arRequest, arRequest.GetFunction() == FC_FREEZE_CLEAR);
+		c->ConfigureAndSendSimpleResponse();
+		break;
+	case (FC_FREEZE_NO_ACK):
+	case (FC_FREEZE_CLEAR_NO_ACK):
+		c->HandleFreeze(arRequest, arRequest.GetFunction() == FC_FREEZE_CLEAR_NO_ACK);
+		break;
 	case (FC_PROPRIETARY_VTO_TRANSFER):
 		ChangeState(c, apNext);
 		if(aSeqInfo != SI_PREV) c->HandleVtoTransfer(arRequest);
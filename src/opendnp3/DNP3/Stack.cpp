@@ -25,10 +25,11 @@ namespace apl
 namespace dnp
 {
 
-Stack::Stack(Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aAppCfg, LinkConfig aCfg) :
+Stack::Stack(Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aAppCfg, LinkConfig aCfg, BufferPool* apPool) :
 	mLink(apLogger->GetSubLogger("link"), apTimerSrc, aCfg),
-	mTransport(apLogger->GetSubLogger("transport")),
-	mApplication(apLogger->GetSubLogger("app"), apTimerSrc, aAppCfg)
+	mTransport(apLogger->GetSubLogger("transport"), aAppCfg.FragSize, apPool),
+	mApplication(apLogger->GetSubLogger("app"), apTimerSrc, aAppCfg, apPool),
+	mProfile(apLogger)
 {
 	mLink.SetUpperLayer(&mTransport);
 	mTransport.SetUpperLayer(&mApplication);
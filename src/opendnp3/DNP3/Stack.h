@@ -25,6 +25,8 @@
 #include "VtoDataInterface.h"
 #include "VtoReader.h"
 
+#include <opendnp3/APL/HandlerProfiler.h>
+
 namespace apl
 {
 
@@ -37,7 +39,11 @@ namespace dnp
 class Stack
 {
 public:
-	Stack(Logger*, ITimerSource* apTimerSrc, AppConfig aAppCfg, LinkConfig aCfg);
+	/**
+	 * @param apPool	If not NULL, the transport and application layers borrow
+	 *					their fragment buffers from the pool instead of owning them
+	 */
+	Stack(Logger*, ITimerSource* apTimerSrc, AppConfig aAppCfg, LinkConfig aCfg, BufferPool* apPool = NULL);
 	virtual ~Stack() {}
 
 	/**
@@ -57,6 +63,9 @@ public:
 	LinkLayer mLink;
 	TransportLayer mTransport;
 	AppLayer mApplication;
+
+	/// What the handlers run for this stack are charged to, see HandlerProfiler
+	HandlerProfile mProfile;
 };
 
 }
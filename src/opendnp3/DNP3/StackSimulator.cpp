@@ -0,0 +1,322 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "StackSimulator.h"
+
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/TimingTools.h>
+
+#include "LinkLayerRouter.h"
+#include "LinkRoute.h"
+#include "MasterStack.h"
+#include "SlaveStack.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace boost::posix_time;
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+RejectingCommandAcceptor gAcceptor;
+
+Logger* StackLogger(Logger* apLogger, const char* apPrefix, size_t aIndex)
+{
+	std::ostringstream oss;
+	oss << apPrefix << aIndex;
+	Logger* pLogger = apLogger->GetSubLogger(oss.str());
+	pLogger->SetVarName(oss.str());
+	return pLogger;
+}
+
+}
+
+/**
+	One master and one outstation on a line of their own. The pair is the
+	master's publisher, which is how it sees the changes arrive.
+*/
+class SimulatedPair : public IDataObserver
+{
+public:
+	SimulatedPair(StackSimulator* apSim, size_t aIndex, Logger* apMasterLogger, Logger* apSlaveLogger);
+
+	void Start();
+	void Shutdown();
+
+	bool IsShutdown() {
+		return mMasterRouter.GetState() == PLS_SHUTDOWN && mSlaveRouter.GetState() == PLS_SHUTDOWN;
+	}
+
+	/// @return changes that haven't reached the master
+	size_t NumPending() const {
+		return mPending.size();
+	}
+
+	PhysicalLayerAsyncSimulated mMasterLine;
+	PhysicalLayerAsyncSimulated mSlaveLine;
+	LinkLayerRouter mMasterRouter;
+	LinkLayerRouter mSlaveRouter;
+	MasterStack mMaster;
+	SlaveStack mSlave;
+
+private:
+
+	void ScheduleUpdate();
+	void OnUpdate();
+
+	// Implement IDataObserver
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {}
+	void _Update(const Analog& arPoint, size_t);
+	void _Update(const Counter&, size_t) {}
+	void _Update(const ControlStatus&, size_t) {}
+	void _Update(const SetpointStatus&, size_t) {}
+
+	StackSimulator* mpSim;
+	IDataObserver* mpSlaveData;
+	boost::int64_t mSequence;
+
+	typedef std::map<boost::int64_t, ptime> PendingMap;
+	PendingMap mPending;	// changes made by the outstation by sequence number, until the master sees them
+};
+
+SimulatedPair::SimulatedPair(StackSimulator* apSim, size_t aIndex, Logger* apMasterLogger, Logger* apSlaveLogger) :
+	mMasterLine(apMasterLogger->GetSubLogger("line"), &apSim->mTimers, apSim->mConfig.line, apSim->mConfig.Seed + 2 * aIndex),
+	mSlaveLine(apSlaveLogger->GetSubLogger("line"), &apSim->mTimers, apSim->mConfig.line, apSim->mConfig.Seed + 2 * aIndex + 1),
+	mMasterRouter(apMasterLogger->GetSubLogger("router"), &mMasterLine, &apSim->mTimers, apSim->mConfig.OpenRetry),
+	mSlaveRouter(apSlaveLogger->GetSubLogger("router"), &mSlaveLine, &apSim->mTimers, apSim->mConfig.OpenRetry),
+	mMaster(apMasterLogger, &apSim->mTimers, this, apSim->mScheduler.CreateNewGroup(), apSim->mConfig.master,
+	        apSim->mConfig.master.app.Lightweight ? &apSim->mBufferPool : NULL, &apSim->mTimers),
+	mSlave(apSlaveLogger, &apSim->mTimers, &gAcceptor, apSim->mConfig.slave, apSim->mConfig.slave.app.Lightweight ? &apSim->mBufferPool : NULL),
+	mpSim(apSim),
+	mpSlaveData(mSlave.mSlave.GetDataObserver()),
+	mSequence(0)
+{
+	PhysicalLayerAsyncSimulated::Connect(&mMasterLine, &mSlaveLine);
+
+	const LinkConfig& master = apSim->mConfig.master.link;
+	mMaster.mLink.SetRouter(&mMasterRouter);
+	mMasterRouter.AddContext(&mMaster.mLink, LinkRoute(master.RemoteAddr, master.LocalAddr));
+
+	const LinkConfig& slave = apSim->mConfig.slave.link;
+	mSlave.mLink.SetRouter(&mSlaveRouter);
+	mSlaveRouter.AddContext(&mSlave.mLink, LinkRoute(slave.RemoteAddr, slave.LocalAddr));
+}
+
+void SimulatedPair::Start()
+{
+	mSlaveRouter.Start();
+	mMasterRouter.Start();
+	this->ScheduleUpdate();
+}
+
+void SimulatedPair::Shutdown()
+{
+	mMasterRouter.Shutdown();
+	mSlaveRouter.Shutdown();
+}
+
+void SimulatedPair::ScheduleUpdate()
+{
+	if(mpSim->mConfig.UpdatePeriod <= 0) return;
+
+	// exponential intervals, so changes across the outstations arrive as a poisson process
+	double delay = -std::log(1.0 - mpSim->mRandom.Next()) * mpSim->mConfig.UpdatePeriod;
+	mpSim->mTimers.Start(static_cast<millis_t>(delay), boost::bind(&SimulatedPair::OnUpdate, this));
+}
+
+void SimulatedPair::OnUpdate()
+{
+	size_t num = mpSim->mConfig.slave.device.mAnalog.size();
+	boost::int64_t sequence = ++mSequence;
+	mPending[sequence] = mpSim->mTimers.GetUTC();
+	++mpSim->mNumUpdates;
+
+	{
+		Transaction tr(mpSlaveData);
+		mpSlaveData->Update(Analog(static_cast<double>(sequence), AQ_ONLINE), static_cast<size_t>(sequence % num));
+	}
+
+	this->ScheduleUpdate();
+}
+
+void SimulatedPair::_Update(const Analog& arPoint, size_t)
+{
+	// integrity polls and events both carry a change, whichever arrives first counts
+	PendingMap::iterator i = mPending.find(static_cast<boost::int64_t>(arPoint.GetValue()));
+	if(i == mPending.end()) return;
+
+	mpSim->mpLatency->Observe((mpSim->mTimers.GetUTC() - i->second).total_milliseconds());
+	mPending.erase(i);
+}
+
+StackSimulator::StackSimulator(Logger* apLogger, const SimulatorConfig& arCfg) :
+	mpLogger(apLogger),
+	mConfig(arCfg),
+	mTimers(),
+	mScheduler(&mTimers, &mTimers),
+	mRandom(arCfg.Seed),
+	mpLatency(apLogger->GetHistogram("sim_latency_ms", "Virtual milliseconds from an outstation change until its master published it")),
+	mNumUpdates(0),
+	mWallTime(0)
+{
+	if(mConfig.slave.device.mAnalog.empty()) throw ArgumentException(LOCATION, "The simulated outstations need at least one analog");
+
+	mPairs.reserve(mConfig.NumPairs);
+	for(size_t i = 0; i < mConfig.NumPairs; ++i) {
+		mPairs.push_back(new SimulatedPair(this, i, StackLogger(apLogger, "master", i), StackLogger(apLogger, "slave", i)));
+	}
+
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		pPair->Start();
+	}
+}
+
+StackSimulator::~StackSimulator()
+{
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		pPair->Shutdown();
+	}
+
+	// the masters keep scheduling polls, so run only until the lines have closed
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		while(!mPairs[i]->IsShutdown() && mTimers.RunOne());
+	}
+
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		delete pPair;
+	}
+}
+
+void StackSimulator::Run(millis_t aDuration)
+{
+	StopWatch sw;
+	mTimers.RunFor(aDuration);
+	mWallTime += sw.Elapsed();
+}
+
+ICommandAcceptor* StackSimulator::GetCommandAcceptor(size_t aIndex)
+{
+	return mPairs.at(aIndex)->mMaster.mMaster.GetCmdAcceptor();
+}
+
+size_t StackSimulator::NumLost() const
+{
+	size_t num = 0;
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		num += pPair->mMasterLine.NumLost() + pPair->mSlaveLine.NumLost();
+	}
+	return num;
+}
+
+size_t StackSimulator::MaxLineBuffer() const
+{
+	size_t max = 0;
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		max = std::max(max, std::max(pPair->mMasterLine.MaxBuffered(), pPair->mSlaveLine.MaxBuffered()));
+	}
+	return max;
+}
+
+boost::int64_t StackSimulator::Sum(const std::string& arName, boost::int64_t* apMax) const
+{
+	std::vector<MetricSample> samples;
+	mpLogger->GetMetrics()->Snapshot(samples);
+
+	boost::int64_t sum = 0;
+	if(apMax != NULL) *apMax = 0;
+	BOOST_FOREACH(const MetricSample & s, samples) {
+		if(s.name != arName) continue;
+		sum += s.value;
+		if(apMax != NULL && s.value > *apMax) *apMax = s.value;
+	}
+	return sum;
+}
+
+void StackSimulator::Report(std::ostream& arStream) const
+{
+	double seconds = mTimers.Elapsed() / 1000.0;
+	double wall = mWallTime / 1000.0;
+
+	MetricSample latency;
+	mpLatency->Read(latency);
+
+	size_t pending = 0;
+	BOOST_FOREACH(SimulatedPair * pPair, mPairs) {
+		pending += pPair->NumPending();
+	}
+
+	boost::int64_t peak = 0;
+	boost::int64_t peakSum = this->Sum("event_buffer_peak", &peak);
+	boost::int64_t frames = this->Sum("link_rx_frames");
+	boost::int64_t bytes = this->Sum("link_rx_bytes");
+
+	arStream << std::fixed << std::setprecision(1);
+	arStream << "pairs:                 " << mPairs.size() << std::endl;
+	arStream << "virtual s:             " << seconds << std::endl;
+	arStream << "wall s:                " << wall << std::endl;
+	arStream << "speedup:               " << (wall > 0 ? seconds / wall : 0) << std::endl;
+	arStream << "events run:            " << mTimers.NumRun() << std::endl;
+	arStream << "events/s (wall):       " << (wall > 0 ? mTimers.NumRun() / wall : 0) << std::endl;
+	arStream << "changes:               " << mNumUpdates << std::endl;
+	arStream << "changes delivered:     " << latency.value << std::endl;
+	arStream << "changes in flight:     " << pending << std::endl;
+	arStream << "delivered/s:           " << (seconds > 0 ? latency.value / seconds : 0) << std::endl;
+	arStream << "latency mean ms:       " << (latency.value > 0 ? latency.sum / latency.value : 0) << std::endl;
+	arStream << "latency p50 ms <=      " << MetricHistogram::Percentile(latency, 50) << std::endl;
+	arStream << "latency p90 ms <=      " << MetricHistogram::Percentile(latency, 90) << std::endl;
+	arStream << "latency p99 ms <=      " << MetricHistogram::Percentile(latency, 99) << std::endl;
+	arStream << "link frames/s:         " << (seconds > 0 ? frames / seconds : 0) << std::endl;
+	arStream << "link bytes/s:          " << (seconds > 0 ? bytes / seconds : 0) << std::endl;
+	arStream << "frames lost:           " << this->NumLost() << std::endl;
+	arStream << "link retries:          " << this->Sum("link_retries") << std::endl;
+	arStream << "app retries:           " << this->Sum("app_retries") << std::endl;
+	arStream << "event buffer peak:     " << peak << std::endl;
+	arStream << "event buffer peak avg: " << (mPairs.empty() ? 0 : static_cast<double>(peakSum) / mPairs.size()) << std::endl;
+	arStream << "line buffer peak:      " << this->MaxLineBuffer() << std::endl;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,143 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __STACK_SIMULATOR_H_
+#define __STACK_SIMULATOR_H_
+
+#include <opendnp3/APL/AsyncTaskScheduler.h>
+#include <opendnp3/APL/BufferPool.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSimulated.h>
+#include <opendnp3/APL/Uncopyable.h>
+#include <opendnp3/APL/VirtualTimerSource.h>
+
+#include "MasterStackConfig.h"
+#include "SlaveStackConfig.h"
+
+#include <ostream>
+#include <vector>
+
+namespace apl
+{
+
+class Logger;
+class ICommandAcceptor;
+
+namespace dnp
+{
+
+class SimulatedPair;
+
+/**
+	Settings for a StackSimulator
+*/
+struct SimulatorConfig {
+	SimulatorConfig() :
+		NumPairs(1),
+		UpdatePeriod(10000),
+		OpenRetry(5000),
+		Seed(0)
+	{
+		slave.device = DeviceTemplate(0, 10);
+	}
+
+	size_t NumPairs;			// master/outstation pairs, each on a line of its own
+	MasterStackConfig master;	// used for every master
+	SlaveStackConfig slave;		// used for every outstation, the device needs at least one analog
+	LineModel line;				// applied in both directions
+	millis_t UpdatePeriod;		// mean ms between analog changes on each outstation, 0 for none
+	millis_t OpenRetry;			// ms the routers wait before reopening a line
+	boost::uint32_t Seed;		// runs with the same seed and config are identical
+};
+
+/**
+	Runs complete master/outstation pairs in virtual time, for checking how
+	thousands of outstations behave over simulated hours or days.
+
+	Each pair is wired like AsyncStackManager would wire it, a LinkLayerRouter
+	per end over a PhysicalLayerAsyncSimulated line, but everything runs on
+	the calling thread from one VirtualTimerSource. Every outstation changes a
+	random analog at exponentially distributed intervals, and the value is a
+	sequence number that lets the master side measure how long each change
+	took to arrive.
+
+	The stacks' own metrics (link_rx_frames, app_retries, event_buffer_peak...)
+	are registered per pair in the logger's registry, under "masterN" and
+	"slaveN", the simulator adds sim_latency_ms under its own var name.
+*/
+class StackSimulator : private Uncopyable
+{
+public:
+	StackSimulator(Logger* apLogger, const SimulatorConfig& arCfg);
+	~StackSimulator();
+
+	/// Runs aDuration ms of virtual time as fast as the callbacks allow
+	void Run(millis_t aDuration);
+
+	VirtualTimerSource* GetTimerSource() {
+		return &mTimers;
+	}
+
+	/// @return where commands for the outstation of pair aIndex are queued
+	ICommandAcceptor* GetCommandAcceptor(size_t aIndex);
+
+	/// @return analog changes made by the outstations
+	boost::int64_t NumUpdates() const {
+		return mNumUpdates;
+	}
+
+	/// @return changes that have reached their master
+	boost::int64_t NumDelivered() const {
+		return mpLatency->GetCount();
+	}
+
+	/// @return writes dropped by the line model
+	size_t NumLost() const;
+
+	/// @return the most bytes any line end had received but not read
+	size_t MaxLineBuffer() const;
+
+	/// Writes throughput, latency and buffer figures for everything run so far
+	void Report(std::ostream& arStream) const;
+
+private:
+
+	/// @return the sum of a per-pair counter, and the largest single value in aMax
+	boost::int64_t Sum(const std::string& arName, boost::int64_t* apMax = NULL) const;
+
+	Logger* mpLogger;
+	SimulatorConfig mConfig;
+
+	VirtualTimerSource mTimers;		// declared first so it outlives every stack
+	AsyncTaskScheduler mScheduler;
+	BufferPool mBufferPool;
+	RandomDouble mRandom;
+
+	MetricHistogram* mpLatency;
+	boost::int64_t mNumUpdates;
+	millis_t mWallTime;
+
+	std::vector<SimulatedPair*> mPairs;
+
+	friend class SimulatedPair;
+};
+
+}
+}
+
+#endif
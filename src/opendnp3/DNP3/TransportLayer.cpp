@@ -37,14 +37,14 @@ namespace apl
 namespace dnp
 {
 
-TransportLayer::TransportLayer(apl::Logger* apLogger, size_t aFragSize) :
+TransportLayer::TransportLayer(apl::Logger* apLogger, size_t aFragSize, BufferPool* apPool) :
 	Loggable(apLogger),
 	IUpperLayer(apLogger),
 	ILowerLayer(apLogger),
 	mpState(TLS_Closed::Inst()),
 	M_FRAG_SIZE(aFragSize),
-	mReceiver(apLogger, this, aFragSize),
-	mTransmitter(apLogger, this, aFragSize),
+	mReceiver(apLogger, this, aFragSize, apPool),
+	mTransmitter(apLogger, this, aFragSize, apPool),
 	mThisLayerUp(false)
 {
 
@@ -63,6 +63,7 @@ void TransportLayer::ThisLayerUp()
 void TransportLayer::ThisLayerDown()
 {
 	mReceiver.Reset();
+	mTransmitter.Reset();
 	mThisLayerUp = false;
 	if(mpUpperLayer != NULL) mpUpperLayer->OnLowerLayerDown();
 }
@@ -105,6 +106,7 @@ void TransportLayer::SignalSendSuccess()
 
 void TransportLayer::SignalSendFailure()
 {
+	mTransmitter.Reset();
 	if(mpUpperLayer != NULL) mpUpperLayer->OnSendFailure();
 }
 
@@ -42,7 +42,11 @@ class TransportLayer : public IUpperLayer, public ILowerLayer
 {
 public:
 
-	TransportLayer(apl::Logger* apLogger, size_t aFragSize = DEFAULT_FRAG_SIZE);
+	/**
+		@param apPool If not NULL, the receive and transmit buffers are borrowed from
+		the pool while a fragment is in flight instead of being held by the layer
+	*/
+	TransportLayer(apl::Logger* apLogger, size_t aFragSize = DEFAULT_FRAG_SIZE, BufferPool* apPool = NULL);
 	virtual ~TransportLayer() {}
 
 	/* Actions - Taken by the states/transmitter/receiver in response to events */
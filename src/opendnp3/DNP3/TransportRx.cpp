@@ -22,6 +22,7 @@
 #include "TransportConstants.h"
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LatencyTrace.h>
 
 #include <sstream>
 #include <memory.h>
@@ -33,20 +34,28 @@ namespace apl
 namespace dnp
 {
 
-TransportRx::TransportRx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize) :
+TransportRx::TransportRx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize, BufferPool* apPool) :
 	Loggable(apLogger),
 	mpContext(apContext),
-	mBuffer(aFragSize),
+	mpPool(apPool),
+	M_FRAG_SIZE(aFragSize),
+	mBuffer(apPool == NULL ? aFragSize : 0),
 	mNumBytesRead(0),
 	mSeq(0)
 {
 
 }
 
+TransportRx::~TransportRx()
+{
+	if(mpPool != NULL) mpPool->Release(mBuffer);
+}
+
 void TransportRx::Reset()
 {
 	mNumBytesRead = 0;
 	mSeq = 0;
+	if(mpPool != NULL) mpPool->Release(mBuffer);
 }
 
 void TransportRx::HandleReceive(const boost::uint8_t* apData, size_t aNumBytes)
@@ -77,6 +86,7 @@ void TransportRx::HandleReceive(const boost::uint8_t* apData, size_t aNumBytes)
 			ERROR_BLOCK(LEV_WARNING, "Exceeded the buffer size before a complete fragment was read", TLERR_BUFFER_FULL);
 			mNumBytesRead = 0;
 		} else { //passed all validation
+			if(mpPool != NULL) mpPool->Acquire(mBuffer, M_FRAG_SIZE);
 			memcpy(mBuffer + mNumBytesRead, apData + 1, payload_len);
 			mNumBytesRead += payload_len;
 			mSeq = (mSeq + 1) % 64;
@@ -84,10 +94,14 @@ void TransportRx::HandleReceive(const boost::uint8_t* apData, size_t aNumBytes)
 			if(last) {
 				size_t tmp = mNumBytesRead;
 				mNumBytesRead = 0;
+				LatencyTrace::Mark(TS_TRANSPORT);
 				mpContext->ReceiveAPDU(mBuffer, tmp);
 			}
 		}
 	}
+
+	// a receiver that isn't in the middle of a fragment doesn't hold a borrowed buffer
+	if(mNumBytesRead == 0 && mpPool != NULL) mpPool->Release(mBuffer);
 }
 
 bool TransportRx::ValidateHeader(bool aFir, bool aFin, int aSeq, size_t aPayloadSize)
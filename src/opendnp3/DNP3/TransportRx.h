@@ -23,6 +23,7 @@
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/APL/Loggable.h>
 #include <opendnp3/APL/CopyableBuffer.h>
+#include <opendnp3/APL/BufferPool.h>
 
 #include "TransportConstants.h"
 
@@ -39,7 +40,12 @@ State/validation for the DNP3 transport layer's receive channel.
 class TransportRx : public Loggable
 {
 public:
-	TransportRx(Logger*, TransportLayer*, size_t aFragSize);
+	/**
+		@param apPool If not NULL, the reassembly buffer is borrowed from the pool
+		only while a fragment is being received
+	*/
+	TransportRx(Logger*, TransportLayer*, size_t aFragSize, BufferPool* apPool = NULL);
+	~TransportRx();
 
 	void HandleReceive(const boost::uint8_t*, size_t);
 
@@ -50,7 +56,9 @@ private:
 	bool ValidateHeader(bool aFir, bool aFin, int aSeq, size_t aPayloadSize);
 
 	TransportLayer* mpContext;
+	BufferPool* mpPool;
 
+	const size_t M_FRAG_SIZE;
 	CopyableBuffer mBuffer;
 	size_t mNumBytesRead;
 	int mSeq;
@@ -58,7 +66,7 @@ private:
 
 
 	size_t BufferRemaining() {
-		return mBuffer.Size() - mNumBytesRead;
+		return M_FRAG_SIZE - mNumBytesRead;
 	}
 };
 
@@ -34,20 +34,32 @@ namespace apl
 namespace dnp
 {
 
-TransportTx::TransportTx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize) :
+TransportTx::TransportTx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize, BufferPool* apPool) :
 	Loggable(apLogger),
 	mpContext(apContext),
-	mBufferAPDU(aFragSize),
-	mBufferTPDU(TL_MAX_TPDU_LENGTH),
+	mpPool(apPool),
+	M_FRAG_SIZE(aFragSize),
+	mBufferAPDU(apPool == NULL ? aFragSize : 0),
+	mBufferTPDU(apPool == NULL ? TL_MAX_TPDU_LENGTH : 0),
 	mNumBytesSent(0),
 	mNumBytesToSend(0),
 	mSeq(0)
 {}
 
+TransportTx::~TransportTx()
+{
+	this->ReleaseBuffers();
+}
+
 void TransportTx::Send(const boost::uint8_t* apData, size_t aNumBytes)
 {
 	assert(aNumBytes > 0);
-	assert(aNumBytes <= mBufferAPDU.Size());
+	assert(aNumBytes <= M_FRAG_SIZE);
+
+	if(mpPool != NULL) {
+		mpPool->Acquire(mBufferAPDU, M_FRAG_SIZE);
+		mpPool->Acquire(mBufferTPDU, TL_MAX_TPDU_LENGTH);
+	}
 
 	memcpy(mBufferAPDU, apData, aNumBytes);
 	mNumBytesToSend = aNumBytes;
@@ -73,11 +85,25 @@ bool TransportTx::CheckForSend()
 		mpContext->TransmitTPDU(mBufferTPDU, num_to_send + 1);
 		return false;
 	} else {
-		mNumBytesSent = mNumBytesToSend = 0;
+		this->Reset();
 		return true;
 	}
 }
 
+void TransportTx::Reset()
+{
+	mNumBytesSent = mNumBytesToSend = 0;
+	this->ReleaseBuffers();
+}
+
+void TransportTx::ReleaseBuffers()
+{
+	if(mpPool != NULL) {
+		mpPool->Release(mBufferAPDU);
+		mpPool->Release(mBufferTPDU);
+	}
+}
+
 bool TransportTx::SendSuccess()
 {
 	mSeq = (mSeq + 1) % 64;
@@ -23,6 +23,7 @@
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/APL/Loggable.h>
 #include <opendnp3/APL/CopyableBuffer.h>
+#include <opendnp3/APL/BufferPool.h>
 
 #include "TransportConstants.h"
 
@@ -39,12 +40,20 @@ State/validation for the DNP3 transport layer's send channel.
 class TransportTx : public Loggable
 {
 public:
-	TransportTx(Logger*, TransportLayer*, size_t aFragSize);
+	/**
+		@param apPool If not NULL, the APDU and TPDU buffers are borrowed from the pool
+		only while a fragment is being sent
+	*/
+	TransportTx(Logger*, TransportLayer*, size_t aFragSize, BufferPool* apPool = NULL);
+	~TransportTx();
 
 
 	void Send(const boost::uint8_t*, size_t); // A fresh call to Send() will reset the state
 	bool SendSuccess();
 
+	/// Abandons any send in progress
+	void Reset();
+
 
 	static boost::uint8_t GetHeader(bool aFir, bool aFin, int aSeq);
 
@@ -52,8 +61,12 @@ private:
 
 	bool CheckForSend();
 
+	void ReleaseBuffers();
+
 	TransportLayer* mpContext;
+	BufferPool* mpPool;
 
+	const size_t M_FRAG_SIZE;
 	CopyableBuffer mBufferAPDU;
 	CopyableBuffer mBufferTPDU;
 
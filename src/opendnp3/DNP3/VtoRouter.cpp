@@ -55,7 +55,7 @@ void VtoRouter::OnVtoDataReceived(const VtoData& arData)
 		 * Each physical layer action is processed serially, so we can take
 		 * advantage of the FIFO structure to keep things simple.
 		 */
-		this->mPhysLayerTxBuffer.push(arData);
+		this->mPhysLayerTxBuffer.Push(arData);
 		this->CheckForPhysWrite();
 	}
 }
@@ -64,9 +64,17 @@ void VtoRouter::_OnReceive(const boost::uint8_t* apData, size_t aLength)
 {
 	LOG_BLOCK(LEV_COMM, "GotLocalData: " << aLength);
 
-	// turn the incoming data into a VtoMessage object and enque it
-	VtoMessage msg(VTODT_DATA, apData, aLength);
-	this->mVtoTxBuffer.push_back(msg);
+	// enque the data, handing the read buffer to the message rather than copying it
+	VtoMessage& msg = this->mVtoTxBuffer.Push();
+	msg.type = VTODT_DATA;
+	msg.length = aLength;
+	msg.offset = 0;
+	if(apData == mReadBuffer.Buffer()) {
+		msg.data.Swap(mReadBuffer);
+		if(mReadBuffer.Size() < msg.data.Size()) mReadBuffer = CopyableBuffer(msg.data.Size());
+	} else {
+		msg.data = CopyableBuffer(apData, aLength);
+	}
 
 	this->CheckForVtoWrite();
 	this->CheckForPhysRead();
@@ -74,23 +82,27 @@ void VtoRouter::_OnReceive(const boost::uint8_t* apData, size_t aLength)
 
 void VtoRouter::CheckForVtoWrite()
 {
-	if(!mVtoTxBuffer.empty()) {
-		VtoMessage msg = mVtoTxBuffer.front();
-		mVtoTxBuffer.pop_front();
+	if(!mVtoTxBuffer.Empty()) {
+		// The writer only posts its notifications, so it can't re-enter here and the
+		// message can be consumed in place at the front of the queue
+		VtoMessage& msg = mVtoTxBuffer.Front();
 
 		// type DATA means this is a buffer and we need to pull the data out and send it to the vto writer
 		if(msg.type == VTODT_DATA) {
-			size_t numWritten = mpVtoWriter->Write(msg.data.Buffer(), msg.data.Size(), this->GetChannelId());
-			LOG_BLOCK(LEV_INTERPRET, "VtoWriter: " << numWritten << " of " << msg.data.Size());
-			if(numWritten < msg.data.Size()) {
-				size_t remainder = msg.data.Size() - numWritten;
-				VtoMessage partial(VTODT_DATA, msg.data.Buffer() + numWritten, remainder);
-				mVtoTxBuffer.push_front(partial);
-			} else this->CheckForVtoWrite();
+			size_t remainder = msg.length - msg.offset;
+			size_t numWritten = mpVtoWriter->Write(msg.data.Buffer() + msg.offset, remainder, this->GetChannelId());
+			LOG_BLOCK(LEV_INTERPRET, "VtoWriter: " << numWritten << " of " << remainder);
+			if(numWritten < remainder) msg.offset += numWritten;	// wait for OnBufferAvailable() to write the rest
+			else {
+				mVtoTxBuffer.Pop();
+				this->CheckForVtoWrite();
+			}
 		} else {
 			// if we have generated REMOTE_OPENED or REMOTE_CLOSED message we need to send the SetLocalVtoState
 			// update to the vtowriter so it can be serialized in the correct order.
-			mpVtoWriter->SetLocalVtoState(msg.type == VTODT_REMOTE_OPENED, this->GetChannelId());
+			bool opened = (msg.type == VTODT_REMOTE_OPENED);
+			mVtoTxBuffer.Pop();
+			mpVtoWriter->SetLocalVtoState(opened, this->GetChannelId());
 			this->CheckForVtoWrite();
 		}
 	}
@@ -111,25 +123,25 @@ void VtoRouter::_OnSendFailure()
 
 void VtoRouter::CheckForPhysRead()
 {
-	if(mpPhys->CanRead() && mVtoTxBuffer.size() < 10) {	//TODO - Make this configurable or track the size in bytes
+	if(mpPhys->CanRead() && mVtoTxBuffer.Size() < 10) {	//TODO - Make this configurable or track the size in bytes
 		mpPhys->AsyncRead(mReadBuffer, mReadBuffer.Size());
 	}
 }
 
 void VtoRouter::CheckForPhysWrite()
 {
-	if(!mPhysLayerTxBuffer.empty()) {
-		VtoDataType type = mPhysLayerTxBuffer.front().GetType();
+	if(!mPhysLayerTxBuffer.Empty()) {
+		VtoDataType type = mPhysLayerTxBuffer.Front().GetType();
 		if(type == VTODT_DATA) {
 			// only write to the physical layer if we have a valid local connection
 			if(mpPhys->CanWrite()) {
-				mWriteData = mPhysLayerTxBuffer.front();
-				mPhysLayerTxBuffer.pop();
+				mWriteData = mPhysLayerTxBuffer.Front();
+				mPhysLayerTxBuffer.Pop();
 				mpPhys->AsyncWrite(mWriteData.mpData, mWriteData.GetSize());
 				LOG_BLOCK(LEV_COMM, "Wrote: " << mWriteData.GetSize());
 			}
 		} else {
-			this->mPhysLayerTxBuffer.pop();
+			this->mPhysLayerTxBuffer.Pop();
 			this->DoVtoRemoteConnectedChanged(type == VTODT_REMOTE_OPENED);
 		}
 	}
@@ -137,7 +149,10 @@ void VtoRouter::CheckForPhysWrite()
 
 void VtoRouter::NotifyRemoteSideOfState(bool aConnected)
 {
-	mVtoTxBuffer.push_back(VtoMessage(aConnected ? VTODT_REMOTE_OPENED : VTODT_REMOTE_CLOSED));
+	VtoMessage& msg = mVtoTxBuffer.Push();	// keeps the slot's buffer for the next DATA message
+	msg.type = aConnected ? VTODT_REMOTE_OPENED : VTODT_REMOTE_CLOSED;
+	msg.length = 0;
+	msg.offset = 0;
 	this->CheckForVtoWrite();
 }
 
@@ -145,9 +160,9 @@ void VtoRouter::FlushBuffers()
 {
 	// clear out all of the data when we close the local connection
 
-	while(mPhysLayerTxBuffer.size() > 0) {
-		LOG_BLOCK(LEV_WARNING, "Tossing data: " << this->mPhysLayerTxBuffer.front().GetType() << " size: " << this->mPhysLayerTxBuffer.front().GetSize());
-		this->mPhysLayerTxBuffer.pop();
+	while(mPhysLayerTxBuffer.Size() > 0) {
+		LOG_BLOCK(LEV_WARNING, "Tossing data: " << this->mPhysLayerTxBuffer.Front().GetType() << " size: " << this->mPhysLayerTxBuffer.Front().GetSize());
+		this->mPhysLayerTxBuffer.Pop();
 	}
 
 }
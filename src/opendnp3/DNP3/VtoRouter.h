@@ -18,12 +18,10 @@
 #ifndef __VTO_ROUTER_H_
 #define __VTO_ROUTER_H_
 
-#include <queue>
-#include <deque>
-
 #include <opendnp3/APL/IHandlerAsync.h>
 #include <opendnp3/APL/PhysicalLayerMonitor.h>
 #include <opendnp3/APL/CopyableBuffer.h>
+#include <opendnp3/APL/RingQueue.h>
 
 #include "VtoDataInterface.h"
 
@@ -43,20 +41,28 @@ struct VtoRouterSettings;
 /**
  * helper object that allows us to serialize data and up/down communication events into
  * the same data stream
+ *
+ * The messages live in a RingQueue and keep their buffer when they're popped, so a
+ * DATA message holds the first 'length' bytes of 'data', of which the first 'offset'
+ * have already been handed to the VtoWriter.
  */
 class VtoMessage
 {
 public:
 
-	VtoMessage(VtoDataType aType) :
-		type(aType), data() {}
+	VtoMessage() :
+		type(VTODT_DATA), data(), length(0), offset(0) {}
 
+	VtoMessage(VtoDataType aType) :
+		type(aType), data(), length(0), offset(0) {}
 
 	VtoMessage(VtoDataType aType, const boost::uint8_t* apBuffer, size_t aBufferSize) :
-		type(aType), data(apBuffer, aBufferSize) {}
+		type(aType), data(apBuffer, aBufferSize), length(aBufferSize), offset(0) {}
 
 	VtoDataType    type;
 	CopyableBuffer data;
+	size_t         length;
+	size_t         offset;
 };
 
 
@@ -177,16 +183,18 @@ private:
 	 * The transmit buffer for Vto -> physical layer.  The data that
 	 * is put into this buffer was originally received via VTO.
 	 */
-	std::queue<VtoData> mPhysLayerTxBuffer;
+	RingQueue<VtoData> mPhysLayerTxBuffer;
 
 	/**
 	 * The transmit message buffer for vto actions (OPEN/CLOSE/DATA) from physical layer -> Vto.
 	 * The data that is put into this buffer was originally received from the physical layer.
 	 */
-	std::deque<VtoMessage> mVtoTxBuffer;
+	RingQueue<VtoMessage> mVtoTxBuffer;
 
 	/**
-	 * Buffer used to read from the physical layer
+	 * Buffer used to read from the physical layer. It's swapped into the
+	 * message it was read for, so the buffers circulate between here and
+	 * mVtoTxBuffer instead of being copied.
 	 */
 	CopyableBuffer mReadBuffer;
 
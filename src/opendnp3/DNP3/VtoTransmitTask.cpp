@@ -36,9 +36,9 @@ void VtoTransmitTask::ConfigureRequest(APDU& arAPDU)
 	 */
 	arAPDU.Set(mUseNonStandardCode ? FC_PROPRIETARY_VTO_TRANSFER : FC_WRITE);
 
-	const size_t MAX_VTO_EVENTS = 7;
-	/* Get all of the data objects in the buffer. */
-	size_t numObjects = this->mBuffer.Select(PC_ALL_EVENTS, MAX_VTO_EVENTS);
+	/* Select as many data objects as will fill the fragment. */
+	size_t space = mFragSize - RequestHeader::Inst()->GetSize();
+	size_t numObjects = this->mBuffer.SelectBySize(PC_ALL_EVENTS, space, VTO_OBJECT_OVERHEAD);
 
 	LOG_BLOCK(LEV_INTERPRET, "VtoTransmitTask Sending: " << numObjects << " of " << this->mBuffer.Size());
 
@@ -52,6 +52,7 @@ public:
 	VtoTransmitTask(Logger* log, size_t fragSize, bool aUseNonStandardCode) :
 		MasterTaskBase(log),
 		mBuffer(fragSize * 10),
+		mFragSize(fragSize),
 		mUseNonStandardCode(aUseNonStandardCode)
 	{}
 
@@ -100,6 +101,12 @@ public:
 
 protected:
 
+	/**
+	 * Size of the request fragments, each write is filled with as many
+	 * objects as fit.
+	 */
+	size_t mFragSize;
+
 	/** FC_WRITE can't be retried so, another code is needed to
 	* make a reliable stream in the MASTER -> SLAVE direction
 	*/
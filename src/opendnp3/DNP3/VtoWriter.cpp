@@ -33,8 +33,8 @@ VtoWriter::VtoWriter(Logger* apLogger, size_t aMaxVtoChunks) :
 
 VtoWriter::~VtoWriter()
 {
-	if(mQueue.size() > 0) {
-		LOG_BLOCK(LEV_WARNING, "On destruction, writer had " << mQueue.size() << " chunks that went unread");
+	if(mQueue.Size() > 0) {
+		LOG_BLOCK(LEV_WARNING, "On destruction, writer had " << mQueue.Size() << " chunks that went unread");
 	}
 }
 
@@ -70,12 +70,11 @@ size_t VtoWriter::Write(const boost::uint8_t* apData,
 void VtoWriter::SetLocalVtoState(bool aLocalVtoConnectionOpened, boost::uint8_t aChannelId)
 {
 
-	VtoData vto = EnhancedVto::CreateVtoData(aLocalVtoConnectionOpened, aChannelId);
-	VtoEvent evt(vto, PC_CLASS_1, 255);
+	VtoEvent evt(EnhancedVto::CreateVtoData(aLocalVtoConnectionOpened, aChannelId), PC_CLASS_1, 255);
 
 	/* Thread safe for rest of function */
 	CriticalSection cs(&mLock);
-	this->mQueue.push_back(evt);
+	this->mQueue.Push(evt);
 	this->NotifyAll();
 }
 
@@ -108,13 +107,15 @@ void VtoWriter::QueueVtoObject(const boost::uint8_t* apData,
                                boost::uint8_t aChannelId)
 {
 	/*
-	 * Create a new VtoData instance, set the event data associated
-	 * with it, and then push the object onto the transmission queue.
+	 * Fill the next slot of the transmission queue directly rather than
+	 * copying a temporary VtoEvent into it.
 	 */
-	VtoData vto(apData, aLength);
-
-	VtoEvent evt(vto, PC_CLASS_1, aChannelId);
-	this->mQueue.push_back(evt);
+	VtoEvent& evt = this->mQueue.Push();
+	evt.mValue.Copy(apData, aLength);
+	evt.mClass = PC_CLASS_1;
+	evt.mIndex = aChannelId;
+	evt.mSequence = 0;
+	evt.mWritten = false;
 }
 
 size_t VtoWriter::Flush(IVtoEventAcceptor* apAcceptor, size_t aMaxEvents)
@@ -123,10 +124,10 @@ size_t VtoWriter::Flush(IVtoEventAcceptor* apAcceptor, size_t aMaxEvents)
 
 	{
 		CriticalSection cs(&mLock);
-		while(numUpdates < aMaxEvents && mQueue.size() > 0) {
-			VtoEvent& evt = mQueue.front();
+		while(numUpdates < aMaxEvents && mQueue.Size() > 0) {
+			VtoEvent& evt = mQueue.Front();
 			apAcceptor->Update(evt.mValue, evt.mClass, evt.mIndex);
-			mQueue.pop_front();
+			mQueue.Pop();
 			++numUpdates;
 		}
 	}
@@ -170,12 +171,12 @@ size_t VtoWriter::Size()
 	 */
 	CriticalSection cs(&mLock);
 
-	return mQueue.size();
+	return mQueue.Size();
 }
 
 size_t VtoWriter::NumChunksAvailable()
 {
-	return mMaxVtoChunks - mQueue.size();
+	return mMaxVtoChunks - mQueue.Size();
 }
 
 size_t VtoWriter::NumBytesAvailable()
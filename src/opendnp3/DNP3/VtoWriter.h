@@ -18,13 +18,13 @@
 #ifndef __VTO_WRITER_H_
 #define __VTO_WRITER_H_
 
-#include <deque>
 #include <set>
 
 #include <opendnp3/APL/Lock.h>
 #include <opendnp3/APL/DataInterfaces.h>
 #include <opendnp3/APL/SubjectBase.h>
 #include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/RingQueue.h>
 
 #include "EventTypes.h"
 #include "VtoDataInterface.h"
@@ -112,7 +112,7 @@ public:
 
 protected:
 
-	std::deque<VtoEvent> mQueue;
+	RingQueue<VtoEvent> mQueue;
 
 private:
 
@@ -50,10 +50,13 @@ IntegrationTest::IntegrationTest(Logger* apLogger, FilterLevel aLevel, boost::ui
 {
 	this->InitLocalObserver();
 
+	// the masters compare against mLocalFDO as updates arrive, so it must be
+	// flushed before any of the slaves are
+	mFanout.AddObserver(&mLocalFDO);
+
 	for (size_t i = 0; i < aNumPairs; ++i) {
 		AddStackPair(aLevel, aNumPoints);
 	}
-	mFanout.AddObserver(&mLocalFDO);
 }
 
 void IntegrationTest::InitLocalObserver()
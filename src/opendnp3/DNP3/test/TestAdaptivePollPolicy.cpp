@@ -0,0 +1,186 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/Metrics.h>
+
+#include <opendnp3/DNP3/AdaptivePollPolicy.h>
+#include <opendnp3/DNP3/MasterConfig.h>
+
+#include "MasterTestObject.h"
+
+using namespace std;
+using namespace apl;
+using namespace apl::dnp;
+using namespace boost::posix_time;
+
+namespace
+{
+
+MasterConfig AdaptiveConfig()
+{
+	MasterConfig cfg;
+	cfg.AdaptivePolling = true;
+	cfg.IntegrityRate = 1000;
+	cfg.MaxIntegrityRate = 5000;
+	cfg.MinScanRate = 1000;
+	cfg.UnsolHealthyWindow = 10000;
+	cfg.AddExceptionScan(PC_CLASS_1, 60000);
+	return cfg;
+}
+
+ptime Origin()
+{
+	return ptime(boost::gregorian::date(2011, 1, 1));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(AdaptivePollPolicySuite)
+
+BOOST_AUTO_TEST_CASE(StartsAtConfiguredRates)
+{
+	EventLog log;
+	AdaptivePollPolicy policy(log.GetLogger(LEV_WARNING, "master"), AdaptiveConfig());
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 60000);
+}
+
+BOOST_AUTO_TEST_CASE(StretchesIntegrityWhileUnsolIsHealthy)
+{
+	EventLog log;
+	AdaptivePollPolicy policy(log.GetLogger(LEV_WARNING, "master"), AdaptiveConfig());
+	MetricCounter* pSaved = log.GetMetrics()->GetCounter("master", "poll_bytes_saved");
+
+	policy.OnUnsol(Origin());
+	policy.OnIntegrityPoll(Origin() + seconds(1), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 2000);
+	BOOST_REQUIRE_EQUAL(pSaved->Get(), 0);
+
+	policy.OnIntegrityPoll(Origin() + seconds(3), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 4000);
+	BOOST_REQUIRE_EQUAL(pSaved->Get(), 100); // one poll stood in for two
+
+	policy.OnIntegrityPoll(Origin() + seconds(7), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 5000); // capped
+	BOOST_REQUIRE_EQUAL(pSaved->Get(), 400);
+}
+
+BOOST_AUTO_TEST_CASE(SilenceRestoresIntegrityRate)
+{
+	EventLog log;
+	AdaptivePollPolicy policy(log.GetLogger(LEV_WARNING, "master"), AdaptiveConfig());
+
+	// no unsolicited response has ever arrived
+	policy.OnIntegrityPoll(Origin(), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+
+	policy.OnUnsol(Origin());
+	policy.OnIntegrityPoll(Origin() + seconds(1), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 2000);
+
+	policy.OnIntegrityPoll(Origin() + seconds(11), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(EventScansThatFindEventsTighten)
+{
+	EventLog log;
+	AdaptivePollPolicy policy(log.GetLogger(LEV_WARNING, "master"), AdaptiveConfig());
+
+	policy.OnEventScan(true);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 30000);
+	policy.OnEventScan(true);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 15000);
+
+	policy.OnEventScan(false);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 30000);
+	policy.OnEventScan(false);
+	policy.OnEventScan(false);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 60000);
+
+	for(size_t i = 0; i < 20; ++i) policy.OnEventScan(true);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 1000); // bounded
+}
+
+BOOST_AUTO_TEST_CASE(OverflowTightensEverything)
+{
+	EventLog log;
+	AdaptivePollPolicy policy(log.GetLogger(LEV_WARNING, "master"), AdaptiveConfig());
+
+	policy.OnUnsol(Origin());
+	policy.OnIntegrityPoll(Origin() + seconds(1), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 2000);
+
+	policy.OnEventBufferOverflow();
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 1000);
+
+	// the poll that follows the overflow doesn't count as healthy
+	policy.OnUnsol(Origin() + seconds(2));
+	policy.OnIntegrityPoll(Origin() + seconds(2), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+	policy.OnIntegrityPoll(Origin() + seconds(3), 100);
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 2000);
+
+	policy.Reset();
+	BOOST_REQUIRE_EQUAL(policy.GetIntegrityRate(), 1000);
+	BOOST_REQUIRE_EQUAL(policy.GetScanRate(0), 60000);
+}
+
+BOOST_AUTO_TEST_CASE(MasterStretchesIntegrityPoll)
+{
+	MasterConfig cfg = AdaptiveConfig();
+	cfg.mScans.clear();
+	MasterTestObject t(cfg);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00");
+	t.SendUnsolToMaster("F0 82 00 00");
+
+	t.fake_time.Advance(1000);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00");
+
+	// the next poll is now 2 seconds out
+	t.fake_time.Advance(1000);
+	t.mts.DispatchOne();
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+	t.fake_time.Advance(1000);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00");
+
+	// a lost link starts over at the configured rate
+	t.master.OnLowerLayerDown();
+	t.master.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00");
+	t.fake_time.Advance(1000);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -191,4 +191,53 @@ BOOST_AUTO_TEST_CASE(CounterLastReportedChange)
 	TestBufferForEvent(true, Counter(0), t, t.buffer.mCounterEvents);
 }
 
+// points that aren't updated between freezes are resolved from the generations, never copied
+BOOST_AUTO_TEST_CASE(FrozenCountersSpanSeveralClears)
+{
+	DatabaseTestObject t;
+	t.db.Configure(DT_COUNTER, 2, true);
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(10, CQ_ONLINE), 0);
+		t.db.Update(Counter(20, CQ_ONLINE), 1);
+	}
+
+	t.db.FreezeCounters(100, true);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetValue(), 10);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetTime(), 100);
+	BOOST_REQUIRE_EQUAL(t.db.GetCounter(0).GetValue(), 0);
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(3, CQ_ONLINE), 1);
+	}
+
+	// the second clear freezes the value left by the first
+	t.db.FreezeCounters(200, true);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetValue(), 0);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(1).GetValue(), 3);
+	BOOST_REQUIRE_EQUAL(t.db.GetCounter(1).GetValue(), 0);
+
+	t.db.FreezeCounters(300, false);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetValue(), 0);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(1).GetValue(), 0);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(1).GetTime(), 300);
+
+	// updating a point settles it, its frozen value is unchanged
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(4, CQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetValue(), 0);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetTime(), 300);
+	BOOST_REQUIRE_EQUAL(t.db.GetCounter(0).GetValue(), 4);
+
+	t.db.FreezeCounters(0, 0, 400, true);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetValue(), 4);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(0).GetTime(), 400);
+	BOOST_REQUIRE_EQUAL(t.db.GetCounter(0).GetValue(), 0);
+	BOOST_REQUIRE_EQUAL(t.db.GetFrozenCounter(1).GetTime(), 300);
+	BOOST_REQUIRE_THROW(t.db.FreezeCounters(0, 2, 500, false), IndexOutOfBoundsException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
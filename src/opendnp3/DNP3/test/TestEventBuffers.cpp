@@ -143,6 +143,33 @@ BOOST_AUTO_TEST_CASE(ResetEventsProperlyOnFailure)
 	}
 	b.Deselect();
 }
+
+BOOST_AUTO_TEST_CASE(SelectBySizeFillsBudget)
+{
+	InsertionOrderedEventBuffer<VtoEvent> b(100);
+
+	boost::uint8_t data[100] = { 0 };
+	for (size_t i = 0; i < 10; ++i) b.Update(VtoData(data, 100), PC_CLASS_1, 0);
+
+	// 3 events and their overhead fit, the 4th would go 5 bytes over
+	size_t space = 3 * 105 + 100;
+	BOOST_REQUIRE_EQUAL(b.SelectBySize(PC_CLASS_1, space, 5), 3);
+	BOOST_REQUIRE_EQUAL(space, 100);
+	BOOST_REQUIRE_EQUAL(b.NumSelected(), 3);
+
+	// the count limit still applies
+	space = 10000;
+	BOOST_REQUIRE_EQUAL(b.SelectBySize(PC_CLASS_1, space, 5, 2), 2);
+	BOOST_REQUIRE_EQUAL(space, 10000 - 2 * 105);
+
+	// a budget smaller than one event still selects one
+	space = 10;
+	BOOST_REQUIRE_EQUAL(b.SelectBySize(PC_CLASS_1, space, 5), 1);
+	BOOST_REQUIRE_EQUAL(space, 0);
+
+	BOOST_REQUIRE_EQUAL(b.Deselect(), 6);
+	BOOST_REQUIRE_EQUAL(b.NumUnselected(), 10);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(TimeOrderedEventBufferSuite)
@@ -0,0 +1,217 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <opendnp3/APL/test/util/TestHelpers.h>
+
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/FlexibleDataObserver.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/LastValueTable.h>
+#include <opendnp3/DNP3/Objects.h>
+#include <opendnp3/DNP3/ResponseLoader.h>
+
+#include "MasterTestObject.h"
+
+using namespace apl;
+using namespace apl::dnp;
+using namespace boost;
+
+namespace
+{
+
+// Writes a static response with aNum g30v1 analogs, every aModulus'th point is set to aChange
+void WriteAnalogs(APDU& arAPDU, size_t aNum, size_t aModulus, int aChange)
+{
+	arAPDU.Set(FC_RESPONSE);
+	IINField iin;
+	arAPDU.SetIIN(iin);
+
+	Group30Var1* pObj = Group30Var1::Inst();
+	ObjectWriteIterator i = arAPDU.WriteContiguous(pObj, 0, aNum - 1);
+	for(size_t index = 0; index < aNum; ++index) {
+		int value = ((index % aModulus) == 0) ? aChange : static_cast<int>(index);
+		pObj->Write(*i, Analog(value, AQ_ONLINE));
+		++i;
+	}
+}
+
+size_t Load(APDU& arAPDU, Logger* apLogger, FlexibleDataObserver* apObs, VtoReader* apVto, LastValueTable* apTable)
+{
+	apObs->Clear();
+	arAPDU.Interpret();
+	ResponseLoader loader(apLogger, apObs, apVto, apTable);
+	for(HeaderReadIterator hdr = arAPDU.BeginRead(); !hdr.IsEnd(); ++hdr) {
+		loader.Process(hdr);
+	}
+	return apObs->GetTotalCount();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(LastValueTableSuite)
+
+BOOST_AUTO_TEST_CASE(FirstUpdateIsAlwaysAChange)
+{
+	LastValueTable t;
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), 0));
+	BOOST_REQUIRE(t.Update(Analog(0, AQ_ONLINE), 0));
+	BOOST_REQUIRE(t.Update(Counter(0, CQ_ONLINE), 7));
+	BOOST_REQUIRE(t.Update(ControlStatus(false, TQ_ONLINE), 3));
+	BOOST_REQUIRE(t.Update(SetpointStatus(0, PQ_ONLINE), 1));
+}
+
+BOOST_AUTO_TEST_CASE(DetectsValueQualityAndTimeChanges)
+{
+	LastValueTable t;
+	Analog a(5, AQ_ONLINE);
+	BOOST_REQUIRE(t.Update(a, 2));
+	BOOST_REQUIRE_FALSE(t.Update(a, 2));
+
+	a.SetValue(6);
+	BOOST_REQUIRE(t.Update(a, 2));
+
+	a.SetQuality(AQ_COMM_LOST);
+	BOOST_REQUIRE(t.Update(a, 2));
+
+	a.SetTime(TimeStamp_t(100));
+	BOOST_REQUIRE(t.Update(a, 2));
+	BOOST_REQUIRE_FALSE(t.Update(a, 2));
+}
+
+BOOST_AUTO_TEST_CASE(BinaryValueIsPartOfQuality)
+{
+	LastValueTable t;
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), 4));
+	BOOST_REQUIRE_FALSE(t.Update(Binary(true, BQ_ONLINE), 4));
+	BOOST_REQUIRE(t.Update(Binary(false, BQ_ONLINE), 4));
+}
+
+BOOST_AUTO_TEST_CASE(TypesAndIndicesAreIndependent)
+{
+	LastValueTable t;
+	BOOST_REQUIRE(t.Update(Counter(1, CQ_ONLINE), 0));
+	BOOST_REQUIRE(t.Update(Counter(1, CQ_ONLINE), 1));
+	BOOST_REQUIRE(t.Update(Analog(1, AQ_ONLINE), 0));
+	BOOST_REQUIRE_FALSE(t.Update(Counter(1, CQ_ONLINE), 0));
+}
+
+BOOST_AUTO_TEST_CASE(ClearForgetsValues)
+{
+	LastValueTable t;
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), 0));
+	t.Clear();
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), 0));
+}
+
+BOOST_AUTO_TEST_CASE(IndicesAboveMaximumAreNotCached)
+{
+	LastValueTable t;
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), LastValueTable::MAX_INDEX + 1));
+	BOOST_REQUIRE(t.Update(Binary(true, BQ_ONLINE), LastValueTable::MAX_INDEX + 1));
+	BOOST_REQUIRE_EQUAL(t.NumBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LoaderOnlyPublishesChanges)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_INFO, "rsp");
+	FlexibleDataObserver fdo;
+	VtoReader vto(pLogger);
+	LastValueTable table;
+	APDU apdu;
+
+	WriteAnalogs(apdu, 10, 5, 100);
+	BOOST_REQUIRE_EQUAL(Load(apdu, pLogger, &fdo, &vto, &table), 10);
+	BOOST_REQUIRE_EQUAL(Load(apdu, pLogger, &fdo, &vto, &table), 0);
+
+	WriteAnalogs(apdu, 10, 5, 200); // indices 0 and 5 change
+	BOOST_REQUIRE_EQUAL(Load(apdu, pLogger, &fdo, &vto, &table), 2);
+	BOOST_REQUIRE(fdo.Check(200, AQ_ONLINE, 0));
+	BOOST_REQUIRE(fdo.Check(200, AQ_ONLINE, 5));
+}
+
+BOOST_AUTO_TEST_CASE(MasterFiltersUnchangedPoints)
+{
+	MasterConfig cfg;
+	cfg.FilterUnchangedPoints = true;
+	cfg.IntegrityRate = 1000;
+	MasterTestObject t(cfg);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 03 81 81"); //group 1 var 2, index 2-3, Online, true
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 2);
+
+	t.fdo.Clear();
+	t.fake_time.Advance(1000);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 03 81 01"); //index 3 goes false
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	BOOST_REQUIRE(t.fdo.Check(false, BQ_ONLINE, 3, TimeStamp_t(0)));
+
+	// a new session republishes everything
+	t.fdo.Clear();
+	t.master.OnLowerLayerDown();
+	t.master.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 03 81 01");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 2);
+}
+
+/*
+ * Publish rate of a 400 point analog integrity poll into a FlexibleDataObserver
+ * with and without the table, at change ratios typical of a quiet system.
+ */
+BOOST_AUTO_TEST_CASE(PublishRate)
+{
+	const size_t NUM_POINTS = 400;
+	const size_t NUM_POLLS = 250;
+	const size_t MODULI[] = { 100, 10, 1 };
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "rsp");
+	FlexibleDataObserver fdo;
+	VtoReader vto(pLogger);
+	APDU apdu;
+
+	for(size_t m = 0; m < sizeof(MODULI) / sizeof(MODULI[0]); ++m) {
+		for(int filtered = 0; filtered < 2; ++filtered) {
+			LastValueTable table;
+			LastValueTable* pTable = filtered ? &table : NULL;
+			size_t published = 0;
+			StopWatch sw;
+			for(size_t poll = 0; poll < NUM_POLLS; ++poll) {
+				WriteAnalogs(apdu, NUM_POINTS, MODULI[m], static_cast<int>(poll));
+				published += Load(apdu, pLogger, &fdo, &vto, pTable);
+			}
+			millis_t elapsed = sw.Elapsed();
+			BOOST_REQUIRE(published <= NUM_POINTS * NUM_POLLS);
+			double rate = (NUM_POINTS * NUM_POLLS * 1000.0) / (elapsed > 0 ? elapsed : 1);
+			BOOST_TEST_MESSAGE("change ratio 1/" << MODULI[m] << (filtered ? " filtered" : " unfiltered") <<
+			                   ": " << published << " published, " << rate << " points/sec, " <<
+			                   table.NumBytes() << " bytes cached");
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
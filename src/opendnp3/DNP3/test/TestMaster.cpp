@@ -577,6 +577,58 @@ BOOST_AUTO_TEST_CASE(SolicitedMultiFragResponse)
 	BOOST_REQUIRE(t.fdo.Check(false, BQ_RESTART, 3, TimeStamp_t(0)));
 }
 
+BOOST_AUTO_TEST_CASE(ControlPreemptsMultiFragPoll)
+{
+	MasterConfig master_cfg;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+
+	BinaryOutput bo(CC_PULSE); bo.mStatus = CS_SUCCESS;
+	CommandResponseQueue rsp;
+	t.master.GetCmdAcceptor()->AcceptCommand(bo, 1, 7, &rsp);
+
+	// the command is queued when the first fragment arrives, so the rest of the poll is canceled
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 02 81", false);
+	BOOST_REQUIRE_EQUAL(t.app.mNumCancel, 1);
+	t.master.OnSolFailure();
+
+	std::string crob = "0C 01 17 01 01 01 01 64 00 00 00 64 00 00 00 00";
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 03 " + crob); // SELECT
+	t.RespondToMaster("C0 81 00 00 " + crob);
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 04 " + crob); // OPERATE
+	t.RespondToMaster("C0 81 00 00 " + crob);
+
+	CommandResponse cr;
+	BOOST_REQUIRE(rsp.WaitForResponse(cr, 7, 0));
+	BOOST_REQUIRE_EQUAL(cr.mResult, CS_SUCCESS);
+
+	// then the poll starts over
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+}
+
+BOOST_AUTO_TEST_CASE(ControlWaitsForPollWithoutPreemption)
+{
+	MasterConfig master_cfg;
+	master_cfg.PreemptPolls = false;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+
+	BinaryOutput bo(CC_PULSE); bo.mStatus = CS_SUCCESS;
+	CommandResponseQueue rsp;
+	t.master.GetCmdAcceptor()->AcceptCommand(bo, 1, 7, &rsp);
+
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 02 81", false);
+	BOOST_REQUIRE_EQUAL(t.app.mNumCancel, 0);
+	t.RespondToMaster("C0 81 00 00 01 02 00 03 03 02");
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 03 0C 01 17 01 01 01 01 64 00 00 00 64 00 00 00 00"); // SELECT
+}
+
 BOOST_AUTO_TEST_CASE(EventPoll)
 {
 	MasterConfig master_cfg;
@@ -0,0 +1,169 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/ToHex.h>
+#include <opendnp3/APL/test/util/BufferHelpers.h>
+#include <opendnp3/APL/test/util/MockTimerSource.h>
+
+#include <opendnp3/DNP3/DeviceTemplate.h>
+#include <opendnp3/DNP3/DNPCommandMaster.h>
+#include <opendnp3/DNP3/SharedDatabase.h>
+#include <opendnp3/DNP3/Slave.h>
+#include <opendnp3/DNP3/SlaveEventBuffer.h>
+
+#include "MockAppLayer.h"
+
+using namespace apl;
+using namespace apl::dnp;
+
+namespace
+{
+
+void Increment(size_t* apCount)
+{
+	++(*apCount);
+}
+
+// One outstation session of a shared database, wired like SlaveTestObject
+class Session
+{
+public:
+	Session(EventLog& arLog, MockTimerSource* apTimerSrc, SharedDatabase* apShared, const std::string& arName) :
+		app(arLog.GetLogger(LEV_INFO, arName + ".app")),
+		cmdMaster(10000),
+		slave(arLog.GetLogger(LEV_INFO, arName), &app, apTimerSrc, &time, apShared->GetDatabase(), &cmdMaster, Config(), apShared)
+	{
+		app.SetUser(&slave);
+		slave.OnLowerLayerUp();
+	}
+
+	std::string Request(const std::string& arData) {
+		HexSequence hs(arData);
+		mAPDU.Reset();
+		mAPDU.Write(hs, hs.Size());
+		mAPDU.Interpret();
+		slave.OnRequest(mAPDU, SI_OTHER);
+		mAPDU = app.Read();
+		return toHex(mAPDU.GetBuffer(), mAPDU.Size(), true);
+	}
+
+	static SlaveConfig Config() {
+		SlaveConfig cfg;
+		cfg.mDisableUnsol = true;
+		return cfg;
+	}
+
+	MockTimeManager time;
+	MockAppLayer app;
+	DNPCommandMaster cmdMaster;
+	Slave slave;
+	APDU mAPDU;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(SharedDatabaseSuite)
+
+BOOST_AUTO_TEST_CASE(EventsAreCopiedToEverySession)
+{
+	EventLog log;
+	SharedDatabase shared(log.GetLogger(LEV_INFO, "shared"), NULL, DeviceTemplate(0, 2));
+	shared.GetDatabase()->SetClass(DT_ANALOG, PC_CLASS_1);
+
+	EventMaxConfig max;
+	SlaveEventBuffer a(max);
+	SlaveEventBuffer b(max);
+	size_t notified = 0;
+	shared.AddSession(&a, boost::bind(&Increment, &notified));
+	shared.AddSession(&b, boost::bind(&Increment, &notified));
+	BOOST_REQUIRE_EQUAL(shared.NumSessions(), 2);
+
+	{
+		Transaction tr(shared.GetDataObserver());
+		shared.GetDataObserver()->Update(Analog(10, AQ_ONLINE), 0);
+		shared.GetDataObserver()->Update(Analog(20, AQ_ONLINE), 1);
+	}
+
+	BOOST_REQUIRE_EQUAL(shared.Flush(), 2);
+	BOOST_REQUIRE_EQUAL(notified, 2);
+	BOOST_REQUIRE_EQUAL(a.NumType(BT_ANALOG), 2);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_ANALOG), 2);
+
+	// nothing new, nobody is bothered
+	BOOST_REQUIRE_EQUAL(shared.Flush(), 0);
+	BOOST_REQUIRE_EQUAL(notified, 2);
+
+	shared.RemoveSession(&a);
+	{
+		Transaction tr(shared.GetDataObserver());
+		shared.GetDataObserver()->Update(Analog(30, AQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE_EQUAL(shared.Flush(), 1);
+	BOOST_REQUIRE_EQUAL(notified, 3);
+	BOOST_REQUIRE_EQUAL(a.NumType(BT_ANALOG), 2);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_ANALOG), 3);
+}
+
+BOOST_AUTO_TEST_CASE(SessionsConfirmEventsIndependently)
+{
+	EventLog log;
+	MockTimerSource mts;
+	SharedDatabase shared(log.GetLogger(LEV_INFO, "shared"), NULL, DeviceTemplate(0, 2));
+	shared.GetDatabase()->SetClass(DT_ANALOG, PC_CLASS_1);
+
+	Session primary(log, &mts, &shared, "primary");
+	Session backup(log, &mts, &shared, "backup");
+	BOOST_REQUIRE_EQUAL(primary.slave.GetDataObserver(), shared.GetDataObserver());
+
+	{
+		Transaction tr(shared.GetDataObserver());
+		shared.GetDataObserver()->Update(Analog(0x0987, AQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE_EQUAL(shared.Flush(), 1);
+
+	// the primary reads and confirms the event
+	BOOST_REQUIRE_EQUAL(primary.Request("C0 01 3C 02 06"), "E0 81 80 00 20 01 17 01 00 01 87 09 00 00");
+	BOOST_REQUIRE_EQUAL(primary.Request("C0 01 3C 02 06"), "C0 81 80 00");
+
+	// the backup still has it
+	BOOST_REQUIRE_EQUAL(backup.Request("C0 01 3C 02 06"), "E0 81 80 00 20 01 17 01 00 01 87 09 00 00");
+
+	// both serve the same static data
+	BOOST_REQUIRE_EQUAL(primary.Request("C0 01 1E 00 06"), backup.Request("C0 01 1E 00 06"));
+}
+
+BOOST_AUTO_TEST_CASE(SessionLeavesWhenDestroyed)
+{
+	EventLog log;
+	MockTimerSource mts;
+	SharedDatabase shared(log.GetLogger(LEV_INFO, "shared"), NULL, DeviceTemplate(0, 2));
+	{
+		Session session(log, &mts, &shared, "session");
+		BOOST_REQUIRE_EQUAL(shared.NumSessions(), 1);
+	}
+	BOOST_REQUIRE_EQUAL(shared.NumSessions(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
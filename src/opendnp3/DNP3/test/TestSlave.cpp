@@ -1511,5 +1511,125 @@ BOOST_AUTO_TEST_CASE(ReadGrp40Var4)
 
 
 
+void ConfigureCounters(SlaveTestObject& t, PointClass aClass0, PointClass aClass1)
+{
+	t.db.Configure(DT_COUNTER, 2);
+	t.db.SetClass(DT_COUNTER, 0, aClass0);
+	t.db.SetClass(DT_COUNTER, 1, aClass1);
+	t.slave.OnLowerLayerUp();
+
+	Transaction tr(&t.db);
+	t.db.Update(Counter(5, CQ_ONLINE), 0);
+	t.db.Update(Counter(7, CQ_ONLINE), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FreezeCounters)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	ConfigureCounters(t, PC_CLASS_0, PC_CLASS_0);
+
+	t.SendToSlave("C0 07 14 00 06"); // freeze all counters
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(9, CQ_ONLINE), 0);
+	}
+
+	t.SendToSlave("C0 01 15 01 06"); // read 21 var 1
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 15 01 00 00 01 01 05 00 00 00 01 07 00 00 00");
+
+	t.SendToSlave("C0 01 14 01 06"); // read 20 var 1
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 14 01 00 00 01 01 09 00 00 00 01 07 00 00 00");
+}
+
+BOOST_AUTO_TEST_CASE(FreezeAndClearCounters)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	ConfigureCounters(t, PC_CLASS_0, PC_CLASS_0);
+
+	t.SendToSlave("C0 09 14 00 06"); // freeze and clear all counters
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 01 14 01 06"); // read 20 var 1
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 14 01 00 00 01 01 00 00 00 00 01 00 00 00 00");
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(2, CQ_ONLINE), 1);
+	}
+
+	t.SendToSlave("C0 07 14 00 06"); // freeze all counters again
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 01 15 01 06"); // read 21 var 1, the clear is frozen
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 15 01 00 00 01 01 00 00 00 00 01 02 00 00 00");
+}
+
+BOOST_AUTO_TEST_CASE(FreezeCounterRangeWithTime)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	ConfigureCounters(t, PC_CLASS_0, PC_CLASS_0);
+	t.fakeTime.SetTime(1234);
+
+	t.SendToSlave("C0 08 14 00 00 01 01"); // freeze counter 1 without an ack
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+
+	t.SendToSlave("C0 01 15 05 06"); // read 21 var 5, counter 0 has never been frozen
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 15 05 00 00 01 02 00 00 00 00 00 00 00 00 00 00 01 07 00 00 00 D2 04 00 00 00 00");
+
+	t.SendToSlave("C0 07 14 00 00 02 02"); // freeze counter 2, which doesn't exist
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 04");
+}
+
+BOOST_AUTO_TEST_CASE(FrozenCounterEventsReportLatestFreeze)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	ConfigureCounters(t, PC_CLASS_1, PC_CLASS_1);
+
+	t.SendToSlave("C0 01 17 00 06"); // read 23 var 0, nothing has been frozen
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 07 14 00 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Counter(6, CQ_ONLINE), 0);
+	}
+
+	t.SendToSlave("C0 07 14 00 06"); // a second freeze replaces the unread events
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 01 17 00 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 17 01 17 02 00 01 06 00 00 00 01 01 07 00 00 00");
+
+	t.SendToSlave("C0 01 17 00 06"); // the events were confirmed
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+}
+
+BOOST_AUTO_TEST_CASE(FrozenCounterEventsInClassPoll)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	ConfigureCounters(t, PC_CLASS_2, PC_CLASS_3);
+
+	t.SendToSlave("C0 01 3C 02 06"); // class 1 has nothing
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 07 14 00 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+
+	t.SendToSlave("C0 01 3C 04 06"); // class 3, the counter event and then the frozen counter event
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 16 01 17 01 01 01 07 00 00 00 17 01 17 01 01 01 07 00 00 00");
+
+	t.SendToSlave("C0 01 3C 03 06"); // class 2 is still unread
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 16 01 17 01 00 01 05 00 00 00 17 01 17 01 00 01 05 00 00 00");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
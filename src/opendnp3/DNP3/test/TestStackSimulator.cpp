@@ -0,0 +1,185 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/test/util/LogTester.h>
+#include <opendnp3/DNP3/StackSimulator.h>
+
+#include <map>
+#include <sstream>
+
+using namespace apl;
+using namespace apl::dnp;
+
+namespace
+{
+
+SimulatorConfig Config(size_t aNumPairs)
+{
+	SimulatorConfig cfg;
+	cfg.NumPairs = aNumPairs;
+	cfg.UpdatePeriod = 1000;
+	cfg.line.mLatency = 20;
+	cfg.line.mJitter = 10;
+	cfg.line.mBitsPerSecond = 9600;
+	cfg.master.master.IntegrityRate = 60000;
+	cfg.master.master.AddExceptionScan(PC_CLASS_1 | PC_CLASS_2 | PC_CLASS_3, 2000);
+	return cfg;
+}
+
+// one outstation whose integrity poll is ~10 fragments, each taking ~2.7 s on a 9600 bps line
+SimulatorConfig SlowPollConfig(bool aPreempt)
+{
+	SimulatorConfig cfg;
+	cfg.UpdatePeriod = 0;
+	cfg.line.mLatency = 20;
+	cfg.line.mBitsPerSecond = 9600;
+	cfg.slave.device = DeviceTemplate(0, 4000, 0, 0, 0, 1);
+	cfg.master.master.IntegrityRate = 1000;
+	cfg.master.master.PreemptPolls = aPreempt;
+	return cfg;
+}
+
+// issues a command every 7 virtual seconds and measures how long each takes to come back
+class CommandLatency : public IResponseAcceptor
+{
+public:
+	CommandLatency(StackSimulator* apSim) : mpSim(apSim), mSequence(0), mCount(0), mTotal(0), mMax(0) {}
+
+	void Run(size_t aNumCommands) {
+		mpSim->Run(20000); // past the startup tasks
+		for(size_t i = 0; i < aNumCommands; ++i) {
+			mSent[++mSequence] = mpSim->GetTimerSource()->GetUTC();
+			mpSim->GetCommandAcceptor(0)->AcceptCommand(BinaryOutput(CC_LATCH_ON), 0, mSequence, this);
+			mpSim->Run(7000);
+		}
+		mpSim->Run(30000);
+	}
+
+	void AcceptResponse(const CommandResponse&, int aSequence) {
+		boost::int64_t ms = (mpSim->GetTimerSource()->GetUTC() - mSent[aSequence]).total_milliseconds();
+		++mCount;
+		mTotal += ms;
+		mMax = std::max(mMax, ms);
+	}
+
+	StackSimulator* mpSim;
+	int mSequence;
+	std::map<int, boost::posix_time::ptime> mSent;
+
+	size_t mCount;
+	boost::int64_t mTotal;
+	boost::int64_t mMax;
+};
+
+boost::int64_t MetricValue(LogTester& arLog, const std::string& arName, const std::string& arSource)
+{
+	std::vector<MetricSample> samples;
+	arLog.mLog.GetMetrics()->Snapshot(samples);
+	for(size_t i = 0; i < samples.size(); ++i) {
+		if(samples[i].name == arName && samples[i].source == arSource) return samples[i].value;
+	}
+	return -1;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(StackSimulatorSuite)
+
+BOOST_AUTO_TEST_CASE(ChangesReachTheMasters)
+{
+	LogTester log;
+	StackSimulator sim(log.mLog.GetLogger(LEV_WARNING, "sim"), Config(10));
+
+	sim.Run(10 * 60 * 1000);
+
+	// about 600 changes per outstation, all but the last scan's worth have arrived
+	BOOST_REQUIRE(sim.NumUpdates() > 5000);
+	BOOST_REQUIRE(sim.NumDelivered() > sim.NumUpdates() - 100);
+	BOOST_REQUIRE_EQUAL(sim.NumLost(), 0);
+	BOOST_REQUIRE_EQUAL(sim.GetTimerSource()->Elapsed(), 10 * 60 * 1000);
+
+	std::ostringstream oss;
+	sim.Report(oss);
+	BOOST_REQUIRE(oss.str().find("latency p99") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LostFramesDelayButDontStopDelivery)
+{
+	LogTester log;
+	SimulatorConfig cfg = Config(10);
+	cfg.line.mLoss = 0.2;
+	StackSimulator sim(log.mLog.GetLogger(LEV_ERROR, "sim"), cfg);
+
+	sim.Run(10 * 60 * 1000);
+
+	// lost polls and responses are retried on the next scan
+	BOOST_REQUIRE(sim.NumLost() > 0);
+	BOOST_REQUIRE(sim.NumDelivered() > sim.NumUpdates() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(RunsAreRepeatable)
+{
+	LogTester log1, log2;
+	SimulatorConfig cfg = Config(5);
+	cfg.line.mLoss = 0.05;
+	StackSimulator sim1(log1.mLog.GetLogger(LEV_ERROR, "sim"), cfg);
+	StackSimulator sim2(log2.mLog.GetLogger(LEV_ERROR, "sim"), cfg);
+
+	sim1.Run(5 * 60 * 1000);
+	sim2.Run(5 * 60 * 1000);
+
+	BOOST_REQUIRE_EQUAL(sim1.GetTimerSource()->NumRun(), sim2.GetTimerSource()->NumRun());
+	BOOST_REQUIRE_EQUAL(sim1.NumDelivered(), sim2.NumDelivered());
+	BOOST_REQUIRE_EQUAL(sim1.NumLost(), sim2.NumLost());
+}
+
+BOOST_AUTO_TEST_CASE(CommandsPreemptSlowPolls)
+{
+	const size_t NUM_COMMANDS = 20;
+
+	LogTester logWait, logPreempt;
+	StackSimulator waiting(logWait.mLog.GetLogger(LEV_ERROR, "sim"), SlowPollConfig(false));
+	StackSimulator preempting(logPreempt.mLog.GetLogger(LEV_ERROR, "sim"), SlowPollConfig(true));
+	CommandLatency before(&waiting), after(&preempting);
+
+	before.Run(NUM_COMMANDS);
+	after.Run(NUM_COMMANDS);
+
+	BOOST_TEST_MESSAGE("command latency waiting for polls: mean " << before.mTotal / NUM_COMMANDS << " ms, max " << before.mMax << " ms");
+	BOOST_TEST_MESSAGE("command latency preempting polls: mean " << after.mTotal / NUM_COMMANDS << " ms, max " << after.mMax << " ms");
+
+	BOOST_REQUIRE_EQUAL(before.mCount, NUM_COMMANDS);
+	BOOST_REQUIRE_EQUAL(after.mCount, NUM_COMMANDS);
+
+	// without preemption a command can wait out a whole ~27 s poll. With it, a command waits for the
+	// fragment being received and the one the outstation starts sending when it's confirmed.
+	BOOST_REQUIRE(before.mMax > 15000);
+	BOOST_REQUIRE(after.mMax < 7000);
+	BOOST_REQUIRE(after.mTotal * 2 < before.mTotal);
+
+	BOOST_REQUIRE_EQUAL(MetricValue(logWait, "polls_preempted", "master0"), 0);
+	BOOST_REQUIRE(MetricValue(logPreempt, "polls_preempted", "master0") > 0);
+	BOOST_REQUIRE_EQUAL(MetricValue(logPreempt, "command_wait_ms", "master0"), NUM_COMMANDS);
+	BOOST_REQUIRE_EQUAL(MetricValue(logPreempt, "command_wire_ms", "master0"), NUM_COMMANDS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
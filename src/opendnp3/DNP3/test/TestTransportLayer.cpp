@@ -260,5 +260,57 @@ BOOST_AUTO_TEST_CASE(TestSendFullAPDU)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(TestPooledReceiveOnlyBorrowsMidFragment)
+{
+	BufferPool pool;
+	TransportTestObject test(true, LEV_INFO, false, &pool);
+
+	test.lower.SendUp(test.GetData("40"));	// FIR/_/0
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 1);
+
+	test.lower.SendUp("81 77");	// _/FIN/1
+	BOOST_REQUIRE(test.upper.BufferEquals(test.GetData("") + " 77"));
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 1);
+
+	// the next fragment reuses the released buffer
+	test.lower.SendUp("C2 78");
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 1);
+	BOOST_REQUIRE(test.IsLogErrorFree());
+}
+
+BOOST_AUTO_TEST_CASE(TestPooledReceiveReleasedWhenClosed)
+{
+	BufferPool pool;
+	TransportTestObject test(true, LEV_INFO, false, &pool);
+
+	test.lower.SendUp(test.GetData("40"));	// FIR/_/0
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 1);
+	test.lower.ThisLayerDown();
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestPooledSendBorrowsUntilComplete)
+{
+	BufferPool pool;
+	TransportTestObject test(true, LEV_INFO, false, &pool);
+
+	test.lower.DisableAutoSendCallback();
+	test.upper.SendDown("11");
+	BOOST_REQUIRE(test.lower.BufferEquals("C0 11"));
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 2); // apdu and tpdu buffers
+
+	test.lower.SendSuccess();
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+
+	test.lower.ClearBuffer();
+	test.upper.SendDown("22");
+	BOOST_REQUIRE(test.lower.BufferEquals("C1 22"));
+	test.lower.SendFailure();
+	BOOST_REQUIRE_EQUAL(pool.NumBorrowed(), 0);
+	BOOST_REQUIRE_EQUAL(pool.NumFree(), 2);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,8 @@
 #include <boost/test/unit_test.hpp>
 
 
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Metrics.h>
 #include <opendnp3/APL/RandomizedBuffer.h>
 #include <opendnp3/APL/test/util/MockPhysicalLayerMonitor.h>
 
@@ -34,9 +36,10 @@ public:
 	        bool aImmediateOutput = false,
 	        bool aLogToFile = false,
 	        FilterLevel level = LEV_INFO,
-	        boost::uint16_t port = MACRO_PORT_VALUE) :
+	        boost::uint16_t port = MACRO_PORT_VALUE,
+	        size_t aFragSize = DEFAULT_FRAG_SIZE) :
 
-		VtoIntegrationTestBase(clientOnSlave, aImmediateOutput, aLogToFile, level, port),
+		VtoIntegrationTestBase(clientOnSlave, aImmediateOutput, aLogToFile, level, port, aFragSize),
 		local(mLog.GetLogger(level, "local-mock-phys-monitor"), &vtoClient, &timerSource, 500),
 		remote(mLog.GetLogger(level, "remote-mock-phys-monitor"), &vtoServer, &timerSource, 500) {
 
@@ -171,6 +174,52 @@ BOOST_AUTO_TEST_CASE(LargeDataTransferSlaveToMaster)
 	TestLargeDataOneWay(stack, MACRO_BUFFER_SIZE);
 }
 
+/*
+ * Moves aSizeInBytes through the stack without corruption and returns the
+ * average number of bytes in each fragment arReceiver took in. Every
+ * fragment is counted, polls and confirms included, so it's a lower bound.
+ */
+double TransferAndMeasure(VtoOnewayTestStack& arTest, size_t aSizeInBytes, const std::string& arReceiver)
+{
+	MetricCounter* pFragments = arTest.mLog.GetMetrics()->GetCounter(arReceiver, "app_rx_fragments");
+
+	arTest.local.Start();
+	arTest.remote.Start();
+	BOOST_REQUIRE(arTest.WaitForBothSides(PLS_OPEN));
+
+	boost::int64_t fragments = pFragments->Get();
+	boost::int64_t start = LatencyTrace::Now();
+
+	RandomizedBuffer data(aSizeInBytes);
+	arTest.remote.ExpectData(data);
+	arTest.local.WriteData(data);
+	BOOST_REQUIRE(arTest.WaitForExpectedDataToBeReceived(60000));
+
+	double seconds = (LatencyTrace::Now() - start) / 1000000.0;
+	fragments = pFragments->Get() - fragments;
+	BOOST_REQUIRE(fragments > 0);
+
+	double perFragment = static_cast<double>(aSizeInBytes) / fragments;
+	BOOST_TEST_MESSAGE(arReceiver << " received " << aSizeInBytes << " bytes in " << fragments << " fragments, "
+	                   << perFragment << " bytes/fragment, " << (aSizeInBytes / seconds / 1024) << " KB/s");
+	return perFragment;
+}
+
+// the old selection stopped at 7 objects, so 7 full objects is the most it could carry
+const double MAX_BYTES_WITH_7_OBJECTS = 7 * VtoData::MAX_SIZE;
+
+BOOST_AUTO_TEST_CASE(MasterToSlaveFillsFragments)
+{
+	VtoOnewayTestStack stack(true, false, false, LEV_INFO, MACRO_PORT_VALUE, 4096);
+	BOOST_REQUIRE(TransferAndMeasure(stack, 1 << 18, "slave") > MAX_BYTES_WITH_7_OBJECTS);
+}
+
+BOOST_AUTO_TEST_CASE(SlaveToMasterFillsFragments)
+{
+	VtoOnewayTestStack stack(false, false, false, LEV_INFO, MACRO_PORT_VALUE, 4096);
+	BOOST_REQUIRE(TransferAndMeasure(stack, 1 << 18, "master") > MAX_BYTES_WITH_7_OBJECTS);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /* vim: set ts=4 sw=4: */
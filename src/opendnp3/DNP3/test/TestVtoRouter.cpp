@@ -163,6 +163,31 @@ BOOST_AUTO_TEST_CASE(PhysReadBuffering)
 	BOOST_REQUIRE_EQUAL(rtc.writer.Size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(PartialWritesResumeAtOffset)
+{
+	RouterTestClass rtc(VtoRouterSettings(0, true, true), 1); // writer only takes 1 chunk!
+	rtc.phys.SignalOpenSuccess();
+
+	// one more byte than fits in a chunk, followed by a second read
+	size_t max = VtoData::MAX_SIZE;
+	std::string first;
+	for(size_t i = 0; i < max; ++i) first += "01 ";
+	first += "02";
+	rtc.phys.TriggerRead(first);
+	rtc.phys.TriggerRead("03 04");
+	BOOST_REQUIRE_EQUAL(rtc.writer.Size(), 1);
+
+	VtoEvent vto;
+	BOOST_REQUIRE(rtc.writer.Read(vto));
+	BOOST_REQUIRE_EQUAL(vto.mValue.GetSize(), max);
+
+	BOOST_REQUIRE(rtc.writer.Read(vto));
+	CheckVtoEvent(vto, "02", 0, PC_CLASS_1);
+	BOOST_REQUIRE(rtc.writer.Read(vto));
+	CheckVtoEvent(vto, "03 04", 0, PC_CLASS_1);
+	BOOST_REQUIRE_EQUAL(rtc.writer.Size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /* vim: set ts=4 sw=4: */
@@ -31,10 +31,10 @@ namespace apl
 namespace dnp
 {
 
-TransportTestObject::TransportTestObject(bool aOpenOnStart, FilterLevel aLevel, bool aImmediate) :
+TransportTestObject::TransportTestObject(bool aOpenOnStart, FilterLevel aLevel, bool aImmediate, BufferPool* apPool) :
 	LogTester(aImmediate),
 	mpLogger(mLog.GetLogger(aLevel, "TransportTestObject")),
-	transport(mpLogger),
+	transport(mpLogger, DEFAULT_FRAG_SIZE, apPool),
 	lower(mpLogger),
 	upper(mpLogger)
 {
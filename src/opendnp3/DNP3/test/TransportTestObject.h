@@ -37,7 +37,7 @@ namespace dnp
 class TransportTestObject : public LogTester
 {
 public:
-	TransportTestObject(bool aOpenOnStart = false, FilterLevel aLevel = LEV_INFO, bool aImmediate = false);
+	TransportTestObject(bool aOpenOnStart = false, FilterLevel aLevel = LEV_INFO, bool aImmediate = false, BufferPool* apPool = NULL);
 
 	// Generate a complete packet sequence inside the vector and
 	// return the corresponding reassembled APDU
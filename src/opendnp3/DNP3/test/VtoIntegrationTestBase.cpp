@@ -35,7 +35,8 @@ VtoIntegrationTestBase::VtoIntegrationTestBase(
         bool aImmediateOutput,
         bool aLogToFile,
         FilterLevel level,
-        boost::uint16_t port) :
+        boost::uint16_t port,
+        size_t aFragSize) :
 
 	LogTester(),
 	Loggable(mpTestLogger),
@@ -56,6 +57,8 @@ VtoIntegrationTestBase::VtoIntegrationTestBase(
 		SlaveStackConfig config;
 		config.app.NumRetry = 3;
 		config.app.RspTimeout = 500;
+		config.app.FragSize = aFragSize;
+		config.slave.mMaxFragSize = aFragSize;
 		manager.AddSlave("dnp-tcp-server", "slave", level, &cmdAcceptor, config);
 	}
 
@@ -64,6 +67,8 @@ VtoIntegrationTestBase::VtoIntegrationTestBase(
 		MasterStackConfig config;
 		config.app.NumRetry = 3;
 		config.app.RspTimeout = 500;
+		config.app.FragSize = aFragSize;
+		config.master.FragSize = aFragSize;
 		config.master.UseNonStandardVtoFunction = true;
 		manager.AddMaster("dnp-tcp-client", "master", level, &fdo, config);
 	}
@@ -30,6 +30,7 @@
 #include <opendnp3/APL/PhysicalLayerAsyncTCPServer.h>
 
 #include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/DNPConstants.h>
 
 
 /** Platforms have different reserved port ranges */
@@ -55,7 +56,8 @@ public:
 	        bool aImmediateOutput = false,
 	        bool aLogToFile = false,
 	        FilterLevel level = LEV_INFO,
-	        boost::uint16_t port = MACRO_PORT_VALUE);
+	        boost::uint16_t port = MACRO_PORT_VALUE,
+	        size_t aFragSize = DEFAULT_FRAG_SIZE);
 
 	virtual ~VtoIntegrationTestBase();
 
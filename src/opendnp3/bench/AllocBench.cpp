@@ -0,0 +1,272 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "AllocBench.h"
+
+#include <opendnp3/APL/AtomicOps.h>
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+#include <opendnp3/DNP3/VtoDataInterface.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#if __cplusplus >= 201103L
+#define ALLOC_BENCH_THROWS_BAD_ALLOC
+#define ALLOC_BENCH_NO_THROW noexcept
+#else
+#define ALLOC_BENCH_THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define ALLOC_BENCH_NO_THROW throw()
+#endif
+
+namespace
+{
+apl::atomic_int64_t gNumAllocations = 0;
+}
+
+// Counting replacements for the global allocation functions. The array and
+// nothrow forms are implemented by the library in terms of these.
+void* operator new(std::size_t aSize) ALLOC_BENCH_THROWS_BAD_ALLOC
+{
+	apl::AtomicAddRelaxed(&gNumAllocations, 1);
+	void* p = std::malloc(aSize > 0 ? aSize : 1);
+	if(p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* apMem) ALLOC_BENCH_NO_THROW
+{
+	std::free(apMem);
+}
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char CLIENT_NAME[] = "client";
+const char SERVER_NAME[] = "server";
+const char MASTER_NAME[] = "master";
+const char SLAVE_NAME[] = "slave";
+const boost::uint8_t VTO_CHANNEL = 1;
+const millis_t CONNECT_TIMEOUT = 10000;
+const boost::int64_t MAX_VTO_BACKLOG = 8 * 1024; // bytes written but not yet received, so the writer queue never fills
+
+class CountingDataObserver : public IDataObserver
+{
+public:
+	CountingDataObserver() : mNumUpdates(0) {}
+
+	boost::int64_t NumUpdates() const {
+		return AtomicLoadRelaxed(&mNumUpdates);
+	}
+
+private:
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Analog&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Counter&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const ControlStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+
+	atomic_int64_t mNumUpdates;
+};
+
+class CountingVtoCallbacks : public IVtoCallbacks
+{
+public:
+	CountingVtoCallbacks() : IVtoCallbacks(VTO_CHANNEL), mNumBytes(0) {}
+
+	boost::int64_t NumBytes() const {
+		return AtomicLoadRelaxed(&mNumBytes);
+	}
+
+	void OnVtoDataReceived(const VtoData& arData) {
+		AtomicAddRelaxed(&mNumBytes, static_cast<boost::int64_t>(arData.GetSize()));
+	}
+
+private:
+	atomic_int64_t mNumBytes;
+};
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+// sleeps until apCount returns at least aTarget, @throw Exception if it takes too long
+template <class T>
+void WaitForCount(const T* apCounter, boost::int64_t (T::*apCount)() const, boost::int64_t aTarget, const std::string& arWhat)
+{
+	Timeout to(CONNECT_TIMEOUT);
+	while((apCounter->*apCount)() < aTarget) {
+		if(to.IsExpired()) throw Exception(LOCATION, "Timed out waiting for " + arWhat);
+		Thread::SleepFor(1);
+	}
+}
+
+double Per(boost::int64_t aAllocations, boost::int64_t aCount)
+{
+	return (aCount > 0) ? static_cast<double>(aAllocations) / aCount : 0;
+}
+
+}
+
+AllocBench::AllocBench(size_t aNumPoints, millis_t aDuration, boost::uint16_t aPort, FilterLevel aLevel) :
+	mNumPoints(aNumPoints),
+	mDuration(aDuration),
+	mPort(aPort),
+	mLevel(aLevel)
+{
+
+}
+
+boost::int64_t AllocBench::NumAllocations()
+{
+	return AtomicLoadRelaxed(&gNumAllocations);
+}
+
+void AllocBench::Run(std::ostream& arStream)
+{
+	boost::int64_t points = 0;
+	boost::int64_t pollAllocs = this->MeasurePolling(points);
+	boost::int64_t bytes = 0;
+	boost::int64_t vtoAllocs = this->MeasureVto(bytes);
+
+	arStream << "points polled:      " << points << std::endl;
+	arStream << "allocations:        " << pollAllocs << std::endl;
+	arStream << "vto bytes:          " << bytes << std::endl;
+	arStream << "allocations:        " << vtoAllocs << std::endl;
+	arStream << std::fixed << std::setprecision(4);
+	arStream << "allocs/point:       " << Per(pollAllocs, points) << std::endl;
+	arStream << "allocs/vto byte:    " << Per(vtoAllocs, bytes) << std::endl;
+}
+
+void AllocBench::AddStacks(AsyncStackManager& arMgr, millis_t aIntegrityRate, IDataObserver* apObserver, ICommandAcceptor* apAcceptor)
+{
+	arMgr.AddTCPClient(CLIENT_NAME, PhysLayerSettings(mLevel, 1000), "127.0.0.1", mPort);
+	arMgr.AddTCPServer(SERVER_NAME, PhysLayerSettings(mLevel, 1000), "127.0.0.1", mPort);
+
+	MasterStackConfig master;
+	master.master.IntegrityRate = aIntegrityRate;
+	master.master.DoUnsolOnStartup = false;
+	master.master.UseNonStandardVtoFunction = true;
+	arMgr.AddMaster(CLIENT_NAME, MASTER_NAME, mLevel, apObserver, master);
+
+	SlaveStackConfig slave;
+	slave.device = DeviceTemplate(0, mNumPoints);
+	arMgr.AddSlave(SERVER_NAME, SLAVE_NAME, mLevel, apAcceptor, slave);
+}
+
+boost::int64_t AllocBench::MeasurePolling(boost::int64_t& arNumPoints)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	CountingDataObserver observer;
+	RejectingCommandAcceptor acceptor;
+
+	AsyncStackManager mgr(log.GetLogger(mLevel, "bench"));
+	this->AddStacks(mgr, 1, &observer, &acceptor); // poll back to back
+
+	// let a few polls go by so the queues and buffers reach their working size
+	WaitForCount(&observer, &CountingDataObserver::NumUpdates, 10 * static_cast<boost::int64_t>(mNumPoints), "the first polls");
+
+	boost::int64_t allocStart = NumAllocations();
+	boost::int64_t pointStart = observer.NumUpdates();
+	Thread::SleepFor(mDuration);
+	boost::int64_t allocs = NumAllocations() - allocStart;
+	arNumPoints = observer.NumUpdates() - pointStart;
+
+	mgr.Shutdown();
+	return allocs;
+}
+
+boost::int64_t AllocBench::MeasureVto(boost::int64_t& arNumBytes)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	CountingDataObserver observer;
+	RejectingCommandAcceptor acceptor;
+	CountingVtoCallbacks vto;
+
+	AsyncStackManager mgr(log.GetLogger(mLevel, "bench"));
+	this->AddStacks(mgr, -1, &observer, &acceptor); // only the startup integrity poll
+	mgr.AddVtoChannel(SLAVE_NAME, &vto);
+
+	// the master keeps a small backlog of data queued for the slave
+	IVtoWriter* pWriter = mgr.GetVtoWriter(MASTER_NAME);
+	boost::uint8_t data[1024];
+	for(size_t i = 0; i < sizeof(data); ++i) data[i] = static_cast<boost::uint8_t>(i);
+
+	boost::int64_t sent = 0;
+	Timeout warmup(mDuration / 4);
+	while(!warmup.IsExpired()) {
+		if(sent - vto.NumBytes() < MAX_VTO_BACKLOG) sent += pWriter->Write(data, sizeof(data), VTO_CHANNEL);
+		Thread::SleepFor(1);
+	}
+	WaitForCount(&vto, &CountingVtoCallbacks::NumBytes, sent, "the first VTO data");
+
+	boost::int64_t allocStart = NumAllocations();
+	boost::int64_t byteStart = vto.NumBytes();
+	Timeout run(mDuration);
+	while(!run.IsExpired()) {
+		if(sent - vto.NumBytes() < MAX_VTO_BACKLOG) sent += pWriter->Write(data, sizeof(data), VTO_CHANNEL);
+		Thread::SleepFor(1);
+	}
+	WaitForCount(&vto, &CountingVtoCallbacks::NumBytes, sent, "the VTO data");
+	boost::int64_t allocs = NumAllocations() - allocStart;
+	arNumBytes = vto.NumBytes() - byteStart;
+
+	mgr.Shutdown();
+	return allocs;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
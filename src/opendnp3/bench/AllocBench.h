@@ -0,0 +1,78 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ALLOC_BENCH_H_
+#define __ALLOC_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+
+class ICommandAcceptor;
+class IDataObserver;
+
+namespace dnp
+{
+
+class AsyncStackManager;
+
+/**
+	Connects a master to a slave over loopback TCP and counts the heap
+	allocations made by the process while the master integrity polls the
+	slave, and then with a fresh pair while the master streams VTO data to
+	the slave. The
+	counts come from the replacement operator new defined with the bench,
+	so they cover every thread in the process.
+*/
+class AllocBench
+{
+public:
+
+	AllocBench(size_t aNumPoints, millis_t aDuration, boost::uint16_t aPort, FilterLevel aLevel);
+
+	/// Runs both phases and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+	/// @return number of times operator new has been called by the process
+	static boost::int64_t NumAllocations();
+
+private:
+
+	/// Adds a master on a TCP client polling a slave of mNumPoints analogs on a TCP server
+	void AddStacks(AsyncStackManager& arMgr, millis_t aIntegrityRate, IDataObserver* apObserver, ICommandAcceptor* apAcceptor);
+
+	/// @return allocations made while the master integrity polls back to back
+	boost::int64_t MeasurePolling(boost::int64_t& arNumPoints);
+
+	/// @return allocations made while the master streams VTO data to the slave
+	boost::int64_t MeasureVto(boost::int64_t& arNumBytes);
+
+	size_t mNumPoints;
+	millis_t mDuration;
+	boost::uint16_t mPort;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,89 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <iostream>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+
+#include <opendnp3/APL/Exception.h>
+
+#include "BenchSuite.h"
+#include "MacroBenchmarks.h"
+#include "MicroBenchmarks.h"
+
+using namespace std;
+using namespace apl;
+using namespace apl::dnp;
+
+namespace po = boost::program_options;
+
+/*
+ * Command line syntax:
+ *
+ *    bench-dnp3 [--filter <name>] [--repeat <n>] [--duration <ms>] [--port <port>] [--verbose]
+ *
+ * Every measurement is written to stdout as benchmark,metric,value,unit
+ */
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	size_t repeat;
+	millis_t duration;
+	boost::uint16_t port;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+	("help,H", "display program options")
+	("filter,F", po::value<std::string>(&filter), "Only run the benchmarks whose names contain this, e.g. micro. or tcp_poll")
+	("repeat,R", po::value<size_t>(&repeat)->default_value(5), "Number of timed batches per micro benchmark")
+	("duration,D", po::value<millis_t>(&duration)->default_value(2000), "How long each macro benchmark measures for in ms")
+	("port,P", po::value<boost::uint16_t>(&port)->default_value(20000), "First local TCP port used by the macro benchmarks")
+	("verbose,V", "Log stack warnings during the macro benchmarks");
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+	} catch ( boost::program_options::error& ex ) {
+		cerr << ex.what() << endl;
+		cerr << desc << endl;
+		return -1;
+	}
+
+	if(vm.count("help") || repeat == 0 || duration <= 0) {
+		cerr << "bench-dnp3 [options]" << endl;
+		cerr << desc << endl;
+		return vm.count("help") ? 0 : -1;
+	}
+
+	FilterLevel level = vm.count("verbose") ? LEV_WARNING : LEV_ERROR;
+
+	try {
+		BenchSuite suite(cout, filter, repeat, duration);
+		RunMicroBenchmarks(suite);
+		RunMacroBenchmarks(suite, port, level);
+	} catch(const Exception& ex) {
+		cerr << ex.GetErrorString() << endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,88 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "BenchSuite.h"
+
+#include <opendnp3/APL/LatencyTrace.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace apl
+{
+namespace dnp
+{
+
+BenchSuite::BenchSuite(std::ostream& arStream, const std::string& arFilter, size_t aRepeat, millis_t aDuration) :
+	mpStream(&arStream),
+	mFilter(arFilter),
+	mRepeat(aRepeat > 0 ? aRepeat : 1),
+	mDuration(aDuration)
+{
+	(*mpStream) << "benchmark,metric,value,unit" << std::endl;
+}
+
+bool BenchSuite::IsSelected(const std::string& arName) const
+{
+	return arName.find(mFilter) != std::string::npos;
+}
+
+void BenchSuite::Report(const std::string& arBench, const std::string& arMetric, double aValue, const std::string& arUnit)
+{
+	(*mpStream) << arBench << "," << arMetric << "," << aValue << "," << arUnit << std::endl;
+}
+
+void BenchSuite::RunMicro(const std::string& arName, const boost::function<void ()>& arLoop, size_t aOpsPerLoop)
+{
+	if(!this->IsSelected(arName)) return;
+
+	// grow the batch until it's long enough to time, which also warms the caches
+	size_t loops = 1;
+	while(TimeBatch(arLoop, loops) < MIN_BATCH_US) loops *= 2;
+
+	std::vector<boost::int64_t> batches;
+	for(size_t i = 0; i < mRepeat; ++i) batches.push_back(TimeBatch(arLoop, loops));
+
+	double ops = static_cast<double>(loops) * aOpsPerLoop;
+	double median = Percentile(batches, 50) * 1000.0 / ops;
+	double fastest = batches.front() * 1000.0 / ops;
+
+	this->Report(arName, "median", median, "ns/op");
+	this->Report(arName, "min", fastest, "ns/op");
+	this->Report(arName, "rate", (median > 0) ? 1000000000.0 / median : 0, "ops/s");
+}
+
+boost::int64_t BenchSuite::Percentile(std::vector<boost::int64_t>& arSamples, double aPercent)
+{
+	if(arSamples.empty()) return 0;
+	std::sort(arSamples.begin(), arSamples.end());
+	size_t rank = static_cast<size_t>(std::ceil(aPercent / 100.0 * arSamples.size()));
+	return arSamples[rank > 0 ? rank - 1 : 0];
+}
+
+boost::int64_t BenchSuite::TimeBatch(const boost::function<void ()>& arLoop, size_t aNumLoops)
+{
+	boost::int64_t start = LatencyTrace::Now();
+	for(size_t i = 0; i < aNumLoops; ++i) arLoop();
+	return LatencyTrace::Now() - start;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
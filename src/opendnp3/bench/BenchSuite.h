@@ -0,0 +1,93 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __BENCH_SUITE_H_
+#define __BENCH_SUITE_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Runs the bench-dnp3 benchmarks and writes every measurement as a line
+	of comma separated values:
+
+		benchmark,metric,value,unit
+
+	so the output of two builds can be joined on the first two columns and
+	compared. Nothing else is written to the stream.
+*/
+class BenchSuite
+{
+public:
+
+	/**
+		@param arStream Where the measurements are written
+		@param arFilter Only benchmarks whose names contain this are run, empty runs all
+		@param aRepeat Number of timed batches per micro benchmark
+		@param aDuration How long each macro benchmark measures for in ms
+	*/
+	BenchSuite(std::ostream& arStream, const std::string& arFilter, size_t aRepeat, millis_t aDuration);
+
+	/// @return true if arName contains the filter
+	bool IsSelected(const std::string& arName) const;
+
+	millis_t GetDuration() const {
+		return mDuration;
+	}
+
+	/// Writes one measurement
+	void Report(const std::string& arBench, const std::string& arMetric, double aValue, const std::string& arUnit);
+
+	/**
+		Times arLoop, which performs aOpsPerLoop operations each call. The
+		loop is run in batches long enough for the clock to resolve and the
+		median and fastest batch are reported in ns per operation.
+	*/
+	void RunMicro(const std::string& arName, const boost::function<void ()>& arLoop, size_t aOpsPerLoop);
+
+	/// @return the aPercent percentile of arSamples, which are sorted in place
+	static boost::int64_t Percentile(std::vector<boost::int64_t>& arSamples, double aPercent);
+
+	static const boost::int64_t MIN_BATCH_US = 20000;
+
+private:
+
+	/// @return how long aNumLoops calls of arLoop take in us
+	static boost::int64_t TimeBatch(const boost::function<void ()>& arLoop, size_t aNumLoops);
+
+	std::ostream* mpStream;
+	std::string mFilter;
+	size_t mRepeat;
+	millis_t mDuration;
+};
+
+}
+}
+
+#endif
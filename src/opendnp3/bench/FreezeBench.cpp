@@ -0,0 +1,137 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "FreezeBench.h"
+
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/Database.h>
+
+#include <iomanip>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const size_t CHECK_INTERVAL = 1000;		// freezes of all of the counters between checks of the clock
+
+// mean cost of aCount operations in ns
+double NanosEach(boost::int64_t aMicros, boost::int64_t aCount)
+{
+	return (aCount > 0) ? (aMicros * 1000.0) / aCount : 0;
+}
+
+}
+
+FreezeBench::FreezeBench(size_t aNumCounters, millis_t aDuration) :
+	mNumCounters(aNumCounters),
+	mDuration(aDuration)
+{
+
+}
+
+void FreezeBench::Run(std::ostream& arStream)
+{
+	EventLog log;
+	Database db(log.GetLogger(LEV_ERROR, "bench"));
+	db.Configure(DT_COUNTER, mNumCounters, true);
+
+	millis_t phase = mDuration / 3;
+	millis_t now = 0;
+
+	// freezes of all of the counters, alternating with and without a clear
+	boost::int64_t freezes = 0;
+	boost::int64_t clears = 0;
+	boost::int64_t freezeMicros = 0;
+	boost::int64_t clearMicros = 0;
+	Timeout to(phase);
+	do {
+		boost::int64_t start = LatencyTrace::Now();
+		for(size_t i = 0; i < CHECK_INTERVAL; ++i) db.FreezeCounters(++now, false);
+		boost::int64_t mid = LatencyTrace::Now();
+		for(size_t i = 0; i < CHECK_INTERVAL; ++i) db.FreezeCounters(++now, true);
+		clearMicros += LatencyTrace::Now() - mid;
+		freezeMicros += mid - start;
+		freezes += CHECK_INTERVAL;
+		clears += CHECK_INTERVAL;
+	} while(!to.IsExpired());
+
+	// the same freeze done by copying every counter
+	boost::int64_t copies = 0;
+	boost::int64_t copyMicros = 0;
+	to.Reset(phase);
+	do {
+		boost::int64_t start = LatencyTrace::Now();
+		db.FreezeCounters(0, mNumCounters - 1, ++now, false);
+		copyMicros += LatencyTrace::Now() - start;
+		++copies;
+	} while(!to.IsExpired());
+
+	// updates to every counter, the first after each freeze sets the frozen value aside
+	boost::int64_t settled = 0;
+	boost::int64_t settledMicros = 0;
+	boost::int64_t updates = 0;
+	boost::int64_t updateMicros = 0;
+	boost::uint32_t value = 0;
+	to.Reset(phase);
+	do {
+		db.FreezeCounters(++now, false);
+		++value;
+
+		boost::int64_t start = LatencyTrace::Now();
+		{
+			Transaction t(&db);
+			for(size_t i = 0; i < mNumCounters; ++i) db.Update(Counter(value, CQ_ONLINE), i);
+		}
+		boost::int64_t mid = LatencyTrace::Now();
+		{
+			Transaction t(&db);
+			for(size_t i = 0; i < mNumCounters; ++i) db.Update(Counter(value, CQ_ONLINE), i);
+		}
+		updateMicros += LatencyTrace::Now() - mid;
+		settledMicros += mid - start;
+		settled += mNumCounters;
+		updates += mNumCounters;
+	} while(!to.IsExpired());
+
+	size_t running = mNumCounters * sizeof(CounterInfo);
+	size_t frozen = db.FrozenCounterMemory();
+
+	arStream << "counters:               " << mNumCounters << std::endl;
+	arStream << std::fixed << std::setprecision(1);
+	arStream << "freeze all (ns):        " << NanosEach(freezeMicros, freezes) << std::endl;
+	arStream << "freeze and clear (ns):  " << NanosEach(clearMicros, clears) << std::endl;
+	arStream << "copying freeze (ns):    " << NanosEach(copyMicros, copies) << std::endl;
+	arStream << "first update (ns):      " << NanosEach(settledMicros, settled) << std::endl;
+	arStream << "later update (ns):      " << NanosEach(updateMicros, updates) << std::endl;
+	arStream << "running column (bytes): " << running << std::endl;
+	arStream << "frozen column (bytes):  " << frozen << std::endl;
+	arStream << std::setprecision(2);
+	arStream << "frozen bytes/counter:   " << (mNumCounters > 0 ? static_cast<double>(frozen) / mNumCounters : 0) << std::endl;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
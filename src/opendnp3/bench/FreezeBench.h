@@ -0,0 +1,55 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __FREEZE_BENCH_H_
+#define __FREEZE_BENCH_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Freezes a database's counters over and over and reports the latency of
+	freezing all of them, with and without clearing, next to the cost of
+	copying them with a range freeze. Also reports what an update costs
+	right after a freeze and the memory held for the frozen values.
+*/
+class FreezeBench
+{
+public:
+
+	FreezeBench(size_t aNumCounters, millis_t aDuration);
+
+	/// Runs each phase for a third of the duration and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	size_t mNumCounters;
+	millis_t mDuration;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,127 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "IdleBench.h"
+
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <iomanip>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char PORT_NAME[] = "idle";
+const boost::uint16_t MASTER_ADDR = 0xFFF0; // above every outstation address
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+// bytes allocated from the heap and not yet freed, 0 where the platform can't tell us
+size_t HeapInUse()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+	return static_cast<size_t>(mallinfo().uordblks);
+#else
+	return 0;
+#endif
+}
+
+}
+
+IdleBench::IdleBench(size_t aNumStacks, boost::uint16_t aPort, FilterLevel aLevel) :
+	mNumStacks(aNumStacks),
+	mPort(aPort),
+	mLevel(aLevel)
+{
+
+}
+
+void IdleBench::Run(std::ostream& arStream)
+{
+	double normal = this->MeasureBytesPerStack(false);
+	double lightweight = this->MeasureBytesPerStack(true);
+
+	arStream << "idle stacks:        " << mNumStacks << std::endl;
+	if(normal == 0) {
+		arStream << "heap usage isn't available on this platform" << std::endl;
+		return;
+	}
+
+	arStream << std::fixed << std::setprecision(0);
+	arStream << "bytes/stack:        " << normal << std::endl;
+	arStream << "lightweight:        " << lightweight << std::endl;
+	arStream << std::setprecision(1);
+	arStream << "saved:              " << (100 * (normal - lightweight) / normal) << "%" << std::endl;
+}
+
+double IdleBench::MeasureBytesPerStack(bool aLightweight)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	RejectingCommandAcceptor acceptor;
+
+	AsyncStackManager mgr(log.GetLogger(mLevel, "bench"));
+	mgr.AddTCPServer(PORT_NAME, PhysLayerSettings(mLevel, 1000), "127.0.0.1", mPort);
+
+	SlaveStackConfig cfg;
+	cfg.link.RemoteAddr = MASTER_ADDR;
+	cfg.app.Lightweight = aLightweight;
+
+	size_t before = HeapInUse();
+	for(size_t i = 0; i < mNumStacks; ++i) {
+		std::ostringstream name;
+		name << "outstation" << i;
+		cfg.link.LocalAddr = static_cast<boost::uint16_t>(i + 1);
+		mgr.AddSlave(PORT_NAME, name.str(), mLevel, &acceptor, cfg);
+	}
+	size_t after = HeapInUse();
+
+	mgr.Shutdown();
+
+	return (mNumStacks > 0) ? static_cast<double>(after - before) / mNumStacks : 0;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,62 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __IDLE_BENCH_H_
+#define __IDLE_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Adds thousands of outstations to a listening TCP server that no master
+	connects to, once with the default configuration and once with
+	AppConfig::Lightweight, and reports the heap used per idle stack.
+*/
+class IdleBench
+{
+public:
+
+	/// Outstations are given link addresses 1 to N, the rest are reserved
+	static const size_t MAX_STACKS = 0xFFEF;
+
+	IdleBench(size_t aNumStacks, boost::uint16_t aPort, FilterLevel aLevel);
+
+	/// Runs both configurations and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	/// @return heap bytes in use per stack after adding the stacks
+	double MeasureBytesPerStack(bool aLightweight);
+
+	size_t mNumStacks;
+	boost::uint16_t mPort;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,277 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "MacroBenchmarks.h"
+
+#include "BenchSuite.h"
+
+#include <opendnp3/APL/AtomicOps.h>
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <boost/asio.hpp>
+
+#include <string>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char CLIENT_NAME[] = "client";
+const char SERVER_NAME[] = "server";
+const char MASTER_NAME[] = "master";
+const char SLAVE_NAME[] = "slave";
+const char SEGMENT_NAME[] = "bench-dnp3";
+const size_t NUM_POINTS = 100;
+const size_t MAX_BATCHES_IN_FLIGHT = 4;	// keeps the slave's event buffer from overflowing
+const millis_t CONNECT_TIMEOUT = 10000;
+const size_t MAX_SAMPLES = 1000000;
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+/**
+	Counts the analogs the master publishes and, while recording, samples
+	either the time between responses or the age of each analog. The
+	samples are only written by the master's thread, so they can be read
+	once the stack manager is shut down.
+*/
+class SamplingDataObserver : public IDataObserver
+{
+public:
+
+	SamplingDataObserver(boost::int64_t aOrigin, bool aSampleAge) :
+		mOrigin(aOrigin),
+		mSampleAge(aSampleAge),
+		mRecording(0),
+		mNumAnalogs(0),
+		mNumResponses(0),
+		mLastEnd(0)
+	{
+		mSamples.reserve(MAX_SAMPLES);
+	}
+
+	void SetRecording(bool aRecording) {
+		AtomicAddRelaxed(&mRecording, aRecording ? 1 : -1);
+	}
+
+	boost::int64_t NumAnalogs() const {
+		return AtomicLoadRelaxed(&mNumAnalogs);
+	}
+
+	boost::int64_t NumResponses() const {
+		return AtomicLoadRelaxed(&mNumResponses);
+	}
+
+	std::vector<boost::int64_t> mSamples;
+
+private:
+
+	void _Start() {}
+
+	void _End() {
+		AtomicAddRelaxed(&mNumResponses, 1);
+		boost::int64_t now = LatencyTrace::Now();
+		if(!mSampleAge && mLastEnd != 0) this->Sample(now - mLastEnd);
+		mLastEnd = now;
+	}
+
+	void _Update(const Binary&, size_t) {}
+	void _Update(const Analog& arPoint, size_t) {
+		// the startup integrity poll reports zeros, which aren't timestamps
+		if(mSampleAge && arPoint.GetValue() <= 0) return;
+		AtomicAddRelaxed(&mNumAnalogs, 1);
+		if(mSampleAge) this->Sample(LatencyTrace::Now() - mOrigin - static_cast<boost::int64_t>(arPoint.GetValue()));
+	}
+	void _Update(const Counter&, size_t) {}
+	void _Update(const ControlStatus&, size_t) {}
+	void _Update(const SetpointStatus&, size_t) {}
+
+	void Sample(boost::int64_t aValue) {
+		if(AtomicLoadRelaxed(&mRecording) > 0 && mSamples.size() < MAX_SAMPLES) mSamples.push_back(aValue);
+	}
+
+	boost::int64_t mOrigin;
+	bool mSampleAge;
+	atomic_int64_t mRecording;
+	atomic_int64_t mNumAnalogs;
+	atomic_int64_t mNumResponses;
+	boost::int64_t mLastEnd;
+};
+
+// sleeps until arObserver has published aTarget analogs, @throw Exception if it takes too long
+void WaitForAnalogs(const SamplingDataObserver& arObserver, boost::int64_t aTarget, const std::string& arWhat)
+{
+	Timeout to(CONNECT_TIMEOUT);
+	while(arObserver.NumAnalogs() < aTarget) {
+		if(to.IsExpired()) throw Exception(LOCATION, "Timed out waiting for " + arWhat);
+		Thread::SleepFor(1);
+	}
+}
+
+double PerSecond(boost::int64_t aCount, boost::int64_t aMicros)
+{
+	return (aMicros > 0) ? aCount * 1000000.0 / aMicros : 0;
+}
+
+// connects the stacks over loopback TCP on aPort, or over a shared memory segment if aPort is 0
+IDataObserver* AddStacks(AsyncStackManager& arMgr, boost::uint16_t aPort, FilterLevel aLevel, millis_t aIntegrityRate, IDataObserver* apObserver, ICommandAcceptor* apAcceptor)
+{
+	if(aPort == 0) {
+		arMgr.AddSharedMemoryClient(CLIENT_NAME, PhysLayerSettings(aLevel, 100), SEGMENT_NAME);
+		arMgr.AddSharedMemoryServer(SERVER_NAME, PhysLayerSettings(aLevel, 100), SEGMENT_NAME);
+	} else {
+		arMgr.AddTCPClient(CLIENT_NAME, PhysLayerSettings(aLevel, 1000), "127.0.0.1", aPort);
+		arMgr.AddTCPServer(SERVER_NAME, PhysLayerSettings(aLevel, 1000), "127.0.0.1", aPort);
+	}
+
+	MasterStackConfig master;
+	master.master.IntegrityRate = aIntegrityRate;
+	master.master.DoUnsolOnStartup = true;
+	master.master.EnableUnsol = true;
+	master.master.UnsolClassMask = PC_ALL_EVENTS;
+	arMgr.AddMaster(CLIENT_NAME, MASTER_NAME, aLevel, apObserver, master);
+
+	SlaveStackConfig slave;
+	slave.slave.mDisableUnsol = false;
+	slave.slave.mUnsolPackDelay = 0;
+	slave.device = DeviceTemplate(0, NUM_POINTS);
+	return arMgr.AddSlave(SERVER_NAME, SLAVE_NAME, aLevel, apAcceptor, slave);
+}
+
+void RunPolls(BenchSuite& arSuite, const std::string& arName, boost::uint16_t aPort, FilterLevel aLevel)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	SamplingDataObserver observer(0, false);
+	RejectingCommandAcceptor acceptor;
+
+	AsyncStackManager mgr(log.GetLogger(aLevel, "bench"));
+	AddStacks(mgr, aPort, aLevel, 1, &observer, &acceptor); // poll back to back
+	WaitForAnalogs(observer, 10 * static_cast<boost::int64_t>(NUM_POINTS), "the first polls");
+
+	boost::int64_t polls = observer.NumResponses();
+	boost::int64_t start = LatencyTrace::Now();
+	observer.SetRecording(true);
+	Thread::SleepFor(arSuite.GetDuration());
+	observer.SetRecording(false);
+	polls = observer.NumResponses() - polls;
+	boost::int64_t elapsed = LatencyTrace::Now() - start;
+
+	mgr.Shutdown();
+
+	arSuite.Report(arName, "rate", PerSecond(polls, elapsed), "polls/s");
+	arSuite.Report(arName, "points", PerSecond(polls * NUM_POINTS, elapsed), "points/s");
+	arSuite.Report(arName, "p50", static_cast<double>(BenchSuite::Percentile(observer.mSamples, 50)), "us");
+	arSuite.Report(arName, "p99", static_cast<double>(BenchSuite::Percentile(observer.mSamples, 99)), "us");
+}
+
+void RunEvents(BenchSuite& arSuite, const std::string& arName, boost::uint16_t aPort, FilterLevel aLevel)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	boost::int64_t origin = LatencyTrace::Now();
+	SamplingDataObserver observer(origin, true);
+	RejectingCommandAcceptor acceptor;
+
+	AsyncStackManager mgr(log.GetLogger(aLevel, "bench"));
+	IDataObserver* pSlave = AddStacks(mgr, aPort, aLevel, -1, &observer, &acceptor); // only the startup integrity poll
+
+	// every batch changes all the analogs to the time it was sent, in us since origin
+	boost::int64_t sent = 0;
+	boost::int64_t last = 0;
+	boost::int64_t received = 0;
+	boost::int64_t start = 0;
+	Timeout run(CONNECT_TIMEOUT);
+	bool recording = false;
+	while(!recording || !run.IsExpired()) {
+		if(sent - observer.NumAnalogs() >= static_cast<boost::int64_t>(MAX_BATCHES_IN_FLIGHT * NUM_POINTS)) {
+			Thread::SleepFor(0);
+			continue;
+		}
+
+		boost::int64_t stamp = LatencyTrace::Now() - origin;
+		if(stamp <= last) stamp = last + 1;
+		last = stamp;
+		{
+			Transaction tr(pSlave);
+			for(size_t i = 0; i < NUM_POINTS; ++i) pSlave->Update(Analog(static_cast<double>(stamp), AQ_ONLINE), i);
+		}
+		sent += NUM_POINTS;
+
+		// the first batch waits for the connection, after that the clock starts
+		if(!recording) {
+			WaitForAnalogs(observer, sent, "the first events");
+			run.Reset(arSuite.GetDuration());
+			received = observer.NumAnalogs();
+			start = LatencyTrace::Now();
+			observer.SetRecording(true);
+			recording = true;
+		}
+	}
+
+	observer.SetRecording(false);
+	received = observer.NumAnalogs() - received;
+	boost::int64_t elapsed = LatencyTrace::Now() - start;
+
+	mgr.Shutdown();
+
+	arSuite.Report(arName, "rate", PerSecond(received, elapsed), "events/s");
+	arSuite.Report(arName, "p50", static_cast<double>(BenchSuite::Percentile(observer.mSamples, 50)), "us");
+	arSuite.Report(arName, "p99", static_cast<double>(BenchSuite::Percentile(observer.mSamples, 99)), "us");
+}
+
+}
+
+void RunMacroBenchmarks(BenchSuite& arSuite, boost::uint16_t aPort, FilterLevel aLevel)
+{
+	if(arSuite.IsSelected("macro.tcp_poll")) RunPolls(arSuite, "macro.tcp_poll", aPort, aLevel);
+	if(arSuite.IsSelected("macro.tcp_events")) RunEvents(arSuite, "macro.tcp_events", aPort + 1, aLevel);
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+	if(arSuite.IsSelected("macro.shm_poll")) RunPolls(arSuite, "macro.shm_poll", 0, aLevel);
+	if(arSuite.IsSelected("macro.shm_events")) RunEvents(arSuite, "macro.shm_events", 0, aLevel);
+#endif
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
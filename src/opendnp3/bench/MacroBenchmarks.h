@@ -0,0 +1,51 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __MACRO_BENCHMARKS_H_
+#define __MACRO_BENCHMARKS_H_
+
+#include <opendnp3/APL/LogTypes.h>
+
+#include <boost/cstdint.hpp>
+
+namespace apl
+{
+namespace dnp
+{
+
+class BenchSuite;
+
+/**
+	Runs a master and slave pair in this process, connected over loopback
+	TCP starting at aPort, for each of:
+
+	- macro.tcp_poll    the master integrity polls back to back, reported
+	                    as polls/s and the p50/p99 time between responses
+	- macro.tcp_events  the slave reports changes as unsolicited events,
+	                    reported as events/s and the p50/p99 latency from
+	                    the slave's update to the master's observer
+	- macro.shm_poll    macro.tcp_poll over a PhysicalLayerAsyncSharedMemory
+	                    pair instead of TCP, where local sockets exist
+	- macro.shm_events  macro.tcp_events over shared memory
+*/
+void RunMacroBenchmarks(BenchSuite& arSuite, boost::uint16_t aPort, FilterLevel aLevel);
+
+}
+}
+
+#endif
@@ -0,0 +1,394 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "MicroBenchmarks.h"
+
+#include "BenchSuite.h"
+
+#include <opendnp3/APL/ChangeBuffer.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/LockBoost.h>
+#include <opendnp3/APL/Log.h>
+
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/Database.h>
+#include <opendnp3/DNP3/DeviceTemplate.h>
+#include <opendnp3/DNP3/DNPCrc.h>
+#include <opendnp3/DNP3/IFrameSink.h>
+#include <opendnp3/DNP3/LinkFrame.h>
+#include <opendnp3/DNP3/LinkLayerReceiver.h>
+#include <opendnp3/DNP3/ResponseContext.h>
+#include <opendnp3/DNP3/ResponseLoader.h>
+#include <opendnp3/DNP3/SharedDatabase.h>
+#include <opendnp3/DNP3/SlaveConfig.h>
+#include <opendnp3/DNP3/SlaveEventBuffer.h>
+#include <opendnp3/DNP3/SlaveResponseTypes.h>
+#include <opendnp3/DNP3/VtoReader.h>
+
+#include <boost/bind.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const size_t NUM_POINTS = 100;
+const size_t CRC_BLOCKS = 16;
+const size_t NUM_FRAMES = 16;
+
+// discards measurements so only the code under test is timed
+class NullDataObserver : public IDataObserver
+{
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {}
+	void _Update(const Analog&, size_t) {}
+	void _Update(const Counter&, size_t) {}
+	void _Update(const ControlStatus&, size_t) {}
+	void _Update(const SetpointStatus&, size_t) {}
+};
+
+class CountingFrameSink : public IFrameSink
+{
+public:
+	CountingFrameSink() : mNumFrames(0) {}
+
+	size_t mNumFrames;
+
+	void Ack(bool, bool, boost::uint16_t, boost::uint16_t) {}
+	void Nack(bool, bool, boost::uint16_t, boost::uint16_t) {}
+	void LinkStatus(bool, bool, boost::uint16_t, boost::uint16_t) {}
+	void NotSupported (bool, bool, boost::uint16_t, boost::uint16_t) {}
+	void TestLinkStatus(bool, bool, boost::uint16_t, boost::uint16_t) {}
+	void ResetLinkStates(bool, boost::uint16_t, boost::uint16_t) {}
+	void RequestLinkStatus(bool, boost::uint16_t, boost::uint16_t) {}
+	void ConfirmedUserData(bool, bool, boost::uint16_t, boost::uint16_t, const boost::uint8_t*, size_t) {}
+	void UnconfirmedUserData(bool, boost::uint16_t, boost::uint16_t, const boost::uint8_t*, size_t) {
+		++mNumFrames;
+	}
+};
+
+class CrcBench
+{
+public:
+	CrcBench() : mSum(0) {
+		for(size_t i = 0; i < sizeof(mBuffer); ++i) mBuffer[i] = static_cast<boost::uint8_t>(i);
+	}
+
+	void Loop() {
+		for(size_t i = 0; i < CRC_BLOCKS; ++i) mSum += DNPCrc::CalcCrc(mBuffer + i * 16, 16);
+	}
+
+	unsigned int mSum;	// consumed so the calls can't be optimized away
+
+private:
+	boost::uint8_t mBuffer[CRC_BLOCKS * 16];
+};
+
+class LinkParseBench
+{
+public:
+	LinkParseBench(Logger* apLogger) : mReceiver(apLogger, &mSink) {
+		boost::uint8_t data[250];
+		for(size_t i = 0; i < sizeof(data); ++i) data[i] = static_cast<boost::uint8_t>(i);
+
+		LinkFrame frame;
+		frame.FormatUnconfirmedUserData(true, 1, 1024, data, sizeof(data));
+		for(size_t i = 0; i < NUM_FRAMES; ++i) mStream.insert(mStream.end(), frame.GetBuffer(), frame.GetBuffer() + frame.GetSize());
+	}
+
+	void Loop() {
+		size_t pos = 0;
+		while(pos < mStream.size()) {
+			size_t num = mStream.size() - pos;
+			if(num > mReceiver.NumWriteBytes()) num = mReceiver.NumWriteBytes();
+			memcpy(mReceiver.WriteBuff(), &mStream[pos], num);
+			mReceiver.OnRead(num);
+			pos += num;
+		}
+	}
+
+	CountingFrameSink mSink;
+
+private:
+	LinkLayerReceiver mReceiver;
+	std::vector<boost::uint8_t> mStream;
+};
+
+// an outstation with NUM_POINTS of each static type answering class 0 reads
+class OutstationFixture
+{
+public:
+	OutstationFixture(Logger* apLogger) :
+		mDatabase(apLogger),
+		mTypes(mConfig),
+		mContext(apLogger, &mDatabase, &mTypes, mConfig.mEventMaxConfig)
+	{
+		mDatabase.Configure(DT_BINARY, NUM_POINTS);
+		mDatabase.Configure(DT_ANALOG, NUM_POINTS);
+		mDatabase.Configure(DT_COUNTER, NUM_POINTS);
+
+		boost::uint8_t read[] = { 0xC0, FC_READ, 60, 1, QC_ALL_OBJ };
+		mRead.Write(read, sizeof(read));
+		mRead.Interpret();
+	}
+
+	void Loop() {
+		mContext.Configure(mRead);
+		do {
+			mContext.LoadResponse(mResponse);
+		} while(!mContext.IsComplete());
+	}
+
+	Database mDatabase;
+	SlaveConfig mConfig;
+	SlaveResponseTypes mTypes;
+	ResponseContext mContext;
+	APDU mRead;
+	APDU mResponse;
+};
+
+// a response carrying only the analogs of an OutstationFixture
+class AnalogResponseBench
+{
+public:
+	AnalogResponseBench(Logger* apLogger) : mpLogger(apLogger), mVtoReader(apLogger) {
+		Database db(apLogger);
+		db.Configure(DT_ANALOG, NUM_POINTS);
+		SlaveConfig cfg;
+		SlaveResponseTypes types(cfg);
+		ResponseContext rc(apLogger, &db, &types, cfg.mEventMaxConfig);
+
+		boost::uint8_t read[] = { 0xC0, FC_READ, 30, 0, QC_ALL_OBJ };
+		APDU request;
+		request.Write(read, sizeof(read));
+		request.Interpret();
+
+		rc.Configure(request);
+		rc.LoadResponse(mResponse);
+		mBytes.assign(mResponse.GetBuffer(), mResponse.GetBuffer() + mResponse.Size());
+		this->Interpret();
+	}
+
+	void Interpret() {
+		mResponse.Write(&mBytes[0], mBytes.size());
+		mResponse.Interpret();
+	}
+
+	void Load() {
+		ResponseLoader loader(mpLogger, &mObserver, &mVtoReader);
+		for(HeaderReadIterator hdr = mResponse.BeginRead(); !hdr.IsEnd(); ++hdr) loader.Process(hdr);
+	}
+
+private:
+	Logger* mpLogger;
+	NullDataObserver mObserver;
+	VtoReader mVtoReader;
+	std::vector<boost::uint8_t> mBytes;
+	APDU mResponse;
+};
+
+class EventBufferBench
+{
+public:
+	EventBufferBench() : mBuffer(EventMaxConfig()) {}
+
+	void Loop() {
+		for(size_t i = 0; i < NUM_POINTS; ++i) mBuffer.Update(Analog(static_cast<double>(i), AQ_ONLINE), PC_CLASS_1, i);
+		mBuffer.Select(PC_CLASS_1);
+		AnalogEventIter itr;
+		mBuffer.Begin(itr);
+		size_t num = mBuffer.NumSelected(BT_ANALOG);
+		for(size_t i = 0; i < num; ++i, ++itr) itr->mWritten = true;
+		mBuffer.ClearWritten();
+	}
+
+private:
+	SlaveEventBuffer mBuffer;
+};
+
+class ChangeBufferBench
+{
+public:
+	void Loop() {
+		{
+			Transaction t(&mBuffer);
+			for(size_t i = 0; i < NUM_POINTS; ++i) mBuffer.Update(Analog(static_cast<double>(i), AQ_ONLINE), i);
+		}
+		mBuffer.FlushUpdates(&mObserver);
+	}
+
+private:
+	ChangeBuffer<SigLock> mBuffer;
+	NullDataObserver mObserver;
+};
+
+// drains every class 1 analog event from a session's buffer
+void DrainEvents(SlaveEventBuffer* apBuffer)
+{
+	apBuffer->Select(PC_CLASS_1);
+	AnalogEventIter itr;
+	apBuffer->Begin(itr);
+	size_t num = apBuffer->NumSelected(BT_ANALOG);
+	for(size_t i = 0; i < num; ++i, ++itr) itr->mWritten = true;
+	apBuffer->ClearWritten();
+}
+
+// NUM_POINTS analog changes reported to aNumSessions slave sessions, each with its own database
+class SeparateIngestBench
+{
+public:
+	SeparateIngestBench(Logger* apLogger, size_t aNumSessions) : mValue(0) {
+		for(size_t i = 0; i < aNumSessions; ++i) {
+			Session* pSession = new Session(apLogger);
+			mSessions.push_back(pSession);
+		}
+	}
+
+	~SeparateIngestBench() {
+		for(size_t i = 0; i < mSessions.size(); ++i) delete mSessions[i];
+	}
+
+	void Loop() {
+		++mValue;
+		for(size_t s = 0; s < mSessions.size(); ++s) {
+			Session* pSession = mSessions[s];
+			{
+				Transaction t(&pSession->mChanges);
+				for(size_t i = 0; i < NUM_POINTS; ++i) pSession->mChanges.Update(Analog(mValue + i, AQ_ONLINE), i);
+			}
+			pSession->mChanges.FlushUpdates(&pSession->mDatabase);
+			DrainEvents(&pSession->mEvents);
+		}
+	}
+
+private:
+
+	class Session
+	{
+	public:
+		Session(Logger* apLogger) : mDatabase(apLogger), mEvents(EventMaxConfig()) {
+			mDatabase.Configure(DT_ANALOG, NUM_POINTS);
+			mDatabase.SetClass(DT_ANALOG, PC_CLASS_1);
+			mDatabase.SetEventBuffer(&mEvents);
+		}
+
+		ChangeBuffer<SigLock> mChanges;
+		Database mDatabase;
+		SlaveEventBuffer mEvents;
+	};
+
+	double mValue;
+	std::vector<Session*> mSessions;
+};
+
+// the same changes reported once to a SharedDatabase serving aNumSessions slave sessions
+class SharedIngestBench
+{
+public:
+	SharedIngestBench(Logger* apLogger, size_t aNumSessions) :
+		mValue(0),
+		mShared(apLogger, NULL, DeviceTemplate(0, NUM_POINTS))
+	{
+		mShared.GetDatabase()->SetClass(DT_ANALOG, PC_CLASS_1);
+		for(size_t i = 0; i < aNumSessions; ++i) {
+			SlaveEventBuffer* pBuffer = new SlaveEventBuffer(EventMaxConfig());
+			mBuffers.push_back(pBuffer);
+			mShared.AddSession(pBuffer, FunctionVoidZero());
+		}
+	}
+
+	~SharedIngestBench() {
+		for(size_t i = 0; i < mBuffers.size(); ++i) {
+			mShared.RemoveSession(mBuffers[i]);
+			delete mBuffers[i];
+		}
+	}
+
+	void Loop() {
+		++mValue;
+		IDataObserver* pObserver = mShared.GetDataObserver();
+		{
+			Transaction t(pObserver);
+			for(size_t i = 0; i < NUM_POINTS; ++i) pObserver->Update(Analog(mValue + i, AQ_ONLINE), i);
+		}
+		mShared.Flush();
+		for(size_t i = 0; i < mBuffers.size(); ++i) DrainEvents(mBuffers[i]);
+	}
+
+private:
+	double mValue;
+	SharedDatabase mShared;
+	std::vector<SlaveEventBuffer*> mBuffers;
+};
+
+std::string IngestName(const char* apMode, size_t aNumSessions)
+{
+	std::ostringstream oss;
+	oss << "micro.ingest_" << apMode << "_" << aNumSessions;
+	return oss.str();
+}
+
+}
+
+void RunMicroBenchmarks(BenchSuite& arSuite)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_ERROR, "bench");
+
+	CrcBench crc;
+	arSuite.RunMicro("micro.crc", boost::bind(&CrcBench::Loop, &crc), CRC_BLOCKS);
+
+	LinkParseBench parse(pLogger);
+	arSuite.RunMicro("micro.link_parse", boost::bind(&LinkParseBench::Loop, &parse), NUM_FRAMES);
+
+	AnalogResponseBench response(pLogger);
+	arSuite.RunMicro("micro.apdu_interpret", boost::bind(&AnalogResponseBench::Interpret, &response), 1);
+
+	OutstationFixture outstation(pLogger);
+	arSuite.RunMicro("micro.response_context", boost::bind(&OutstationFixture::Loop, &outstation), 1);
+
+	EventBufferBench events;
+	arSuite.RunMicro("micro.event_buffer", boost::bind(&EventBufferBench::Loop, &events), NUM_POINTS);
+
+	ChangeBufferBench changes;
+	arSuite.RunMicro("micro.change_buffer", boost::bind(&ChangeBufferBench::Loop, &changes), NUM_POINTS);
+
+	arSuite.RunMicro("micro.response_loader", boost::bind(&AnalogResponseBench::Load, &response), NUM_POINTS);
+
+	const size_t SESSIONS[] = { 1, 8 };
+	for(size_t i = 0; i < sizeof(SESSIONS) / sizeof(SESSIONS[0]); ++i) {
+		SeparateIngestBench separate(pLogger, SESSIONS[i]);
+		arSuite.RunMicro(IngestName("separate", SESSIONS[i]), boost::bind(&SeparateIngestBench::Loop, &separate), NUM_POINTS);
+
+		SharedIngestBench shared(pLogger, SESSIONS[i]);
+		arSuite.RunMicro(IngestName("shared", SESSIONS[i]), boost::bind(&SharedIngestBench::Loop, &shared), NUM_POINTS);
+	}
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,48 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __MICRO_BENCHMARKS_H_
+#define __MICRO_BENCHMARKS_H_
+
+namespace apl
+{
+namespace dnp
+{
+
+class BenchSuite;
+
+/**
+	Runs the single threaded benchmarks of the parsing, encoding and
+	buffering code that every fragment passes through:
+
+	- micro.crc              DNPCrc over 16 byte link blocks
+	- micro.link_parse       LinkLayerReceiver splitting a stream into frames
+	- micro.apdu_interpret   APDU::Interpret of a 100 analog response
+	- micro.response_context ResponseContext loading an integrity response
+	- micro.event_buffer     SlaveEventBuffer update, select and clear
+	- micro.change_buffer    ChangeBuffer transactions flushed to an observer
+	- micro.response_loader  ResponseLoader publishing a 100 analog response
+	- micro.ingest_separate_N 100 analog changes reported to N slaves with their own databases
+	- micro.ingest_shared_N  the same changes reported once to a SharedDatabase with N sessions
+*/
+void RunMicroBenchmarks(BenchSuite& arSuite);
+
+}
+}
+
+#endif
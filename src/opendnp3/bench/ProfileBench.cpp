@@ -0,0 +1,214 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "ProfileBench.h"
+
+#include <opendnp3/APL/AtomicOps.h>
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/HandlerProfiler.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const size_t NUM_POINTS = 10;
+const size_t NUM_TOP = 5;
+const millis_t CONNECT_TIMEOUT_PER_SESSION = 20;
+
+class CountingDataObserver : public IDataObserver
+{
+public:
+	CountingDataObserver() : mNumUpdates(0) {}
+
+	boost::int64_t NumUpdates() const {
+		return AtomicLoadRelaxed(&mNumUpdates);
+	}
+
+private:
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Analog&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Counter&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const ControlStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+
+	atomic_int64_t mNumUpdates;
+};
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+std::string Name(const char* apPrefix, size_t aIndex)
+{
+	std::ostringstream oss;
+	oss << apPrefix << aIndex;
+	return oss.str();
+}
+
+double Per(double aValue, double aCount)
+{
+	return (aCount > 0) ? aValue / aCount : 0;
+}
+
+}
+
+ProfileBench::ProfileBench(size_t aNumSessions, boost::uint16_t aBasePort, millis_t aPollRate, millis_t aDuration, FilterLevel aLevel) :
+	mNumSessions(aNumSessions),
+	mBasePort(aBasePort),
+	mPollRate(aPollRate),
+	mDuration(aDuration),
+	mLevel(aLevel)
+{
+
+}
+
+void ProfileBench::Run(std::ostream& arStream)
+{
+	arStream << "sessions:             " << mNumSessions << std::endl;
+	arStream << "poll rate ms:         " << mPollRate << ", " << mPollRate / 10 << " for master0" << std::endl;
+
+	Result off = this->Measure(false, arStream);
+	this->Report(arStream, "profiling off", off);
+	Result on = this->Measure(true, arStream);
+	this->Report(arStream, "profiling on", on);
+
+	double offPerFrame = Per(off.cpu, static_cast<double>(off.frames));
+	double onPerFrame = Per(on.cpu, static_cast<double>(on.frames));
+	arStream << std::fixed << std::setprecision(1);
+	arStream << "overhead %:           " << Per(100 * (onPerFrame - offPerFrame), offPerFrame) << std::endl;
+	arStream.unsetf(std::ios_base::floatfield);
+}
+
+ProfileBench::Result ProfileBench::Measure(bool aProfile, std::ostream& arStream)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	CountingDataObserver observer;
+	RejectingCommandAcceptor acceptor;
+	Result result;
+
+	AsyncStackManager masters(log.GetLogger(mLevel, "masters"), TCPB_ASIO);
+	AsyncStackManager slaves(log.GetLogger(mLevel, "slaves"), TCPB_ASIO);
+
+	SlaveStackConfig slave;
+	slave.device = DeviceTemplate(0, NUM_POINTS);
+
+	MasterStackConfig master;
+	master.master.DoUnsolOnStartup = false;
+
+	for(size_t i = 0; i < mNumSessions; ++i) {
+		boost::uint16_t port = static_cast<boost::uint16_t>(mBasePort + i);
+		master.master.IntegrityRate = (i == 0) ? mPollRate / 10 : mPollRate;
+		slaves.AddTCPServer(Name("server", i), PhysLayerSettings(mLevel, 1000), "127.0.0.1", port);
+		slaves.AddSlave(Name("server", i), Name("slave", i), mLevel, &acceptor, slave);
+		masters.AddTCPClient(Name("client", i), PhysLayerSettings(mLevel, 1000), "127.0.0.1", port);
+		masters.AddMaster(Name("client", i), Name("master", i), mLevel, &observer, master);
+	}
+
+	// wait for the startup integrity polls, so connecting isn't measured
+	Timeout to(CONNECT_TIMEOUT_PER_SESSION * mNumSessions + 10000);
+	while(observer.NumUpdates() < static_cast<boost::int64_t>(mNumSessions * NUM_POINTS)) {
+		if(to.IsExpired()) throw Exception(LOCATION, "Timed out waiting for the sessions to connect");
+		Thread::SleepFor(10);
+	}
+
+	MetricsRegistry* pMetrics = log.GetMetrics();
+	std::vector<MetricCounter*> frames;
+	for(size_t i = 0; i < mNumSessions; ++i) {
+		frames.push_back(pMetrics->GetCounter(Name("client", i), "link_rx_frames"));
+		frames.push_back(pMetrics->GetCounter(Name("server", i), "link_rx_frames"));
+	}
+
+	masters.SetHandlerProfiling(aProfile);
+	boost::int64_t frameStart = 0;
+	for(size_t i = 0; i < frames.size(); ++i) frameStart -= frames[i]->Get();
+	std::clock_t cpuStart = std::clock();
+
+	Thread::SleepFor(mDuration);
+
+	std::clock_t cpuStop = std::clock();
+	result.frames = frameStart;
+	for(size_t i = 0; i < frames.size(); ++i) result.frames += frames[i]->Get();
+	result.cpu = static_cast<double>(cpuStop - cpuStart) / CLOCKS_PER_SEC;
+
+	if(aProfile) {
+		// both managers log to the same registry, so the masters see every stack
+		arStream << "busiest stacks:" << std::endl;
+		HandlerProfiler::WriteReport(*pMetrics, NUM_TOP, arStream);
+	}
+	masters.SetHandlerProfiling(false);
+
+	masters.Shutdown();
+	slaves.Shutdown();
+
+	return result;
+}
+
+void ProfileBench::Report(std::ostream& arStream, const char* apName, const Result& arResult)
+{
+	arStream << apName << ":" << std::endl;
+	arStream << "  frames:             " << arResult.frames << std::endl;
+	arStream << std::fixed << std::setprecision(2);
+	arStream << "  cpu s:              " << arResult.cpu << std::endl;
+	arStream << "  cpu us/frame:       " << Per(arResult.cpu * 1000000, static_cast<double>(arResult.frames)) << std::endl;
+	arStream.unsetf(std::ios_base::floatfield);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
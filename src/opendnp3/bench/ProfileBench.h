@@ -0,0 +1,73 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PROFILE_BENCH_H_
+#define __PROFILE_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Polls outstations over loopback TCP, one of them ten times as often as
+	the rest, once with handler profiling off and once with it on. Reports
+	the process CPU per link frame for both, so the cost of leaving the
+	profiler on shows, and the busiest stacks it found.
+*/
+class ProfileBench
+{
+public:
+
+	/// Each session needs its own TCP port above the base port
+	static const size_t MAX_SESSIONS = 10000;
+
+	ProfileBench(size_t aNumSessions, boost::uint16_t aBasePort, millis_t aPollRate, millis_t aDuration, FilterLevel aLevel);
+
+	/// Runs without and then with profiling and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	struct Result {
+		Result() : frames(0), cpu(0) {}
+
+		boost::int64_t frames;
+		double cpu;
+	};
+
+	Result Measure(bool aProfile, std::ostream& arStream);
+
+	void Report(std::ostream& arStream, const char* apName, const Result& arResult);
+
+	size_t mNumSessions;
+	boost::uint16_t mBasePort;
+	millis_t mPollRate;
+	millis_t mDuration;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,131 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "ReadBench.h"
+
+#include "AllocBench.h"
+
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/Database.h>
+#include <opendnp3/DNP3/ResponseContext.h>
+#include <opendnp3/DNP3/SlaveConfig.h>
+#include <opendnp3/DNP3/SlaveResponseTypes.h>
+
+#include <iomanip>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const size_t HEADER_SIZE = 7;			// group, variation, qualifier and 2 octet start/stop
+const size_t CHECK_INTERVAL = 100;		// requests between checks of the clock
+
+double PerSecond(boost::int64_t aCount, double aSeconds)
+{
+	return (aSeconds > 0) ? aCount / aSeconds : 0;
+}
+
+double Per(boost::int64_t aValue, boost::int64_t aCount)
+{
+	return (aCount > 0) ? static_cast<double>(aValue) / aCount : 0;
+}
+
+}
+
+ReadBench::ReadBench(size_t aNumPoints, millis_t aDuration) :
+	mNumPoints(aNumPoints),
+	mDuration(aDuration)
+{
+
+}
+
+void ReadBench::Run(std::ostream& arStream)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_ERROR, "bench");
+
+	Database db(pLogger);
+	db.Configure(DT_ANALOG, mNumPoints, true);
+
+	SlaveConfig cfg;
+	SlaveResponseTypes types(cfg);
+	ResponseContext rc(pLogger, &db, &types, cfg.mEventMaxConfig);
+
+	// read every other range of analogs until the points or the fragment run out
+	size_t maxHeaders = (DEFAULT_FRAG_SIZE - 2) / HEADER_SIZE;
+	std::vector<boost::uint8_t> request;
+	request.push_back(0xC0);
+	request.push_back(FC_READ);
+	size_t numHeaders = 0;
+	for(size_t start = 0; start + POINTS_PER_RANGE <= mNumPoints && numHeaders < maxHeaders; start += 2 * POINTS_PER_RANGE) {
+		size_t stop = start + POINTS_PER_RANGE - 1;
+		boost::uint8_t hdr[HEADER_SIZE] = { 30, 1, QC_2B_START_STOP,
+		                                     static_cast<boost::uint8_t>(start & 0xFF), static_cast<boost::uint8_t>(start >> 8),
+		                                     static_cast<boost::uint8_t>(stop & 0xFF), static_cast<boost::uint8_t>(stop >> 8)
+		                                   };
+		request.insert(request.end(), hdr, hdr + HEADER_SIZE);
+		++numHeaders;
+	}
+
+	APDU read;
+	read.Write(&request[0], request.size());
+	read.Interpret();
+	APDU rsp;
+
+	boost::int64_t requests = 0;
+	boost::int64_t fragments = 0;
+	boost::int64_t allocStart = AllocBench::NumAllocations();
+	boost::int64_t start = LatencyTrace::Now();
+
+	Timeout to(mDuration);
+	do {
+		for(size_t i = 0; i < CHECK_INTERVAL; ++i) {
+			rc.Configure(read);
+			do {
+				rc.LoadResponse(rsp);
+				++fragments;
+			} while(!rc.IsComplete());
+			++requests;
+		}
+	} while(!to.IsExpired());
+
+	boost::int64_t allocs = AllocBench::NumAllocations() - allocStart;
+	double elapsed = (LatencyTrace::Now() - start) / 1000000.0;
+
+	arStream << "ranged headers:     " << numHeaders << " of " << POINTS_PER_RANGE << " analogs" << std::endl;
+	arStream << "requests:           " << requests << std::endl;
+	arStream << std::fixed << std::setprecision(1);
+	arStream << "requests/s:         " << PerSecond(requests, elapsed) << std::endl;
+	arStream << "fragments/request:  " << Per(fragments, requests) << std::endl;
+	arStream << std::setprecision(4);
+	arStream << "allocs/request:     " << Per(allocs, requests) << std::endl;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,58 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __READ_BENCH_H_
+#define __READ_BENCH_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Drives a slave's ResponseContext with a READ request made of many small
+	ranged analog headers, as a master reading scattered points would send,
+	and reports how many requests per second it can answer along with the
+	heap allocations made per request.
+*/
+class ReadBench
+{
+public:
+
+	/// Points covered by each ranged header in the request
+	static const size_t POINTS_PER_RANGE = 4;
+
+	ReadBench(size_t aNumPoints, millis_t aDuration);
+
+	/// Answers the request repeatedly for the duration and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	size_t mNumPoints;
+	millis_t mDuration;
+};
+
+}
+}
+
+#endif
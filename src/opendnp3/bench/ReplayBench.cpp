@@ -0,0 +1,196 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "ReplayBench.h"
+
+#include <boost/bind.hpp>
+
+#include <opendnp3/APL/CaptureFile.h>
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/PhysicalLayerAsyncReplay.h>
+#include <opendnp3/APL/SyncVar.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/DNPCrc.h>
+#include <opendnp3/DNP3/LinkHeader.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char PORT_NAME[] = "replay";
+const char STACK_NAME[] = "stack";
+
+// discards measurements so the report only measures the stack
+class NullDataObserver : public IDataObserver
+{
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {}
+	void _Update(const Analog&, size_t) {}
+	void _Update(const Counter&, size_t) {}
+	void _Update(const ControlStatus&, size_t) {}
+	void _Update(const SetpointStatus&, size_t) {}
+};
+
+// replays don't execute controls
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+double PerSecond(boost::int64_t aCount, double aSeconds)
+{
+	return (aSeconds > 0) ? aCount / aSeconds : 0;
+}
+
+double MicrosPer(double aSeconds, boost::int64_t aCount)
+{
+	return (aCount > 0) ? (aSeconds * 1000000) / aCount : 0;
+}
+
+}
+
+ReplayBench::ReplayBench(const std::string& arPath, bool aRealTime, FilterLevel aLevel) :
+	mPath(arPath),
+	mRealTime(aRealTime),
+	mLevel(aLevel),
+	mFromMaster(false),
+	mLocalAddr(0),
+	mRemoteAddr(0)
+{
+	this->DetectRoute();
+}
+
+void ReplayBench::DetectRoute()
+{
+	const size_t MAX_SEARCH = 4096;
+
+	CaptureReader reader(mPath);
+	CaptureRecord rec;
+	std::vector<boost::uint8_t> bytes;
+
+	while(bytes.size() < MAX_SEARCH && reader.Next(rec)) {
+		if(rec.direction != CD_READ) continue;
+		bytes.insert(bytes.end(), rec.data.Buffer(), rec.data.Buffer() + rec.data.Size());
+
+		for(size_t i = 0; i + LI_CRC + 2 <= bytes.size(); ++i) {
+			const boost::uint8_t* pHeader = &bytes[i];
+			if(pHeader[LI_START_05] != 0x05 || pHeader[LI_START_64] != 0x64) continue;
+			if(!DNPCrc::IsCorrectCRC(pHeader, LI_CRC)) continue;
+
+			LinkHeader header;
+			header.Read(pHeader);
+			mFromMaster = header.IsFromMaster();
+			mLocalAddr = header.GetDest();
+			mRemoteAddr = header.GetSrc();
+			return;
+		}
+	}
+
+	throw Exception(LOCATION, "No link frames were read in capture: " + mPath);
+}
+
+void ReplayBench::Run(std::ostream& arStream)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+
+	AsyncStackManager mgr(log.GetLogger(mLevel, "bench"));
+	std::auto_ptr<PhysicalLayerAsyncReplay> pReplay(new PhysicalLayerAsyncReplay(log.GetLogger(mLevel, PORT_NAME), mgr.GetIOService(), mPath, mRealTime));
+
+	SyncVar<bool> finished(false);
+	pReplay->SetFinishedHandler(boost::bind(&SyncVar<bool>::Set, &finished, true));
+
+	NullDataObserver observer;
+	RejectingCommandAcceptor acceptor;
+
+	mgr.AddPhysicalLayer(PORT_NAME, PhysLayerSettings(mLevel, 1000), pReplay.get());
+
+	boost::int64_t start = LatencyTrace::Now();
+	std::clock_t cpuStart = std::clock();
+
+	if(mFromMaster) {
+		SlaveStackConfig cfg;
+		cfg.link.LocalAddr = mLocalAddr;
+		cfg.link.RemoteAddr = mRemoteAddr;
+		cfg.device = DeviceTemplate(100, 100, 100, 10, 10, 10, 10);
+		mgr.AddSlave(PORT_NAME, STACK_NAME, mLevel, &acceptor, cfg);
+	} else {
+		MasterStackConfig cfg;
+		cfg.link.LocalAddr = mLocalAddr;
+		cfg.link.RemoteAddr = mRemoteAddr;
+		mgr.AddMaster(PORT_NAME, STACK_NAME, mLevel, &observer, cfg);
+	}
+
+	finished.WaitUntil(true, -1);
+
+	std::clock_t cpuStop = std::clock();
+	double elapsed = (LatencyTrace::Now() - start) / 1000000.0;
+	double cpu = static_cast<double>(cpuStop - cpuStart) / CLOCKS_PER_SEC;
+
+	mgr.Shutdown(); // the replay layer isn't owned by the manager, so it must stop using it first
+
+	MetricsRegistry* pMetrics = log.GetMetrics();
+	boost::int64_t frames = pMetrics->GetCounter(PORT_NAME, "link_rx_frames")->Get();
+	boost::int64_t apdus = pMetrics->GetCounter(STACK_NAME, "app_rx_fragments")->Get();
+
+	arStream << "capture:        " << mPath << std::endl;
+	arStream << "replayed into:  " << (mFromMaster ? "slave" : "master") << " " << mLocalAddr << " <- " << mRemoteAddr;
+	arStream << (mRealTime ? " at recorded timing" : " as fast as possible") << std::endl;
+	arStream << "reads:          " << pReplay->NumReplayed() << std::endl;
+	arStream << "frames:         " << frames << std::endl;
+	arStream << "apdus:          " << apdus << std::endl;
+	arStream << std::fixed << std::setprecision(6);
+	arStream << "elapsed s:      " << elapsed << std::endl;
+	arStream << "cpu s:          " << cpu << std::endl;
+	arStream << std::setprecision(1);
+	arStream << "frames/s:       " << PerSecond(frames, elapsed) << std::endl;
+	arStream << "apdus/s:        " << PerSecond(apdus, elapsed) << std::endl;
+	arStream << std::setprecision(2);
+	arStream << "cpu us/frame:   " << MicrosPer(cpu, frames) << std::endl;
+	arStream << "cpu us/apdu:    " << MicrosPer(cpu, apdus) << std::endl;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
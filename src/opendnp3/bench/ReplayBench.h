@@ -0,0 +1,65 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __REPLAY_BENCH_H_
+#define __REPLAY_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+#include <string>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Replays a capture made with AsyncStackManager::StartCapture() into a
+	master or slave stack and reports the throughput and CPU cost of the
+	stack processing it. The role and link addresses are taken from the
+	first link frame in the capture.
+*/
+class ReplayBench
+{
+public:
+
+	ReplayBench(const std::string& arPath, bool aRealTime, FilterLevel aLevel);
+
+	/// Runs the capture to the end and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	/// Finds the first link header in the captured reads, @throw Exception if there isn't one
+	void DetectRoute();
+
+	std::string mPath;
+	bool mRealTime;
+	FilterLevel mLevel;
+
+	bool mFromMaster;		// the captured reads were sent by a master, so replay them into a slave
+	boost::uint16_t mLocalAddr;
+	boost::uint16_t mRemoteAddr;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,223 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SerialBench.h"
+
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Threadable.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/LinkFrame.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <ctime>
+#include <iomanip>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char LOGGER_NAME[] = "bench";
+const char PORT_NAME[] = "serial";
+const char STACK_NAME[] = "slave";
+
+// the frames go to an address nothing is listening on, so the outstation never answers
+const boost::uint16_t UNROUTED_ADDR = 999;
+const boost::uint16_t MASTER_ADDR = 100;
+
+const size_t IDLE_CHARS = 20;		// silence between frames
+const size_t BITS_PER_CHAR = 10;	// 8N1
+const millis_t OPEN_DELAY = 500;	// the port configures the terminal when it opens
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+// writes the frames into the pty no faster than the line would carry them
+class LineWriter : public Threadable
+{
+public:
+	LineWriter(int aFd, int aBaud) :
+		mFd(aFd),
+		mBaud(aBaud)
+	{
+		boost::uint8_t data[LS_MAX_USER_DATA_SIZE];
+		for(size_t i = 0; i < LS_MAX_USER_DATA_SIZE; ++i) data[i] = static_cast<boost::uint8_t>(i);
+
+		LinkFrame frame;
+		frame.FormatRequestLinkStatus(true, UNROUTED_ADDR, MASTER_ADDR);
+		this->Add(frame);
+		frame.FormatUnconfirmedUserData(true, UNROUTED_ADDR, MASTER_ADDR, data, 50);
+		this->Add(frame);
+		frame.FormatUnconfirmedUserData(true, UNROUTED_ADDR, MASTER_ADDR, data, LS_MAX_USER_DATA_SIZE);
+		this->Add(frame);
+	}
+
+private:
+
+	void Add(const LinkFrame& arFrame) {
+		mFrames.push_back(std::vector<boost::uint8_t>(arFrame.GetBuffer(), arFrame.GetBuffer() + arFrame.GetSize()));
+	}
+
+	void Run() {
+		boost::int64_t start = LatencyTrace::Now();
+		boost::int64_t slots = 0;	// character times accounted for so far
+		size_t frame = 0;
+		size_t pos = 0;
+		size_t idle = 0;
+		std::vector<boost::uint8_t> chunk;
+
+		while(!this->IsExitRequested()) {
+			boost::int64_t due = (LatencyTrace::Now() - start) * mBaud / (BITS_PER_CHAR * 1000000);
+			chunk.clear();
+			for(; slots < due; ++slots) {
+				if(idle > 0) {
+					--idle;
+					continue;
+				}
+				const std::vector<boost::uint8_t>& bytes = mFrames[frame];
+				chunk.push_back(bytes[pos++]);
+				if(pos == bytes.size()) {
+					pos = 0;
+					frame = (frame + 1) % mFrames.size();
+					idle = IDLE_CHARS;
+				}
+			}
+			if(!chunk.empty() && write(mFd, &chunk[0], chunk.size()) < 0) return;
+			Thread::SleepFor(1);
+		}
+	}
+
+	int mFd;
+	int mBaud;
+	std::vector< std::vector<boost::uint8_t> > mFrames;
+};
+
+double Per(double aValue, double aCount)
+{
+	return (aCount > 0) ? aValue / aCount : 0;
+}
+
+}
+
+SerialBench::SerialBench(int aBaud, millis_t aDuration, FilterLevel aLevel) :
+	mBaud(aBaud),
+	mDuration(aDuration),
+	mLevel(aLevel)
+{
+
+}
+
+void SerialBench::Run(std::ostream& arStream)
+{
+	arStream << "baud:              " << mBaud << std::endl;
+	arStream << "duration ms:       " << mDuration << std::endl;
+
+	Result stream = this->Measure(READ_STREAM);
+	this->Report(arStream, "stream", stream);
+
+	Result framed = this->Measure(READ_FRAMED);
+	this->Report(arStream, "framed", framed);
+}
+
+SerialBench::Result SerialBench::Measure(ReadModeType aMode)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master < 0) throw Exception(LOCATION, "Unable to open a pseudo terminal");
+	if(grantpt(master) < 0 || unlockpt(master) < 0) {
+		close(master);
+		throw Exception(LOCATION, "Unable to unlock the pseudo terminal");
+	}
+
+	SerialSettings serial;
+	serial.mDevice = ptsname(master);
+	serial.mBaud = mBaud;
+	serial.mReadMode = aMode;
+
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	RejectingCommandAcceptor acceptor;
+	Result result;
+
+	{
+		AsyncStackManager mgr(log.GetLogger(mLevel, LOGGER_NAME));
+		mgr.AddSerial(PORT_NAME, PhysLayerSettings(mLevel, 1000), serial);
+		mgr.AddSlave(PORT_NAME, STACK_NAME, mLevel, &acceptor, SlaveStackConfig());
+		Thread::SleepFor(OPEN_DELAY);
+
+		LineWriter writer(master, mBaud);
+		Thread thread(&writer);
+
+		std::clock_t cpuStart = std::clock();
+		thread.Start();
+		Thread::SleepFor(mDuration);
+		thread.RequestStop();
+		thread.WaitForStop();
+		std::clock_t cpuStop = std::clock();
+
+		MetricsRegistry* pMetrics = log.GetMetrics();
+		result.frames = pMetrics->GetCounter(PORT_NAME, "link_rx_frames")->Get();
+		result.reads = pMetrics->GetCounter(LOGGER_NAME, "serial_reads")->Get();
+		result.gaps = pMetrics->GetCounter(LOGGER_NAME, "serial_gaps")->Get();
+		result.cpu = static_cast<double>(cpuStop - cpuStart) / CLOCKS_PER_SEC;
+
+		mgr.Shutdown(); // before the pty goes away, or the port sees a hangup
+	}
+
+	close(master);
+	return result;
+}
+
+void SerialBench::Report(std::ostream& arStream, const char* apName, const Result& arResult)
+{
+	arStream << apName << ":" << std::endl;
+	arStream << "  frames:          " << arResult.frames << std::endl;
+	arStream << "  reads:           " << arResult.reads << std::endl;
+	arStream << "  gaps:            " << arResult.gaps << std::endl;
+	arStream << std::fixed << std::setprecision(2);
+	arStream << "  reads/frame:     " << Per(static_cast<double>(arResult.reads), static_cast<double>(arResult.frames)) << std::endl;
+	arStream << "  cpu us/frame:    " << Per(arResult.cpu * 1000000, static_cast<double>(arResult.frames)) << std::endl;
+	arStream.unsetf(std::ios_base::floatfield);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
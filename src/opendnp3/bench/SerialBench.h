@@ -0,0 +1,71 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SERIAL_BENCH_H_
+#define __SERIAL_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/SerialTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Feeds link frames into a serial port through a pseudo terminal, paced
+	at the baud rate with a short silence between frames as on a polled
+	multidrop line. Runs once with stream reads and once with framed reads
+	and reports how many read callbacks the port made per frame.
+*/
+class SerialBench
+{
+public:
+
+	SerialBench(int aBaud, millis_t aDuration, FilterLevel aLevel);
+
+	/// Runs both read modes and writes the report to arStream, @throw Exception if a pty can't be opened
+	void Run(std::ostream& arStream);
+
+private:
+
+	struct Result {
+		Result() : frames(0), reads(0), gaps(0), cpu(0) {}
+
+		boost::int64_t frames;
+		boost::int64_t reads;
+		boost::int64_t gaps;
+		double cpu;
+	};
+
+	Result Measure(ReadModeType aMode);
+
+	void Report(std::ostream& arStream, const char* apName, const Result& arResult);
+
+	int mBaud;
+	millis_t mDuration;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,171 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SharedMemoryBench.h"
+
+#include <opendnp3/APL/DataTypes.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/SharedMemoryDataObserver.h>
+#include <opendnp3/APL/SharedMemoryDataReader.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Threadable.h>
+
+#include <iomanip>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const char SEGMENT_NAME[] = "dnp3bench_shared_points";
+const size_t UPDATES_PER_TRANSACTION = 100;
+const size_t READS_PER_POLL = 1000;
+
+class Writer : public Threadable
+{
+public:
+	Writer(SharedMemoryDataObserver* apObserver, size_t aNumPoints) :
+		mNumUpdates(0),
+		mpObserver(apObserver),
+		mNumPoints(aNumPoints)
+	{}
+
+	size_t mNumUpdates;
+
+private:
+
+	void Run() {
+		double value = 0;
+		while(!this->IsExitRequested()) {
+			Transaction tr(mpObserver);
+			for(size_t i = 0; i < UPDATES_PER_TRANSACTION; ++i) {
+				mpObserver->Update(Analog(++value, AQ_ONLINE), mNumUpdates++ % mNumPoints);
+			}
+		}
+	}
+
+	SharedMemoryDataObserver* mpObserver;
+	size_t mNumPoints;
+};
+
+class Reader : public Threadable
+{
+public:
+	Reader(size_t aNumPoints) :
+		mReader(SEGMENT_NAME),
+		mNumPoints(aNumPoints),
+		mNumReads(0),
+		mNumChanges(0),
+		mNumOverruns(0)
+	{}
+
+	SharedMemoryDataReader mReader;
+	size_t mNumPoints;
+	size_t mNumReads;
+	size_t mNumChanges;
+	size_t mNumOverruns;
+
+private:
+
+	void Run() {
+		SharedPointValue value;
+		std::vector<SharedPointChange> changes;
+		while(!this->IsExitRequested()) {
+			for(size_t i = 0; i < READS_PER_POLL; ++i) {
+				mReader.Read(SPT_ANALOG, mNumReads++ % mNumPoints, value);
+			}
+			changes.clear();
+			if(mReader.PollChanges(changes)) mNumChanges += changes.size();
+			else ++mNumOverruns;
+		}
+	}
+};
+
+double PerSecond(size_t aCount, double aSeconds)
+{
+	return (aSeconds > 0) ? aCount / aSeconds : 0;
+}
+
+}
+
+SharedMemoryBench::SharedMemoryBench(size_t aNumReaders, size_t aNumPoints, millis_t aDuration) :
+	mNumReaders(aNumReaders),
+	mNumPoints(aNumPoints),
+	mDuration(aDuration)
+{
+
+}
+
+void SharedMemoryBench::Run(std::ostream& arStream)
+{
+	SharedMemoryDataObserver observer(SEGMENT_NAME, SharedPointTableSizes(0, mNumPoints));
+
+	Writer writer(&observer, mNumPoints);
+	std::vector<Reader*> readers;
+	for(size_t i = 0; i < mNumReaders; ++i) readers.push_back(new Reader(mNumPoints));
+
+	Thread writerThread(&writer);
+	std::vector<Thread*> readerThreads;
+	for(size_t i = 0; i < mNumReaders; ++i) readerThreads.push_back(new Thread(readers[i]));
+
+	boost::int64_t start = LatencyTrace::Now();
+	writerThread.Start();
+	for(size_t i = 0; i < mNumReaders; ++i) readerThreads[i]->Start();
+
+	Thread::SleepFor(mDuration);
+
+	writerThread.RequestStop();
+	writerThread.WaitForStop();
+	for(size_t i = 0; i < mNumReaders; ++i) {
+		readerThreads[i]->RequestStop();
+		readerThreads[i]->WaitForStop();
+	}
+	double elapsed = (LatencyTrace::Now() - start) / 1000000.0;
+
+	size_t reads = 0, retries = 0, changes = 0, overruns = 0;
+	for(size_t i = 0; i < mNumReaders; ++i) {
+		reads += readers[i]->mNumReads;
+		retries += readers[i]->mReader.NumRetries();
+		changes += readers[i]->mNumChanges;
+		overruns += readers[i]->mNumOverruns;
+		delete readerThreads[i];
+		delete readers[i];
+	}
+
+	arStream << "points:             " << mNumPoints << std::endl;
+	arStream << "readers:            " << mNumReaders << std::endl;
+	arStream << std::fixed << std::setprecision(3);
+	arStream << "elapsed s:          " << elapsed << std::endl;
+	arStream << std::setprecision(0);
+	arStream << "updates/s:          " << PerSecond(writer.mNumUpdates, elapsed) << std::endl;
+	arStream << "reads/s:            " << PerSecond(reads, elapsed) << std::endl;
+	arStream << "reads/s per reader: " << PerSecond(reads, elapsed) / (mNumReaders > 0 ? mNumReaders : 1) << std::endl;
+	arStream << "changes polled:     " << changes << std::endl;
+	arStream << "ring overruns:      " << overruns << std::endl;
+	arStream << std::setprecision(4);
+	arStream << "retries/read %:     " << (reads > 0 ? (100.0 * retries) / reads : 0) << std::endl;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,56 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_MEMORY_BENCH_H_
+#define __SHARED_MEMORY_BENCH_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Measures contention on a SharedMemoryDataObserver segment. One thread
+	publishes analogs as fast as it can while several reader threads, each
+	with its own SharedMemoryDataReader, copy points and poll for changes.
+	Reports update and read rates and how often readers had to retry.
+*/
+class SharedMemoryBench
+{
+public:
+
+	SharedMemoryBench(size_t aNumReaders, size_t aNumPoints, millis_t aDuration);
+
+	/// Runs the benchmark and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	size_t mNumReaders;
+	size_t mNumPoints;
+	millis_t mDuration;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,69 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "SimBench.h"
+
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/TimingTools.h>
+
+#include <algorithm>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const millis_t PROGRESS_PERIOD = 60 * 60 * 1000;
+
+}
+
+SimBench::SimBench(const SimulatorConfig& arConfig, millis_t aVirtualTime, FilterLevel aLevel) :
+	mConfig(arConfig),
+	mVirtualTime(aVirtualTime),
+	mLevel(aLevel)
+{
+
+}
+
+void SimBench::Run(std::ostream& arStream)
+{
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+
+	StopWatch setup;
+	StackSimulator sim(log.GetLogger(mLevel, "sim"), mConfig);
+	arStream << "setup s:               " << setup.Elapsed() / 1000.0 << std::endl;
+
+	for(millis_t done = 0; done < mVirtualTime;) {
+		millis_t step = std::min(PROGRESS_PERIOD, mVirtualTime - done);
+		sim.Run(step);
+		done += step;
+		arStream << "  " << done / PROGRESS_PERIOD << "h: " << sim.NumUpdates() << " changes, " << sim.NumDelivered() << " delivered" << std::endl;
+	}
+
+	sim.Report(arStream);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
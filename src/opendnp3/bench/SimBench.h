@@ -0,0 +1,55 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SIM_BENCH_H_
+#define __SIM_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/Types.h>
+#include <opendnp3/DNP3/StackSimulator.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Runs a StackSimulator for a stretch of virtual time, printing progress
+	every simulated hour and the simulator's report at the end.
+*/
+class SimBench
+{
+public:
+
+	SimBench(const SimulatorConfig& arConfig, millis_t aVirtualTime, FilterLevel aLevel);
+
+	void Run(std::ostream& arStream);
+
+private:
+
+	SimulatorConfig mConfig;
+	millis_t mVirtualTime;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,280 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include "UringBench.h"
+
+#include <opendnp3/APL/AtomicOps.h>
+#include <opendnp3/APL/CommandInterfaces.h>
+#include <opendnp3/APL/DataInterfaces.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/IoUringService.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/LogToStdio.h>
+#include <opendnp3/APL/Metrics.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Timeout.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <ctime>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+const size_t NUM_POINTS = 10;
+const millis_t CONNECT_TIMEOUT_PER_SESSION = 20;
+
+class CountingDataObserver : public IDataObserver
+{
+public:
+	CountingDataObserver() : mNumUpdates(0) {}
+
+	boost::int64_t NumUpdates() const {
+		return AtomicLoadRelaxed(&mNumUpdates);
+	}
+
+private:
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Analog&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const Counter&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const ControlStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		AtomicAddRelaxed(&mNumUpdates, 1);
+	}
+
+	atomic_int64_t mNumUpdates;
+};
+
+class RejectingCommandAcceptor : public ICommandAcceptor
+{
+public:
+	void AcceptCommand(const BinaryOutput&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+	void AcceptCommand(const Setpoint&, size_t, int aSequence, IResponseAcceptor* apRspAcceptor) {
+		apRspAcceptor->AcceptResponse(CommandResponse(CS_NOT_SUPPORTED), aSequence);
+	}
+};
+
+/**
+	Counts the system calls made by the constructing thread and every
+	thread it starts afterwards with the raw_syscalls tracepoint. Needs
+	tracefs to be mounted and permission to use perf events.
+*/
+class SyscallCounter
+{
+public:
+	SyscallCounter() : mFd(-1) {
+#ifdef __linux__
+		const char* paths[] = {
+			"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+			"/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"
+		};
+		for(size_t i = 0; i < sizeof(paths) / sizeof(paths[0]) && mFd < 0; ++i) {
+			std::ifstream in(paths[i]);
+			boost::uint64_t id;
+			if(!(in >> id)) continue;
+
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_TRACEPOINT;
+			attr.size = sizeof(attr);
+			attr.config = id;
+			attr.inherit = 1;
+			mFd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+		}
+#endif
+	}
+
+	~SyscallCounter() {
+#ifdef __linux__
+		if(mFd >= 0) close(mFd);
+#endif
+	}
+
+	/// @return the count so far, -1 if system calls can't be counted
+	boost::int64_t Read() {
+#ifdef __linux__
+		boost::uint64_t count;
+		if(mFd >= 0 && read(mFd, &count, sizeof(count)) == sizeof(count)) return static_cast<boost::int64_t>(count);
+#endif
+		return -1;
+	}
+
+private:
+	int mFd;
+};
+
+std::string Name(const char* apPrefix, size_t aIndex)
+{
+	std::ostringstream oss;
+	oss << apPrefix << aIndex;
+	return oss.str();
+}
+
+double Per(double aValue, double aCount)
+{
+	return (aCount > 0) ? aValue / aCount : 0;
+}
+
+}
+
+UringBench::UringBench(size_t aNumSessions, boost::uint16_t aBasePort, millis_t aPollRate, millis_t aDuration, FilterLevel aLevel) :
+	mNumSessions(aNumSessions),
+	mBasePort(aBasePort),
+	mPollRate(aPollRate),
+	mDuration(aDuration),
+	mLevel(aLevel)
+{
+
+}
+
+void UringBench::Run(std::ostream& arStream)
+{
+	arStream << "sessions:             " << mNumSessions << std::endl;
+	arStream << "poll rate ms:         " << mPollRate << std::endl;
+
+	Result asio = this->Measure(TCPB_ASIO);
+	this->Report(arStream, "asio", asio);
+
+#ifdef APL_HAS_IO_URING
+	if(IoUringService::IsSupported()) {
+		Result uring = this->Measure(TCPB_IO_URING);
+		this->Report(arStream, "io_uring", uring);
+		return;
+	}
+#endif
+
+	arStream << "io_uring isn't available on this host" << std::endl;
+}
+
+UringBench::Result UringBench::Measure(TCPBackend aBackend)
+{
+	// opened first, so it counts the stack threads started below
+	SyscallCounter syscalls;
+
+	EventLog log;
+	log.AddLogSubscriber(LogToStdio::Inst());
+	CountingDataObserver observer;
+	RejectingCommandAcceptor acceptor;
+	Result result;
+
+	AsyncStackManager masters(log.GetLogger(mLevel, "masters"), aBackend);
+	AsyncStackManager slaves(log.GetLogger(mLevel, "slaves"), aBackend);
+
+	SlaveStackConfig slave;
+	slave.device = DeviceTemplate(0, NUM_POINTS);
+
+	MasterStackConfig master;
+	master.master.IntegrityRate = mPollRate;
+	master.master.DoUnsolOnStartup = false;
+
+	for(size_t i = 0; i < mNumSessions; ++i) {
+		boost::uint16_t port = static_cast<boost::uint16_t>(mBasePort + i);
+		slaves.AddTCPServer(Name("server", i), PhysLayerSettings(mLevel, 1000), "127.0.0.1", port);
+		slaves.AddSlave(Name("server", i), Name("slave", i), mLevel, &acceptor, slave);
+		masters.AddTCPClient(Name("client", i), PhysLayerSettings(mLevel, 1000), "127.0.0.1", port);
+		masters.AddMaster(Name("client", i), Name("master", i), mLevel, &observer, master);
+	}
+
+	// wait for the startup integrity polls, so connecting isn't measured
+	Timeout to(CONNECT_TIMEOUT_PER_SESSION * mNumSessions + 10000);
+	while(observer.NumUpdates() < static_cast<boost::int64_t>(mNumSessions * NUM_POINTS)) {
+		if(to.IsExpired()) throw Exception(LOCATION, "Timed out waiting for the sessions to connect");
+		Thread::SleepFor(10);
+	}
+
+	MetricsRegistry* pMetrics = log.GetMetrics();
+	std::vector<MetricCounter*> frames;
+	for(size_t i = 0; i < mNumSessions; ++i) {
+		frames.push_back(pMetrics->GetCounter(Name("client", i), "link_rx_frames"));
+		frames.push_back(pMetrics->GetCounter(Name("server", i), "link_rx_frames"));
+	}
+
+	boost::int64_t frameStart = 0;
+	for(size_t i = 0; i < frames.size(); ++i) frameStart -= frames[i]->Get();
+	boost::int64_t syscallStart = syscalls.Read();
+	std::clock_t cpuStart = std::clock();
+
+	Thread::SleepFor(mDuration);
+
+	std::clock_t cpuStop = std::clock();
+	boost::int64_t syscallStop = syscalls.Read();
+	result.frames = frameStart;
+	for(size_t i = 0; i < frames.size(); ++i) result.frames += frames[i]->Get();
+
+	result.cpu = static_cast<double>(cpuStop - cpuStart) / CLOCKS_PER_SEC;
+	if(syscallStart >= 0 && syscallStop >= 0) result.syscalls = syscallStop - syscallStart;
+
+	masters.Shutdown();
+	slaves.Shutdown();
+
+	return result;
+}
+
+void UringBench::Report(std::ostream& arStream, const char* apName, const Result& arResult)
+{
+	double seconds = mDuration / 1000.0;
+
+	arStream << apName << ":" << std::endl;
+	arStream << "  frames:             " << arResult.frames << std::endl;
+	arStream << std::fixed << std::setprecision(2);
+	arStream << "  cpu s:              " << arResult.cpu << std::endl;
+	arStream << "  cpu us/s/session:   " << Per(arResult.cpu * 1000000, seconds * mNumSessions) << std::endl;
+	arStream << "  cpu us/frame:       " << Per(arResult.cpu * 1000000, static_cast<double>(arResult.frames)) << std::endl;
+	if(arResult.syscalls < 0) {
+		arStream << "  syscalls/frame:     n/a, mount tracefs and allow perf events to count them" << std::endl;
+	} else {
+		arStream << "  syscalls:           " << arResult.syscalls << std::endl;
+		arStream << "  syscalls/frame:     " << Per(static_cast<double>(arResult.syscalls), static_cast<double>(arResult.frames)) << std::endl;
+	}
+	arStream.unsetf(std::ios_base::floatfield);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
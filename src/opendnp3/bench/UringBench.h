@@ -0,0 +1,76 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __URING_BENCH_H_
+#define __URING_BENCH_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/APL/TCPTypes.h>
+#include <opendnp3/APL/Types.h>
+
+#include <ostream>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Connects masters to outstations over loopback TCP, one port per
+	session, and lets them poll slowly so most sessions are idle most of
+	the time. Runs once with the asio backend and once with io_uring and
+	reports the process CPU per session and, where the kernel lets us
+	count them, the system calls per link frame.
+*/
+class UringBench
+{
+public:
+
+	/// Each session needs its own TCP port above the base port
+	static const size_t MAX_SESSIONS = 10000;
+
+	UringBench(size_t aNumSessions, boost::uint16_t aBasePort, millis_t aPollRate, millis_t aDuration, FilterLevel aLevel);
+
+	/// Runs both backends and writes the report to arStream
+	void Run(std::ostream& arStream);
+
+private:
+
+	struct Result {
+		Result() : frames(0), syscalls(-1), cpu(0) {}
+
+		boost::int64_t frames;
+		boost::int64_t syscalls;	// -1 if they can't be counted
+		double cpu;
+	};
+
+	Result Measure(TCPBackend aBackend);
+
+	void Report(std::ostream& arStream, const char* apName, const Result& arResult);
+
+	size_t mNumSessions;
+	boost::uint16_t mBasePort;
+	millis_t mPollRate;
+	millis_t mDuration;
+	FilterLevel mLevel;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,182 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <iostream>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/positional_options.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+
+#include <opendnp3/APL/Exception.h>
+
+#include "AllocBench.h"
+#include "FreezeBench.h"
+#include "IdleBench.h"
+#include "ProfileBench.h"
+#include "ReadBench.h"
+#include "ReplayBench.h"
+#include "SerialBench.h"
+#include "SharedMemoryBench.h"
+#include "SimBench.h"
+#include "UringBench.h"
+
+using namespace std;
+using namespace apl;
+using namespace apl::dnp;
+
+namespace po = boost::program_options;
+
+/*
+ * Command line syntax:
+ *
+ *    dnp3bench replay <capture> [--realtime] [--verbose]
+ *    dnp3bench idle [--stacks <n>] [--port <port>] [--verbose]
+ *    dnp3bench shm [--readers <n>] [--points <n>] [--duration <ms>]
+ *    dnp3bench alloc [--points <n>] [--duration <ms>] [--port <port>] [--verbose]
+ *    dnp3bench reads [--points <n>] [--duration <ms>]
+ *    dnp3bench uring [--stacks <n>] [--port <port>] [--poll-rate <ms>] [--duration <ms>] [--verbose]
+ *    dnp3bench serial [--baud <bps>] [--duration <ms>] [--verbose]
+ *    dnp3bench sim [--stacks <n>] [--sim-time <s>] [--poll-rate <ms>] [--update-period <ms>] [--latency <ms>] [--loss <p>] [--baud <bps>] [--verbose]
+ *    dnp3bench profile [--stacks <n>] [--port <port>] [--poll-rate <ms>] [--duration <ms>] [--verbose]
+ *    dnp3bench freeze [--points <n>] [--duration <ms>]
+ */
+int main(int argc, char* argv[])
+{
+	std::string command;
+	std::string capture;
+	size_t stacks;
+	boost::uint16_t port;
+	size_t readers;
+	size_t points;
+	millis_t duration;
+	millis_t pollRate;
+	int baud;
+	millis_t simTime;
+	millis_t updatePeriod;
+	millis_t latency;
+	double loss;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+	("help,H", "display program options")
+	("command", po::value<std::string>(&command), "The benchmark to run: replay, idle, shm, alloc, reads, uring, serial, sim, profile or freeze")
+	("capture,C", po::value<std::string>(&capture), "Capture file to replay, recorded with AsyncStackManager::StartCapture")
+	("realtime,R", "Replay the capture at the recorded timing instead of as fast as possible")
+	("stacks,N", po::value<size_t>(&stacks)->default_value(1000), "Number of idle outstations, uring or profile sessions, or simulated pairs to add")
+	("port,P", po::value<boost::uint16_t>(&port)->default_value(20000), "Local TCP port the idle or alloc outstations listen on, the first of the uring or profile ports")
+	("readers", po::value<size_t>(&readers)->default_value(4), "Number of shared memory reader threads")
+	("points", po::value<size_t>(&points)->default_value(1000), "Number of analogs in the shared memory segment or the outstation, or counters to freeze")
+	("duration,D", po::value<millis_t>(&duration)->default_value(2000), "How long to run the shm, reads and freeze benchmarks or each alloc, uring, serial and profile phase in ms")
+	("poll-rate", po::value<millis_t>(&pollRate)->default_value(1000), "How often each uring or profile master polls its outstation, or each simulated master scans for events, in ms")
+	("baud", po::value<int>(&baud)->default_value(9600), "Line rate the serial benchmark paces its frames at and the simulated lines run at")
+	("sim-time", po::value<millis_t>(&simTime)->default_value(3600), "Virtual seconds to simulate")
+	("update-period", po::value<millis_t>(&updatePeriod)->default_value(10000), "Mean ms between changes on each simulated outstation")
+	("latency", po::value<millis_t>(&latency)->default_value(50), "One way latency of the simulated lines in ms")
+	("loss", po::value<double>(&loss)->default_value(0.0), "Probability that a simulated line drops a frame")
+	("verbose,V", "Log stack warnings during the benchmark");
+
+	po::positional_options_description pos;
+	pos.add("command", 1).add("capture", 1);
+
+	po::variables_map vm;
+	try {
+		po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), vm);
+		po::notify(vm);
+	} catch ( boost::program_options::error& ex ) {
+		cout << ex.what() << endl;
+		cout << desc << endl;
+		return -1;
+	}
+
+	bool replay = (command == "replay" && !capture.empty());
+	bool idle = (command == "idle" && stacks > 0 && stacks <= IdleBench::MAX_STACKS);
+	bool shm = (command == "shm" && points > 0);
+	bool alloc = (command == "alloc" && points > 0);
+	bool reads = (command == "reads" && points >= ReadBench::POINTS_PER_RANGE);
+	bool uring = (command == "uring" && stacks > 0 && stacks <= UringBench::MAX_SESSIONS && port + stacks <= 65536 && pollRate > 0);
+	bool serial = (command == "serial" && baud > 0);
+	bool sim = (command == "sim" && stacks > 0 && simTime > 0 && pollRate > 0 && baud > 0 && loss >= 0 && loss < 1);
+	bool profile = (command == "profile" && stacks > 0 && stacks <= ProfileBench::MAX_SESSIONS && port + stacks <= 65536 && pollRate >= 10);
+	bool freeze = (command == "freeze" && points > 0);
+
+	if(vm.count("help") || !(replay || idle || shm || alloc || reads || uring || serial || sim || profile || freeze)) {
+		cout << "dnp3bench replay <capture> [options]" << endl;
+		cout << "dnp3bench idle [options]" << endl;
+		cout << "dnp3bench shm [options]" << endl;
+		cout << "dnp3bench alloc [options]" << endl;
+		cout << "dnp3bench reads [options]" << endl;
+		cout << "dnp3bench uring [options]" << endl;
+		cout << "dnp3bench serial [options]" << endl;
+		cout << "dnp3bench sim [options]" << endl;
+		cout << "dnp3bench profile [options]" << endl;
+		cout << "dnp3bench freeze [options]" << endl;
+		cout << desc << endl;
+		return vm.count("help") ? 0 : -1;
+	}
+
+	FilterLevel level = vm.count("verbose") ? LEV_WARNING : LEV_ERROR;
+
+	try {
+		if(replay) {
+			ReplayBench bench(capture, vm.count("realtime") > 0, level);
+			bench.Run(cout);
+		} else if(idle) {
+			IdleBench bench(stacks, port, level);
+			bench.Run(cout);
+		} else if(shm) {
+			SharedMemoryBench bench(readers, points, duration);
+			bench.Run(cout);
+		} else if(alloc) {
+			AllocBench bench(points, duration, port, level);
+			bench.Run(cout);
+		} else if(reads) {
+			ReadBench bench(points, duration);
+			bench.Run(cout);
+		} else if(uring) {
+			UringBench bench(stacks, port, pollRate, duration, level);
+			bench.Run(cout);
+		} else if(serial) {
+			SerialBench bench(baud, duration, level);
+			bench.Run(cout);
+		} else if(sim) {
+			SimulatorConfig cfg;
+			cfg.NumPairs = stacks;
+			cfg.UpdatePeriod = updatePeriod;
+			cfg.line.mLatency = latency;
+			cfg.line.mLoss = loss;
+			cfg.line.mBitsPerSecond = baud;
+			cfg.master.master.IntegrityRate = 60 * 60 * 1000;
+			cfg.master.master.AddExceptionScan(PC_CLASS_1 | PC_CLASS_2 | PC_CLASS_3, pollRate);
+			SimBench bench(cfg, simTime * 1000, level);
+			bench.Run(cout);
+		} else if(profile) {
+			ProfileBench bench(stacks, port, pollRate, duration, level);
+			bench.Run(cout);
+		} else {
+			FreezeBench bench(points, duration);
+			bench.Run(cout);
+		}
+	} catch(const Exception& ex) {
+		cout << ex.GetErrorString() << endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -2,6 +2,9 @@
 
 #include <opendnp3/APL/Util.h>
 #include <opendnp3/APL/ITimerSource.h>
+#include <opendnp3/APL/HandlerProfiler.h>
+#include <opendnp3/APL/LatencyTrace.h>
+#include <opendnp3/APL/Parsing.h>
 
 #include <boost/bind.hpp>
 #include <sstream>
@@ -136,6 +139,22 @@ void LogTerminalExtension::_BindToTerminal(ITerminal* apTerminal)
 	cmd.mUsage = "print vars";
 	cmd.mDesc = "Prints non-operational information to the console";
 	apTerminal->BindCommand(cmd, "vars");
+
+	cmd.mName = "trace";
+	cmd.mHandler = boost::bind(&LogTerminalExtension::HandleTrace, this, _1);
+	cmd.mUsage = "trace [sample rate]";
+	cmd.mDesc  = "Prints where time goes between reading data and publishing it.\n";
+	cmd.mDesc += "With an argument, traces 1 in every <sample rate> reads, 0 turns\n";
+	cmd.mDesc += "tracing off.";
+	apTerminal->BindCommand(cmd, "trace");
+
+	cmd.mName = "profile";
+	cmd.mHandler = boost::bind(&LogTerminalExtension::HandleProfile, this, _1);
+	cmd.mUsage = "profile [on|off] [count]";
+	cmd.mDesc  = "Prints the stacks and channels that have kept the io_service thread\n";
+	cmd.mDesc += "busiest, the top 10 unless a count is given. on and off start and\n";
+	cmd.mDesc += "stop the profiling.";
+	apTerminal->BindCommand(cmd, "profile");
 }
 
 void LogTerminalExtension::ResetActiveColumns()
@@ -176,6 +195,51 @@ retcode LogTerminalExtension::HandlePrintVars(std::vector<std::string>& arTokens
 		oss << "Source: " << v[i].source << " Name: " << v[i].name << " Value: " << v[i].value << "\r\n";
 	}
 
+	std::vector<MetricSample> samples;
+	mpLog->GetMetrics()->Snapshot(samples);
+	for(size_t i = 0; i < samples.size(); i++) {
+		oss << "Source: " << samples[i].source << " Name: " << samples[i].name << " Value: " << samples[i].value;
+		if(samples[i].type == MT_HISTOGRAM) oss << " Sum: " << samples[i].sum;
+		oss << "\r\n";
+	}
+
+	this->Send(oss.str());
+
+	return SUCCESS;
+}
+
+retcode LogTerminalExtension::HandleTrace(std::vector<std::string>& arTokens)
+{
+	if(arTokens.size() > 1) return BAD_ARGUMENTS;
+
+	if(arTokens.size() == 1) {
+		int rate;
+		if(!Parsing::GetPositive(arTokens[0], rate)) return BAD_ARGUMENTS;
+		LatencyTrace::SetSampleRate(rate);
+	}
+
+	ostringstream oss;
+	oss << "Sample rate: " << LatencyTrace::GetSampleRate() << "\r\n";
+	LatencyTrace::WriteReport(*mpLog->GetMetrics(), oss);
+	this->Send(oss.str());
+
+	return SUCCESS;
+}
+
+retcode LogTerminalExtension::HandleProfile(std::vector<std::string>& arTokens)
+{
+	if(arTokens.size() > 2) return BAD_ARGUMENTS;
+
+	int count = 10;
+	for(size_t i = 0; i < arTokens.size(); ++i) {
+		if(arTokens[i] == "on") HandlerProfiler::SetEnabled(true);
+		else if(arTokens[i] == "off") HandlerProfiler::SetEnabled(false);
+		else if(!Parsing::GetPositive(arTokens[i], count)) return BAD_ARGUMENTS;
+	}
+
+	ostringstream oss;
+	oss << "Profiling: " << (HandlerProfiler::IsEnabled() ? "on" : "off") << "\r\n";
+	HandlerProfiler::WriteReport(*mpLog->GetMetrics(), static_cast<size_t>(count), oss);
 	this->Send(oss.str());
 
 	return SUCCESS;
@@ -56,6 +56,8 @@ private:
 	retcode HandlePrintLog(std::vector<std::string>&);
 	retcode HandlePrintLoggers(std::vector<std::string>&);
 	retcode HandlePrintVars(std::vector<std::string>&);
+	retcode HandleTrace(std::vector<std::string>&);
+	retcode HandleProfile(std::vector<std::string>&);
 	//run
 	retcode HandleRunLog(std::vector<std::string>& arTokens);
 	//set
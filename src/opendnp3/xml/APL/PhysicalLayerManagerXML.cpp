@@ -52,6 +52,7 @@ void PhysicalLayerManagerXML :: AddList(const APLXML_Base::PhysicalLayerList_t*
 	AddStandalones<Serial_t>(apList->SerialVector, aLevel);
 	AddStandalones<TCPClient_t>(apList->TCPClientVector, aLevel);
 	AddStandalones<TCPServer_t>(apList->TCPServerVector, aLevel);
+	AddStandalones<SharedMemory_t>(apList->SharedMemoryVector, aLevel);
 }
 
 // Created helper function to remove ugly loops.
@@ -39,6 +39,9 @@ IPhysicalLayerAsyncFactory PhysicalLayerXMLFactory :: GetFactoryAsync(const APLX
 	const APLXML_Base::TCPClient_t* pClient = dynamic_cast<const APLXML_Base::TCPClient_t*>(apCfg);
 	if(pClient != NULL) return GetAsync(pClient);
 
+	const APLXML_Base::SharedMemory_t* pShared = dynamic_cast<const APLXML_Base::SharedMemory_t*>(apCfg);
+	if(pShared != NULL) return GetAsync(pShared);
+
 	throw Exception(LOCATION, "Unknown PhysicalLayerDescriptor_t");
 }
 
@@ -60,6 +63,11 @@ IPhysicalLayerAsyncFactory PhysicalLayerXMLFactory :: GetAsync(const APLXML_Base
 	return PhysicalLayerFactory::GetTCPServerAsync(apCfg->Endpoint, port);
 }
 
+IPhysicalLayerAsyncFactory PhysicalLayerXMLFactory :: GetAsync(const APLXML_Base::SharedMemory_t* apCfg)
+{
+	return PhysicalLayerFactory::GetSharedMemoryAsync(apCfg->Segment, apCfg->Server);
+}
+
 SerialSettings GetSerialSettings(const APLXML_Base::Serial_t* apCfg)
 {
 	SerialSettings s;
@@ -37,6 +37,7 @@ public:
 
 	/* These factories should take the regular configuration types */
 	static IPhysicalLayerAsyncFactory GetAsync(const APLXML_Base::Serial_t* apCfg);
+	static IPhysicalLayerAsyncFactory GetAsync(const APLXML_Base::SharedMemory_t* apCfg);
 	static IPhysicalLayerAsyncFactory GetAsync(const APLXML_Base::TCPClient_t* apCfg);
 	static IPhysicalLayerAsyncFactory GetAsync(const APLXML_Base::TCPServer_t* apCfg);
 };
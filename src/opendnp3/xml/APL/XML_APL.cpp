@@ -61,5 +61,16 @@ APLXML_Base::Serial_t* XML_APL::AddSerial(APLXML_Base::PhysicalLayerList_t& arLi
 	return pLayer;
 }
 
+APLXML_Base::SharedMemory_t* XML_APL::AddSharedMemory(APLXML_Base::PhysicalLayerList_t& arList, const std::string& arName, const std::string& arSegment, bool aServer)
+{
+	APLXML_Base::SharedMemory_t* pLayer = new APLXML_Base::SharedMemory_t();
+	pLayer->Name = arName;
+	pLayer->Segment = arSegment;
+	pLayer->Server = aServer;
+	pLayer->OpenRetryMS = 5000;
+	arList.SharedMemoryVector.push_back(pLayer);
+	return pLayer;
+}
+
 }
 }
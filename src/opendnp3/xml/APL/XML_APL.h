@@ -33,6 +33,7 @@ public:
 	static APLXML_Base::TCPServer_t* AddTCPServer(APLXML_Base::PhysicalLayerList_t& arList, const std::string& arDevice, const std::string& arEndpoint, int aPort);
 	static APLXML_Base::TCPClient_t* AddTCPClient(APLXML_Base::PhysicalLayerList_t& arList, const std::string& arDevice, const std::string& arAdderss, int aPort);
 	static APLXML_Base::Serial_t* AddSerial(APLXML_Base::PhysicalLayerList_t& arList, const std::string& arName, const std::string& arDevice);
+	static APLXML_Base::SharedMemory_t* AddSharedMemory(APLXML_Base::PhysicalLayerList_t& arList, const std::string& arName, const std::string& arSegment, bool aServer);
 
 };
 
@@ -62,6 +62,12 @@ bool XmlToConfig::Configure(const APLXML_Base::PhysicalLayerList_t& arList, Filt
 		PhysLayerSettings s(aLevel, pCfg->OpenRetryMS);
 		arMgr.AddSerial(pCfg->Name, s, xml::GetSerialSettings(pCfg) );
 	}
+	for (size_t i = 0; i < arList.SharedMemoryVector.size(); i++ ) {
+		SharedMemory_t* pCfg = arList.SharedMemoryVector[i];
+		PhysLayerSettings s(aLevel, pCfg->OpenRetryMS);
+		if(pCfg->Server) arMgr.AddSharedMemoryServer(pCfg->Name, s, pCfg->Segment);
+		else arMgr.AddSharedMemoryClient(pCfg->Name, s, pCfg->Segment);
+	}
 
 	return true;
 }
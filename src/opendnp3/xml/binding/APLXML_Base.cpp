@@ -267,10 +267,35 @@ void Serial_t :: toXml(TiXmlNode* pParent, bool aCreateNode, bool aIgnoreValid){
 	pEm->SetAttribute("FlowControl", ToString_FlowControlEnum(FlowControl));
 };
 
+void SharedMemory_t :: fromXml(TiXmlNode* pNode){
+	if(pNode == NULL)return;
+	XML_CHECK("SharedMemory",pNode->Type() == TiXmlNode::ELEMENT);
+	TiXmlElement* pEm = pNode->ToElement();
+	XML_CHECK("SharedMemory",pEm != 0);
+	this->APLXML_Base::PhysicalLayerDescriptor_t::fromXml(pNode);
+	Segment = FromString_string(pEm, pEm->Attribute("Segment"));
+	Server = FromString_bool(pEm, pEm->Attribute("Server"));
+	valid=true;
+};
+void SharedMemory_t :: toXml(TiXmlNode* pParent, bool aCreateNode, bool aIgnoreValid){
+	if(!aIgnoreValid && !valid) return;
+	TiXmlElement * pEm;
+	if(aCreateNode){
+		pEm = new TiXmlElement("SharedMemory");
+		pParent->LinkEndChild(pEm);
+	}else{
+		pEm = pParent->ToElement();
+	}
+	this->APLXML_Base::PhysicalLayerDescriptor_t::toXml(pEm, false, aIgnoreValid);
+	pEm->SetAttribute("Segment", ToString_string(Segment));
+	pEm->SetAttribute("Server", ToString_bool(Server));
+};
+
 PhysicalLayerList_t::PhysicalLayerList_t():
 		TCPServer("TCPServer"), TCPServerVector(TCPServer.collection),
 		TCPClient("TCPClient"), TCPClientVector(TCPClient.collection),
-		Serial("Serial"), SerialVector(Serial.collection){};
+		Serial("Serial"), SerialVector(Serial.collection),
+		SharedMemory("SharedMemory"), SharedMemoryVector(SharedMemory.collection){};
 void PhysicalLayerList_t :: fromXml(TiXmlNode* pNode){
 	if(pNode == NULL)return;
 	XML_CHECK("PhysicalLayerList",pNode->Type() == TiXmlNode::ELEMENT);
@@ -279,10 +304,11 @@ void PhysicalLayerList_t :: fromXml(TiXmlNode* pNode){
 	TCPServer.fromXml(pNode);
 	TCPClient.fromXml(pNode);
 	Serial.fromXml(pNode);
+	SharedMemory.fromXml(pNode);
 	valid=true;
 };
 void PhysicalLayerList_t :: toXml(TiXmlNode* pParent, bool aCreateNode, bool aIgnoreValid){
-	if(TCPServer.size() == 0 && TCPClient.size() == 0 && Serial.size() == 0)return;
+	if(TCPServer.size() == 0 && TCPClient.size() == 0 && Serial.size() == 0 && SharedMemory.size() == 0)return;
 	if(!aIgnoreValid && !valid) return;
 	TiXmlElement * pEm;
 	if(aCreateNode){
@@ -294,6 +320,7 @@ void PhysicalLayerList_t :: toXml(TiXmlNode* pParent, bool aCreateNode, bool aIg
 	TCPServer.toXml(pEm, true, aIgnoreValid);
 	TCPClient.toXml(pEm, true, aIgnoreValid);
 	Serial.toXml(pEm, true, aIgnoreValid);
+	SharedMemory.toXml(pEm, true, aIgnoreValid);
 };
 
 }
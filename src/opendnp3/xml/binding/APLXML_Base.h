@@ -103,6 +103,13 @@ public:
 	StopBitsEnum StopBits;
 	FlowControlEnum FlowControl;
 };
+class SharedMemory_t : public APLXML_Base::PhysicalLayerDescriptor_t{
+public:
+	void toXml(TiXmlNode* pParent, bool aCreateNode, bool aIgnoreValid);
+	void fromXml(TiXmlNode* pNode);
+	string Segment;
+	bool Server;
+};
 #ifdef SWIG
 }
 %template(Serial_c) std::vector<APLXML_Base::Serial_t*>;
@@ -110,6 +117,11 @@ namespace APLXML_Base{
 #endif
 #ifdef SWIG
 }
+%template(SharedMemory_c) std::vector<APLXML_Base::SharedMemory_t*>;
+namespace APLXML_Base{
+#endif
+#ifdef SWIG
+}
 %template(TCPClient_c) std::vector<APLXML_Base::TCPClient_t*>;
 namespace APLXML_Base{
 #endif
@@ -139,6 +151,11 @@ public:
 #endif
 	private: collectedType < Serial_t > Serial;
 	public: vector < Serial_t* >& SerialVector;
+#ifdef SWIG
+%immutable SharedMemoryVector;
+#endif
+	private: collectedType < SharedMemory_t > SharedMemory;
+	public: vector < SharedMemory_t* >& SharedMemoryVector;
 };
 }
 #endif